@@ -18,6 +18,7 @@
 #include "base/image.h"
 #include "base/label.h"
 #include "base/lcd.h"
+#include "base/perf_stats.h"
 #include "base/progress_bar.h"
 #include "base/rect.h"
 #include "base/resource_manager.h"
@@ -60,6 +61,8 @@ static int wrap_image_t_get_prop(lua_State* L);
 static int wrap_image_t_set_prop(lua_State* L);
 static int wrap_label_t_get_prop(lua_State* L);
 static int wrap_label_t_set_prop(lua_State* L);
+static int wrap_perf_stats_t_get_prop(lua_State* L);
+static int wrap_perf_stats_t_set_prop(lua_State* L);
 static int wrap_progress_bar_t_get_prop(lua_State* L);
 static int wrap_progress_bar_t_set_prop(lua_State* L);
 static int wrap_point_t_get_prop(lua_State* L);
@@ -1125,6 +1128,222 @@ static void label_t_init(lua_State* L) {
   luaL_openlib(L, "Label", static_funcs, 0);
   lua_settop(L, 0);
 }
+static int wrap_perf_stats_get(lua_State* L) {
+  perf_stats_t* ret = NULL;
+  ret = (perf_stats_t*)perf_stats_get();
+
+  return tk_newuserdata(L, ret, "/perf_stats_t", "awtk.perf_stats_t");
+}
+
+static int wrap_perf_stats_reset(lua_State* L) {
+  ret_t ret = 0;
+  ret = (ret_t)perf_stats_reset();
+
+  lua_pushnumber(L, (lua_Number)(ret));
+
+  return 1;
+}
+
+static const struct luaL_Reg perf_stats_t_member_funcs[] = {{NULL, NULL}};
+
+static int wrap_perf_stats_t_set_prop(lua_State* L) {
+  perf_stats_t* obj = (perf_stats_t*)tk_checkudata(L, 1, "perf_stats_t");
+  const char* name = (const char*)luaL_checkstring(L, 2);
+  (void)obj;
+  (void)name;
+  if (strcmp(name, "fps") == 0) {
+    printf("fps is readonly\n");
+    return 0;
+  } else if (strcmp(name, "frames") == 0) {
+    printf("frames is readonly\n");
+    return 0;
+  } else if (strcmp(name, "paint_time") == 0) {
+    printf("paint_time is readonly\n");
+    return 0;
+  } else if (strcmp(name, "max_paint_time") == 0) {
+    printf("max_paint_time is readonly\n");
+    return 0;
+  } else if (strcmp(name, "dirty_pixels") == 0) {
+    printf("dirty_pixels is readonly\n");
+    return 0;
+  } else if (strcmp(name, "pixels_filled") == 0) {
+    printf("pixels_filled is readonly\n");
+    return 0;
+  } else if (strcmp(name, "pixels_blended") == 0) {
+    printf("pixels_blended is readonly\n");
+    return 0;
+  } else if (strcmp(name, "pixels_copied") == 0) {
+    printf("pixels_copied is readonly\n");
+    return 0;
+  } else if (strcmp(name, "glyph_hits") == 0) {
+    printf("glyph_hits is readonly\n");
+    return 0;
+  } else if (strcmp(name, "glyph_misses") == 0) {
+    printf("glyph_misses is readonly\n");
+    return 0;
+  } else if (strcmp(name, "glyph_hit_rate") == 0) {
+    printf("glyph_hit_rate is readonly\n");
+    return 0;
+  } else if (strcmp(name, "image_hits") == 0) {
+    printf("image_hits is readonly\n");
+    return 0;
+  } else if (strcmp(name, "image_misses") == 0) {
+    printf("image_misses is readonly\n");
+    return 0;
+  } else if (strcmp(name, "image_hit_rate") == 0) {
+    printf("image_hit_rate is readonly\n");
+    return 0;
+  } else if (strcmp(name, "timers_fired") == 0) {
+    printf("timers_fired is readonly\n");
+    return 0;
+  } else if (strcmp(name, "idles_dispatched") == 0) {
+    printf("idles_dispatched is readonly\n");
+    return 0;
+  } else if (strcmp(name, "timer_count") == 0) {
+    printf("timer_count is readonly\n");
+    return 0;
+  } else if (strcmp(name, "idle_count") == 0) {
+    printf("idle_count is readonly\n");
+    return 0;
+  } else if (strcmp(name, "mem_used") == 0) {
+    printf("mem_used is readonly\n");
+    return 0;
+  } else if (strcmp(name, "mem_free") == 0) {
+    printf("mem_free is readonly\n");
+    return 0;
+  } else if (strcmp(name, "mem_free_blocks") == 0) {
+    printf("mem_free_blocks is readonly\n");
+    return 0;
+  } else if (strcmp(name, "mem_fragmentation") == 0) {
+    printf("mem_fragmentation is readonly\n");
+    return 0;
+  } else {
+    printf("%s: not supported %s\n", __func__, name);
+    return 0;
+  }
+}
+
+static int wrap_perf_stats_t_get_prop(lua_State* L) {
+  perf_stats_t* obj = (perf_stats_t*)tk_checkudata(L, 1, "perf_stats_t");
+  const char* name = (const char*)luaL_checkstring(L, 2);
+  const luaL_Reg* ret = find_member(perf_stats_t_member_funcs, name);
+
+  (void)obj;
+  (void)name;
+  if (ret) {
+    lua_pushcfunction(L, ret->func);
+    return 1;
+  }
+  if (strcmp(name, "fps") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->fps));
+
+    return 1;
+  } else if (strcmp(name, "frames") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->frames));
+
+    return 1;
+  } else if (strcmp(name, "paint_time") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->paint_time));
+
+    return 1;
+  } else if (strcmp(name, "max_paint_time") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->max_paint_time));
+
+    return 1;
+  } else if (strcmp(name, "dirty_pixels") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->dirty_pixels));
+
+    return 1;
+  } else if (strcmp(name, "pixels_filled") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->pixels_filled));
+
+    return 1;
+  } else if (strcmp(name, "pixels_blended") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->pixels_blended));
+
+    return 1;
+  } else if (strcmp(name, "pixels_copied") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->pixels_copied));
+
+    return 1;
+  } else if (strcmp(name, "glyph_hits") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->glyph_hits));
+
+    return 1;
+  } else if (strcmp(name, "glyph_misses") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->glyph_misses));
+
+    return 1;
+  } else if (strcmp(name, "glyph_hit_rate") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->glyph_hit_rate));
+
+    return 1;
+  } else if (strcmp(name, "image_hits") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->image_hits));
+
+    return 1;
+  } else if (strcmp(name, "image_misses") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->image_misses));
+
+    return 1;
+  } else if (strcmp(name, "image_hit_rate") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->image_hit_rate));
+
+    return 1;
+  } else if (strcmp(name, "timers_fired") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->timers_fired));
+
+    return 1;
+  } else if (strcmp(name, "idles_dispatched") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->idles_dispatched));
+
+    return 1;
+  } else if (strcmp(name, "timer_count") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->timer_count));
+
+    return 1;
+  } else if (strcmp(name, "idle_count") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->idle_count));
+
+    return 1;
+  } else if (strcmp(name, "mem_used") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->mem_used));
+
+    return 1;
+  } else if (strcmp(name, "mem_free") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->mem_free));
+
+    return 1;
+  } else if (strcmp(name, "mem_free_blocks") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->mem_free_blocks));
+
+    return 1;
+  } else if (strcmp(name, "mem_fragmentation") == 0) {
+    lua_pushinteger(L, (lua_Integer)(obj->mem_fragmentation));
+
+    return 1;
+  } else {
+    printf("%s: not supported %s\n", __func__, name);
+    return 0;
+  }
+}
+
+static void perf_stats_t_init(lua_State* L) {
+  static const struct luaL_Reg static_funcs[] = {
+      {"get", wrap_perf_stats_get}, {"reset", wrap_perf_stats_reset}, {NULL, NULL}};
+
+  static const struct luaL_Reg index_funcs[] = {{"__index", wrap_perf_stats_t_get_prop},
+                                                {"__newindex", wrap_perf_stats_t_set_prop},
+                                                {NULL, NULL}};
+
+  luaL_newmetatable(L, "awtk.perf_stats_t");
+  lua_pushstring(L, "__index");
+  lua_pushvalue(L, -2);
+  lua_settable(L, -3);
+  luaL_openlib(L, NULL, index_funcs, 0);
+  luaL_openlib(L, "PerfStats", static_funcs, 0);
+  lua_settop(L, 0);
+}
 static int wrap_progress_bar_create(lua_State* L) {
   widget_t* ret = NULL;
   widget_t* parent = (widget_t*)tk_checkudata(L, 1, "widget_t");
@@ -2771,6 +2990,7 @@ void luaL_openawtk(lua_State* L) {
   idle_t_init(L);
   image_t_init(L);
   label_t_init(L);
+  perf_stats_t_init(L);
   progress_bar_t_init(L);
   point_t_init(L);
   rect_t_init(L);
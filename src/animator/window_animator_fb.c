@@ -20,6 +20,7 @@
  */
 
 #include "base/mem.h"
+#include "base/window_manager.h"
 #include "base/window_animator.h"
 
 static ret_t window_animator_open_destroy(window_animator_t* wa) {
@@ -38,10 +39,100 @@ static ret_t window_animator_close_destroy(window_animator_t* wa) {
   return window_animator_open_destroy(wa);
 }
 
+static ret_t window_animator_surface_destroy(bitmap_t* img) {
+  /*缓冲区属于窗口管理器。*/
+  return RET_OK;
+}
+
+/*合成模式下，覆盖整个屏幕的窗口的缓冲区和截图一样，可以直接使用。*/
+static bool_t window_animator_use_surface(widget_t* win, bitmap_t* img) {
+  bitmap_t* surface = NULL;
+  widget_t* wm = win->parent;
+
+  if (win->x != 0 || win->y != 0 || win->w != wm->w || win->h != wm->h) {
+    return FALSE;
+  }
+
+  surface = window_manager_get_surface(wm, win);
+  if (surface == NULL) {
+    return FALSE;
+  }
+
+  *img = *surface;
+  img->specific_destroy = NULL;
+  img->destroy = window_animator_surface_destroy;
+
+  return TRUE;
+}
+
+/*直接绘制到lcd格式的离屏缓冲区(来自lcd的缓冲区池)，不需要截图和转换格式。
+ *缓冲区没有清除，背景色不是不透明的窗口要画在屏幕当前的内容上，再截图。*/
+static bool_t window_animator_paint_offline(canvas_t* c, rect_t* r, widget_t* win, bitmap_t* img) {
+  canvas_t lc;
+  lcd_t* layer = NULL;
+  color_t trans = color_init(0, 0, 0, 0);
+
+  if (style_get_color(&(win->style), STYLE_ID_BG_COLOR, trans).rgba.a != 0xff) {
+    return FALSE;
+  }
+
+  memset(img, 0x00, sizeof(bitmap_t));
+  img->w = c->lcd->w;
+  img->h = c->lcd->h;
+  layer = lcd_create_layer(c->lcd, img);
+  if (layer == NULL) {
+    return FALSE;
+  }
+
+  canvas_init(&lc, layer, c->font_manager);
+  ENSURE(canvas_begin_frame(&lc, r, LCD_DRAW_OFFLINE) == RET_OK);
+  win->dirty = TRUE;
+  ENSURE(widget_paint(win, &lc) == RET_OK);
+  ENSURE(canvas_end_frame(&lc) == RET_OK);
+  lcd_destroy(layer);
+
+  return TRUE;
+}
+
+static ret_t window_animator_snapshot(canvas_t* c, rect_t* r, widget_t* win, bitmap_t* img) {
+  if (window_animator_use_surface(win, img) || window_animator_paint_offline(c, r, win, img)) {
+    return RET_OK;
+  }
+
+  ENSURE(canvas_begin_frame(c, r, LCD_DRAW_OFFLINE) == RET_OK);
+  ENSURE(widget_paint(win, c) == RET_OK);
+  ENSURE(lcd_take_snapshot(c->lcd, img) == RET_OK);
+  ENSURE(canvas_end_frame(c) == RET_OK);
+  img->flags = BITMAP_FLAG_OPAQUE;
+
+  return RET_OK;
+}
+
+/*只绘制本帧需要更新的区域。没有缩放的图片按相同的偏移裁剪源矩形，由lcd逐行拷贝或者混合。*/
+static ret_t window_animator_draw_image(window_animator_t* wa, bitmap_t* img, rect_t* src,
+                                       rect_t* dst) {
+  rect_t s = *src;
+  rect_t d = *dst;
+
+  /*缩放的图片只用于缩放动画，不会超出本帧需要更新的区域。*/
+  if (s.w == d.w && s.h == d.h) {
+    rect_intersect(&d, &(wa->dirty_rect));
+    if (d.w <= 0 || d.h <= 0) {
+      return RET_OK;
+    }
+
+    s.x += d.x - dst->x;
+    s.y += d.y - dst->y;
+    s.w = d.w;
+    s.h = d.h;
+  }
+
+  return lcd_draw_image(wa->canvas->lcd, img, &s, &d);
+}
+
 static ret_t window_animator_prepare(window_animator_t* wa, canvas_t* c, widget_t* prev_win,
                                      widget_t* curr_win, bool_t open) {
   rect_t r;
-  lcd_t* lcd = c->lcd;
   widget_t* wm = prev_win->parent;
 
   wa->ratio = 1;
@@ -52,18 +143,8 @@ static ret_t window_animator_prepare(window_animator_t* wa, canvas_t* c, widget_
   wa->curr_win = curr_win;
   rect_init(r, 0, 0, wm->w, wm->h);
 
-  ENSURE(canvas_begin_frame(c, &r, LCD_DRAW_OFFLINE) == RET_OK);
-  ENSURE(widget_paint(prev_win, c) == RET_OK);
-  ENSURE(lcd_take_snapshot(lcd, &(wa->prev_img)) == RET_OK);
-  ENSURE(canvas_end_frame(c) == RET_OK);
-
-  ENSURE(canvas_begin_frame(c, &r, LCD_DRAW_OFFLINE) == RET_OK);
-  ENSURE(widget_paint(curr_win, c) == RET_OK);
-  ENSURE(lcd_take_snapshot(lcd, &(wa->curr_img)) == RET_OK);
-  ENSURE(canvas_end_frame(c) == RET_OK);
-
-  wa->prev_img.flags = BITMAP_FLAG_OPAQUE;
-  wa->curr_img.flags = BITMAP_FLAG_OPAQUE;
+  window_animator_snapshot(c, &r, prev_win, &(wa->prev_img));
+  window_animator_snapshot(c, &r, curr_win, &(wa->curr_img));
 
   return RET_OK;
 }
@@ -53,6 +53,11 @@ static ret_t fbo_to_img(framebuffer_object_t* fbo, bitmap_t* img) {
   return RET_OK;
 }
 
+static ret_t window_animator_draw_image(window_animator_t* wa, bitmap_t* img, rect_t* src,
+                                       rect_t* dst) {
+  return lcd_draw_image(wa->canvas->lcd, img, src, dst);
+}
+
 static ret_t window_animator_prepare(window_animator_t* wa, canvas_t* c, widget_t* prev_win,
                                      widget_t* curr_win, bool_t open) {
   vgcanvas_t* vg = lcd_get_vgcanvas(c->lcd);
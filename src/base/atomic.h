@@ -0,0 +1,129 @@
+/**
+ * File:   atomic.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  atomic load/store with memory ordering
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-19 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_ATOMIC_H
+#define TK_ATOMIC_H
+
+#include "base/types_def.h"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+BEGIN_C_DECLS
+
+/*
+ * 在线程之间(或者中断和主循环之间)传递数据时使用：
+ * 写完数据后用tk_atomic_store发布，另一方用tk_atomic_load读到后才能访问数据。
+ *
+ * 其它编译器依赖volatile：单核MCU上只需要保证编译器不重排，
+ * VC在x86上的volatile本身就有acquire/release语义。
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define tk_atomic_load(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define tk_atomic_store(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#else
+#define tk_atomic_load(p) (*(p))
+#define tk_atomic_store(p, v) \
+  do {                        \
+    *(p) = (v);               \
+  } while (0)
+#endif
+
+/*
+ * 多个生产者之间需要的读-改-写操作。
+ * GCC/clang用__atomic内建函数，VC用_Interlocked系列函数。
+ * 其它编译器(如Keil/IAR)必须由平台定义TK_ATOMIC_LOCK()/TK_ATOMIC_UNLOCK()，
+ * 通常是关中断或进入临界区，否则无法保证原子性，直接报错。
+ */
+#if !defined(__GNUC__) && !defined(__clang__) && !defined(_MSC_VER)
+#if !defined(TK_ATOMIC_LOCK) || !defined(TK_ATOMIC_UNLOCK)
+#error "atomic.h: define TK_ATOMIC_LOCK()/TK_ATOMIC_UNLOCK() (critical section) for this compiler"
+#endif
+#endif
+
+static inline bool_t tk_atomic_cas_u32(volatile uint32_t* p, uint32_t* expected,
+                                       uint32_t desired) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_compare_exchange_n(p, expected, desired, FALSE, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE);
+#elif defined(_MSC_VER)
+  uint32_t old = (uint32_t)_InterlockedCompareExchange((volatile long*)p, (long)desired,
+                                                       (long)(*expected));
+  if (old == *expected) {
+    return TRUE;
+  }
+
+  *expected = old;
+  return FALSE;
+#else
+  bool_t ret = FALSE;
+
+  TK_ATOMIC_LOCK();
+  if (*p == *expected) {
+    *p = desired;
+    ret = TRUE;
+  } else {
+    *expected = *p;
+  }
+  TK_ATOMIC_UNLOCK();
+
+  return ret;
+#endif
+}
+
+static inline uint32_t tk_atomic_exchange_u32(volatile uint32_t* p, uint32_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_exchange_n(p, v, __ATOMIC_ACQ_REL);
+#elif defined(_MSC_VER)
+  return (uint32_t)_InterlockedExchange((volatile long*)p, (long)v);
+#else
+  uint32_t old = 0;
+
+  TK_ATOMIC_LOCK();
+  old = *p;
+  *p = v;
+  TK_ATOMIC_UNLOCK();
+
+  return old;
+#endif
+}
+
+static inline uint32_t tk_atomic_fetch_add_u32(volatile uint32_t* p, uint32_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_fetch_add(p, v, __ATOMIC_ACQ_REL);
+#elif defined(_MSC_VER)
+  return (uint32_t)_InterlockedExchangeAdd((volatile long*)p, (long)v);
+#else
+  uint32_t old = 0;
+
+  TK_ATOMIC_LOCK();
+  old = *p;
+  *p = old + v;
+  TK_ATOMIC_UNLOCK();
+
+  return old;
+#endif
+}
+
+END_C_DECLS
+
+#endif /*TK_ATOMIC_H*/
@@ -21,9 +21,23 @@
 
 #include "base/bitmap.h"
 
+static bitmap_fence_t s_fence = NULL;
+static void* s_fence_ctx = NULL;
+
+ret_t bitmap_set_destroy_fence(bitmap_fence_t fence, void* ctx) {
+  s_fence = fence;
+  s_fence_ctx = ctx;
+
+  return RET_OK;
+}
+
 ret_t bitmap_destroy(bitmap_t* bitmap) {
   return_value_if_fail(bitmap != NULL && bitmap->destroy != NULL, RET_BAD_PARAMS);
 
+  if (s_fence != NULL) {
+    s_fence(s_fence_ctx, bitmap);
+  }
+
   if(bitmap->specific_destroy != NULL) {
     bitmap->specific_destroy(bitmap);
   }
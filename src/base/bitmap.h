@@ -30,6 +30,7 @@ struct _bitmap_t;
 typedef struct _bitmap_t bitmap_t;
 
 typedef ret_t (*bitmap_destroy_t)(bitmap_t* bitmap);
+typedef ret_t (*bitmap_fence_t)(void* ctx, bitmap_t* bitmap);
 
 /**
  * @enum bitmap_format_t
@@ -80,7 +81,13 @@ typedef enum _bitmap_flag_t {
    * @const BITMAP_FLAG_TEXTURE
    * OpenGL Texture, bitmap的id是有效的texture id。
    */
-  BITMAP_FLAG_TEXTURE = 4
+  BITMAP_FLAG_TEXTURE = 4,
+
+  /**
+   * @const BITMAP_FLAG_LCD_NATIVE
+   * 图片数据是LCD的原生像素格式(由lcd_create_layer生成)，只能绘制到同类的LCD上，绘制时直接拷贝像素。
+   */
+  BITMAP_FLAG_LCD_NATIVE = 8
 } bitmap_flag_t;
 
 /**
@@ -145,6 +152,17 @@ struct _bitmap_t {
  */
 ret_t bitmap_destroy(bitmap_t* bitmap);
 
+/**
+ * @method bitmap_set_destroy_fence
+ * 设置销毁图片之前调用的函数(同时只能有一个，NULL表示取消)。
+ * 绘制命令可能被延后到其它线程中执行(请参考render_thread_t)，它们引用的图片数据在执行完之前不能释放，
+ * fence负责等待这些命令执行完。只能在GUI线程中销毁图片。
+ * @param {bitmap_fence_t} fence 销毁图片之前调用的函数。
+ * @param {void*} ctx fence的上下文。
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t bitmap_set_destroy_fence(bitmap_fence_t fence, void* ctx);
+
 /**
  * @enum image_draw_type_t
  * @prefix IMAGE_DRAW_
@@ -22,6 +22,10 @@
 #include "base/canvas.h"
 #include "base/wuxiaolin.inc"
 
+#ifndef CANVAS_GLYPHS_NR
+#define CANVAS_GLYPHS_NR 16
+#endif /*CANVAS_GLYPHS_NR*/
+
 ret_t canvas_translate(canvas_t* c, xy_t dx, xy_t dy) {
   return_value_if_fail(c != NULL, RET_BAD_PARAMS);
   c->ox += dx;
@@ -133,8 +137,18 @@ ret_t canvas_set_font(canvas_t* c, const char* name, uint16_t size) {
   return RET_OK;
 }
 
+static uint8_t canvas_get_advance(canvas_t* c, wchar_t chr) {
+  glyph_metrics_t m;
+
+  if (font_get_metrics(c->font, chr, &m, c->font_size) == RET_OK) {
+    return m.advance;
+  }
+
+  return FONT_DEFAULT_ADVANCE;
+}
+
+/*只取字符的宽度，不生成字模。*/
 static wh_t canvas_measure_text_default(canvas_t* c, wchar_t* str, int32_t nr) {
-  glyph_t g;
   wh_t w = 0;
   int32_t i = 0;
   return_value_if_fail(c != NULL && str != NULL && c->font != NULL, 0);
@@ -144,12 +158,7 @@ static wh_t canvas_measure_text_default(canvas_t* c, wchar_t* str, int32_t nr) {
   }
 
   for (i = 0; i < nr; i++) {
-    wchar_t chr = str[i];
-    if (chr == ' ') {
-      w += 4;
-    } else if (font_find_glyph(c->font, chr, &g, c->font_size) == RET_OK) {
-      w += g.w + 1;
-    }
+    w += canvas_get_advance(c, str[i]);
   }
 
   return w;
@@ -354,14 +363,13 @@ ret_t canvas_stroke_rect(canvas_t* c, xy_t x, xy_t y, wh_t w, wh_t h) {
   return canvas_stroke_rect_impl(c, c->ox + x, c->oy + y, w, h);
 }
 
-static ret_t canvas_draw_glyph(canvas_t* c, glyph_t* g, xy_t x, xy_t y) {
-  rect_t src;
+static bool_t canvas_clip_glyph(canvas_t* c, glyph_t* g, xy_t x, xy_t y, lcd_glyph_t* out) {
   rect_t dst;
   xy_t x2 = x + g->w;
   xy_t y2 = y + g->h;
 
   if (x > c->clip_right || x2 < c->clip_left || y > c->clip_bottom || y2 < c->clip_top) {
-    return RET_OK;
+    return FALSE;
   }
 
   dst.x = ftk_max(x, c->clip_left);
@@ -369,12 +377,44 @@ static ret_t canvas_draw_glyph(canvas_t* c, glyph_t* g, xy_t x, xy_t y) {
   dst.w = ftk_min(x2, c->clip_right) - dst.x;
   dst.h = ftk_min(y2, c->clip_bottom) - dst.y;
 
-  src.x = dst.x - x;
-  src.y = dst.y - y;
-  src.w = dst.w;
-  src.h = dst.h;
+  out->glyph = *g;
+  out->src.x = dst.x - x;
+  out->src.y = dst.y - y;
+  out->src.w = dst.w;
+  out->src.h = dst.h;
+  out->x = dst.x;
+  out->y = dst.y;
+
+  return TRUE;
+}
+
+static ret_t canvas_draw_glyph(canvas_t* c, glyph_t* g, xy_t x, xy_t y) {
+  lcd_glyph_t lg;
+
+  if (!canvas_clip_glyph(c, g, x, y, &lg)) {
+    return RET_OK;
+  }
+
+  return lcd_draw_glyph(c->lcd, &(lg.glyph), &(lg.src), lg.x, lg.y);
+}
+
+static ret_t canvas_draw_glyphs(canvas_t* c, lcd_glyph_t* glyphs, uint32_t nr) {
+  rect_t r;
+  rect_t bounds;
+  uint32_t i = 0;
+
+  if (nr == 0) {
+    return RET_OK;
+  }
 
-  return lcd_draw_glyph(c->lcd, g, &src, dst.x, dst.y);
+  rect_init(bounds, 0, 0, 0, 0);
+  for (i = 0; i < nr; i++) {
+    lcd_glyph_t* iter = glyphs + i;
+    rect_init(r, iter->x, iter->y, iter->src.w, iter->src.h);
+    rect_merge(&bounds, &r);
+  }
+
+  return lcd_draw_glyphs(c->lcd, glyphs, nr, &bounds);
 }
 
 static ret_t canvas_draw_char_impl(canvas_t* c, wchar_t chr, xy_t x, xy_t y) {
@@ -382,6 +422,10 @@ static ret_t canvas_draw_char_impl(canvas_t* c, wchar_t chr, xy_t x, xy_t y) {
   uint16_t font_size = c->font_size;
   return_value_if_fail(font_find_glyph(c->font, chr, &g, font_size) == RET_OK, RET_BAD_PARAMS);
 
+  if (g.w == 0 || g.h == 0) {
+    return RET_OK;
+  }
+
   x += g.x;
   y += font_size + g.y;
 
@@ -394,11 +438,14 @@ ret_t canvas_draw_char(canvas_t* c, wchar_t chr, xy_t x, xy_t y) {
   return canvas_draw_char_impl(c, chr, c->ox + x, c->oy + y);
 }
 
+/*同一行的字模收集起来一起交给lcd绘制，换行或者缓冲区满时提交。*/
 static ret_t canvas_draw_text_impl(canvas_t* c, wchar_t* str, int32_t nr, xy_t x, xy_t y) {
   glyph_t g;
   int32_t i = 0;
   xy_t left = x;
+  uint32_t glyphs_nr = 0;
   uint16_t font_size = c->font_size;
+  lcd_glyph_t glyphs[CANVAS_GLYPHS_NR];
 
   if (nr < 0) {
     nr = wcslen(str);
@@ -407,28 +454,36 @@ static ret_t canvas_draw_text_impl(canvas_t* c, wchar_t* str, int32_t nr, xy_t x
   y -= font_size * 1 / 3;
   for (i = 0; i < nr; i++) {
     wchar_t chr = str[i];
-    if (chr == ' ') {
-      x += 4;
-    } else if (chr == '\r') {
+    if (chr == '\r') {
       if (str[i + 1] != '\n') {
+        canvas_draw_glyphs(c, glyphs, glyphs_nr);
+        glyphs_nr = 0;
         y += font_size;
         x = left;
       }
     } else if (chr == '\r') {
+      canvas_draw_glyphs(c, glyphs, glyphs_nr);
+      glyphs_nr = 0;
       y += font_size;
       x = left;
     } else if (font_find_glyph(c->font, chr, &g, c->font_size) == RET_OK) {
       xy_t xx = x + g.x;
       xy_t yy = y + font_size + g.y;
 
-      canvas_draw_glyph(c, &g, xx, yy);
-      x += g.w + 1;
+      if (g.w > 0 && g.h > 0 && canvas_clip_glyph(c, &g, xx, yy, glyphs + glyphs_nr)) {
+        glyphs_nr++;
+        if (glyphs_nr == CANVAS_GLYPHS_NR) {
+          canvas_draw_glyphs(c, glyphs, glyphs_nr);
+          glyphs_nr = 0;
+        }
+      }
+      x += g.advance;
     } else {
-      x += 4;
+      x += canvas_get_advance(c, chr);
     }
   }
 
-  return RET_OK;
+  return canvas_draw_glyphs(c, glyphs, glyphs_nr);
 }
 
 ret_t canvas_draw_text(canvas_t* c, wchar_t* str, int32_t nr, xy_t x, xy_t y) {
@@ -92,11 +92,11 @@ ret_t check_button_set_value(widget_t* widget, bool_t value) {
   return RET_OK;
 }
 
-static ret_t check_button_get_prop(widget_t* widget, const char* name, value_t* v) {
+static ret_t check_button_get_prop(widget_t* widget, prop_atom_t atom, value_t* v) {
   check_button_t* check_button = CHECK_BUTTON(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
 
-  if (strcmp(name, "value") == 0) {
+  if (atom == PROP_ATOM_VALUE) {
     value_set_uint8(v, check_button->value);
     return RET_OK;
   }
@@ -104,10 +104,10 @@ static ret_t check_button_get_prop(widget_t* widget, const char* name, value_t*
   return RET_NOT_FOUND;
 }
 
-static ret_t check_button_set_prop(widget_t* widget, const char* name, const value_t* v) {
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+static ret_t check_button_set_prop(widget_t* widget, prop_atom_t atom, const value_t* v) {
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
 
-  if (strcmp(name, "value") == 0) {
+  if (atom == PROP_ATOM_VALUE) {
     return check_button_set_value(widget, value_bool(v));
   }
 
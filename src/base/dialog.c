@@ -42,40 +42,46 @@ static ret_t dialog_on_paint_self(widget_t* widget, canvas_t* c) {
   return RET_OK;
 }
 
-static ret_t dialog_get_prop(widget_t* widget, const char* name, value_t* v) {
+static ret_t dialog_get_prop(widget_t* widget, prop_atom_t atom, value_t* v) {
   dialog_t* dialog = DIALOG(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
-
-  if (str_fast_equal(name, WIDGET_PROP_TEXT)) {
-    return widget_get_prop(dialog->title, name, v);
-  } else if (str_fast_equal(name, WIDGET_PROP_ANIM_HINT)) {
-    value_set_str(v, dialog->anim_hint.str);
-    return RET_OK;
-  } else if (str_fast_equal(name, WIDGET_PROP_MARGIN)) {
-    value_set_int(v, dialog->margin);
-    return RET_OK;
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
+
+  switch (atom) {
+    case PROP_ATOM_TEXT:
+      return widget_get_prop_atom(dialog->title, atom, v);
+    case PROP_ATOM_ANIM_HINT:
+      value_set_str(v, dialog->anim_hint.str);
+      return RET_OK;
+    case PROP_ATOM_MARGIN:
+      value_set_int(v, dialog->margin);
+      return RET_OK;
+    default:
+      break;
   }
 
   return RET_NOT_FOUND;
 }
 
-static ret_t dialog_set_prop(widget_t* widget, const char* name, const value_t* v) {
+static ret_t dialog_set_prop(widget_t* widget, prop_atom_t atom, const value_t* v) {
   dialog_t* dialog = DIALOG(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
-
-  if (str_fast_equal(name, WIDGET_PROP_TEXT)) {
-    return widget_set_prop(dialog->title, name, v);
-  } else if (str_fast_equal(name, WIDGET_PROP_STYLE)) {
-    widget_set_prop(dialog->title, name, v);
-    widget_set_prop(dialog->client, name, v);
-    return RET_OK;
-  } else if (str_fast_equal(name, WIDGET_PROP_ANIM_HINT)) {
-    str_from_value(&(dialog->anim_hint), v);
-    return RET_OK;
-  } else if (str_fast_equal(name, WIDGET_PROP_MARGIN)) {
-    dialog->margin = value_int(v);
-    dialog_on_relayout_children(widget);
-    return RET_OK;
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
+
+  switch (atom) {
+    case PROP_ATOM_TEXT:
+      return widget_set_prop_atom(dialog->title, atom, v);
+    case PROP_ATOM_STYLE:
+      widget_set_prop_atom(dialog->title, atom, v);
+      widget_set_prop_atom(dialog->client, atom, v);
+      return RET_OK;
+    case PROP_ATOM_ANIM_HINT:
+      str_from_value(&(dialog->anim_hint), v);
+      return RET_OK;
+    case PROP_ATOM_MARGIN:
+      dialog->margin = value_int(v);
+      dialog_on_relayout_children(widget);
+      return RET_OK;
+    default:
+      break;
   }
 
   return RET_NOT_FOUND;
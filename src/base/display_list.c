@@ -0,0 +1,423 @@
+/**
+ * File:   display_list.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  record lcd commands and replay them later
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-12 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/display_list.h"
+
+#define DL_ALIGN(size) (((size) + sizeof(void*) - 1) & ~(sizeof(void*) - 1))
+#define DL_POINTS_BATCH 64
+
+typedef enum _dl_cmd_type_t {
+  DL_CMD_NONE = 0,
+  DL_CMD_SET_GLOBAL_ALPHA,
+  DL_CMD_SET_TEXT_COLOR,
+  DL_CMD_SET_STROKE_COLOR,
+  DL_CMD_SET_FILL_COLOR,
+  DL_CMD_DRAW_HLINE,
+  DL_CMD_DRAW_VLINE,
+  DL_CMD_DRAW_POINTS,
+  DL_CMD_FILL_RECT,
+  DL_CMD_DRAW_GLYPH,
+  DL_CMD_DRAW_IMAGE
+} dl_cmd_type_t;
+
+typedef struct _dl_cmd_t {
+  uint32_t type;
+  uint32_t size;
+} dl_cmd_t;
+
+typedef struct _dl_color_cmd_t {
+  dl_cmd_t cmd;
+  color_t color;
+} dl_color_cmd_t;
+
+/*hline只用r.w，vline只用r.h。*/
+typedef struct _dl_rect_cmd_t {
+  dl_cmd_t cmd;
+  rect_t r;
+} dl_rect_cmd_t;
+
+typedef struct _dl_points_cmd_t {
+  dl_cmd_t cmd;
+  uint32_t nr;
+  point_t points[1];
+} dl_points_cmd_t;
+
+typedef struct _dl_glyph_cmd_t {
+  dl_cmd_t cmd;
+  glyph_t glyph;
+  rect_t src;
+  xy_t x;
+  xy_t y;
+} dl_glyph_cmd_t;
+
+typedef struct _dl_image_cmd_t {
+  dl_cmd_t cmd;
+  bitmap_t img;
+  rect_t src;
+  rect_t dst;
+} dl_image_cmd_t;
+
+static void* display_list_alloc_cmd(display_list_t* dl, uint32_t type, uint32_t size) {
+  dl_cmd_t* cmd = NULL;
+
+  size = DL_ALIGN(size);
+  if (dl->size + size > dl->capacity) {
+    uint32_t capacity = dl->capacity + (dl->capacity >> 1) + size;
+    uint8_t* data = TKMEM_REALLOC(uint8_t, dl->data, capacity);
+    return_value_if_fail(data != NULL, NULL);
+
+    dl->data = data;
+    dl->capacity = capacity;
+  }
+
+  cmd = (dl_cmd_t*)(dl->data + dl->size);
+  cmd->type = type;
+  cmd->size = size;
+  dl->size += size;
+  dl->cmds_nr++;
+
+  return cmd;
+}
+
+static ret_t display_list_add_bounds(display_list_t* dl, xy_t x, xy_t y, wh_t w, wh_t h) {
+  rect_t r;
+
+  rect_init(r, x, y, w, h);
+
+  return rect_merge(&(dl->bounds), &r);
+}
+
+static ret_t display_list_record_color(display_list_t* dl, uint32_t type, color_t color) {
+  dl_color_cmd_t* cmd = NULL;
+
+  cmd = (dl_color_cmd_t*)display_list_alloc_cmd(dl, type, sizeof(dl_color_cmd_t));
+  return_value_if_fail(cmd != NULL, RET_OOM);
+  cmd->color = color;
+
+  return RET_OK;
+}
+
+static ret_t display_list_record_rect(display_list_t* dl, uint32_t type, xy_t x, xy_t y, wh_t w,
+                                      wh_t h) {
+  dl_rect_cmd_t* cmd = NULL;
+
+  if (w <= 0 || h <= 0) {
+    return RET_OK;
+  }
+
+  cmd = (dl_rect_cmd_t*)display_list_alloc_cmd(dl, type, sizeof(dl_rect_cmd_t));
+  return_value_if_fail(cmd != NULL, RET_OOM);
+  rect_init(cmd->r, x, y, w, h);
+
+  return display_list_add_bounds(dl, x, y, w, h);
+}
+
+static ret_t display_list_set_global_alpha(lcd_t* lcd, uint8_t alpha) {
+  color_t color = color_init(0, 0, 0, alpha);
+
+  return display_list_record_color(DISPLAY_LIST(lcd), DL_CMD_SET_GLOBAL_ALPHA, color);
+}
+
+static ret_t display_list_record_state(display_list_t* dl) {
+  lcd_t* lcd = &(dl->lcd);
+
+  /*回放时目标lcd的状态是未知的，先恢复录制开始时的状态。*/
+  display_list_set_global_alpha(lcd, lcd->global_alpha);
+  display_list_record_color(dl, DL_CMD_SET_TEXT_COLOR, lcd->text_color);
+  display_list_record_color(dl, DL_CMD_SET_STROKE_COLOR, lcd->stroke_color);
+
+  return display_list_record_color(dl, DL_CMD_SET_FILL_COLOR, lcd->fill_color);
+}
+
+ret_t display_list_reset(display_list_t* dl) {
+  return_value_if_fail(dl != NULL, RET_BAD_PARAMS);
+
+  dl->size = 0;
+  dl->cmds_nr = 0;
+  rect_init(dl->bounds, 0, 0, 0, 0);
+
+  return display_list_record_state(dl);
+}
+
+static ret_t display_list_begin_frame(lcd_t* lcd, rect_t* dirty_rect) {
+  lcd->dirty_rect = dirty_rect;
+
+  return display_list_reset(DISPLAY_LIST(lcd));
+}
+
+static ret_t display_list_set_text_color(lcd_t* lcd, color_t color) {
+  return display_list_record_color(DISPLAY_LIST(lcd), DL_CMD_SET_TEXT_COLOR, color);
+}
+
+static ret_t display_list_set_stroke_color(lcd_t* lcd, color_t color) {
+  return display_list_record_color(DISPLAY_LIST(lcd), DL_CMD_SET_STROKE_COLOR, color);
+}
+
+static ret_t display_list_set_fill_color(lcd_t* lcd, color_t color) {
+  return display_list_record_color(DISPLAY_LIST(lcd), DL_CMD_SET_FILL_COLOR, color);
+}
+
+static ret_t display_list_draw_hline(lcd_t* lcd, xy_t x, xy_t y, wh_t w) {
+  return display_list_record_rect(DISPLAY_LIST(lcd), DL_CMD_DRAW_HLINE, x, y, w, 1);
+}
+
+static ret_t display_list_draw_vline(lcd_t* lcd, xy_t x, xy_t y, wh_t h) {
+  return display_list_record_rect(DISPLAY_LIST(lcd), DL_CMD_DRAW_VLINE, x, y, 1, h);
+}
+
+static ret_t display_list_fill_rect(lcd_t* lcd, xy_t x, xy_t y, wh_t w, wh_t h) {
+  return display_list_record_rect(DISPLAY_LIST(lcd), DL_CMD_FILL_RECT, x, y, w, h);
+}
+
+static ret_t display_list_draw_points(lcd_t* lcd, point_t* points, uint32_t nr) {
+  uint32_t i = 0;
+  dl_points_cmd_t* cmd = NULL;
+  display_list_t* dl = DISPLAY_LIST(lcd);
+  uint32_t size = sizeof(dl_points_cmd_t) + nr * sizeof(point_t);
+
+  if (nr == 0) {
+    return RET_OK;
+  }
+
+  cmd = (dl_points_cmd_t*)display_list_alloc_cmd(dl, DL_CMD_DRAW_POINTS, size);
+  return_value_if_fail(cmd != NULL, RET_OOM);
+
+  cmd->nr = nr;
+  memcpy(cmd->points, points, nr * sizeof(point_t));
+  for (i = 0; i < nr; i++) {
+    display_list_add_bounds(dl, points[i].x, points[i].y, 1, 1);
+  }
+
+  return RET_OK;
+}
+
+static ret_t display_list_draw_glyph(lcd_t* lcd, glyph_t* glyph, rect_t* src, xy_t x, xy_t y) {
+  dl_glyph_cmd_t* cmd = NULL;
+  display_list_t* dl = DISPLAY_LIST(lcd);
+
+  cmd = (dl_glyph_cmd_t*)display_list_alloc_cmd(dl, DL_CMD_DRAW_GLYPH, sizeof(dl_glyph_cmd_t));
+  return_value_if_fail(cmd != NULL, RET_OOM);
+
+  cmd->glyph = *glyph;
+  cmd->src = *src;
+  cmd->x = x;
+  cmd->y = y;
+
+  return display_list_add_bounds(dl, x, y, src->w, src->h);
+}
+
+static ret_t display_list_draw_image(lcd_t* lcd, bitmap_t* img, rect_t* src, rect_t* dst) {
+  dl_image_cmd_t* cmd = NULL;
+  display_list_t* dl = DISPLAY_LIST(lcd);
+
+  cmd = (dl_image_cmd_t*)display_list_alloc_cmd(dl, DL_CMD_DRAW_IMAGE, sizeof(dl_image_cmd_t));
+  return_value_if_fail(cmd != NULL, RET_OOM);
+
+  /*图片对象常常是调用者栈上的临时变量，所以拷贝一份，但不拥有图片数据。*/
+  cmd->img = *img;
+  cmd->img.destroy = NULL;
+  cmd->src = *src;
+  cmd->dst = *dst;
+
+  return display_list_add_bounds(dl, dst->x, dst->y, dst->w, dst->h);
+}
+
+static ret_t display_list_end_frame(lcd_t* lcd) { return RET_OK; }
+
+static ret_t display_list_destroy(lcd_t* lcd) {
+  display_list_t* dl = DISPLAY_LIST(lcd);
+
+  if (dl->data != NULL) {
+    TKMEM_FREE(dl->data);
+  }
+  TKMEM_FREE(dl);
+
+  return RET_OK;
+}
+
+static ret_t display_list_replay_points(lcd_t* lcd, dl_points_cmd_t* cmd, rect_t* clip) {
+  uint32_t i = 0;
+  uint32_t nr = 0;
+  point_t points[DL_POINTS_BATCH];
+
+  for (i = 0; i < cmd->nr; i++) {
+    point_t* p = cmd->points + i;
+    if (rect_contains(clip, p->x, p->y)) {
+      points[nr++] = *p;
+      if (nr == DL_POINTS_BATCH) {
+        lcd_draw_points(lcd, points, nr);
+        nr = 0;
+      }
+    }
+  }
+
+  if (nr > 0) {
+    lcd_draw_points(lcd, points, nr);
+  }
+
+  return RET_OK;
+}
+
+static ret_t display_list_replay_glyph(lcd_t* lcd, dl_glyph_cmd_t* cmd, rect_t* clip) {
+  rect_t src;
+  rect_t dst;
+
+  rect_init(dst, cmd->x, cmd->y, cmd->src.w, cmd->src.h);
+  rect_intersect(&dst, clip);
+  if (dst.w <= 0 || dst.h <= 0) {
+    return RET_OK;
+  }
+
+  src.x = cmd->src.x + dst.x - cmd->x;
+  src.y = cmd->src.y + dst.y - cmd->y;
+  src.w = dst.w;
+  src.h = dst.h;
+
+  return lcd_draw_glyph(lcd, &(cmd->glyph), &src, dst.x, dst.y);
+}
+
+static ret_t display_list_replay_image(lcd_t* lcd, dl_image_cmd_t* cmd, rect_t* clip) {
+  rect_t src;
+  rect_t dst = cmd->dst;
+  rect_t* s = &(cmd->src);
+  rect_t* d = &(cmd->dst);
+
+  rect_intersect(&dst, clip);
+  if (dst.w <= 0 || dst.h <= 0) {
+    return RET_OK;
+  } else if (dst.w == d->w && dst.h == d->h) {
+    return lcd_draw_image(lcd, &(cmd->img), s, d);
+  }
+
+  /*与canvas_draw_image的裁剪方法相同。*/
+  src.x = s->x + (dst.x - d->x) * s->w / d->w;
+  src.y = s->y + (dst.y - d->y) * s->h / d->h;
+  src.w = dst.w * s->w / d->w;
+  src.h = dst.h * s->h / d->h;
+  if (src.w <= 0 || src.h <= 0) {
+    return RET_OK;
+  }
+
+  return lcd_draw_image(lcd, &(cmd->img), &src, &dst);
+}
+
+ret_t display_list_replay(display_list_t* dl, lcd_t* lcd, rect_t* clip_rect) {
+  rect_t r;
+  rect_t clip;
+  uint32_t offset = 0;
+  return_value_if_fail(dl != NULL && lcd != NULL && lcd != &(dl->lcd), RET_BAD_PARAMS);
+
+  if (clip_rect != NULL) {
+    clip = *clip_rect;
+  } else {
+    rect_init(clip, 0, 0, lcd->w, lcd->h);
+  }
+
+  while (offset < dl->size) {
+    dl_cmd_t* cmd = (dl_cmd_t*)(dl->data + offset);
+    offset += cmd->size;
+
+    switch (cmd->type) {
+      case DL_CMD_SET_GLOBAL_ALPHA: {
+        lcd_set_global_alpha(lcd, ((dl_color_cmd_t*)cmd)->color.rgba.a);
+        break;
+      }
+      case DL_CMD_SET_TEXT_COLOR: {
+        lcd_set_text_color(lcd, ((dl_color_cmd_t*)cmd)->color);
+        break;
+      }
+      case DL_CMD_SET_STROKE_COLOR: {
+        lcd_set_stroke_color(lcd, ((dl_color_cmd_t*)cmd)->color);
+        break;
+      }
+      case DL_CMD_SET_FILL_COLOR: {
+        lcd_set_fill_color(lcd, ((dl_color_cmd_t*)cmd)->color);
+        break;
+      }
+      case DL_CMD_DRAW_HLINE:
+      case DL_CMD_DRAW_VLINE:
+      case DL_CMD_FILL_RECT: {
+        r = ((dl_rect_cmd_t*)cmd)->r;
+        rect_intersect(&r, &clip);
+        if (r.w > 0 && r.h > 0) {
+          if (cmd->type == DL_CMD_DRAW_HLINE) {
+            lcd_draw_hline(lcd, r.x, r.y, r.w);
+          } else if (cmd->type == DL_CMD_DRAW_VLINE) {
+            lcd_draw_vline(lcd, r.x, r.y, r.h);
+          } else {
+            lcd_fill_rect(lcd, r.x, r.y, r.w, r.h);
+          }
+        }
+        break;
+      }
+      case DL_CMD_DRAW_POINTS: {
+        display_list_replay_points(lcd, (dl_points_cmd_t*)cmd, &clip);
+        break;
+      }
+      case DL_CMD_DRAW_GLYPH: {
+        display_list_replay_glyph(lcd, (dl_glyph_cmd_t*)cmd, &clip);
+        break;
+      }
+      case DL_CMD_DRAW_IMAGE: {
+        display_list_replay_image(lcd, (dl_image_cmd_t*)cmd, &clip);
+        break;
+      }
+      default: {
+        assert(!"invalid display list command");
+        return RET_FAIL;
+      }
+    }
+  }
+
+  return RET_OK;
+}
+
+display_list_t* display_list_create(wh_t w, wh_t h) {
+  lcd_t* lcd = NULL;
+  display_list_t* dl = TKMEM_ZALLOC(display_list_t);
+  return_value_if_fail(dl != NULL, NULL);
+
+  lcd = &(dl->lcd);
+  lcd->begin_frame = display_list_begin_frame;
+  lcd->set_global_alpha = display_list_set_global_alpha;
+  lcd->set_text_color = display_list_set_text_color;
+  lcd->set_stroke_color = display_list_set_stroke_color;
+  lcd->set_fill_color = display_list_set_fill_color;
+  lcd->draw_vline = display_list_draw_vline;
+  lcd->draw_hline = display_list_draw_hline;
+  lcd->fill_rect = display_list_fill_rect;
+  lcd->draw_image = display_list_draw_image;
+  lcd->draw_glyph = display_list_draw_glyph;
+  lcd->draw_points = display_list_draw_points;
+  lcd->end_frame = display_list_end_frame;
+  lcd->destroy = display_list_destroy;
+
+  lcd->w = w;
+  lcd->h = h;
+  lcd->ratio = 1;
+  lcd->global_alpha = 0xff;
+  lcd->type = LCD_FRAMEBUFFER;
+
+  display_list_reset(dl);
+
+  return dl;
+}
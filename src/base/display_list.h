@@ -0,0 +1,106 @@
+/**
+ * File:   display_list.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  record lcd commands and replay them later
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-12 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_DISPLAY_LIST_H
+#define TK_DISPLAY_LIST_H
+
+#include "base/lcd.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @class display_list_t
+ * @parent lcd_t
+ * 显示列表。
+ * 它本身是一个lcd，用canvas在上面绘制时，并不真正绘制，而是把绘制命令记录到一块连续的内存中，
+ * 之后可以在任意lcd上回放(可以只回放与指定区域相交的部分)。
+ * canvas在调用lcd之前已经完成了平移和裁剪，所以记录的是屏幕坐标下裁剪后的命令。
+ *
+ * 注意：
+ * 1.命令中只保存了字模和图片数据的指针，回放时这些数据必须仍然有效。
+ * 2.vgcanvas的绘制不会被记录。
+ * 3.每次begin_frame会清除之前记录的命令。
+ */
+typedef struct _display_list_t {
+  lcd_t lcd;
+
+  /**
+   * @property {uint32_t} cmds_nr
+   * @readonly
+   * 命令的个数。
+   */
+  uint32_t cmds_nr;
+  /**
+   * @property {uint32_t} size
+   * @readonly
+   * 命令占用的内存大小。
+   */
+  uint32_t size;
+  /**
+   * @property {rect_t} bounds
+   * @readonly
+   * 全部绘制命令覆盖的区域。
+   */
+  rect_t bounds;
+
+  /*private*/
+  uint8_t* data;
+  uint32_t capacity;
+} display_list_t;
+
+/**
+ * @method display_list_create
+ * @constructor
+ * 创建显示列表。
+ * @param {wh_t} w 宽度(一般与回放的lcd相同)。
+ * @param {wh_t} h 高度(一般与回放的lcd相同)。
+ *
+ * @return {display_list_t*} 返回显示列表对象，用lcd_destroy销毁。
+ */
+display_list_t* display_list_create(wh_t w, wh_t h);
+
+/**
+ * @method display_list_reset
+ * 清除记录的命令。
+ * @param {display_list_t*} dl 显示列表对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t display_list_reset(display_list_t* dl);
+
+/**
+ * @method display_list_replay
+ * 在lcd上回放记录的命令。
+ * 命令只在与clip_rect相交的部分绘制，clip_rect为NULL时全部绘制。
+ * 调用者负责lcd的begin_frame/end_frame。
+ * @param {display_list_t*} dl 显示列表对象。
+ * @param {lcd_t*} lcd 目标lcd对象。
+ * @param {rect_t*} clip_rect 裁剪区域。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t display_list_replay(display_list_t* dl, lcd_t* lcd, rect_t* clip_rect);
+
+#define DISPLAY_LIST(lcd) ((display_list_t*)(lcd))
+
+END_C_DECLS
+
+#endif /*TK_DISPLAY_LIST_H*/
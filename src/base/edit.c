@@ -22,16 +22,24 @@
 #include "base/mem.h"
 #include "base/edit.h"
 #include "base/keys.h"
-#include "base/timer.h"
 #include "base/enums.h"
 #include "base/events.h"
+#include "base/frame_scheduler.h"
 
 static ret_t edit_update_status(widget_t* widget);
 
-static ret_t edit_update_carent(const timer_info_t* timer) {
+static ret_t edit_text_changed(widget_t* widget) {
+  edit_t* edit = EDIT(widget);
+
+  text_layout_invalidate(&(edit->layout));
+
+  return widget_invalidate_text_layout(widget);
+}
+
+static ret_t edit_update_carent(const frame_info_t* info) {
   rect_t r;
-  edit_t* edit = EDIT(timer->ctx);
-  widget_t* widget = WIDGETP(timer->ctx);
+  edit_t* edit = EDIT(info->ctx);
+  widget_t* widget = WIDGETP(info->ctx);
 
   rect_init(r, edit->caret_x, 0, 1, widget->h);
   widget_invalidate(widget, &r);
@@ -69,9 +77,11 @@ static ret_t edit_on_paint_self(widget_t* widget, canvas_t* c) {
     canvas_set_text_color(c, tc);
     canvas_set_font(c, font_name, font_size);
 
+    /*每个字符的宽度只在文本或者字体改变时测量一次。*/
+    text_layout_update(&(edit->layout), c, str->str, str->size, 0);
     i = str->size - 1;
     while (w > 0 && i >= 0) {
-      cw = canvas_measure_text(c, str->str + i, 1);
+      cw = text_layout_measure(&(edit->layout), i, 1);
       caret_x += cw;
       w -= cw;
       if (w > cw && i > 0) {
@@ -133,6 +143,7 @@ static ret_t edit_on_key_down(widget_t* widget, key_event_t* e) {
     }
   }
 
+  edit_text_changed(widget);
   edit_update_status(widget);
   widget_invalidate(widget, NULL);
 
@@ -184,7 +195,7 @@ static ret_t edit_on_event(widget_t* widget, event_t* e) {
   switch (type) {
     case EVT_POINTER_DOWN:
       if (edit->timer_id == 0) {
-        edit->timer_id = timer_add(edit_update_carent, widget, 600);
+        edit->timer_id = frame_scheduler_add(frame_scheduler(), edit_update_carent, widget, 600);
       }
       edit_update_status(widget);
       break;
@@ -265,14 +276,16 @@ ret_t edit_set_input_tips(widget_t* widget, const wchar_t* tips) {
   edit_t* edit = EDIT(widget);
   return_value_if_fail(widget != NULL && tips != NULL, RET_BAD_PARAMS);
 
+  edit_text_changed(widget);
+
   return wstr_set(&(edit->tips), tips);
 }
 
-static ret_t edit_get_prop(widget_t* widget, const char* name, value_t* v) {
+static ret_t edit_get_prop(widget_t* widget, prop_atom_t atom, value_t* v) {
   edit_t* edit = EDIT(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
 
-  if (strcmp(name, WIDGET_PROP_MIN) == 0) {
+  if (atom == PROP_ATOM_MIN) {
     if (edit->limit.type == INPUT_INT) {
       value_set_int(v, edit->limit.i.min);
     } else if (edit->limit.type == INPUT_TEXT) {
@@ -283,7 +296,7 @@ static ret_t edit_get_prop(widget_t* widget, const char* name, value_t* v) {
       return RET_NOT_FOUND;
     }
     return RET_OK;
-  } else if (strcmp(name, WIDGET_PROP_MAX) == 0) {
+  } else if (atom == PROP_ATOM_MAX) {
     if (edit->limit.type == INPUT_INT) {
       value_set_int(v, edit->limit.i.max);
     } else if (edit->limit.type == INPUT_TEXT) {
@@ -294,20 +307,20 @@ static ret_t edit_get_prop(widget_t* widget, const char* name, value_t* v) {
       return RET_NOT_FOUND;
     }
     return RET_OK;
-  } else if (strcmp(name, WIDGET_PROP_STEP) == 0) {
+  } else if (atom == PROP_ATOM_STEP) {
     if (edit->limit.type == INPUT_FLOAT) {
       value_set_float(v, edit->limit.f.step);
       return RET_OK;
     } else {
       return RET_NOT_FOUND;
     }
-  } else if (strcmp(name, WIDGET_PROP_INPUT_TYPE) == 0) {
+  } else if (atom == PROP_ATOM_INPUT_TYPE) {
     value_set_uint32(v, edit->limit.type);
     return RET_OK;
-  } else if (strcmp(name, "readonly") == 0) {
+  } else if (atom == PROP_ATOM_READONLY) {
     value_set_bool(v, edit->readonly);
     return RET_OK;
-  } else if (strcmp(name, "tips") == 0) {
+  } else if (atom == PROP_ATOM_TIPS) {
     value_set_wstr(v, edit->tips.str);
     return RET_OK;
   }
@@ -315,11 +328,11 @@ static ret_t edit_get_prop(widget_t* widget, const char* name, value_t* v) {
   return RET_NOT_FOUND;
 }
 
-static ret_t edit_set_prop(widget_t* widget, const char* name, const value_t* v) {
+static ret_t edit_set_prop(widget_t* widget, prop_atom_t atom, const value_t* v) {
   edit_t* edit = EDIT(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
 
-  if (strcmp(name, WIDGET_PROP_MIN) == 0) {
+  if (atom == PROP_ATOM_MIN) {
     if (edit->limit.type == INPUT_INT) {
       edit->limit.i.min = value_int(v);
     } else if (edit->limit.type == INPUT_TEXT) {
@@ -330,7 +343,7 @@ static ret_t edit_set_prop(widget_t* widget, const char* name, const value_t* v)
       return RET_NOT_FOUND;
     }
     return RET_OK;
-  } else if (strcmp(name, WIDGET_PROP_MAX) == 0) {
+  } else if (atom == PROP_ATOM_MAX) {
     if (edit->limit.type == INPUT_INT) {
       edit->limit.i.max = value_int(v);
     } else if (edit->limit.type == INPUT_TEXT) {
@@ -341,14 +354,14 @@ static ret_t edit_set_prop(widget_t* widget, const char* name, const value_t* v)
       return RET_NOT_FOUND;
     }
     return RET_OK;
-  } else if (strcmp(name, WIDGET_PROP_STEP) == 0) {
+  } else if (atom == PROP_ATOM_STEP) {
     if (edit->limit.type == INPUT_FLOAT) {
       edit->limit.f.step = value_float(v);
       return RET_OK;
     } else {
       return RET_NOT_FOUND;
     }
-  } else if (strcmp(name, WIDGET_PROP_INPUT_TYPE) == 0) {
+  } else if (atom == PROP_ATOM_INPUT_TYPE) {
     if (v->type == VALUE_TYPE_STRING) {
       const key_type_value_t* kv = input_type_find(value_str(v));
       if (kv != NULL) {
@@ -358,10 +371,11 @@ static ret_t edit_set_prop(widget_t* widget, const char* name, const value_t* v)
       edit->limit.type = (input_type_t)value_int(v);
     }
     return RET_OK;
-  } else if (strcmp(name, "readonly") == 0) {
+  } else if (atom == PROP_ATOM_READONLY) {
     edit->readonly = value_bool(v);
     return RET_OK;
-  } else if (strcmp(name, "tips") == 0) {
+  } else if (atom == PROP_ATOM_TIPS) {
+    edit_text_changed(widget);
     if (v->type == VALUE_TYPE_STRING) {
       wstr_set_utf8(&(edit->tips), value_str(v));
       return RET_OK;
@@ -370,16 +384,33 @@ static ret_t edit_set_prop(widget_t* widget, const char* name, const value_t* v)
       return RET_OK;
     }
     return RET_BAD_PARAMS;
+  } else if (atom == PROP_ATOM_TEXT) {
+    edit_text_changed(widget);
   }
   edit_update_status(widget);
 
   return RET_NOT_FOUND;
 }
 
+static ret_t edit_destroy(widget_t* widget) {
+  edit_t* edit = EDIT(widget);
+
+  if (edit->timer_id != 0) {
+    frame_scheduler_remove(frame_scheduler(), edit->timer_id);
+    edit->timer_id = 0;
+  }
+
+  wstr_reset(&(edit->tips));
+  text_layout_deinit(&(edit->layout));
+
+  return RET_OK;
+}
+
 static const widget_vtable_t s_edit_vtable = {.on_paint_self = edit_on_paint_self,
                                               .set_prop = edit_set_prop,
                                               .get_prop = edit_get_prop,
-                                              .on_event = edit_on_event};
+                                              .on_event = edit_on_event,
+                                              .destroy = edit_destroy};
 
 widget_t* edit_create(widget_t* parent, xy_t x, xy_t y, wh_t w, wh_t h) {
   widget_t* widget = NULL;
@@ -108,6 +108,7 @@ typedef struct _edit_t {
   wstr_t tips;
   uint32_t timer_id;
   input_limit_t limit;
+  text_layout_t layout;
 } edit_t;
 
 /**
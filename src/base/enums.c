@@ -47,6 +47,8 @@ static const key_type_value_t widget_type_value[] = {
     {"dialog_title", 0, WIDGET_DIALOG_TITLE},
     {"dialog_view", 0, WIDGET_VIEW},
     {"dialog_client", 0, WIDGET_DIALOG_CLIENT},
+    {"list_view", 0, WIDGET_LIST_VIEW},
+    {"scroll_view", 0, WIDGET_SCROLL_VIEW},
 };
 
 static const key_type_value_t style_id_name_value[] = {
@@ -20,12 +20,13 @@
  */
 
 #include "base/mem.h"
+#include "base/atomic.h"
 #include "base/event_queue.h"
 
 event_queue_t* event_queue_create(uint16_t capacity) {
-  uint16_t size = 0;
+  uint32_t size = 0;
   event_queue_t* q = NULL;
-  return_value_if_fail(capacity > 1, NULL);
+  return_value_if_fail(capacity > 1 && capacity < 0x8000, NULL);
 
   size = sizeof(event_queue_t) + (capacity - 1) * sizeof(event_all_t);
   q = (event_queue_t*)TKMEM_ALLOC(size);
@@ -33,53 +34,83 @@ event_queue_t* event_queue_create(uint16_t capacity) {
 
   memset(q, 0x00, size);
   q->capacity = capacity;
+  q->move_reserved = capacity / 4;
 
   return q;
 }
 
+static inline event_all_t* event_queue_at(event_queue_t* q, uint16_t index) {
+  return q->events + (index < q->capacity ? index : index - q->capacity);
+}
+
+static inline uint16_t event_queue_next(event_queue_t* q, uint16_t index) {
+  return (index + 1) < 2 * q->capacity ? index + 1 : 0;
+}
+
+static inline uint16_t event_queue_count(event_queue_t* q, uint16_t r, uint16_t w) {
+  return w >= r ? w - r : w + 2 * q->capacity - r;
+}
+
+uint16_t event_queue_size(event_queue_t* q) {
+  return_value_if_fail(q != NULL, 0);
+
+  return event_queue_count(q, tk_atomic_load(&(q->r)), tk_atomic_load(&(q->w)));
+}
+
 ret_t event_queue_recv(event_queue_t* q, event_all_t* e) {
+  uint16_t r = 0;
+  uint16_t w = 0;
   return_value_if_fail(q != NULL && e != NULL, RET_BAD_PARAMS);
-  if (q->r != q->w || q->full) {
-    memcpy(e, q->events + q->r, sizeof(*e));
-    if ((q->r + 1) < q->capacity) {
-      q->r++;
-    } else {
-      q->r = 0;
-    }
-    q->full = FALSE;
-
-    return RET_OK;
+
+  r = q->r;
+  w = tk_atomic_load(&(q->w));
+  if (r == w) {
+    return RET_FAIL;
+  }
+
+  memcpy(e, event_queue_at(q, r), sizeof(*e));
+  r = event_queue_next(q, r);
+
+  /*连续的移动事件只需要处理最后一个*/
+  while (e->e.event.type == EVT_POINTER_MOVE && r != w &&
+         event_queue_at(q, r)->e.event.type == EVT_POINTER_MOVE) {
+    memcpy(e, event_queue_at(q, r), sizeof(*e));
+    r = event_queue_next(q, r);
   }
 
-  return RET_FAIL;
+  tk_atomic_store(&(q->r), r);
+
+  return RET_OK;
 }
 
 ret_t event_queue_send(event_queue_t* q, const event_all_t* e) {
+  uint16_t w = 0;
+  uint16_t limit = 0;
   return_value_if_fail(q != NULL && e != NULL, RET_BAD_PARAMS);
-  if (q->r != q->w || !q->full) {
-    memcpy(q->events + q->w, e, sizeof(*e));
-    if ((q->w + 1) < q->capacity) {
-      q->w++;
-    } else {
-      q->w = 0;
-    }
-    if (q->r == q->w) {
-      q->full = TRUE;
-    }
-
-    return RET_OK;
+
+  w = q->w;
+  limit = q->capacity;
+  if (e->e.event.type == EVT_POINTER_MOVE) {
+    limit -= q->move_reserved;
   }
 
-  return RET_FAIL;
+  if (event_queue_count(q, tk_atomic_load(&(q->r)), w) >= limit) {
+    q->dropped++;
+    return RET_FAIL;
+  }
+
+  memcpy(event_queue_at(q, w), e, sizeof(*e));
+  tk_atomic_store(&(q->w), event_queue_next(q, w));
+
+  return RET_OK;
 }
 
 ret_t event_queue_replace_last(event_queue_t* q, const event_all_t* e) {
+  uint16_t w = 0;
   return_value_if_fail(q != NULL && e != NULL, RET_BAD_PARAMS);
-  if (q->w > 0) {
-    memcpy(q->events + q->w - 1, e, sizeof(*e));
-  } else {
-    memcpy(q->events + q->capacity - 1, e, sizeof(*e));
-  }
+
+  w = q->w > 0 ? q->w - 1 : 2 * q->capacity - 1;
+  memcpy(event_queue_at(q, w), e, sizeof(*e));
 
   return RET_OK;
 }
@@ -34,17 +34,31 @@ typedef struct _event_all_t {
   } e;
 } event_all_t;
 
+/*
+ * 单生产者/单消费者的无锁环形队列(比如触摸中断发送事件，主循环接收事件)。
+ *
+ * r只由消费者修改，w只由生产者修改，取值范围是[0, 2*capacity)，r==w表示空，相差capacity表示满，
+ * 不需要共享的full标志。生产者写完事件后才发布w，消费者读完事件后才发布r。
+ *
+ * 队列快满时(只剩move_reserved个空位)丢掉新的EVT_POINTER_MOVE，给按下/松开等事件留出空间。
+ * 接收时连续的EVT_POINTER_MOVE只返回最后一个。
+ */
 typedef struct _event_queue_t {
-  uint16_t r;
-  uint16_t w;
-  uint16_t full;
+  volatile uint16_t r;
+  volatile uint16_t w;
   uint16_t capacity;
+  uint16_t move_reserved;
+  /*因为队列满而丢掉的事件个数(只由生产者修改)*/
+  volatile uint32_t dropped;
   event_all_t events[1];
 } event_queue_t;
 
 event_queue_t* event_queue_create(uint16_t capacity);
 ret_t event_queue_recv(event_queue_t* q, event_all_t* e);
 ret_t event_queue_send(event_queue_t* q, const event_all_t* e);
+uint16_t event_queue_size(event_queue_t* q);
+
+/*只能在生产者和消费者是同一个线程时使用。*/
 ret_t event_queue_replace_last(event_queue_t* q, const event_all_t* e);
 ret_t event_queue_destroy(event_queue_t* q);
 
@@ -20,11 +20,40 @@
  */
 
 #include "base/font.h"
+#include "base/profiler.h"
 
 ret_t font_find_glyph(font_t* f, wchar_t chr, glyph_t* g, uint16_t font_size) {
+  ret_t ret = RET_OK;
   return_value_if_fail(f != NULL && f->find_glyph != NULL && g != NULL, RET_BAD_PARAMS);
 
-  return f->find_glyph(f, chr, g, font_size);
+  PROFILER_BEGIN("font_find_glyph", f->name);
+  ret = f->find_glyph(f, chr, g, font_size);
+  PROFILER_END();
+
+  return ret;
+}
+
+ret_t font_get_metrics(font_t* f, wchar_t chr, glyph_metrics_t* m, uint16_t font_size) {
+  glyph_t g;
+  return_value_if_fail(f != NULL && f->find_glyph != NULL && m != NULL, RET_BAD_PARAMS);
+
+  if (f->get_metrics != NULL) {
+    return f->get_metrics(f, chr, m, font_size);
+  }
+
+  memset(&g, 0x00, sizeof(g));
+  if (f->find_glyph(f, chr, &g, font_size) != RET_OK) {
+    return RET_NOT_FOUND;
+  }
+
+  m->x = g.x;
+  m->y = g.y;
+  m->w = g.w;
+  m->h = g.h;
+  /*没有设置advance的字体，按原来的方式用字模的宽度加1。*/
+  m->advance = g.advance > 0 ? g.advance : g.w + 1;
+
+  return RET_OK;
 }
 
 bool_t font_match(font_t* f, const char* name, uint16_t font_size) {
@@ -29,27 +29,59 @@ BEGIN_C_DECLS
 struct _font_t;
 typedef struct _font_t font_t;
 
+/*字体中找不到的字符(比如旧格式的位图字体中没有保存的空格)使用的宽度。*/
+#define FONT_DEFAULT_ADVANCE 4
+
+/*
+ * 字模的格式。低4位是每个像素的位数(0表示8位)，量化后的覆盖率按行存放，每行从字节边界开始，
+ * 一个字节中高位的像素在左边。
+ * 设置了GLYPH_FMT_RLE时(只用于1/2/4位)，每行按行程压缩：每个字节的高bpp位是覆盖率，
+ * 其余的位是重复次数减1，行程不跨行。
+ */
+#define GLYPH_FMT_A8 0
+#define GLYPH_FMT_A1 1
+#define GLYPH_FMT_A2 2
+#define GLYPH_FMT_A4 4
+#define GLYPH_FMT_RLE 0x80
+#define GLYPH_FMT_BPP(format) (((format)&0x0f) ? ((format)&0x0f) : 8)
+
 typedef struct _glyph_t {
   int8_t x;
   int8_t y;
   uint8_t w;
   uint8_t h;
+  uint8_t advance;
+  uint8_t format;
   const uint8_t* data;
 } glyph_t;
 
+/*字符的度量信息：左上角相对于基线起点的偏移、包围盒的大小和画完后前进的宽度。*/
+typedef struct _glyph_metrics_t {
+  int8_t x;
+  int8_t y;
+  uint8_t w;
+  uint8_t h;
+  uint8_t advance;
+} glyph_metrics_t;
+
 typedef bool_t (*font_match_t)(font_t* f, const char* name, uint16_t font_size);
 typedef ret_t (*font_find_glyph_t)(font_t* f, wchar_t chr, glyph_t* g, uint16_t font_size);
+typedef ret_t (*font_get_metrics_t)(font_t* f, wchar_t chr, glyph_metrics_t* m,
+                                    uint16_t font_size);
 typedef ret_t (*font_destroy_t)(font_t* f);
 
 struct _font_t {
   const char* name;
   font_match_t match;
   font_find_glyph_t find_glyph;
+  /*可选。只取度量信息，不生成字模。没有提供时从find_glyph的结果中取。*/
+  font_get_metrics_t get_metrics;
   font_destroy_t destroy;
 };
 
 bool_t font_match(font_t* f, const char* name, uint16_t font_size);
 ret_t font_find_glyph(font_t* f, wchar_t chr, glyph_t* g, uint16_t font_size);
+ret_t font_get_metrics(font_t* f, wchar_t chr, glyph_metrics_t* m, uint16_t font_size);
 ret_t font_destroy(font_t* f);
 
 END_C_DECLS
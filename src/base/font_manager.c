@@ -43,29 +43,38 @@ font_manager_t* font_manager_create(void) {
 font_manager_t* font_manager_init(font_manager_t* fm) {
   return_value_if_fail(fm != NULL, NULL);
   array_init(&(fm->fonts), 2);
+  memset(fm->cache, 0x00, sizeof(fm->cache));
 
   return fm;
 }
 
 ret_t font_manager_add(font_manager_t* fm, font_t* font) {
   return_value_if_fail(fm != NULL && font != NULL, RET_BAD_PARAMS);
-  
+
+  /*新加的字体可能比之前找到的更合适。*/
+  memset(fm->cache, 0x00, sizeof(fm->cache));
+
   return array_push(&(fm->fonts), font);
 }
 
-font_t* font_manager_find(font_manager_t* fm, const char* name, uint16_t size) {
-  uint32_t i = 0;
-  uint32_t nr = 0;
-  font_t** fonts = NULL;
-  return_value_if_fail(fm != NULL, NULL);
+static font_cache_item_t* font_manager_cache_item(font_manager_t* fm, const char* name,
+                                                  uint16_t size, uint32_t* len) {
+  uint32_t hash = 5381;
+  const uint8_t* p = (const uint8_t*)name;
 
-  nr = fm->fonts.size;
-  fonts = (font_t**)fm->fonts.elms;
-  return_value_if_fail(nr > 0, NULL);
-
-  if (name == NULL) {
-    name = STR_DEFAULT_FONT;
+  while (*p) {
+    hash = ((hash << 5) + hash) + *p++;
   }
+  hash = ((hash << 5) + hash) + size;
+  *len = p - (const uint8_t*)name;
+
+  return fm->cache + (hash % FONT_MANAGER_CACHE_NR);
+}
+
+static font_t* font_manager_lookup(font_manager_t* fm, const char* name, uint16_t size) {
+  uint32_t i = 0;
+  uint32_t nr = fm->fonts.size;
+  font_t** fonts = (font_t**)fm->fonts.elms;
 
   for (i = 0; i < nr; i++) {
     font_t* iter = fonts[i];
@@ -77,6 +86,34 @@ font_t* font_manager_find(font_manager_t* fm, const char* name, uint16_t size) {
   return fonts[0];
 }
 
+font_t* font_manager_find(font_manager_t* fm, const char* name, uint16_t size) {
+  uint32_t len = 0;
+  font_t* font = NULL;
+  font_cache_item_t* item = NULL;
+  return_value_if_fail(fm != NULL, NULL);
+  return_value_if_fail(fm->fonts.size > 0, NULL);
+
+  if (name == NULL) {
+    name = STR_DEFAULT_FONT;
+  }
+
+  item = font_manager_cache_item(fm, name, size, &len);
+  if (item->font != NULL && item->size == size && strcmp(item->name, name) == 0) {
+    return item->font;
+  }
+
+  font = font_manager_lookup(fm, name, size);
+
+  /*名字太长的不缓存。*/
+  if (len <= NAME_LEN) {
+    strcpy(item->name, name);
+    item->size = size;
+    item->font = font;
+  }
+
+  return font;
+}
+
 ret_t font_manager_deinit(font_manager_t* fm) {
   uint32_t i = 0;
   uint32_t nr = 0;
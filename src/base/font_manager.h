@@ -27,13 +27,26 @@
 
 BEGIN_C_DECLS
 
+#ifndef FONT_MANAGER_CACHE_NR
+#define FONT_MANAGER_CACHE_NR 16
+#endif /*FONT_MANAGER_CACHE_NR*/
+
+typedef struct _font_cache_item_t {
+  char name[NAME_LEN + 1];
+  uint16_t size;
+  font_t* font;
+} font_cache_item_t;
+
 /**
  * @class font_manager_t
  * 字体管理器。
  * (如果使用nanovg，字体由nanovg内部管理)
+ *
+ * 查找过的(字体名，字号)记在一个按哈希值直接映射的缓存里，再次查找时不用遍历全部字体。
  */
 typedef struct _font_manager_t {
   array_t fonts;
+  font_cache_item_t cache[FONT_MANAGER_CACHE_NR];
 } font_manager_t;
 
 /**
@@ -0,0 +1,288 @@
+/**
+ * File:   frame_scheduler.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  paint frames at display refresh interval
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-21 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include <time.h>
+#include "base/mem.h"
+#include "base/time.h"
+#include "base/platform.h"
+#include "base/perf_stats.h"
+#include "base/input_trace.h"
+#include "base/window_manager.h"
+#include "base/frame_scheduler.h"
+
+static frame_scheduler_t* s_frame_scheduler = NULL;
+
+frame_scheduler_t* frame_scheduler(void) {
+  return s_frame_scheduler;
+}
+
+ret_t frame_scheduler_set(frame_scheduler_t* fs) {
+  s_frame_scheduler = fs;
+
+  return RET_OK;
+}
+
+frame_scheduler_t* frame_scheduler_create(uint32_t interval) {
+  frame_scheduler_t* fs = NULL;
+  return_value_if_fail(interval > 0, NULL);
+
+  fs = TKMEM_ZALLOC(frame_scheduler_t);
+  return_value_if_fail(fs != NULL, NULL);
+
+  fs->next_id = 1;
+  fs->interval = interval;
+  array_init(&(fs->frames), 5);
+
+  return fs;
+}
+
+ret_t frame_scheduler_set_interval(frame_scheduler_t* fs, uint32_t interval) {
+  return_value_if_fail(fs != NULL && interval > 0, RET_BAD_PARAMS);
+
+  fs->interval = interval;
+  fs->active = FALSE;
+
+  return RET_OK;
+}
+
+uint32_t frame_scheduler_add(frame_scheduler_t* fs, frame_func_t on_frame, void* ctx,
+                             uint32_t interval) {
+  frame_info_t* info = NULL;
+  return_value_if_fail(fs != NULL && on_frame != NULL, 0);
+
+  info = TKMEM_ZALLOC(frame_info_t);
+  return_value_if_fail(info != NULL, 0);
+
+  info->ctx = ctx;
+  info->id = fs->next_id++;
+  info->on_frame = on_frame;
+  info->interval = interval;
+  info->next = frame_scheduler_now(fs) + interval;
+
+  if (array_push(&(fs->frames), info) != RET_OK) {
+    TKMEM_FREE(info);
+    return 0;
+  }
+
+  return info->id;
+}
+
+static int frame_info_compare_id(const void* a, const void* b) {
+  const frame_info_t* info = (const frame_info_t*)a;
+
+  return info->id == *(const uint32_t*)b ? 0 : -1;
+}
+
+static int frame_info_compare_removed(const void* a, const void* b) {
+  const frame_info_t* info = (const frame_info_t*)a;
+  (void)b;
+
+  return info->on_frame == NULL ? 0 : -1;
+}
+
+static ret_t frame_info_destroy(void* data) {
+  TKMEM_FREE(data);
+
+  return RET_OK;
+}
+
+ret_t frame_scheduler_remove(frame_scheduler_t* fs, uint32_t id) {
+  frame_info_t* info = NULL;
+  return_value_if_fail(fs != NULL && id > 0, RET_BAD_PARAMS);
+
+  info = (frame_info_t*)array_find(&(fs->frames), frame_info_compare_id, &id);
+  return_value_if_fail(info != NULL, RET_NOT_FOUND);
+
+  /*分发过程中只做标记，分发完成后再删除。*/
+  info->on_frame = NULL;
+  if (!fs->dispatching) {
+    array_remove_all(&(fs->frames), frame_info_compare_removed, NULL, frame_info_destroy);
+  }
+
+  return RET_OK;
+}
+
+uint32_t frame_scheduler_now(frame_scheduler_t* fs) {
+  if (fs != NULL && fs->dispatching) {
+    return fs->now;
+  }
+
+  return time_now_ms();
+}
+
+static bool_t frame_info_is_due(frame_info_t* info, uint32_t now) {
+  return info->on_frame != NULL && (info->interval == 0 || (int32_t)(now - info->next) >= 0);
+}
+
+static bool_t frame_scheduler_has_work(frame_scheduler_t* fs, uint32_t now, widget_t* wm) {
+  uint32_t i = 0;
+
+  if (wm != NULL && window_manager_need_paint(wm)) {
+    return TRUE;
+  }
+
+  for (i = 0; i < fs->frames.size; i++) {
+    if (frame_info_is_due((frame_info_t*)(fs->frames.elms[i]), now)) {
+      return TRUE;
+    }
+  }
+
+  return FALSE;
+}
+
+static ret_t frame_scheduler_run_callbacks(frame_scheduler_t* fs, uint32_t now) {
+  uint32_t i = 0;
+  uint32_t nr = fs->frames.size;
+
+  /*回调函数中增加的，从下一帧开始调用。*/
+  for (i = 0; i < nr; i++) {
+    frame_info_t* info = (frame_info_t*)(fs->frames.elms[i]);
+
+    if (frame_info_is_due(info, now)) {
+      info->now = now;
+      info->next = now + info->interval;
+      if (info->on_frame(info) != RET_REPEAT) {
+        info->on_frame = NULL;
+      }
+    }
+  }
+
+  return array_remove_all(&(fs->frames), frame_info_compare_removed, NULL, frame_info_destroy);
+}
+
+ret_t frame_scheduler_dispatch(frame_scheduler_t* fs, uint32_t now, widget_t* wm, canvas_t* c) {
+  return_value_if_fail(fs != NULL, RET_BAD_PARAMS);
+
+  /*还没有到刷新时机，期间的invalidate合并到下一帧。*/
+  if (fs->active && (int32_t)(now - fs->deadline) < 0) {
+    return RET_NOT_FOUND;
+  }
+
+  if (!frame_scheduler_has_work(fs, now, wm)) {
+    fs->active = FALSE;
+    return RET_NOT_FOUND;
+  }
+
+  return frame_scheduler_run_frame(fs, now, wm, c);
+}
+
+ret_t frame_scheduler_run_frame(frame_scheduler_t* fs, uint32_t now, widget_t* wm, canvas_t* c) {
+  uint32_t late = 0;
+  uint32_t start = 0;
+  uint32_t frames = 0;
+  bool_t on_grid = FALSE;
+  clock_t cpu_start = 0;
+  frame_scheduler_stat_t* stat = NULL;
+  return_value_if_fail(fs != NULL, RET_BAD_PARAMS);
+
+  stat = &(fs->stat);
+  frames = stat->frames;
+  /*强制运行的帧可能早于刷新时机。*/
+  if (fs->active && (int32_t)(now - fs->deadline) >= 0) {
+    late = now - fs->deadline;
+    stat->missed += late / fs->interval;
+    on_grid = late < fs->interval;
+  }
+
+  /*耗时用平台的时钟，time_now_ms可能是虚拟时钟。*/
+  start = get_time_ms();
+  cpu_start = clock();
+
+  fs->now = now;
+  fs->dispatching = TRUE;
+  frame_scheduler_run_callbacks(fs, now);
+  if (wm != NULL && c != NULL && window_manager_need_paint(wm)) {
+    uint64_t paint_start = get_time_us();
+
+    window_manager_paint(wm, c);
+    stat->frames++;
+    perf_stats_on_frame(now, (uint32_t)(get_time_us() - paint_start));
+  }
+  fs->dispatching = FALSE;
+
+  stat->cost = get_time_ms() - start;
+  stat->max_cost = ftk_max(stat->max_cost, stat->cost);
+  stat->cpu_time = (uint32_t)((clock() - cpu_start) * 1000000.0 / CLOCKS_PER_SEC);
+
+  /*刷新时机对齐到刷新周期上，落后一个周期以上时从现在重新开始。*/
+  if (on_grid) {
+    fs->deadline += fs->interval;
+  } else {
+    fs->deadline = now + fs->interval;
+  }
+  fs->active = TRUE;
+
+  if (input_trace() != NULL) {
+    input_trace_on_frame(input_trace(), c != NULL ? c->lcd : NULL, stat->frames != frames);
+  }
+
+  return RET_OK;
+}
+
+ret_t frame_scheduler_check_idle(frame_scheduler_t* fs, uint32_t now, widget_t* wm) {
+  return_value_if_fail(fs != NULL, RET_BAD_PARAMS);
+
+  if (fs->active && (int32_t)(now - fs->deadline) >= 0 &&
+      !frame_scheduler_has_work(fs, fs->deadline, wm)) {
+    fs->active = FALSE;
+  }
+
+  return RET_OK;
+}
+
+uint32_t frame_scheduler_get_wait_time(frame_scheduler_t* fs, uint32_t now, widget_t* wm,
+                                       uint32_t max_wait) {
+  uint32_t i = 0;
+  uint32_t wait = max_wait;
+  return_value_if_fail(fs != NULL, max_wait);
+
+  /*连续绘制时，到下一个刷新时机醒来，没有需要绘制的内容就回到空闲状态。*/
+  if (fs->active) {
+    int32_t left = (int32_t)(fs->deadline - now);
+    return left > 0 ? ftk_min((uint32_t)left, max_wait) : 0;
+  }
+
+  if (frame_scheduler_has_work(fs, now, wm)) {
+    return 0;
+  }
+
+  for (i = 0; i < fs->frames.size; i++) {
+    frame_info_t* info = (frame_info_t*)(fs->frames.elms[i]);
+    if (info->on_frame != NULL) {
+      wait = ftk_min(wait, info->next - now);
+    }
+  }
+
+  return wait;
+}
+
+ret_t frame_scheduler_destroy(frame_scheduler_t* fs) {
+  uint32_t i = 0;
+  return_value_if_fail(fs != NULL, RET_BAD_PARAMS);
+
+  for (i = 0; i < fs->frames.size; i++) {
+    frame_info_destroy(fs->frames.elms[i]);
+  }
+  array_deinit(&(fs->frames));
+  TKMEM_FREE(fs);
+
+  return RET_OK;
+}
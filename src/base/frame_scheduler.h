@@ -0,0 +1,252 @@
+/**
+ * File:   frame_scheduler.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  paint frames at display refresh interval
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-21 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_FRAME_SCHEDULER_H
+#define TK_FRAME_SCHEDULER_H
+
+#include "base/array.h"
+#include "base/canvas.h"
+#include "base/widget.h"
+
+BEGIN_C_DECLS
+
+struct _frame_info_t;
+typedef struct _frame_info_t frame_info_t;
+
+typedef ret_t (*frame_func_t)(const frame_info_t* info);
+
+struct _frame_info_t {
+  frame_func_t on_frame;
+  void* ctx;
+  uint32_t id;
+  /*0表示每一帧都调用*/
+  uint32_t interval;
+  /*本帧的时间，所有回调函数看到的都相同*/
+  uint32_t now;
+
+  /*private*/
+  uint32_t next;
+};
+
+/**
+ * @class frame_scheduler_stat_t
+ * 帧调度的统计信息。
+ */
+typedef struct _frame_scheduler_stat_t {
+  /**
+   * @property {uint32_t} frames
+   * @readonly
+   * 绘制的帧数。
+   */
+  uint32_t frames;
+  /**
+   * @property {uint32_t} missed
+   * @readonly
+   * 连续绘制时错过的刷新时机的次数。
+   */
+  uint32_t missed;
+  /**
+   * @property {uint32_t} cost
+   * @readonly
+   * 最近一帧的耗时(毫秒，包括动画回调和绘制)。
+   */
+  uint32_t cost;
+  /**
+   * @property {uint32_t} max_cost
+   * @readonly
+   * 最大的一帧耗时(毫秒)。
+   */
+  uint32_t max_cost;
+  /**
+   * @property {uint32_t} cpu_time
+   * @readonly
+   * 最近一帧的CPU时间(微秒)。
+   */
+  uint32_t cpu_time;
+} frame_scheduler_stat_t;
+
+/**
+ * @class frame_scheduler_t
+ * @scriptable no
+ * 帧调度器。
+ *
+ * 主循环每次循环都调用frame_scheduler_dispatch，但是每个刷新周期(interval)最多绘制一帧，
+ * 期间所有的invalidate合并到下一帧。到了刷新时机，先用同一个时间调用到期的动画回调函数
+ * (窗口动画、编辑器的光标和fling等)，再绘制window manager。
+ *
+ * 只能在GUI线程中使用。
+ */
+typedef struct _frame_scheduler_t {
+  /**
+   * @property {uint32_t} interval
+   * @readonly
+   * 刷新周期(毫秒)。
+   */
+  uint32_t interval;
+  /**
+   * @property {frame_scheduler_stat_t} stat
+   * @readonly
+   * 统计信息。
+   */
+  frame_scheduler_stat_t stat;
+
+  /*private*/
+  uint32_t now;
+  uint32_t deadline;
+  uint32_t next_id;
+  /*上一个刷新周期绘制过，deadline有效*/
+  bool_t active;
+  bool_t dispatching;
+  array_t frames;
+} frame_scheduler_t;
+
+/**
+ * @method frame_scheduler
+ * 获取缺省的帧调度器。
+ * @return {frame_scheduler_t*} 返回帧调度器对象。
+ */
+frame_scheduler_t* frame_scheduler(void);
+
+/**
+ * @method frame_scheduler_set
+ * 设置缺省的帧调度器。
+ * @param {frame_scheduler_t*} fs 帧调度器对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t frame_scheduler_set(frame_scheduler_t* fs);
+
+/**
+ * @method frame_scheduler_create
+ * @constructor
+ * 创建帧调度器。
+ * @param {uint32_t} interval 刷新周期(毫秒)。
+ *
+ * @return {frame_scheduler_t*} 返回帧调度器对象。
+ */
+frame_scheduler_t* frame_scheduler_create(uint32_t interval);
+
+/**
+ * @method frame_scheduler_set_interval
+ * 设置刷新周期。
+ * @param {frame_scheduler_t*} fs 帧调度器对象。
+ * @param {uint32_t} interval 刷新周期(毫秒)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t frame_scheduler_set_interval(frame_scheduler_t* fs, uint32_t interval);
+
+/**
+ * @method frame_scheduler_add
+ * 增加一个动画回调函数，在绘制之前调用。
+ * 回调函数返回RET_REPEAT表示继续，返回RET_REMOVE表示删除。
+ * @param {frame_scheduler_t*} fs 帧调度器对象。
+ * @param {frame_func_t} on_frame 回调函数。
+ * @param {void*} ctx 回调函数的上下文。
+ * @param {uint32_t} interval 调用的间隔(毫秒)，0表示每一帧都调用。
+ *
+ * @return {uint32_t} 返回回调函数的ID，0表示失败。
+ */
+uint32_t frame_scheduler_add(frame_scheduler_t* fs, frame_func_t on_frame, void* ctx,
+                             uint32_t interval);
+
+/**
+ * @method frame_scheduler_remove
+ * 删除动画回调函数。
+ * @param {frame_scheduler_t*} fs 帧调度器对象。
+ * @param {uint32_t} id 回调函数的ID。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t frame_scheduler_remove(frame_scheduler_t* fs, uint32_t id);
+
+/**
+ * @method frame_scheduler_now
+ * 获取当前帧的时间。在动画回调函数和绘制中返回本帧的时间，其它时候返回当前时间。
+ * @param {frame_scheduler_t*} fs 帧调度器对象(可以为NULL)。
+ *
+ * @return {uint32_t} 返回时间(毫秒)。
+ */
+uint32_t frame_scheduler_now(frame_scheduler_t* fs);
+
+/**
+ * @method frame_scheduler_dispatch
+ * 到了刷新时机并且有需要绘制的内容，调用到期的动画回调函数，然后绘制window manager。
+ * @param {frame_scheduler_t*} fs 帧调度器对象。
+ * @param {uint32_t} now 当前时间(毫秒)。
+ * @param {widget_t*} wm window manager对象。
+ * @param {canvas_t*} c canvas对象。
+ *
+ * @return {ret_t} 返回RET_OK表示绘制了一帧，RET_NOT_FOUND表示本次没有绘制。
+ */
+ret_t frame_scheduler_dispatch(frame_scheduler_t* fs, uint32_t now, widget_t* wm, canvas_t* c);
+
+/**
+ * @method frame_scheduler_run_frame
+ * 不管刷新时机，立即运行一帧：调用到期的动画回调函数，有需要绘制的内容时绘制window manager。
+ * 回放输入轨迹时用它在录制时的时刻重现每一帧。
+ * @param {frame_scheduler_t*} fs 帧调度器对象。
+ * @param {uint32_t} now 当前时间(毫秒)。
+ * @param {widget_t*} wm window manager对象。
+ * @param {canvas_t*} c canvas对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t frame_scheduler_run_frame(frame_scheduler_t* fs, uint32_t now, widget_t* wm, canvas_t* c);
+
+/**
+ * @method frame_scheduler_check_idle
+ * 过了刷新时机并且没有需要绘制的内容时回到空闲状态(和frame_scheduler_dispatch一样，但是不绘制)。
+ * 回放输入轨迹时两帧之间不运行主循环，用它重现主循环在刷新时机上的检查，以免把空闲的时间算成错过的刷新时机。
+ * @param {frame_scheduler_t*} fs 帧调度器对象。
+ * @param {uint32_t} now 当前时间(毫秒)。
+ * @param {widget_t*} wm window manager对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t frame_scheduler_check_idle(frame_scheduler_t* fs, uint32_t now, widget_t* wm);
+
+/**
+ * @method frame_scheduler_get_wait_time
+ * 主循环可以等待(睡眠)的时间：连续绘制时等到下一个刷新时机，空闲时等到最近的动画回调函数到期。
+ * @param {frame_scheduler_t*} fs 帧调度器对象。
+ * @param {uint32_t} now 当前时间(毫秒)。
+ * @param {widget_t*} wm window manager对象。
+ * @param {uint32_t} max_wait 最长的等待时间(毫秒)。
+ *
+ * @return {uint32_t} 返回等待的时间(毫秒)。
+ */
+uint32_t frame_scheduler_get_wait_time(frame_scheduler_t* fs, uint32_t now, widget_t* wm,
+                                       uint32_t max_wait);
+
+/**
+ * @method frame_scheduler_destroy
+ * @deconstructor
+ * 销毁帧调度器。
+ * @param {frame_scheduler_t*} fs 帧调度器对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t frame_scheduler_destroy(frame_scheduler_t* fs);
+
+END_C_DECLS
+
+#endif /*TK_FRAME_SCHEDULER_H*/
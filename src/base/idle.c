@@ -22,6 +22,8 @@
 #include "base/mem.h"
 #include "base/idle.h"
 #include "base/array.h"
+#include "base/profiler.h"
+#include "base/perf_stats.h"
 
 static uint32_t s_idle_id = 1;
 static array_t* s_idle_manager = NULL;
@@ -93,6 +95,7 @@ const idle_info_t* idle_find(uint32_t idle_id) {
 ret_t idle_dispatch(void) {
   uint32_t i = 0;
   uint32_t nr = 0;
+  uint32_t dispatched = 0;
   idle_info_t** idles = NULL;
   return_value_if_fail(ensure_idle_manager() == RET_OK, RET_BAD_PARAMS);
 
@@ -100,11 +103,13 @@ ret_t idle_dispatch(void) {
     return RET_OK;
   }
 
+  PROFILER_BEGIN("idle_dispatch", NULL);
   idles = (idle_info_t**)s_idle_manager->elms;
   for (i = 0, nr = s_idle_manager->size; i < nr; i++) {
     idle_info_t* iter = idles[i];
     if (iter->on_idle) {
       iter->on_idle(iter);
+      dispatched++;
     } else {
       /*it is removed*/
     }
@@ -112,6 +117,8 @@ ret_t idle_dispatch(void) {
   }
 
   s_idle_manager->size = 0;
+  perf_stats_add(PERF_COUNTER_IDLES_DISPATCHED, dispatched);
+  PROFILER_END();
 
   return RET_OK;
 }
@@ -42,6 +42,7 @@ typedef struct idle_info_t {
  * @scriptable
  * @fake
  * idle函数在paint之后执行。
+ * idle_add只能在GUI线程中调用，其它线程请使用tk_post_task。
  */
 
 /**
@@ -62,14 +62,14 @@ static ret_t image_on_paint_self(widget_t* widget, canvas_t* c) {
   return RET_OK;
 }
 
-static ret_t image_get_prop(widget_t* widget, const char* name, value_t* v) {
+static ret_t image_get_prop(widget_t* widget, prop_atom_t atom, value_t* v) {
   image_t* image = IMAGE(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
 
-  if (strcmp(name, "image") == 0) {
+  if (atom == PROP_ATOM_IMAGE) {
     value_set_pointer(v, &(image->bitmap));
     return RET_OK;
-  } else if (strcmp(name, "draw_type") == 0) {
+  } else if (atom == PROP_ATOM_DRAW_TYPE) {
     value_set_int(v, image->draw_type);
     return RET_OK;
   }
@@ -77,16 +77,16 @@ static ret_t image_get_prop(widget_t* widget, const char* name, value_t* v) {
   return RET_NOT_FOUND;
 }
 
-static ret_t image_set_prop(widget_t* widget, const char* name, const value_t* v) {
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+static ret_t image_set_prop(widget_t* widget, prop_atom_t atom, const value_t* v) {
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
 
-  if (strcmp(name, "image") == 0) {
+  if (atom == PROP_ATOM_IMAGE) {
     if (v->type == VALUE_TYPE_STRING) {
       return image_set_image_name(widget, value_str(v));
     } else if (v->type == VALUE_TYPE_POINTER) {
       return image_set_image(widget, (bitmap_t*)value_pointer(v));
     }
-  } else if (strcmp(name, "draw_type") == 0) {
+  } else if (atom == PROP_ATOM_DRAW_TYPE) {
     if (v->type == VALUE_TYPE_STRING) {
       const key_type_value_t* kv = image_draw_type_find(value_str(v));
       if (kv != NULL) {
@@ -21,6 +21,8 @@
 
 #include "base/mem.h"
 #include "base/time.h"
+#include "base/profiler.h"
+#include "base/perf_stats.h"
 #include "base/image_manager.h"
 #include "base/resource_manager.h"
 
@@ -119,12 +121,12 @@ ret_t image_manager_update_specific(image_manager_t* imm, bitmap_t* image) {
   return RET_NOT_FOUND;
 }
 
-ret_t image_manager_load(image_manager_t* imm, const char* name, bitmap_t* image) {
+static ret_t image_manager_load_impl(image_manager_t* imm, const char* name, bitmap_t* image) {
   const resource_info_t* res = NULL;
-  return_value_if_fail(imm != NULL && name != NULL && image != NULL, RET_BAD_PARAMS);
 
   memset(image, 0x00, sizeof(bitmap_t));
   if (image_manager_lookup(imm, name, image) == RET_OK) {
+    perf_stats_add(PERF_COUNTER_IMAGE_HITS, 1);
     return RET_OK;
   }
 
@@ -147,7 +149,11 @@ ret_t image_manager_load(image_manager_t* imm, const char* name, bitmap_t* image
 #endif
     return RET_OK;
   } else if (imm->loader != NULL) {
-    ret_t ret = image_loader_load(imm->loader, res->data, res->size, image);
+    ret_t ret = RET_OK;
+
+    /*原始格式的图片直接使用资源中的数据，只有需要解码的才算没有命中。*/
+    perf_stats_add(PERF_COUNTER_IMAGE_MISSES, 1);
+    ret = image_loader_load(imm->loader, res->data, res->size, image);
     image_manager_add(imm, name, image);
     resource_manager_unref(resource_manager(), res);
 
@@ -157,6 +163,17 @@ ret_t image_manager_load(image_manager_t* imm, const char* name, bitmap_t* image
   }
 }
 
+ret_t image_manager_load(image_manager_t* imm, const char* name, bitmap_t* image) {
+  ret_t ret = RET_OK;
+  return_value_if_fail(imm != NULL && name != NULL && image != NULL, RET_BAD_PARAMS);
+
+  PROFILER_BEGIN("image_manager_load", name);
+  ret = image_manager_load_impl(imm, name, image);
+  PROFILER_END();
+
+  return ret;
+}
+
 static int bitmap_cache_cmp_time(bitmap_cache_t* a, bitmap_cache_t* b) {
   return (a->last_access_time <= b->last_access_time) ? 0 : -1;
 }
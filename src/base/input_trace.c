@@ -0,0 +1,333 @@
+/**
+ * File:   input_trace.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  record input events, timer firings and frames for replay
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-22 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/fs.h"
+#include "base/mem.h"
+#include "base/time.h"
+#include "base/timer.h"
+#include "base/bitmap.h"
+#include "base/platform.h"
+#include "base/input_trace.h"
+
+/*每条记录保存成一行文本，最长不超过这个长度。*/
+#define INPUT_TRACE_LINE_MAX 64
+
+static input_trace_t* s_input_trace = NULL;
+
+input_trace_t* input_trace(void) {
+  return s_input_trace;
+}
+
+input_trace_t* input_trace_create(wh_t w, wh_t h) {
+  input_trace_t* trace = TKMEM_ZALLOC(input_trace_t);
+  return_value_if_fail(trace != NULL, NULL);
+
+  trace->w = w;
+  trace->h = h;
+
+  return trace;
+}
+
+static ret_t input_trace_extend(input_trace_t* trace) {
+  uint32_t capacity = 0;
+  input_trace_record_t* records = NULL;
+
+  if (trace->size < trace->capacity) {
+    return RET_OK;
+  }
+
+  capacity = trace->capacity > 0 ? trace->capacity * 2 : 64;
+  records = TKMEM_REALLOC(input_trace_record_t, trace->records, capacity);
+  return_value_if_fail(records != NULL, RET_OOM);
+
+  trace->records = records;
+  trace->capacity = capacity;
+
+  return RET_OK;
+}
+
+static ret_t input_trace_push(input_trace_t* trace, uint32_t time, uint16_t type, int32_t x,
+                              int32_t y, uint32_t value) {
+  input_trace_record_t* r = NULL;
+  return_value_if_fail(input_trace_extend(trace) == RET_OK, RET_OOM);
+
+  r = trace->records + trace->size++;
+  r->time = time;
+  r->type = type;
+  r->x = x;
+  r->y = y;
+  r->value = value;
+
+  return RET_OK;
+}
+
+ret_t input_trace_add(input_trace_t* trace, uint16_t type, int32_t x, int32_t y, uint32_t value) {
+  return_value_if_fail(trace != NULL, RET_BAD_PARAMS);
+
+  return input_trace_push(trace, trace->now - trace->start, type, x, y, value);
+}
+
+ret_t input_trace_on_input(input_trace_t* trace, event_t* e) {
+  return_value_if_fail(trace != NULL && e != NULL, RET_BAD_PARAMS);
+
+  switch (e->type) {
+    case EVT_POINTER_DOWN:
+    case EVT_POINTER_MOVE:
+    case EVT_POINTER_UP: {
+      pointer_event_t* evt = (pointer_event_t*)e;
+      return input_trace_add(trace, e->type, evt->x, evt->y, 0);
+    }
+    case EVT_KEY_DOWN:
+    case EVT_KEY_UP: {
+      key_event_t* evt = (key_event_t*)e;
+      return input_trace_add(trace, e->type, 0, 0, evt->key);
+    }
+    default:
+      break;
+  }
+
+  return RET_OK;
+}
+
+ret_t input_trace_on_frame(input_trace_t* trace, lcd_t* lcd, bool_t painted) {
+  uint32_t checksum = 0;
+  return_value_if_fail(trace != NULL, RET_BAD_PARAMS);
+
+  if (painted && lcd != NULL) {
+    checksum = input_trace_checksum(lcd);
+  }
+
+  return input_trace_add(trace, INPUT_TRACE_FRAME, painted ? 1 : 0, 0, checksum);
+}
+
+uint32_t input_trace_checksum(lcd_t* lcd) {
+  bitmap_t img;
+  uint32_t i = 0;
+  uint32_t size = 0;
+  uint32_t hash = 2166136261u;
+  return_value_if_fail(lcd != NULL && lcd->take_snapshot != NULL, 0);
+
+  memset(&img, 0x00, sizeof(img));
+  return_value_if_fail(lcd_take_snapshot(lcd, &img) == RET_OK && img.data != NULL, 0);
+
+  /*FNV-1a*/
+  size = img.w * img.h * (img.format == BITMAP_FMT_RGB565 ? 2 : 4);
+  for (i = 0; i < size; i++) {
+    hash = (hash ^ img.data[i]) * 16777619u;
+  }
+  bitmap_destroy(&img);
+
+  /*0表示没有校验和。*/
+  return hash != 0 ? hash : 1;
+}
+
+ret_t input_trace_tick(input_trace_t* trace) {
+  return_value_if_fail(trace != NULL, RET_BAD_PARAMS);
+
+  trace->now = get_time_ms();
+
+  return RET_OK;
+}
+
+uint32_t input_trace_now(void) {
+  return s_input_trace != NULL ? s_input_trace->now : get_time_ms();
+}
+
+ret_t input_trace_start(input_trace_t* trace) {
+  return_value_if_fail(trace != NULL && s_input_trace == NULL, RET_BAD_PARAMS);
+
+  input_trace_tick(trace);
+  trace->start = trace->now;
+  s_input_trace = trace;
+  time_set_source(input_trace_now);
+  timer_init(input_trace_now);
+
+  return RET_OK;
+}
+
+ret_t input_trace_stop(input_trace_t* trace) {
+  return_value_if_fail(trace != NULL && s_input_trace == trace, RET_BAD_PARAMS);
+
+  s_input_trace = NULL;
+  time_set_source(NULL);
+  timer_init(get_time_ms);
+
+  return RET_OK;
+}
+
+static const char* input_trace_type_name(uint16_t type) {
+  switch (type) {
+    case EVT_POINTER_DOWN:
+      return "down";
+    case EVT_POINTER_MOVE:
+      return "move";
+    case EVT_POINTER_UP:
+      return "up";
+    case EVT_KEY_DOWN:
+      return "key_down";
+    case EVT_KEY_UP:
+      return "key_up";
+    case INPUT_TRACE_TIMER:
+      return "timer";
+    case INPUT_TRACE_FRAME:
+      return "frame";
+    default:
+      return NULL;
+  }
+}
+
+static int input_trace_format_record(char* line, const input_trace_record_t* r) {
+  const char* name = input_trace_type_name(r->type);
+
+  switch (r->type) {
+    case EVT_POINTER_DOWN:
+    case EVT_POINTER_MOVE:
+    case EVT_POINTER_UP:
+      return snprintf(line, INPUT_TRACE_LINE_MAX, "%u %s %d %d\n", r->time, name, r->x, r->y);
+    case EVT_KEY_DOWN:
+    case EVT_KEY_UP:
+    case INPUT_TRACE_TIMER:
+      return snprintf(line, INPUT_TRACE_LINE_MAX, "%u %s %u\n", r->time, name, r->value);
+    case INPUT_TRACE_FRAME:
+      return snprintf(line, INPUT_TRACE_LINE_MAX, "%u %s %d %08x\n", r->time, name, r->x,
+                      r->value);
+    default:
+      return 0;
+  }
+}
+
+ret_t input_trace_save(input_trace_t* trace, const char* filename) {
+  uint32_t i = 0;
+  uint32_t len = 0;
+  ret_t ret = RET_OK;
+  char* buff = NULL;
+  return_value_if_fail(trace != NULL && filename != NULL, RET_BAD_PARAMS);
+
+  buff = (char*)TKMEM_ALLOC((trace->size + 2) * INPUT_TRACE_LINE_MAX);
+  return_value_if_fail(buff != NULL, RET_OOM);
+
+  len = snprintf(buff, INPUT_TRACE_LINE_MAX, "# awtk input trace\nsize %d %d\n", trace->w,
+                 trace->h);
+  for (i = 0; i < trace->size; i++) {
+    len += input_trace_format_record(buff + len, trace->records + i);
+  }
+
+  ret = fs_write_file(filename, buff, len);
+  TKMEM_FREE(buff);
+
+  return ret;
+}
+
+static ret_t input_trace_parse_line(input_trace_t* trace, const char* line) {
+  int x = 0;
+  int y = 0;
+  int w = 0;
+  int h = 0;
+  uint32_t t = 0;
+  uint32_t v = 0;
+  char name[16];
+
+  memset(name, 0x00, sizeof(name));
+  if (line[0] == '#' || line[0] == '\0') {
+    return RET_OK;
+  } else if (sscanf(line, "size %d %d", &w, &h) == 2) {
+    trace->w = w;
+    trace->h = h;
+    return RET_OK;
+  } else if (sscanf(line, "%u %15s", &t, name) != 2) {
+    return RET_BAD_PARAMS;
+  }
+
+  if (strcmp(name, "down") == 0 && sscanf(line, "%*u %*s %d %d", &x, &y) == 2) {
+    return input_trace_push(trace, t, EVT_POINTER_DOWN, x, y, 0);
+  } else if (strcmp(name, "move") == 0 && sscanf(line, "%*u %*s %d %d", &x, &y) == 2) {
+    return input_trace_push(trace, t, EVT_POINTER_MOVE, x, y, 0);
+  } else if (strcmp(name, "up") == 0 && sscanf(line, "%*u %*s %d %d", &x, &y) == 2) {
+    return input_trace_push(trace, t, EVT_POINTER_UP, x, y, 0);
+  } else if (strcmp(name, "key_down") == 0 && sscanf(line, "%*u %*s %u", &v) == 1) {
+    return input_trace_push(trace, t, EVT_KEY_DOWN, 0, 0, v);
+  } else if (strcmp(name, "key_up") == 0 && sscanf(line, "%*u %*s %u", &v) == 1) {
+    return input_trace_push(trace, t, EVT_KEY_UP, 0, 0, v);
+  } else if (strcmp(name, "timer") == 0 && sscanf(line, "%*u %*s %u", &v) == 1) {
+    return input_trace_push(trace, t, INPUT_TRACE_TIMER, 0, 0, v);
+  } else if (strcmp(name, "frame") == 0 && sscanf(line, "%*u %*s %d %x", &x, &v) == 2) {
+    return input_trace_push(trace, t, INPUT_TRACE_FRAME, x, 0, v);
+  }
+
+  return RET_BAD_PARAMS;
+}
+
+input_trace_t* input_trace_load(const char* filename) {
+  uint32_t size = 0;
+  uint32_t lineno = 1;
+  char* line = NULL;
+  char* buff = NULL;
+  input_trace_t* trace = NULL;
+  return_value_if_fail(filename != NULL, NULL);
+
+  buff = (char*)fs_read_file(filename, &size);
+  return_value_if_fail(buff != NULL, NULL);
+
+  trace = input_trace_create(0, 0);
+  if (trace == NULL) {
+    TKMEM_FREE(buff);
+    return NULL;
+  }
+
+  line = buff;
+  while (line != NULL && *line) {
+    char* end = strchr(line, '\n');
+    if (end != NULL) {
+      *end = '\0';
+      if (end > line && end[-1] == '\r') {
+        end[-1] = '\0';
+      }
+    }
+
+    if (input_trace_parse_line(trace, line) != RET_OK) {
+      log_warn("%s:%u: invalid record: %s\n", filename, lineno, line);
+      input_trace_destroy(trace);
+      trace = NULL;
+      break;
+    }
+
+    line = end != NULL ? end + 1 : NULL;
+    lineno++;
+  }
+  TKMEM_FREE(buff);
+
+  return trace;
+}
+
+ret_t input_trace_destroy(input_trace_t* trace) {
+  return_value_if_fail(trace != NULL, RET_BAD_PARAMS);
+
+  if (s_input_trace == trace) {
+    input_trace_stop(trace);
+  }
+
+  if (trace->records != NULL) {
+    TKMEM_FREE(trace->records);
+  }
+  TKMEM_FREE(trace);
+
+  return RET_OK;
+}
@@ -0,0 +1,259 @@
+/**
+ * File:   input_trace.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  record input events, timer firings and frames for replay
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-22 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_INPUT_TRACE_H
+#define TK_INPUT_TRACE_H
+
+#include "base/lcd.h"
+#include "base/events.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @enum input_trace_type_t
+ * @prefix INPUT_TRACE_
+ * 输入轨迹中除输入事件(EVT_POINTER_DOWN/MOVE/UP和EVT_KEY_DOWN/UP)之外的记录类型。
+ */
+typedef enum _input_trace_type_t {
+  /**
+   * @const INPUT_TRACE_TIMER
+   * timer_check触发了定时器。
+   */
+  INPUT_TRACE_TIMER = 0x1000,
+  /**
+   * @const INPUT_TRACE_FRAME
+   * 帧调度器运行了一帧。
+   */
+  INPUT_TRACE_FRAME
+} input_trace_type_t;
+
+/**
+ * @class input_trace_record_t
+ * 输入轨迹中的一条记录。
+ */
+typedef struct _input_trace_record_t {
+  /**
+   * @property {uint32_t} time
+   * @readonly
+   * 相对于开始录制的时间(毫秒)。
+   */
+  uint32_t time;
+  /**
+   * @property {uint16_t} type
+   * @readonly
+   * 事件类型或者input_trace_type_t。
+   */
+  uint16_t type;
+  /**
+   * @property {int32_t} x
+   * @readonly
+   * 指针事件的x坐标。帧记录中表示是否绘制了(1/0)。
+   */
+  int32_t x;
+  /**
+   * @property {int32_t} y
+   * @readonly
+   * 指针事件的y坐标。
+   */
+  int32_t y;
+  /**
+   * @property {uint32_t} value
+   * @readonly
+   * 按键事件的键值，定时器记录中触发的定时器个数，帧记录中framebuffer的校验和(0表示没有)。
+   */
+  uint32_t value;
+} input_trace_record_t;
+
+/**
+ * @class input_trace_t
+ * @scriptable no
+ * 输入轨迹。
+ *
+ * 录制时记录window_manager_dispatch_input_event看到的指针和按键事件、timer_check触发定时器的
+ * 时刻，以及帧调度器运行的每一帧和framebuffer的校验和。
+ *
+ * 录制期间time_now_ms和定时器使用锁存的时钟：主循环每次循环开始时调用input_trace_tick锁存
+ * 当前时间，同一次循环内看到的时间都相同。这样回放时在同样的时刻检查定时器、分发事件和绘制，
+ * 就能得到同样的帧序列(参考main_loop_headless_replay)。
+ *
+ * 其它线程投递的任务(task_queue)不在记录的范围之内。
+ */
+typedef struct _input_trace_t {
+  /**
+   * @property {wh_t} w
+   * @readonly
+   * 录制时屏幕的宽度。
+   */
+  wh_t w;
+  /**
+   * @property {wh_t} h
+   * @readonly
+   * 录制时屏幕的高度。
+   */
+  wh_t h;
+  /**
+   * @property {uint32_t} size
+   * @readonly
+   * 记录的个数。
+   */
+  uint32_t size;
+  /**
+   * @property {input_trace_record_t*} records
+   * @readonly
+   * 记录。
+   */
+  input_trace_record_t* records;
+
+  /*private*/
+  uint32_t capacity;
+  uint32_t start;
+  uint32_t now;
+} input_trace_t;
+
+/**
+ * @method input_trace
+ * 获取正在录制的输入轨迹。
+ * @return {input_trace_t*} 返回输入轨迹对象，没有录制时返回NULL。
+ */
+input_trace_t* input_trace(void);
+
+/**
+ * @method input_trace_create
+ * @constructor
+ * 创建输入轨迹对象。
+ * @param {wh_t} w 屏幕的宽度。
+ * @param {wh_t} h 屏幕的高度。
+ *
+ * @return {input_trace_t*} 返回输入轨迹对象。
+ */
+input_trace_t* input_trace_create(wh_t w, wh_t h);
+
+/**
+ * @method input_trace_load
+ * @constructor
+ * 从文件中加载输入轨迹。
+ * @param {const char*} filename 文件名。
+ *
+ * @return {input_trace_t*} 返回输入轨迹对象。
+ */
+input_trace_t* input_trace_load(const char* filename);
+
+/**
+ * @method input_trace_save
+ * 把输入轨迹保存到文件中(文本格式，每行一条记录)。
+ * @param {input_trace_t*} trace 输入轨迹对象。
+ * @param {const char*} filename 文件名。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t input_trace_save(input_trace_t* trace, const char* filename);
+
+/**
+ * @method input_trace_start
+ * 开始录制，设置为当前的输入轨迹，并让time_now_ms和定时器使用锁存的时钟。
+ * @param {input_trace_t*} trace 输入轨迹对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t input_trace_start(input_trace_t* trace);
+
+/**
+ * @method input_trace_stop
+ * 停止录制，恢复平台的时钟。
+ * @param {input_trace_t*} trace 输入轨迹对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t input_trace_stop(input_trace_t* trace);
+
+/**
+ * @method input_trace_tick
+ * 锁存当前时间。主循环每次循环开始时调用，录制期间没有调用时time_now_ms不会前进。
+ * @param {input_trace_t*} trace 输入轨迹对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t input_trace_tick(input_trace_t* trace);
+
+/**
+ * @method input_trace_now
+ * 获取锁存的时间。
+ *
+ * @return {uint32_t} 返回时间(毫秒)。
+ */
+uint32_t input_trace_now(void);
+
+/**
+ * @method input_trace_add
+ * 在当前时间增加一条记录。
+ * @param {input_trace_t*} trace 输入轨迹对象。
+ * @param {uint16_t} type 事件类型或者input_trace_type_t。
+ * @param {int32_t} x x。
+ * @param {int32_t} y y。
+ * @param {uint32_t} value value。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t input_trace_add(input_trace_t* trace, uint16_t type, int32_t x, int32_t y, uint32_t value);
+
+/**
+ * @method input_trace_on_input
+ * 记录输入事件(由window_manager_dispatch_input_event调用)。其它类型的事件被忽略。
+ * @param {input_trace_t*} trace 输入轨迹对象。
+ * @param {event_t*} e 事件对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t input_trace_on_input(input_trace_t* trace, event_t* e);
+
+/**
+ * @method input_trace_on_frame
+ * 记录一帧(由帧调度器调用)。
+ * @param {input_trace_t*} trace 输入轨迹对象。
+ * @param {lcd_t*} lcd 绘制的lcd，为NULL或者本帧没有绘制时不计算校验和。
+ * @param {bool_t} painted 本帧是否绘制了。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t input_trace_on_frame(input_trace_t* trace, lcd_t* lcd, bool_t painted);
+
+/**
+ * @method input_trace_checksum
+ * 计算lcd上framebuffer的校验和。
+ * @param {lcd_t*} lcd lcd对象(需要支持take_snapshot)。
+ *
+ * @return {uint32_t} 返回校验和，0表示不支持。
+ */
+uint32_t input_trace_checksum(lcd_t* lcd);
+
+/**
+ * @method input_trace_destroy
+ * @deconstructor
+ * 销毁输入轨迹对象(正在录制时先停止)。
+ * @param {input_trace_t*} trace 输入轨迹对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t input_trace_destroy(input_trace_t* trace);
+
+END_C_DECLS
+
+#endif /*TK_INPUT_TRACE_H*/
@@ -197,6 +197,249 @@ ret_t widget_set_children_layout_params(widget_t* widget, uint8_t rows, uint8_t
   return RET_OK;
 }
 
+typedef struct _layout_change_t {
+  widget_t* widget;
+  uint16_t type;
+  rect_t old;
+} layout_change_t;
+
+/*正在分发事件的记录。事件处理函数可能销毁后面的控件，也可能结束嵌套的事务，所以串成链表。*/
+typedef struct _layout_dispatch_t {
+  uint32_t changes_nr;
+  layout_change_t* changes;
+  struct _layout_dispatch_t* prev;
+} layout_dispatch_t;
+
+typedef struct _layout_transaction_t {
+  uint32_t depth;
+  widget_t* root;
+  rect_t damage;
+
+  uint32_t changes_nr;
+  uint32_t changes_capacity;
+  layout_change_t* changes;
+  layout_dispatch_t* dispatching;
+} layout_transaction_t;
+
+static layout_transaction_t s_layout_transaction;
+
+ret_t widget_layout_begin(widget_t* widget) {
+  layout_transaction_t* t = &s_layout_transaction;
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  if (t->depth == 0) {
+    t->root = widget;
+    t->changes_nr = 0;
+    rect_init(t->damage, 0, 0, 0, 0);
+  }
+  t->depth++;
+
+  return RET_OK;
+}
+
+/*计算widget的父控件原点在事务根控件坐标系中的位置，widget不是根控件的子孙时返回FALSE。*/
+static bool_t widget_layout_offset_in_root(widget_t* widget, point_t* offset) {
+  widget_t* iter = widget->parent;
+  widget_t* root = s_layout_transaction.root;
+
+  offset->x = 0;
+  offset->y = 0;
+  while (iter != NULL && iter != root) {
+    offset->x += iter->x;
+    offset->y += iter->y;
+    iter = iter->parent;
+  }
+
+  return iter != NULL && widget != root;
+}
+
+static ret_t widget_layout_add_damage(xy_t x, xy_t y, wh_t w, wh_t h) {
+  rect_t r;
+  rect_init(r, x, y, w, h);
+
+  return rect_merge(&(s_layout_transaction.damage), &r);
+}
+
+static ret_t widget_layout_record_change(widget_t* widget, uint16_t type) {
+  uint32_t i = 0;
+  layout_change_t* iter = NULL;
+  layout_transaction_t* t = &s_layout_transaction;
+
+  if (widget->layout_pending) {
+    for (i = t->changes_nr; i > 0; i--) {
+      iter = t->changes + i - 1;
+      if (iter->widget == widget) {
+        if (iter->type != type) {
+          iter->type = EVT_MOVE_RESIZE;
+        }
+        return RET_OK;
+      }
+    }
+  }
+
+  if (t->changes_nr >= t->changes_capacity) {
+    uint32_t capacity = t->changes_capacity + (t->changes_capacity >> 1) + 8;
+    layout_change_t* changes = TKMEM_REALLOC(layout_change_t, t->changes, capacity);
+    return_value_if_fail(changes != NULL, RET_OOM);
+
+    t->changes = changes;
+    t->changes_capacity = capacity;
+  }
+
+  iter = t->changes + t->changes_nr++;
+  iter->widget = widget;
+  iter->type = type;
+  rect_init(iter->old, widget->x, widget->y, widget->w, widget->h);
+  widget->layout_pending = TRUE;
+
+  return RET_OK;
+}
+
+ret_t widget_layout_defer_move_resize(widget_t* widget, xy_t x, xy_t y, wh_t w, wh_t h,
+                                      uint16_t type) {
+  point_t o;
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  if (s_layout_transaction.depth == 0 || !widget_layout_offset_in_root(widget, &o)) {
+    return RET_NOT_FOUND;
+  }
+
+  if (widget->x == x && widget->y == y && widget->w == w && widget->h == h) {
+    return RET_OK;
+  }
+
+  return_value_if_fail(widget_layout_record_change(widget, type) == RET_OK, RET_OOM);
+
+  widget_layout_add_damage(o.x + widget->x, o.y + widget->y, widget->w, widget->h);
+  widget->x = x;
+  widget->y = y;
+  widget->w = w;
+  widget->h = h;
+  widget_layout_add_damage(o.x + x, o.y + y, w, h);
+
+  return RET_OK;
+}
+
+ret_t widget_layout_defer_invalidate(widget_t* widget, rect_t* r) {
+  point_t o;
+  return_value_if_fail(widget != NULL && r != NULL, RET_BAD_PARAMS);
+
+  if (s_layout_transaction.depth == 0) {
+    return RET_NOT_FOUND;
+  }
+
+  if (widget == s_layout_transaction.root) {
+    return widget_layout_add_damage(r->x, r->y, r->w, r->h);
+  }
+
+  if (!widget_layout_offset_in_root(widget, &o)) {
+    return RET_NOT_FOUND;
+  }
+
+  return widget_layout_add_damage(o.x + widget->x + r->x, o.y + widget->y + r->y, r->w, r->h);
+}
+
+ret_t widget_layout_end(widget_t* widget) {
+  rect_t r;
+  uint32_t i = 0;
+  uint32_t nr = 0;
+  widget_t* root = NULL;
+  layout_dispatch_t dispatching;
+  layout_change_t* changes = NULL;
+  layout_transaction_t* t = &s_layout_transaction;
+  return_value_if_fail(widget != NULL && t->depth > 0, RET_BAD_PARAMS);
+
+  t->depth--;
+  if (t->depth > 0) {
+    return RET_OK;
+  }
+
+  root = t->root;
+  nr = t->changes_nr;
+  changes = t->changes;
+
+  /*事件处理函数可能开始新的事务，先把记录的数据转移出来。*/
+  t->root = NULL;
+  t->changes = NULL;
+  t->changes_nr = 0;
+  t->changes_capacity = 0;
+
+  /*根控件在事务中被销毁了。*/
+  if (root != NULL) {
+    rect_init(r, 0, 0, root->w, root->h);
+    rect_intersect(&r, &(t->damage));
+    if (r.w > 0 && r.h > 0) {
+      widget_invalidate(root, &r);
+    }
+  }
+
+  for (i = 0; i < nr; i++) {
+    changes[i].widget->layout_pending = FALSE;
+  }
+
+  dispatching.changes = changes;
+  dispatching.changes_nr = nr;
+  dispatching.prev = t->dispatching;
+  t->dispatching = &dispatching;
+
+  /*多次修改后又回到原来的位置和大小，不需要通知。分发期间被销毁的控件已经从记录中清除。*/
+  for (i = 0; i < nr; i++) {
+    widget_t* iter = changes[i].widget;
+    rect_t* old = &(changes[i].old);
+
+    if (iter == NULL) {
+      continue;
+    }
+
+    if (iter->x != old->x || iter->y != old->y || iter->w != old->w || iter->h != old->h) {
+      event_t e = {changes[i].type, iter};
+      widget_dispatch(iter, &e);
+    }
+  }
+  t->dispatching = dispatching.prev;
+
+  if (t->changes == NULL) {
+    t->changes = changes;
+    t->changes_capacity = ftk_max(nr, t->changes_capacity);
+  } else {
+    TKMEM_FREE(changes);
+  }
+
+  return RET_OK;
+}
+
+ret_t widget_layout_forget(widget_t* widget) {
+  uint32_t i = 0;
+  layout_dispatch_t* iter = NULL;
+  layout_transaction_t* t = &s_layout_transaction;
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  if (widget == t->root) {
+    t->root = NULL;
+  }
+
+  if (widget->layout_pending) {
+    for (i = 0; i < t->changes_nr; i++) {
+      if (t->changes[i].widget == widget) {
+        t->changes_nr--;
+        memmove(t->changes + i, t->changes + i + 1, (t->changes_nr - i) * sizeof(layout_change_t));
+        break;
+      }
+    }
+    widget->layout_pending = FALSE;
+  }
+
+  for (iter = t->dispatching; iter != NULL; iter = iter->prev) {
+    for (i = 0; i < iter->changes_nr; i++) {
+      if (iter->changes[i].widget == widget) {
+        iter->changes[i].widget = NULL;
+      }
+    }
+  }
+
+  return RET_OK;
+}
+
 ret_t widget_layout(widget_t* widget) {
   return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
   widget_layout_self(widget);
@@ -217,7 +460,7 @@ ret_t widget_layout_self(widget_t* widget) {
   return RET_OK;
 }
 
-ret_t widget_layout_children(widget_t* widget) {
+static ret_t widget_layout_children_impl(widget_t* widget) {
   wh_t w = 0;
   wh_t h = 0;
   xy_t x = 0;
@@ -389,6 +632,17 @@ ret_t widget_layout_children(widget_t* widget) {
   return RET_OK;
 }
 
+ret_t widget_layout_children(widget_t* widget) {
+  ret_t ret = RET_OK;
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  widget_layout_begin(widget);
+  ret = widget_layout_children_impl(widget);
+  widget_layout_end(widget);
+
+  return ret;
+}
+
 children_layout_t* children_layout_parser(children_layout_t* layout, const char* params) {
   const char* p = params;
   return_value_if_fail(layout != NULL && params != NULL, NULL);
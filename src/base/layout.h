@@ -43,6 +43,35 @@ ret_t widget_layout(widget_t* widget);
 ret_t widget_layout_self(widget_t* widget);
 ret_t widget_layout_children(widget_t* widget);
 
+/**
+ * @method widget_layout_begin
+ * 开始一个布局事务。
+ * 事务期间widget子控件的位置/大小变化和widget_invalidate只做记录：
+ * 位置和大小没有变化的控件直接忽略，EVT_MOVE/EVT_RESIZE/EVT_MOVE_RESIZE推迟到事务结束时分发，
+ * 脏矩形合并成一个，结束时只对widget做一次widget_invalidate。
+ * 事务可以嵌套，以最外层的widget为准。
+ * @param {widget_t*} widget 控件对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_layout_begin(widget_t* widget);
+
+/**
+ * @method widget_layout_end
+ * 结束布局事务。最外层的事务结束时提交脏矩形并分发推迟的事件。
+ * @param {widget_t*} widget 控件对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_layout_end(widget_t* widget);
+
+/*供widget.c调用，不在事务中(或者不是事务的子控件)时返回RET_NOT_FOUND。*/
+ret_t widget_layout_defer_move_resize(widget_t* widget, xy_t x, xy_t y, wh_t w, wh_t h,
+                                      uint16_t type);
+ret_t widget_layout_defer_invalidate(widget_t* widget, rect_t* r);
+/*供widget_destroy调用，把控件从还没有提交的事务和正在分发的事件中去掉。*/
+ret_t widget_layout_forget(widget_t* widget);
+
 END_C_DECLS
 
 #endif /*TK_LAYOUT_H*/
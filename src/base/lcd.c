@@ -20,12 +20,18 @@
  */
 
 #include "base/lcd.h"
+#include "base/profiler.h"
 
 ret_t lcd_begin_frame(lcd_t* lcd, rect_t* dirty_rect, lcd_draw_mode_t draw_mode) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->begin_frame != NULL, RET_BAD_PARAMS);
 
   lcd->draw_mode = draw_mode;
-  return lcd->begin_frame(lcd, dirty_rect);
+  PROFILER_BEGIN("lcd_begin_frame", NULL);
+  ret = lcd->begin_frame(lcd, dirty_rect);
+  PROFILER_END();
+
+  return ret;
 }
 
 ret_t lcd_set_clip_rect(lcd_t* lcd, rect_t* rect) {
@@ -101,33 +107,58 @@ ret_t lcd_set_font_size(lcd_t* lcd, uint32_t size) {
 }
 
 ret_t lcd_draw_vline(lcd_t* lcd, xy_t x, xy_t y, wh_t h) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->draw_vline != NULL, RET_BAD_PARAMS);
 
-  return lcd->draw_vline(lcd, x, y, h);
+  PROFILER_BEGIN("lcd_draw_vline", NULL);
+  ret = lcd->draw_vline(lcd, x, y, h);
+  PROFILER_END();
+
+  return ret;
 }
 
 ret_t lcd_draw_hline(lcd_t* lcd, xy_t x, xy_t y, wh_t w) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->draw_hline != NULL, RET_BAD_PARAMS);
 
-  return lcd->draw_hline(lcd, x, y, w);
+  PROFILER_BEGIN("lcd_draw_hline", NULL);
+  ret = lcd->draw_hline(lcd, x, y, w);
+  PROFILER_END();
+
+  return ret;
 }
 
 ret_t lcd_fill_rect(lcd_t* lcd, xy_t x, xy_t y, wh_t w, wh_t h) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->fill_rect != NULL, RET_BAD_PARAMS);
 
-  return lcd->fill_rect(lcd, x, y, w, h);
+  PROFILER_BEGIN("lcd_fill_rect", NULL);
+  ret = lcd->fill_rect(lcd, x, y, w, h);
+  PROFILER_END();
+
+  return ret;
 }
 
 ret_t lcd_stroke_rect(lcd_t* lcd, xy_t x, xy_t y, wh_t w, wh_t h) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->stroke_rect != NULL, RET_BAD_PARAMS);
 
-  return lcd->stroke_rect(lcd, x, y, w, h);
+  PROFILER_BEGIN("lcd_stroke_rect", NULL);
+  ret = lcd->stroke_rect(lcd, x, y, w, h);
+  PROFILER_END();
+
+  return ret;
 }
 
 ret_t lcd_draw_points(lcd_t* lcd, point_t* points, uint32_t nr) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->draw_points != NULL && points != NULL, RET_BAD_PARAMS);
 
-  return lcd->draw_points(lcd, points, nr);
+  PROFILER_BEGIN("lcd_draw_points", NULL);
+  ret = lcd->draw_points(lcd, points, nr);
+  PROFILER_END();
+
+  return ret;
 }
 
 color_t lcd_get_point_color(lcd_t* lcd, xy_t x, xy_t y) {
@@ -142,35 +173,79 @@ color_t lcd_get_point_color(lcd_t* lcd, xy_t x, xy_t y) {
 }
 
 ret_t lcd_draw_image(lcd_t* lcd, bitmap_t* img, rect_t* src, rect_t* dst) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->draw_image != NULL && src != NULL && dst != NULL,
                        RET_BAD_PARAMS);
 
-  return lcd->draw_image(lcd, img, src, dst);
+  PROFILER_BEGIN("lcd_draw_image", NULL);
+  ret = lcd->draw_image(lcd, img, src, dst);
+  PROFILER_END();
+
+  return ret;
 }
 
 ret_t lcd_draw_glyph(lcd_t* lcd, glyph_t* glyph, rect_t* src, xy_t x, xy_t y) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->draw_glyph != NULL && glyph != NULL && src != NULL,
                        RET_BAD_PARAMS);
 
-  return lcd->draw_glyph(lcd, glyph, src, x, y);
+  PROFILER_BEGIN("lcd_draw_glyph", NULL);
+  ret = lcd->draw_glyph(lcd, glyph, src, x, y);
+  PROFILER_END();
+
+  return ret;
+}
+
+ret_t lcd_draw_glyphs(lcd_t* lcd, lcd_glyph_t* glyphs, uint32_t nr, rect_t* bounds) {
+  uint32_t i = 0;
+  ret_t ret = RET_OK;
+  return_value_if_fail(lcd != NULL && glyphs != NULL && bounds != NULL, RET_BAD_PARAMS);
+
+  PROFILER_BEGIN("lcd_draw_glyphs", NULL);
+  if (lcd->draw_glyphs != NULL) {
+    ret = lcd->draw_glyphs(lcd, glyphs, nr, bounds);
+  } else {
+    for (i = 0; i < nr && ret == RET_OK; i++) {
+      lcd_glyph_t* iter = glyphs + i;
+      ret = lcd_draw_glyph(lcd, &(iter->glyph), &(iter->src), iter->x, iter->y);
+    }
+  }
+  PROFILER_END();
+
+  return ret;
 }
 
 wh_t lcd_measure_text(lcd_t* lcd, wchar_t* str, int32_t nr) {
+  wh_t ret = 0;
   return_value_if_fail(lcd != NULL && lcd->measure_text != NULL && str != NULL, 0);
 
-  return lcd->measure_text(lcd, str, nr);
+  PROFILER_BEGIN("lcd_measure_text", NULL);
+  ret = lcd->measure_text(lcd, str, nr);
+  PROFILER_END();
+
+  return ret;
 }
 
 ret_t lcd_draw_text(lcd_t* lcd, wchar_t* str, int32_t nr, xy_t x, xy_t y) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->draw_text != NULL && str != NULL, RET_OK);
 
-  return lcd->draw_text(lcd, str, nr, x, y);
+  PROFILER_BEGIN("lcd_draw_text", NULL);
+  ret = lcd->draw_text(lcd, str, nr, x, y);
+  PROFILER_END();
+
+  return ret;
 }
 
 ret_t lcd_end_frame(lcd_t* lcd) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->end_frame != NULL, RET_BAD_PARAMS);
 
-  return lcd->end_frame(lcd);
+  PROFILER_BEGIN("lcd_end_frame", NULL);
+  ret = lcd->end_frame(lcd);
+  PROFILER_END();
+
+  return ret;
 }
 
 ret_t lcd_destroy(lcd_t* lcd) {
@@ -186,7 +261,36 @@ vgcanvas_t* lcd_get_vgcanvas(lcd_t* lcd) {
 }
 
 ret_t lcd_take_snapshot(lcd_t* lcd, bitmap_t* img) {
+  ret_t ret = RET_OK;
   return_value_if_fail(lcd != NULL && lcd->take_snapshot != NULL, RET_BAD_PARAMS);
 
-  return lcd->take_snapshot(lcd, img);
+  PROFILER_BEGIN("lcd_take_snapshot", NULL);
+  ret = lcd->take_snapshot(lcd, img);
+  PROFILER_END();
+
+  return ret;
+}
+
+lcd_t* lcd_create_layer(lcd_t* lcd, bitmap_t* img) {
+  return_value_if_fail(lcd != NULL && lcd->create_layer != NULL && img != NULL, NULL);
+  return_value_if_fail(img->w > 0 && img->h > 0, NULL);
+
+  return lcd->create_layer(lcd, img);
+}
+
+lcd_t* lcd_create_view(lcd_t* lcd) {
+  return_value_if_fail(lcd != NULL && lcd->create_view != NULL, NULL);
+
+  return lcd->create_view(lcd);
+}
+
+ret_t lcd_scroll(lcd_t* lcd, rect_t* r, xy_t dx, xy_t dy) {
+  ret_t ret = RET_OK;
+  return_value_if_fail(lcd != NULL && lcd->scroll != NULL && r != NULL, RET_BAD_PARAMS);
+
+  PROFILER_BEGIN("lcd_scroll", NULL);
+  ret = lcd->scroll(lcd, r, dx, dy);
+  PROFILER_END();
+
+  return ret;
 }
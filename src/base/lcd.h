@@ -32,6 +32,37 @@ BEGIN_C_DECLS
 struct _lcd_t;
 typedef struct _lcd_t lcd_t;
 
+/**
+ * @class lcd_glyph_t
+ * 已经裁剪并确定了位置的字模，多个字模组成一行文本，用lcd_draw_glyphs一次绘制。
+ */
+typedef struct _lcd_glyph_t {
+  /**
+   * @property {glyph_t} glyph
+   * @readonly
+   * 字模。
+   */
+  glyph_t glyph;
+  /**
+   * @property {rect_t} src
+   * @readonly
+   * 只绘制字模中的这个区域。
+   */
+  rect_t src;
+  /**
+   * @property {xy_t} x
+   * @readonly
+   * 绘制的x坐标。
+   */
+  xy_t x;
+  /**
+   * @property {xy_t} y
+   * @readonly
+   * 绘制的y坐标。
+   */
+  xy_t y;
+} lcd_glyph_t;
+
 typedef ret_t (*lcd_begin_frame_t)(lcd_t* lcd, rect_t* dirty_rect);
 typedef ret_t (*lcd_set_clip_rect_t)(lcd_t* lcd, rect_t* rect);
 
@@ -51,12 +82,16 @@ typedef ret_t (*lcd_fill_rect_t)(lcd_t* lcd, xy_t x, xy_t y, wh_t w, wh_t h);
 typedef ret_t (*lcd_stroke_rect_t)(lcd_t* lcd, xy_t x, xy_t y, wh_t w, wh_t h);
 
 typedef ret_t (*lcd_draw_glyph_t)(lcd_t* lcd, glyph_t* glyph, rect_t* src, xy_t x, xy_t y);
+typedef ret_t (*lcd_draw_glyphs_t)(lcd_t* lcd, lcd_glyph_t* glyphs, uint32_t nr, rect_t* bounds);
 typedef wh_t (*lcd_measure_text_t)(lcd_t* lcd, wchar_t* str, int32_t nr);
 typedef ret_t (*lcd_draw_text_t)(lcd_t* lcd, wchar_t* str, int32_t nr, xy_t x, xy_t y);
 
 typedef ret_t (*lcd_draw_image_t)(lcd_t* lcd, bitmap_t* img, rect_t* src, rect_t* dst);
 typedef vgcanvas_t* (*lcd_get_vgcanvas_t)(lcd_t* lcd);
 typedef ret_t (*lcd_take_snapshot_t)(lcd_t* lcd, bitmap_t* img);
+typedef ret_t (*lcd_scroll_t)(lcd_t* lcd, rect_t* r, xy_t dx, xy_t dy);
+typedef lcd_t* (*lcd_create_layer_t)(lcd_t* lcd, bitmap_t* img);
+typedef lcd_t* (*lcd_create_view_t)(lcd_t* lcd);
 
 typedef ret_t (*lcd_end_frame_t)(lcd_t* lcd);
 typedef ret_t (*lcd_destroy_t)(lcd_t* lcd);
@@ -127,6 +162,7 @@ struct _lcd_t {
   lcd_stroke_rect_t stroke_rect;
   lcd_draw_image_t draw_image;
   lcd_draw_glyph_t draw_glyph;
+  lcd_draw_glyphs_t draw_glyphs;
   lcd_draw_text_t draw_text;
   lcd_measure_text_t measure_text;
   lcd_draw_points_t draw_points;
@@ -134,6 +170,9 @@ struct _lcd_t {
   lcd_end_frame_t end_frame;
   lcd_get_vgcanvas_t get_vgcanvas;
   lcd_take_snapshot_t take_snapshot;
+  lcd_scroll_t scroll;
+  lcd_create_layer_t create_layer;
+  lcd_create_view_t create_view;
 
   lcd_destroy_t destroy;
 
@@ -376,6 +415,20 @@ ret_t lcd_stroke_rect(lcd_t* lcd, xy_t x, xy_t y, wh_t w, wh_t h);
  */
 ret_t lcd_draw_glyph(lcd_t* lcd, glyph_t* glyph, rect_t* src, xy_t x, xy_t y);
 
+/**
+ * @method lcd_draw_glyphs
+ * 用text_color一次绘制一行文本中的多个字模。
+ * lcd没有实现draw_glyphs时，逐个调用draw_glyph。
+ * 寄存器类型的lcd只设置一次窗口，把bounds中的像素一起写入，没有字模的地方用fill_color填充。
+ * @param {lcd_t*} lcd lcd对象。
+ * @param {lcd_glyph_t*} glyphs 字模(从左到右排列，已经按裁剪区裁剪)。
+ * @param {uint32_t} nr 字模的个数。
+ * @param {rect_t*} bounds 全部字模所在的区域。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t lcd_draw_glyphs(lcd_t* lcd, lcd_glyph_t* glyphs, uint32_t nr, rect_t* bounds);
+
 /**
  * @method lcd_measure_text
  * 测量字符串占用的宽度。
@@ -431,6 +484,42 @@ vgcanvas_t* lcd_get_vgcanvas(lcd_t* lcd);
  */
 ret_t lcd_take_snapshot(lcd_t* lcd, bitmap_t* img);
 
+/**
+ * @method lcd_create_layer
+ * 创建一个离屏的lcd，绘制的结果保存在img中，像素格式与lcd相同(img设置BITMAP_FLAG_LCD_NATIVE标志)，
+ * 之后可以用lcd_draw_image直接拷贝到lcd上。只有framebuffer模式，才支持。
+ * img->w/img->h由调用者指定。img->data为NULL时分配图片数据(用bitmap_destroy释放)，否则重用原来的数据。
+ * @param {lcd_t*} lcd lcd对象。
+ * @param {bitmap_t*} img 图片。
+ *
+ * @return {lcd_t*} 返回离屏lcd对象，绘制完成后用lcd_destroy销毁(不会释放图片数据)。
+ */
+lcd_t* lcd_create_layer(lcd_t* lcd, bitmap_t* img);
+
+/**
+ * @method lcd_create_view
+ * 创建一个与lcd共享像素数据的lcd，它有自己的颜色和alpha等状态，
+ * 多个线程可以各用一个，同时在不重叠的区域中绘制。只有framebuffer模式，才支持。
+ * 像素数据只在本帧(begin_frame/end_frame之间)有效，所以每帧重新创建。
+ * @param {lcd_t*} lcd lcd对象。
+ *
+ * @return {lcd_t*} 返回lcd对象，用完后用lcd_destroy销毁(不会释放像素数据)。
+ */
+lcd_t* lcd_create_view(lcd_t* lcd);
+
+/**
+ * @method lcd_scroll
+ * 把指定区域内已经绘制好的像素移动(dx, dy)，移出区域的部分丢弃，移入的部分需要重新绘制。
+ * 只有上一帧的内容仍然保留在framebuffer中的LCD才支持(scroll不为NULL)，主要用于滚动视图。
+ * @param {lcd_t*} lcd lcd对象。
+ * @param {rect_t*} r 区域。
+ * @param {xy_t} dx x方向移动的距离。
+ * @param {xy_t} dy y方向移动的距离。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t lcd_scroll(lcd_t* lcd, rect_t* r, xy_t dx, xy_t dy);
+
 /**
  * @method lcd_end_frame
  * 完成绘制，同步到显示设备。
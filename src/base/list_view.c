@@ -0,0 +1,567 @@
+/**
+ * File:   list_view.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  virtualized list view
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-10 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/time.h"
+#include "base/layout.h"
+#include "base/list_view.h"
+#include "base/widget_vtable.h"
+#include "base/frame_scheduler.h"
+
+#define LIST_VIEW_DEFAULT_ROW_HEIGHT 30
+#define LIST_VIEW_DEFAULT_OVERSCAN 2
+#define LIST_VIEW_DRAG_THRESHOLD 5
+#define LIST_VIEW_FLING_FRICTION 0.002f
+#define LIST_VIEW_FLING_MIN_VELOCITY 0.05f
+
+/*树状数组：heights[i]保存(i - lowbit(i), i]这些行的高度之和，heights[0]不用。*/
+#define LOWBIT(i) ((i) & (~(i) + 1))
+
+static int32_t list_view_prefix_height(list_view_t* list_view, uint32_t nr) {
+  int32_t sum = 0;
+
+  while (nr > 0) {
+    sum += list_view->heights[nr];
+    nr -= LOWBIT(nr);
+  }
+
+  return sum;
+}
+
+static wh_t list_view_get_height_of(list_view_t* list_view, uint32_t index) {
+  if (list_view->heights == NULL) {
+    return list_view->row_height;
+  }
+
+  return list_view_prefix_height(list_view, index + 1) -
+         list_view_prefix_height(list_view, index);
+}
+
+static ret_t list_view_build_heights(list_view_t* list_view) {
+  uint32_t i = 0;
+  uint32_t j = 0;
+  uint32_t nr = list_view->rows_nr;
+  list_view_data_source_t* ds = &(list_view->ds);
+
+  if (list_view->heights != NULL) {
+    TKMEM_FREE(list_view->heights);
+    list_view->heights = NULL;
+  }
+  list_view->heights_mask = 0;
+  list_view->total_height = (int32_t)(list_view->row_height * nr);
+
+  if (ds->get_row_height == NULL || nr == 0) {
+    return RET_OK;
+  }
+
+  list_view->heights = TKMEM_ZALLOCN(uint32_t, nr + 1);
+  return_value_if_fail(list_view->heights != NULL, RET_OOM);
+
+  /*O(n)建树。*/
+  for (i = 1; i <= nr; i++) {
+    list_view->heights[i] += ds->get_row_height(ds->ctx, i - 1);
+    j = i + LOWBIT(i);
+    if (j <= nr) {
+      list_view->heights[j] += list_view->heights[i];
+    }
+  }
+
+  for (i = 1; i <= nr; i <<= 1) {
+    list_view->heights_mask = i;
+  }
+  list_view->total_height = list_view_prefix_height(list_view, nr);
+
+  return RET_OK;
+}
+
+int32_t list_view_get_row_offset(widget_t* widget, uint32_t index) {
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL, 0);
+
+  index = ftk_min(index, list_view->rows_nr);
+  if (list_view->heights == NULL) {
+    return (int32_t)(index * list_view->row_height);
+  }
+
+  return list_view_prefix_height(list_view, index);
+}
+
+uint32_t list_view_get_row_at(widget_t* widget, int32_t offset) {
+  uint32_t pos = 0;
+  uint32_t step = 0;
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL && list_view->rows_nr > 0, 0);
+
+  if (offset <= 0) {
+    return 0;
+  }
+
+  if (list_view->heights == NULL) {
+    pos = list_view->row_height > 0 ? offset / list_view->row_height : 0;
+  } else {
+    /*找最大的pos，使得前pos行的高度之和不超过offset。*/
+    for (step = list_view->heights_mask; step > 0; step >>= 1) {
+      uint32_t next = pos + step;
+      if (next <= list_view->rows_nr && (int32_t)(list_view->heights[next]) <= offset) {
+        pos = next;
+        offset -= list_view->heights[next];
+      }
+    }
+  }
+
+  return ftk_min(pos, list_view->rows_nr - 1);
+}
+
+static int32_t list_view_max_offset(list_view_t* list_view) {
+  int32_t max_offset = list_view->total_height - list_view->widget.h;
+
+  return max_offset > 0 ? max_offset : 0;
+}
+
+static ret_t list_view_ensure_slots(list_view_t* list_view, uint32_t nr) {
+  uint32_t i = 0;
+  int32_t* slots = NULL;
+  widget_t* widget = WIDGETP(list_view);
+  list_view_data_source_t* ds = &(list_view->ds);
+
+  if (nr <= list_view->slots_nr) {
+    return RET_OK;
+  }
+
+  slots = TKMEM_REALLOC(int32_t, list_view->slots, nr);
+  return_value_if_fail(slots != NULL, RET_OOM);
+  list_view->slots = slots;
+
+  /*行号到槽位的映射是index % slots_nr，槽位数变化后要全部重新绑定。*/
+  for (i = 0; i < list_view->slots_nr; i++) {
+    list_view->slots[i] = -1;
+  }
+
+  /*创建行失败时，已经创建的行仍然可用。*/
+  for (i = list_view->slots_nr; i < nr; i++) {
+    widget_t* row = ds->create_row(ds->ctx, widget);
+    return_value_if_fail(row != NULL, RET_FAIL);
+
+    if (row->parent != widget) {
+      widget_add_child(widget, row);
+    }
+    list_view->slots[i] = -1;
+    list_view->slots_nr++;
+  }
+
+  return RET_OK;
+}
+
+static ret_t list_view_layout_cells(list_view_t* list_view, widget_t* row) {
+  uint32_t i = 0;
+  xy_t x = 0;
+  uint32_t nr = 0;
+
+  if (list_view->cols_nr == 0 || row->children == NULL) {
+    return RET_OK;
+  }
+
+  nr = ftk_min(list_view->cols_nr, row->children->size);
+  for (i = 0; i < nr; i++) {
+    widget_t* cell = (widget_t*)(row->children->elms[i]);
+    wh_t w = list_view->cols[i];
+
+    if (w == 0 && i + 1 == list_view->cols_nr) {
+      w = row->w > x ? row->w - x : 0;
+    }
+
+    widget_move_resize(cell, x, 0, w, row->h);
+    x += w;
+  }
+
+  return RET_OK;
+}
+
+static ret_t list_view_relayout(list_view_t* list_view, bool_t rebind) {
+  uint32_t i = 0;
+  uint32_t nr = 0;
+  uint32_t first = 0;
+  uint32_t last = 0;
+  int32_t y = 0;
+  widget_t* widget = WIDGETP(list_view);
+  list_view_data_source_t* ds = &(list_view->ds);
+
+  if (list_view->rows_nr > 0 && ds->create_row != NULL && widget->h > 0) {
+    first = list_view_get_row_at(widget, list_view->offset);
+    last = list_view_get_row_at(widget, list_view->offset + widget->h - 1);
+    first = first > list_view->overscan ? first - list_view->overscan : 0;
+    last = ftk_min(last + list_view->overscan, list_view->rows_nr - 1);
+    nr = last - first + 1;
+
+    /*顶部只有一侧预留行，多分配一些，避免刚开始滚动时反复增加槽位(每次都要全部重新绑定)。*/
+    if (nr > list_view->slots_nr) {
+      uint32_t slots_nr = nr + list_view->overscan + 1;
+      return_value_if_fail(list_view_ensure_slots(list_view, slots_nr) == RET_OK, RET_OOM);
+    }
+  }
+
+  widget_layout_begin(widget);
+
+  if (nr > 0) {
+    y = list_view_get_row_offset(widget, first) - list_view->offset;
+    for (i = first; i <= last; i++) {
+      wh_t h = list_view_get_height_of(list_view, i);
+      uint32_t slot = i % list_view->slots_nr;
+      widget_t* row = (widget_t*)(widget->children->elms[slot]);
+
+      if (rebind || list_view->slots[slot] != (int32_t)i) {
+        list_view->slots[slot] = i;
+        if (ds->bind_row != NULL) {
+          ds->bind_row(ds->ctx, row, i);
+        }
+      }
+
+      row->visible = TRUE;
+      widget_move_resize(row, 0, y, widget->w, h);
+      list_view_layout_cells(list_view, row);
+      y += h;
+    }
+  }
+
+  for (i = 0; i < list_view->slots_nr; i++) {
+    int32_t index = list_view->slots[i];
+    if (nr == 0 || index < (int32_t)first || index > (int32_t)last) {
+      widget_t* row = (widget_t*)(widget->children->elms[i]);
+      row->visible = FALSE;
+      list_view->slots[i] = -1;
+    }
+  }
+
+  widget_invalidate(widget, NULL);
+  widget_layout_end(widget);
+
+  return RET_OK;
+}
+
+ret_t list_view_scroll_to(widget_t* widget, int32_t offset) {
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL, RET_BAD_PARAMS);
+
+  offset = ftk_min(offset, list_view_max_offset(list_view));
+  offset = ftk_max(offset, 0);
+
+  if (offset == list_view->offset && list_view->slots_nr > 0) {
+    return RET_OK;
+  }
+
+  list_view->offset = offset;
+
+  return list_view_relayout(list_view, FALSE);
+}
+
+ret_t list_view_scroll_to_row(widget_t* widget, uint32_t index) {
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  return list_view_scroll_to(widget, list_view_get_row_offset(widget, index));
+}
+
+ret_t list_view_reload(widget_t* widget) {
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL, RET_BAD_PARAMS);
+
+  return list_view_relayout(list_view, TRUE);
+}
+
+ret_t list_view_set_data_source(widget_t* widget, const list_view_data_source_t* ds) {
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL && ds != NULL && ds->create_row != NULL,
+                       RET_BAD_PARAMS);
+
+  widget_destroy_children(widget);
+  list_view->slots_nr = 0;
+  list_view->ds = *ds;
+
+  return list_view_set_rows_nr(widget, list_view->rows_nr);
+}
+
+ret_t list_view_set_rows_nr(widget_t* widget, uint32_t rows_nr) {
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL, RET_BAD_PARAMS);
+
+  list_view->rows_nr = rows_nr;
+  list_view_build_heights(list_view);
+  list_view->offset = ftk_min(list_view->offset, list_view_max_offset(list_view));
+
+  return list_view_relayout(list_view, TRUE);
+}
+
+ret_t list_view_set_row_height(widget_t* widget, wh_t row_height) {
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL && row_height > 0, RET_BAD_PARAMS);
+
+  list_view->row_height = row_height;
+
+  return list_view_set_rows_nr(widget, list_view->rows_nr);
+}
+
+ret_t list_view_set_overscan(widget_t* widget, uint8_t overscan) {
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL, RET_BAD_PARAMS);
+
+  list_view->overscan = overscan;
+
+  return list_view_relayout(list_view, FALSE);
+}
+
+ret_t list_view_set_columns(widget_t* widget, const wh_t* widths, uint32_t nr) {
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL && (widths != NULL || nr == 0), RET_BAD_PARAMS);
+
+  if (list_view->cols != NULL) {
+    TKMEM_FREE(list_view->cols);
+    list_view->cols = NULL;
+  }
+  list_view->cols_nr = 0;
+
+  if (widths != NULL && nr > 0) {
+    list_view->cols = TKMEM_ZALLOCN(wh_t, nr);
+    return_value_if_fail(list_view->cols != NULL, RET_OOM);
+
+    memcpy(list_view->cols, widths, nr * sizeof(wh_t));
+    list_view->cols_nr = nr;
+  }
+
+  return list_view_relayout(list_view, FALSE);
+}
+
+ret_t list_view_update_row_height(widget_t* widget, uint32_t index) {
+  int32_t delta = 0;
+  uint32_t i = index + 1;
+  list_view_t* list_view = LIST_VIEW(widget);
+  list_view_data_source_t* ds = NULL;
+  return_value_if_fail(list_view != NULL && index < list_view->rows_nr, RET_BAD_PARAMS);
+
+  ds = &(list_view->ds);
+  if (list_view->heights == NULL) {
+    return RET_OK;
+  }
+
+  delta = ds->get_row_height(ds->ctx, index) - list_view_get_height_of(list_view, index);
+  if (delta == 0) {
+    return RET_OK;
+  }
+
+  while (i <= list_view->rows_nr) {
+    list_view->heights[i] += delta;
+    i += LOWBIT(i);
+  }
+  list_view->total_height += delta;
+
+  return list_view_relayout(list_view, FALSE);
+}
+
+static ret_t list_view_on_fling(const frame_info_t* info) {
+  int32_t offset = 0;
+  uint32_t now = info->now;
+  widget_t* widget = WIDGETP(info->ctx);
+  list_view_t* list_view = LIST_VIEW(widget);
+  uint32_t elapsed = now - list_view->last_time;
+  float friction = LIST_VIEW_FLING_FRICTION * elapsed;
+
+  offset = list_view->offset + (int32_t)(list_view->velocity * elapsed);
+  list_view->last_time = now;
+
+  if (list_view->velocity > friction) {
+    list_view->velocity -= friction;
+  } else if (list_view->velocity < -friction) {
+    list_view->velocity += friction;
+  } else {
+    list_view->velocity = 0;
+  }
+
+  list_view_scroll_to(widget, offset);
+  if (list_view->offset <= 0 || list_view->offset >= list_view_max_offset(list_view) ||
+      (list_view->velocity < LIST_VIEW_FLING_MIN_VELOCITY &&
+       list_view->velocity > -LIST_VIEW_FLING_MIN_VELOCITY)) {
+    list_view->velocity = 0;
+    list_view->timer_id = 0;
+
+    return RET_REMOVE;
+  }
+
+  return RET_REPEAT;
+}
+
+static ret_t list_view_stop_fling(list_view_t* list_view) {
+  if (list_view->timer_id != 0) {
+    frame_scheduler_remove(frame_scheduler(), list_view->timer_id);
+    list_view->timer_id = 0;
+  }
+  list_view->velocity = 0;
+
+  return RET_OK;
+}
+
+ret_t list_view_fling(widget_t* widget, float velocity) {
+  list_view_t* list_view = LIST_VIEW(widget);
+  return_value_if_fail(list_view != NULL, RET_BAD_PARAMS);
+
+  list_view_stop_fling(list_view);
+  if (velocity < LIST_VIEW_FLING_MIN_VELOCITY && velocity > -LIST_VIEW_FLING_MIN_VELOCITY) {
+    return RET_OK;
+  }
+
+  list_view->velocity = velocity;
+  list_view->last_time = frame_scheduler_now(frame_scheduler());
+  list_view->timer_id = frame_scheduler_add(frame_scheduler(), list_view_on_fling, widget, 0);
+
+  return list_view->timer_id != 0 ? RET_OK : RET_FAIL;
+}
+
+static ret_t list_view_on_event(widget_t* widget, event_t* e) {
+  uint16_t type = e->type;
+  list_view_t* list_view = LIST_VIEW(widget);
+
+  switch (type) {
+    case EVT_POINTER_DOWN: {
+      pointer_event_t* evt = (pointer_event_t*)e;
+
+      list_view_stop_fling(list_view);
+      list_view->pressed = TRUE;
+      list_view->down_y = evt->y;
+      list_view->last_y = evt->y;
+      list_view->down_offset = list_view->offset;
+      list_view->last_time = time_now_ms();
+      break;
+    }
+    case EVT_POINTER_MOVE: {
+      pointer_event_t* evt = (pointer_event_t*)e;
+      xy_t dy = evt->y - list_view->down_y;
+
+      if (!list_view->pressed) {
+        break;
+      }
+
+      if (!list_view->dragging && (dy > LIST_VIEW_DRAG_THRESHOLD || dy < -LIST_VIEW_DRAG_THRESHOLD)) {
+        list_view->dragging = TRUE;
+        widget->target = NULL;
+        widget_grab(widget->parent, widget);
+      }
+
+      if (list_view->dragging) {
+        uint32_t now = time_now_ms();
+        uint32_t elapsed = now - list_view->last_time;
+
+        if (elapsed > 0) {
+          float v = (float)(list_view->last_y - evt->y) / elapsed;
+          list_view->velocity = v * 0.8f + list_view->velocity * 0.2f;
+          list_view->last_time = now;
+          list_view->last_y = evt->y;
+        }
+
+        list_view_scroll_to(widget, list_view->down_offset - dy);
+      }
+      break;
+    }
+    case EVT_POINTER_UP: {
+      if (list_view->dragging) {
+        widget_ungrab(widget->parent, widget);
+        list_view_fling(widget, list_view->velocity);
+      }
+      list_view->pressed = FALSE;
+      list_view->dragging = FALSE;
+      break;
+    }
+    case EVT_RESIZE:
+    case EVT_MOVE_RESIZE: {
+      list_view->offset = ftk_min(list_view->offset, list_view_max_offset(list_view));
+      list_view_relayout(list_view, FALSE);
+      break;
+    }
+    default:
+      break;
+  }
+
+  return RET_OK;
+}
+
+static widget_t* list_view_find_target(widget_t* widget, xy_t x, xy_t y) {
+  uint32_t i = 0;
+  point_t p = {x, y};
+  list_view_t* list_view = LIST_VIEW(widget);
+
+  /*拖动时行控件不响应指针事件。*/
+  if (list_view->dragging || widget->children == NULL) {
+    return NULL;
+  }
+
+  widget_to_local(widget, &p);
+  for (i = 0; i < widget->children->size; i++) {
+    widget_t* iter = (widget_t*)(widget->children->elms[i]);
+
+    if (iter->visible && p.x >= iter->x && p.y >= iter->y && p.x < iter->x + iter->w &&
+        p.y < iter->y + iter->h) {
+      return iter;
+    }
+  }
+
+  return NULL;
+}
+
+static ret_t list_view_on_paint_self(widget_t* widget, canvas_t* c) {
+  return widget_paint_helper(widget, c, NULL, NULL);
+}
+
+static ret_t list_view_destroy(widget_t* widget) {
+  list_view_t* list_view = LIST_VIEW(widget);
+
+  list_view_stop_fling(list_view);
+  if (list_view->slots != NULL) {
+    TKMEM_FREE(list_view->slots);
+  }
+  if (list_view->heights != NULL) {
+    TKMEM_FREE(list_view->heights);
+  }
+  if (list_view->cols != NULL) {
+    TKMEM_FREE(list_view->cols);
+  }
+
+  return RET_OK;
+}
+
+static const widget_vtable_t s_list_view_vtable = {
+    .on_paint_self = list_view_on_paint_self,
+    .on_paint_children = widget_on_paint_children_clip,
+    .on_event = list_view_on_event,
+    .find_target = list_view_find_target,
+    .destroy = list_view_destroy};
+
+widget_t* list_view_create(widget_t* parent, xy_t x, xy_t y, wh_t w, wh_t h) {
+  widget_t* widget = NULL;
+  list_view_t* list_view = TKMEM_ZALLOC(list_view_t);
+  return_value_if_fail(list_view != NULL, NULL);
+
+  widget = WIDGETP(list_view);
+  widget_init(widget, parent, WIDGET_LIST_VIEW);
+  widget->vt = &s_list_view_vtable;
+  list_view->row_height = LIST_VIEW_DEFAULT_ROW_HEIGHT;
+  list_view->overscan = LIST_VIEW_DEFAULT_OVERSCAN;
+  widget_move_resize(widget, x, y, w, h);
+
+  widget_set_state(widget, WIDGET_STATE_NORMAL);
+
+  return widget;
+}
@@ -0,0 +1,273 @@
+/**
+ * File:   list_view.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  virtualized list view
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-10 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_LIST_VIEW_H
+#define TK_LIST_VIEW_H
+
+#include "base/widget.h"
+
+BEGIN_C_DECLS
+
+/**
+ * 创建一个行控件。行控件必须是list_view的子控件(以list_view为parent创建)。
+ */
+typedef widget_t* (*list_view_create_row_t)(void* ctx, widget_t* list_view);
+
+/**
+ * 把行控件绑定到第index条数据。行控件会被反复绑定到不同的数据上。
+ */
+typedef ret_t (*list_view_bind_row_t)(void* ctx, widget_t* row, uint32_t index);
+
+/**
+ * 获取第index行的高度。
+ */
+typedef wh_t (*list_view_get_row_height_t)(void* ctx, uint32_t index);
+
+/**
+ * @class list_view_data_source_t
+ * 列表视图的数据源。
+ */
+typedef struct _list_view_data_source_t {
+  /**
+   * @property {list_view_create_row_t} create_row
+   * 创建行控件。
+   */
+  list_view_create_row_t create_row;
+  /**
+   * @property {list_view_bind_row_t} bind_row
+   * 绑定数据到行控件。
+   */
+  list_view_bind_row_t bind_row;
+  /**
+   * @property {list_view_get_row_height_t} get_row_height
+   * 获取行高。为NULL时所有行的高度都是row_height。
+   */
+  list_view_get_row_height_t get_row_height;
+  /**
+   * @property {void*} ctx
+   * 回调函数的上下文。
+   */
+  void* ctx;
+} list_view_data_source_t;
+
+/**
+ * @class list_view_t
+ * @parent widget_t
+ * @scriptable
+ * 列表视图控件(也可以用来实现表格视图)。
+ * 设置列宽之后进入表格模式：行控件的前cols_nr个子控件是单元格，按列宽从左到右排列。
+ * 只为可见的行(加上前后少量预留的行)创建行控件，滚动时把移出视图的行控件重新绑定到新的数据上，
+ * 所以内存和每帧的开销与总行数无关。
+ * 行高可变时，用树状数组(Fenwick tree)保存行高的前缀和，根据偏移量查找行是O(log n)的。
+ */
+typedef struct _list_view_t {
+  widget_t widget;
+  /**
+   * @property {uint32_t} rows_nr
+   * @readonly
+   * 总行数。
+   */
+  uint32_t rows_nr;
+  /**
+   * @property {wh_t} row_height
+   * @readonly
+   * 固定的行高。
+   */
+  wh_t row_height;
+  /**
+   * @property {uint8_t} overscan
+   * @readonly
+   * 可见区域前后各预留的行数。
+   */
+  uint8_t overscan;
+  /**
+   * @property {int32_t} offset
+   * @readonly
+   * 滚动的偏移量。
+   */
+  int32_t offset;
+  /**
+   * @property {uint32_t} cols_nr
+   * @readonly
+   * 列数(0表示不分列)。
+   */
+  uint32_t cols_nr;
+
+  /*private*/
+  wh_t* cols;
+  list_view_data_source_t ds;
+
+  uint32_t* heights;
+  uint32_t heights_mask;
+  int32_t total_height;
+
+  uint32_t slots_nr;
+  int32_t* slots;
+
+  bool_t pressed;
+  bool_t dragging;
+  xy_t down_y;
+  xy_t last_y;
+  int32_t down_offset;
+  uint32_t last_time;
+  float velocity;
+  uint32_t timer_id;
+} list_view_t;
+
+/**
+ * @method list_view_create
+ * @constructor
+ * 创建list_view对象
+ * @param {widget_t*} parent 父控件
+ * @param {xy_t} x x坐标
+ * @param {xy_t} y y坐标
+ * @param {wh_t} w 宽度
+ * @param {wh_t} h 高度
+ *
+ * @return {widget_t*} 对象。
+ */
+widget_t* list_view_create(widget_t* parent, xy_t x, xy_t y, wh_t w, wh_t h);
+
+/**
+ * @method list_view_set_data_source
+ * 设置数据源。
+ * @param {widget_t*} widget 控件对象。
+ * @param {list_view_data_source_t*} ds 数据源(内容会被拷贝)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_set_data_source(widget_t* widget, const list_view_data_source_t* ds);
+
+/**
+ * @method list_view_set_rows_nr
+ * 设置总行数。行高可变时会重新计算全部行高(O(n))。
+ * @param {widget_t*} widget 控件对象。
+ * @param {uint32_t} rows_nr 总行数。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_set_rows_nr(widget_t* widget, uint32_t rows_nr);
+
+/**
+ * @method list_view_set_row_height
+ * 设置固定的行高。
+ * @param {widget_t*} widget 控件对象。
+ * @param {wh_t} row_height 行高。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_set_row_height(widget_t* widget, wh_t row_height);
+
+/**
+ * @method list_view_set_overscan
+ * 设置可见区域前后各预留的行数。
+ * @param {widget_t*} widget 控件对象。
+ * @param {uint8_t} overscan 行数。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_set_overscan(widget_t* widget, uint8_t overscan);
+
+/**
+ * @method list_view_set_columns
+ * 设置各列的宽度，进入表格模式。最后一列的宽度为0时占满剩余的宽度。
+ * @param {widget_t*} widget 控件对象。
+ * @param {const wh_t*} widths 列宽数组(内容会被拷贝)，为NULL时退出表格模式。
+ * @param {uint32_t} nr 列数。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_set_columns(widget_t* widget, const wh_t* widths, uint32_t nr);
+
+/**
+ * @method list_view_update_row_height
+ * 第index行的高度变化时调用，重新获取该行的高度(O(log n))。
+ * @param {widget_t*} widget 控件对象。
+ * @param {uint32_t} index 行号。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_update_row_height(widget_t* widget, uint32_t index);
+
+/**
+ * @method list_view_reload
+ * 数据变化时调用，重新绑定全部可见的行。
+ * @param {widget_t*} widget 控件对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_reload(widget_t* widget);
+
+/**
+ * @method list_view_scroll_to
+ * 滚动到指定的偏移量。
+ * @param {widget_t*} widget 控件对象。
+ * @param {int32_t} offset 偏移量(会被限制在有效范围内)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_scroll_to(widget_t* widget, int32_t offset);
+
+/**
+ * @method list_view_scroll_to_row
+ * 滚动到指定的行。
+ * @param {widget_t*} widget 控件对象。
+ * @param {uint32_t} index 行号。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_scroll_to_row(widget_t* widget, uint32_t index);
+
+/**
+ * @method list_view_fling
+ * 以指定的初速度惯性滚动。
+ * @param {widget_t*} widget 控件对象。
+ * @param {float} velocity 速度(像素/毫秒)，正数向下滚动。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t list_view_fling(widget_t* widget, float velocity);
+
+/**
+ * @method list_view_get_row_offset
+ * 获取第index行的起始偏移量(O(log n))。
+ * @param {widget_t*} widget 控件对象。
+ * @param {uint32_t} index 行号。
+ *
+ * @return {int32_t} 返回偏移量。
+ */
+int32_t list_view_get_row_offset(widget_t* widget, uint32_t index);
+
+/**
+ * @method list_view_get_row_at
+ * 获取偏移量offset所在的行(O(log n))。
+ * @param {widget_t*} widget 控件对象。
+ * @param {int32_t} offset 偏移量。
+ *
+ * @return {uint32_t} 返回行号。
+ */
+uint32_t list_view_get_row_at(widget_t* widget, int32_t offset);
+
+#define LIST_VIEW(widget) ((list_view_t*)(widget))
+
+END_C_DECLS
+
+#endif /*TK_LIST_VIEW_H*/
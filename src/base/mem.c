@@ -21,7 +21,38 @@
 
 #include "base/mem.h"
 
+static uint32_t s_alloc_times = 0;
+static uint32_t s_free_times = 0;
+
 #ifdef HAS_STD_MALLOC
+void* tk_calloc(uint32_t nmemb, uint32_t size) {
+  s_alloc_times++;
+
+  return calloc(nmemb, size);
+}
+
+void* tk_alloc(uint32_t size) {
+  s_alloc_times++;
+
+  return malloc(size);
+}
+
+void* tk_realloc(void* ptr, uint32_t size) {
+  if (ptr == NULL) {
+    s_alloc_times++;
+  }
+
+  return realloc(ptr, size);
+}
+
+void tk_free(void* ptr) {
+  if (ptr != NULL) {
+    s_free_times++;
+  }
+
+  free(ptr);
+}
+
 ret_t mem_init(void* buffer, uint32_t length) {
   (void)buffer;
   (void)length;
@@ -31,6 +62,9 @@ ret_t mem_init(void* buffer, uint32_t length) {
 mem_stat_t mem_stat(void) {
   mem_stat_t stat;
   memset(&stat, 0x00, sizeof(stat));
+  stat.alloc_times = s_alloc_times;
+  stat.free_times = s_free_times;
+
   return stat;
 }
 
@@ -71,6 +105,8 @@ void* tk_alloc(uint32_t size) {
   free_node_t* iter = NULL;
   uint32_t length = REAL_SIZE(size);
 
+  s_alloc_times++;
+
   /*查找第一个满足条件的空闲块*/
   for (iter = mem_info.free_list; iter != NULL; iter = iter->next) {
     if (iter->length > length) {
@@ -162,6 +198,7 @@ void tk_free(void* ptr) {
 
   return_if_fail(ptr != NULL);
 
+  s_free_times++;
   free_iter = (free_node_t*)((char*)ptr - sizeof(uint32_t));
 
   free_iter->prev = NULL;
@@ -263,10 +300,13 @@ mem_stat_t mem_stat() {
   for (iter = mem_info.free_list; iter != NULL; iter = iter->next) {
     st.free += iter->length;
     st.free_block_nr++;
+    st.max_free_block = ftk_max(st.max_free_block, iter->length);
   }
 
   st.used = st.total - st.free;
   st.used_block_nr = mem_info.used_block_nr;
+  st.alloc_times = s_alloc_times;
+  st.free_times = s_free_times;
 
   return st;
 }
@@ -32,6 +32,11 @@ typedef struct _mem_stat_t {
   uint32_t total;
   uint32_t free_block_nr;
   uint32_t used_block_nr;
+  /*最大的空闲块，用来估计碎片的程度*/
+  uint32_t max_free_block;
+  /*累计的分配/释放次数*/
+  uint32_t alloc_times;
+  uint32_t free_times;
 } mem_stat_t;
 
 ret_t mem_init(void* buffer, uint32_t length);
@@ -40,31 +45,27 @@ mem_stat_t mem_stat(void);
 
 void mem_info_dump(void);
 
-#ifdef HAS_STD_MALLOC
-#define TKMEM_INIT(size)
-#define TKMEM_ALLOC(size) malloc(size)
-#define TKMEM_ZALLOC(type) (type*)calloc(1, sizeof(type))
-#define TKMEM_ZALLOCN(type, n) (type*)calloc(n, sizeof(type))
-#define TKMEM_REALLOC(type, p, n) (type*)realloc(p, (n) * sizeof(type))
-#define TKMEM_FREE(p) free(p)
-#else
 void* tk_calloc(uint32_t nmemb, uint32_t size);
 void* tk_realloc(void* ptr, uint32_t size);
 void tk_free(void* ptr);
 void* tk_alloc(uint32_t size);
 
+/*使用标准malloc时，tk_alloc等函数只是统计分配次数。*/
+#ifdef HAS_STD_MALLOC
+#define TKMEM_INIT(size)
+#else
 #define TKMEM_INIT(size)                      \
   {                                           \
     static uint32_t s_heap_mem[size >> 2];    \
     mem_init(s_heap_mem, sizeof(s_heap_mem)); \
   }
+#endif /*HAS_STD_MALLOC*/
 
 #define TKMEM_ALLOC(size) tk_alloc(size)
 #define TKMEM_ZALLOC(type) (type*)tk_calloc(1, sizeof(type))
 #define TKMEM_ZALLOCN(type, n) (type*)tk_calloc(n, sizeof(type))
 #define TKMEM_REALLOC(type, p, n) (type*)tk_realloc(p, (n) * sizeof(type))
 #define TKMEM_FREE(p) tk_free(p)
-#endif
 
 END_C_DECLS
 #endif /*TK_TKMEM_MANAGER_H*/
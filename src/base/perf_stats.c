@@ -0,0 +1,121 @@
+/**
+ * File:   perf_stats.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  live performance counters
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-23 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/idle.h"
+#include "base/timer.h"
+#include "base/atomic.h"
+#include "base/perf_stats.h"
+
+static perf_stats_t s_perf_stats;
+
+static uint32_t perf_stats_counter(perf_counter_t counter) {
+  return tk_atomic_load(s_perf_stats.counters + counter);
+}
+
+static uint32_t perf_stats_rate(uint32_t hits, uint32_t misses) {
+  uint32_t total = hits + misses;
+
+  return total > 0 ? (uint32_t)((uint64_t)hits * 100 / total) : 100;
+}
+
+perf_stats_t* perf_stats_get(void) {
+  mem_stat_t st = mem_stat();
+  perf_stats_t* s = &s_perf_stats;
+
+  s->glyph_hits = perf_stats_counter(PERF_COUNTER_GLYPH_HITS);
+  s->glyph_misses = perf_stats_counter(PERF_COUNTER_GLYPH_MISSES);
+  s->glyph_hit_rate = perf_stats_rate(s->glyph_hits, s->glyph_misses);
+  s->image_hits = perf_stats_counter(PERF_COUNTER_IMAGE_HITS);
+  s->image_misses = perf_stats_counter(PERF_COUNTER_IMAGE_MISSES);
+  s->image_hit_rate = perf_stats_rate(s->image_hits, s->image_misses);
+  s->timers_fired = perf_stats_counter(PERF_COUNTER_TIMERS_FIRED);
+  s->idles_dispatched = perf_stats_counter(PERF_COUNTER_IDLES_DISPATCHED);
+
+  s->timer_count = timer_count();
+  s->idle_count = idle_count();
+
+  s->mem_used = st.used;
+  s->mem_free = st.free;
+  s->mem_free_blocks = st.free_block_nr;
+  s->mem_fragmentation =
+      st.free > 0 ? 100 - (uint32_t)((uint64_t)st.max_free_block * 100 / st.free) : 0;
+
+  return s;
+}
+
+ret_t perf_stats_reset(void) {
+  uint32_t i = 0;
+  perf_stats_t* s = &s_perf_stats;
+
+  s->fps = 0;
+  s->frames = 0;
+  s->paint_time = 0;
+  s->max_paint_time = 0;
+  s->dirty_pixels = 0;
+  s->pixels_filled = 0;
+  s->pixels_blended = 0;
+  s->pixels_copied = 0;
+  s->fps_start = 0;
+  s->fps_frames = 0;
+  for (i = 0; i < PERF_COUNTER_NR; i++) {
+    tk_atomic_store(s->counters + i, 0);
+  }
+
+  return RET_OK;
+}
+
+ret_t perf_stats_add(perf_counter_t counter, uint32_t n) {
+  return_value_if_fail(counter < PERF_COUNTER_NR, RET_BAD_PARAMS);
+
+  tk_atomic_fetch_add_u32(s_perf_stats.counters + counter, n);
+
+  return RET_OK;
+}
+
+ret_t perf_stats_on_frame(uint32_t now, uint32_t paint_time) {
+  uint32_t elapsed = 0;
+  perf_stats_t* s = &s_perf_stats;
+
+  s->frames++;
+  s->paint_time = paint_time;
+  s->max_paint_time = ftk_max(s->max_paint_time, paint_time);
+
+  /*像素计数器在每一帧结束时清零，累计的值就是这一帧的。*/
+  s->dirty_pixels = tk_atomic_exchange_u32(s->counters + PERF_COUNTER_DIRTY_PIXELS, 0);
+  s->pixels_filled = tk_atomic_exchange_u32(s->counters + PERF_COUNTER_PIXELS_FILLED, 0);
+  s->pixels_blended = tk_atomic_exchange_u32(s->counters + PERF_COUNTER_PIXELS_BLENDED, 0);
+  s->pixels_copied = tk_atomic_exchange_u32(s->counters + PERF_COUNTER_PIXELS_COPIED, 0);
+
+  if (s->fps_frames == 0) {
+    s->fps_start = now;
+  }
+
+  s->fps_frames++;
+  elapsed = now - s->fps_start;
+  if (elapsed >= 1000) {
+    s->fps = (s->fps_frames - 1) * 1000 / elapsed;
+    s->fps_start = now;
+    s->fps_frames = 1;
+  }
+
+  return RET_OK;
+}
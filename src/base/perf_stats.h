@@ -0,0 +1,287 @@
+/**
+ * File:   perf_stats.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  live performance counters
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-23 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_PERF_STATS_H
+#define TK_PERF_STATS_H
+
+#include "base/types_def.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @enum perf_counter_t
+ * @prefix PERF_COUNTER_
+ * 由核心代码和lcd后端累加的计数器。
+ */
+typedef enum _perf_counter_t {
+  /**
+   * @const PERF_COUNTER_DIRTY_PIXELS
+   * 窗口管理器重绘的像素数(脏矩形的面积)。
+   */
+  PERF_COUNTER_DIRTY_PIXELS = 0,
+  /**
+   * @const PERF_COUNTER_PIXELS_FILLED
+   * 用纯色填充的像素数。
+   */
+  PERF_COUNTER_PIXELS_FILLED,
+  /**
+   * @const PERF_COUNTER_PIXELS_BLENDED
+   * 需要混合的像素数(字模、带透明度的图片和半透明绘制)。
+   */
+  PERF_COUNTER_PIXELS_BLENDED,
+  /**
+   * @const PERF_COUNTER_PIXELS_COPIED
+   * 直接拷贝的像素数(不透明的图片和lcd_scroll)。
+   */
+  PERF_COUNTER_PIXELS_COPIED,
+  /**
+   * @const PERF_COUNTER_GLYPH_HITS
+   * 字体的字符度量缓存命中的次数。
+   */
+  PERF_COUNTER_GLYPH_HITS,
+  /**
+   * @const PERF_COUNTER_GLYPH_MISSES
+   * 字体的字符度量缓存没有命中的次数。
+   */
+  PERF_COUNTER_GLYPH_MISSES,
+  /**
+   * @const PERF_COUNTER_IMAGE_HITS
+   * 图片缓存命中的次数。
+   */
+  PERF_COUNTER_IMAGE_HITS,
+  /**
+   * @const PERF_COUNTER_IMAGE_MISSES
+   * 图片缓存没有命中，需要解码的次数。
+   */
+  PERF_COUNTER_IMAGE_MISSES,
+  /**
+   * @const PERF_COUNTER_TIMERS_FIRED
+   * 触发的定时器的次数。
+   */
+  PERF_COUNTER_TIMERS_FIRED,
+  /**
+   * @const PERF_COUNTER_IDLES_DISPATCHED
+   * 调用的idle的次数。
+   */
+  PERF_COUNTER_IDLES_DISPATCHED,
+  /**
+   * @const PERF_COUNTER_NR
+   * 计数器的个数。
+   */
+  PERF_COUNTER_NR
+} perf_counter_t;
+
+/**
+ * @class perf_stats_t
+ * @scriptable
+ * 实时的性能统计信息。
+ *
+ * 核心代码和lcd后端用perf_stats_add累加计数器(原子操作，其它线程也可以调用)，
+ * 帧调度器每绘制一帧调用perf_stats_on_frame。像素相关的统计是最近一帧的，
+ * 缓存命中、定时器和idle的统计是累计的，用perf_stats_reset清零。
+ *
+ * 只有lcd_mem系列的lcd统计像素，其它后端可以自己调用perf_stats_add。
+ */
+typedef struct _perf_stats_t {
+  /**
+   * @property {uint32_t} fps
+   * @readonly
+   * 最近一秒的帧率。
+   */
+  uint32_t fps;
+  /**
+   * @property {uint32_t} frames
+   * @readonly
+   * 绘制的帧数。
+   */
+  uint32_t frames;
+  /**
+   * @property {uint32_t} paint_time
+   * @readonly
+   * 最近一帧的绘制时间(微秒)。
+   */
+  uint32_t paint_time;
+  /**
+   * @property {uint32_t} max_paint_time
+   * @readonly
+   * 最长的绘制时间(微秒)。
+   */
+  uint32_t max_paint_time;
+  /**
+   * @property {uint32_t} dirty_pixels
+   * @readonly
+   * 最近一帧重绘的像素数。
+   */
+  uint32_t dirty_pixels;
+  /**
+   * @property {uint32_t} pixels_filled
+   * @readonly
+   * 最近一帧用纯色填充的像素数。
+   */
+  uint32_t pixels_filled;
+  /**
+   * @property {uint32_t} pixels_blended
+   * @readonly
+   * 最近一帧混合的像素数。
+   */
+  uint32_t pixels_blended;
+  /**
+   * @property {uint32_t} pixels_copied
+   * @readonly
+   * 最近一帧拷贝的像素数。
+   */
+  uint32_t pixels_copied;
+  /**
+   * @property {uint32_t} glyph_hits
+   * @readonly
+   * 字符度量缓存命中的次数。
+   */
+  uint32_t glyph_hits;
+  /**
+   * @property {uint32_t} glyph_misses
+   * @readonly
+   * 字符度量缓存没有命中的次数。
+   */
+  uint32_t glyph_misses;
+  /**
+   * @property {uint32_t} glyph_hit_rate
+   * @readonly
+   * 字符度量缓存的命中率(百分比)。
+   */
+  uint32_t glyph_hit_rate;
+  /**
+   * @property {uint32_t} image_hits
+   * @readonly
+   * 图片缓存命中的次数。
+   */
+  uint32_t image_hits;
+  /**
+   * @property {uint32_t} image_misses
+   * @readonly
+   * 图片缓存没有命中的次数。
+   */
+  uint32_t image_misses;
+  /**
+   * @property {uint32_t} image_hit_rate
+   * @readonly
+   * 图片缓存的命中率(百分比)。
+   */
+  uint32_t image_hit_rate;
+  /**
+   * @property {uint32_t} timers_fired
+   * @readonly
+   * 触发的定时器的次数。
+   */
+  uint32_t timers_fired;
+  /**
+   * @property {uint32_t} idles_dispatched
+   * @readonly
+   * 调用的idle的次数。
+   */
+  uint32_t idles_dispatched;
+  /**
+   * @property {uint32_t} timer_count
+   * @readonly
+   * 当前定时器的个数。
+   */
+  uint32_t timer_count;
+  /**
+   * @property {uint32_t} idle_count
+   * @readonly
+   * 当前idle的个数。
+   */
+  uint32_t idle_count;
+  /**
+   * @property {uint32_t} mem_used
+   * @readonly
+   * 已经使用的堆内存(字节，使用标准malloc时为0)。
+   */
+  uint32_t mem_used;
+  /**
+   * @property {uint32_t} mem_free
+   * @readonly
+   * 空闲的堆内存(字节)。
+   */
+  uint32_t mem_free;
+  /**
+   * @property {uint32_t} mem_free_blocks
+   * @readonly
+   * 空闲块的个数。
+   */
+  uint32_t mem_free_blocks;
+  /**
+   * @property {uint32_t} mem_fragmentation
+   * @readonly
+   * 堆的碎片率(百分比)：不在最大空闲块中的空闲内存所占的比例。
+   */
+  uint32_t mem_fragmentation;
+
+  /*private*/
+  volatile uint32_t counters[PERF_COUNTER_NR];
+  uint32_t fps_start;
+  uint32_t fps_frames;
+} perf_stats_t;
+
+/**
+ * @method perf_stats_get
+ * 获取统计信息，同时采样堆、定时器和idle的当前状态。
+ * @static
+ *
+ * @return {perf_stats_t*} 返回统计信息对象。
+ */
+perf_stats_t* perf_stats_get(void);
+
+/**
+ * @method perf_stats_reset
+ * 清零全部统计信息。
+ * @static
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t perf_stats_reset(void);
+
+/**
+ * @method perf_stats_add
+ * 累加计数器。可以在任何线程中调用。
+ * @static
+ * @scriptable no
+ * @param {perf_counter_t} counter 计数器。
+ * @param {uint32_t} n 增加的值。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t perf_stats_add(perf_counter_t counter, uint32_t n);
+
+/**
+ * @method perf_stats_on_frame
+ * 绘制完一帧(由帧调度器调用)：更新帧率和绘制时间，把像素计数器累计的值记为最近一帧的。
+ * @static
+ * @scriptable no
+ * @param {uint32_t} now 本帧的时间(毫秒)。
+ * @param {uint32_t} paint_time 绘制时间(微秒)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t perf_stats_on_frame(uint32_t now, uint32_t paint_time);
+
+END_C_DECLS
+
+#endif /*TK_PERF_STATS_H*/
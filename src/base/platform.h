@@ -28,6 +28,8 @@ BEGIN_C_DECLS
 
 ret_t platform_prepare(void);
 uint32_t get_time_ms(void);
+/*微秒时钟，给性能剖析用。没有高精度时钟的平台用毫秒时钟换算。*/
+uint64_t get_time_us(void);
 
 END_C_DECLS
 
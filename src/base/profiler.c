@@ -0,0 +1,383 @@
+/**
+ * File:   profiler.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  record nested timing scopes into a ring buffer
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-22 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/fs.h"
+#include "base/mem.h"
+#include "base/atomic.h"
+#include "base/platform.h"
+#include "base/profiler.h"
+
+/*插桩编译进来时，渲染线程等也会记录，每个线程有自己的作用域栈。*/
+#if defined(WITH_PROFILER) && defined(_MSC_VER)
+#define PROFILER_THREAD_LOCAL __declspec(thread)
+#elif defined(WITH_PROFILER) && (defined(__GNUC__) || defined(__clang__))
+#define PROFILER_THREAD_LOCAL __thread
+#else
+#define PROFILER_THREAD_LOCAL
+#endif
+
+/*导出时每个事件最多占用的长度。*/
+#define PROFILER_EVENT_JSON_MAX 256
+
+/*name为NULL表示没有开始记录时进入的作用域(profiler_skip)，离开时不记录。*/
+typedef struct _profiler_scope_t {
+  const char* name;
+  const char* detail;
+  uint64_t start;
+  uint32_t children;
+} profiler_scope_t;
+
+typedef struct _profiler_stack_t {
+  uint16_t tid;
+  uint32_t depth;
+  profiler_scope_t scopes[PROFILER_MAX_DEPTH];
+} profiler_stack_t;
+
+/*
+ * 环形缓冲区和它的大小放在一起发布，记录的线程只读一次指针，不会看到不匹配的大小。
+ * 其它线程可能还在往旧的缓冲区写，所以换下来的缓冲区不马上释放，留到profiler_deinit。
+ */
+typedef struct _profiler_ring_t {
+  uint32_t capacity;
+  struct _profiler_ring_t* retired;
+  profiler_event_t* events;
+} profiler_ring_t;
+
+typedef struct _profiler_t {
+  bool_t enabled;
+  volatile uint32_t next;
+  volatile uint32_t threads;
+  profiler_ring_t* ring;
+} profiler_t;
+
+static profiler_t s_profiler;
+static PROFILER_THREAD_LOCAL profiler_stack_t s_stack;
+
+static profiler_ring_t* profiler_get_ring(void) {
+  return tk_atomic_load(&(s_profiler.ring));
+}
+
+ret_t profiler_start(uint32_t capacity) {
+  profiler_ring_t* ring = NULL;
+  profiler_ring_t* old = profiler_get_ring();
+  return_value_if_fail(capacity > 0, RET_BAD_PARAMS);
+
+  profiler_stop();
+
+  /*大小不变时重用缓冲区，只有next之前的事件是有效的。*/
+  if (old == NULL || old->capacity != capacity) {
+    ring = TKMEM_ZALLOC(profiler_ring_t);
+    return_value_if_fail(ring != NULL, RET_OOM);
+    ring->events = TKMEM_ZALLOCN(profiler_event_t, capacity);
+    if (ring->events == NULL) {
+      TKMEM_FREE(ring);
+      return RET_OOM;
+    }
+
+    ring->capacity = capacity;
+    ring->retired = old;
+    tk_atomic_store(&(s_profiler.ring), ring);
+  }
+
+  tk_atomic_store(&(s_profiler.next), 0);
+  tk_atomic_store(&(s_profiler.enabled), TRUE);
+
+  return RET_OK;
+}
+
+ret_t profiler_stop(void) {
+  tk_atomic_store(&(s_profiler.enabled), FALSE);
+
+  return RET_OK;
+}
+
+bool_t profiler_is_enabled(void) {
+  return tk_atomic_load(&(s_profiler.enabled));
+}
+
+ret_t profiler_skip(void) {
+  profiler_stack_t* stack = &s_stack;
+
+  if (stack->depth < PROFILER_MAX_DEPTH) {
+    stack->scopes[stack->depth].name = NULL;
+  }
+  stack->depth++;
+
+  return RET_OK;
+}
+
+ret_t profiler_begin(const char* name, const char* detail) {
+  profiler_stack_t* stack = &s_stack;
+  return_value_if_fail(name != NULL, RET_BAD_PARAMS);
+
+  if (stack->depth < PROFILER_MAX_DEPTH) {
+    profiler_scope_t* scope = stack->scopes + stack->depth;
+
+    scope->name = name;
+    scope->detail = detail;
+    scope->children = 0;
+    scope->start = get_time_us();
+  }
+  stack->depth++;
+
+  return RET_OK;
+}
+
+static ret_t profiler_record(profiler_stack_t* stack, profiler_scope_t* scope, uint32_t duration) {
+  uint32_t index = 0;
+  profiler_event_t* e = NULL;
+  profiler_ring_t* ring = profiler_get_ring();
+
+  if (ring == NULL) {
+    return RET_OK;
+  }
+
+  if (stack->tid == 0) {
+    stack->tid = (uint16_t)(tk_atomic_fetch_add_u32(&(s_profiler.threads), 1) + 1);
+  }
+
+  index = tk_atomic_fetch_add_u32(&(s_profiler.next), 1);
+  e = ring->events + (index % ring->capacity);
+  e->name = scope->name;
+  e->detail = scope->detail;
+  e->start = scope->start;
+  e->duration = duration;
+  e->self = duration > scope->children ? duration - scope->children : 0;
+  e->tid = stack->tid;
+  e->depth = stack->depth;
+
+  return RET_OK;
+}
+
+ret_t profiler_end(void) {
+  uint32_t duration = 0;
+  profiler_scope_t* scope = NULL;
+  profiler_stack_t* stack = &s_stack;
+
+  /*开始记录之前进入的作用域没有入栈。*/
+  if (stack->depth == 0) {
+    return RET_OK;
+  }
+
+  stack->depth--;
+  if (stack->depth >= PROFILER_MAX_DEPTH) {
+    return RET_OK;
+  }
+
+  scope = stack->scopes + stack->depth;
+  if (scope->name == NULL) {
+    return RET_OK;
+  }
+
+  duration = (uint32_t)(get_time_us() - scope->start);
+  if (stack->depth > 0) {
+    stack->scopes[stack->depth - 1].children += duration;
+  }
+
+  if (profiler_is_enabled()) {
+    profiler_record(stack, scope, duration);
+  }
+
+  return RET_OK;
+}
+
+uint32_t profiler_get_events(profiler_event_t* events, uint32_t max) {
+  uint32_t i = 0;
+  uint32_t nr = 0;
+  uint32_t first = 0;
+  uint32_t next = tk_atomic_load(&(s_profiler.next));
+  profiler_ring_t* ring = profiler_get_ring();
+  return_value_if_fail(events != NULL, 0);
+
+  if (ring == NULL) {
+    return 0;
+  }
+
+  nr = ftk_min(next, ring->capacity);
+  first = next - nr;
+  nr = ftk_min(nr, max);
+  for (i = 0; i < nr; i++) {
+    events[i] = ring->events[(first + i) % ring->capacity];
+  }
+
+  return nr;
+}
+
+static bool_t profiler_str_eq(const char* a, const char* b) {
+  if (a == b) {
+    return TRUE;
+  }
+
+  return a != NULL && b != NULL && strcmp(a, b) == 0;
+}
+
+static int profiler_stat_compare(const void* a, const void* b) {
+  const profiler_stat_t* sa = (const profiler_stat_t*)a;
+  const profiler_stat_t* sb = (const profiler_stat_t*)b;
+
+  if (sa->self == sb->self) {
+    return 0;
+  }
+
+  return sa->self < sb->self ? 1 : -1;
+}
+
+uint32_t profiler_get_stats(const char* name, profiler_stat_t* stats, uint32_t max) {
+  uint32_t i = 0;
+  uint32_t k = 0;
+  uint32_t nr = 0;
+  uint32_t size = 0;
+  uint32_t capacity = 0;
+  profiler_stat_t* all = NULL;
+  profiler_event_t* events = NULL;
+  profiler_ring_t* ring = profiler_get_ring();
+  return_value_if_fail(stats != NULL && max > 0, 0);
+
+  if (ring == NULL) {
+    return 0;
+  }
+
+  /*先全部汇总再排序，stats只返回耗时最多的max个。*/
+  capacity = ring->capacity;
+  events = TKMEM_ZALLOCN(profiler_event_t, capacity);
+  return_value_if_fail(events != NULL, 0);
+  all = TKMEM_ZALLOCN(profiler_stat_t, capacity);
+  if (all == NULL) {
+    TKMEM_FREE(events);
+    return 0;
+  }
+
+  nr = profiler_get_events(events, capacity);
+  for (i = 0; i < nr; i++) {
+    profiler_stat_t* iter = NULL;
+    profiler_event_t* e = events + i;
+
+    if (name != NULL && !profiler_str_eq(name, e->name)) {
+      continue;
+    }
+
+    for (k = 0; k < size; k++) {
+      if (profiler_str_eq(all[k].name, e->name) && profiler_str_eq(all[k].detail, e->detail)) {
+        iter = all + k;
+        break;
+      }
+    }
+
+    if (iter == NULL) {
+      iter = all + size++;
+      iter->name = e->name;
+      iter->detail = e->detail;
+    }
+
+    iter->count++;
+    iter->total += e->duration;
+    iter->self += e->self;
+    iter->max = ftk_max(iter->max, e->duration);
+  }
+  TKMEM_FREE(events);
+
+  qsort(all, size, sizeof(profiler_stat_t), profiler_stat_compare);
+  size = ftk_min(size, max);
+  memcpy(stats, all, size * sizeof(profiler_stat_t));
+  TKMEM_FREE(all);
+
+  return size;
+}
+
+/*名称和附加信息都是标识符，去掉JSON中需要转义的字符。*/
+static const char* profiler_json_str(char* buff, uint32_t size, const char* str) {
+  uint32_t i = 0;
+
+  for (i = 0; str != NULL && *str && i + 1 < size; str++) {
+    if (*str != '"' && *str != '\\' && (uint8_t)(*str) >= 0x20) {
+      buff[i++] = *str;
+    }
+  }
+  buff[i] = '\0';
+
+  return buff;
+}
+
+ret_t profiler_export_chrome_trace(const char* filename) {
+  uint32_t i = 0;
+  uint32_t nr = 0;
+  uint32_t len = 0;
+  uint64_t base = 0;
+  ret_t ret = RET_OK;
+  char* buff = NULL;
+  char name[64];
+  char detail[64];
+  profiler_event_t* events = NULL;
+  profiler_ring_t* ring = profiler_get_ring();
+  return_value_if_fail(filename != NULL && ring != NULL, RET_BAD_PARAMS);
+
+  events = TKMEM_ZALLOCN(profiler_event_t, ring->capacity);
+  return_value_if_fail(events != NULL, RET_OOM);
+
+  nr = profiler_get_events(events, ring->capacity);
+  buff = (char*)TKMEM_ALLOC((nr + 2) * PROFILER_EVENT_JSON_MAX);
+  if (buff == NULL) {
+    TKMEM_FREE(events);
+    return RET_OOM;
+  }
+
+  /*时间从最早的事件开始，事件是按结束时间排列的。*/
+  base = nr > 0 ? events[0].start : 0;
+  for (i = 0; i < nr; i++) {
+    base = ftk_min(base, events[i].start);
+  }
+
+  len = snprintf(buff, PROFILER_EVENT_JSON_MAX, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+  for (i = 0; i < nr; i++) {
+    profiler_event_t* e = events + i;
+
+    len += snprintf(buff + len, PROFILER_EVENT_JSON_MAX,
+                    "%s\n{\"name\":\"%s\",\"cat\":\"awtk\",\"ph\":\"X\",\"ts\":%u,\"dur\":%u,"
+                    "\"pid\":1,\"tid\":%u,\"args\":{\"detail\":\"%s\",\"self\":%u}}",
+                    i > 0 ? "," : "", profiler_json_str(name, sizeof(name), e->name),
+                    (uint32_t)(e->start - base), e->duration, e->tid,
+                    profiler_json_str(detail, sizeof(detail), e->detail), e->self);
+  }
+  len += snprintf(buff + len, PROFILER_EVENT_JSON_MAX, "\n]}\n");
+
+  ret = fs_write_file(filename, buff, len);
+  TKMEM_FREE(buff);
+  TKMEM_FREE(events);
+
+  return ret;
+}
+
+ret_t profiler_deinit(void) {
+  profiler_ring_t* ring = profiler_get_ring();
+
+  profiler_stop();
+  tk_atomic_store(&(s_profiler.ring), NULL);
+  tk_atomic_store(&(s_profiler.next), 0);
+
+  while (ring != NULL) {
+    profiler_ring_t* retired = ring->retired;
+    TKMEM_FREE(ring->events);
+    TKMEM_FREE(ring);
+    ring = retired;
+  }
+
+  return RET_OK;
+}
@@ -0,0 +1,240 @@
+/**
+ * File:   profiler.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  record nested timing scopes into a ring buffer
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-22 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_PROFILER_H
+#define TK_PROFILER_H
+
+#include "base/types_def.h"
+
+BEGIN_C_DECLS
+
+/*每个线程最多记录的嵌套层数，更深的作用域不记录。*/
+#ifndef PROFILER_MAX_DEPTH
+#define PROFILER_MAX_DEPTH 32
+#endif /*PROFILER_MAX_DEPTH*/
+
+/**
+ * @class profiler_event_t
+ * 一个结束了的作用域。
+ */
+typedef struct _profiler_event_t {
+  /**
+   * @property {const char*} name
+   * @readonly
+   * 作用域的名称(常量字符串，通常是函数名)。
+   */
+  const char* name;
+  /**
+   * @property {const char*} detail
+   * @readonly
+   * 附加信息(常量字符串，比如控件的类型和图片的名称)，可以为NULL。
+   */
+  const char* detail;
+  /**
+   * @property {uint64_t} start
+   * @readonly
+   * 开始时间(微秒)。
+   */
+  uint64_t start;
+  /**
+   * @property {uint32_t} duration
+   * @readonly
+   * 耗时(微秒)。
+   */
+  uint32_t duration;
+  /**
+   * @property {uint32_t} self
+   * @readonly
+   * 去掉嵌套的作用域之后的耗时(微秒)。
+   */
+  uint32_t self;
+  /**
+   * @property {uint16_t} tid
+   * @readonly
+   * 线程的序号(从1开始)。
+   */
+  uint16_t tid;
+  /**
+   * @property {uint16_t} depth
+   * @readonly
+   * 嵌套的层数(从0开始)。
+   */
+  uint16_t depth;
+} profiler_event_t;
+
+/**
+ * @class profiler_stat_t
+ * 按名称和附加信息汇总的统计信息。
+ */
+typedef struct _profiler_stat_t {
+  /**
+   * @property {const char*} name
+   * @readonly
+   * 作用域的名称。
+   */
+  const char* name;
+  /**
+   * @property {const char*} detail
+   * @readonly
+   * 附加信息。
+   */
+  const char* detail;
+  /**
+   * @property {uint32_t} count
+   * @readonly
+   * 次数。
+   */
+  uint32_t count;
+  /**
+   * @property {uint32_t} max
+   * @readonly
+   * 最长的一次耗时(微秒)。
+   */
+  uint32_t max;
+  /**
+   * @property {uint64_t} total
+   * @readonly
+   * 总耗时(微秒)。
+   */
+  uint64_t total;
+  /**
+   * @property {uint64_t} self
+   * @readonly
+   * 去掉嵌套的作用域之后的总耗时(微秒)。
+   */
+  uint64_t self;
+} profiler_stat_t;
+
+/**
+ * @method profiler_start
+ * 开始记录。事件记录在capacity个事件的环形缓冲区中，满了之后覆盖最早的事件。
+ * 大小不变时重用原来的缓冲区。其它线程可能正在记录，换下来的缓冲区保留到profiler_deinit才释放。
+ * @param {uint32_t} capacity 环形缓冲区的大小。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t profiler_start(uint32_t capacity);
+
+/**
+ * @method profiler_stop
+ * 停止记录，已经记录的事件保留到下一次profiler_start或者profiler_deinit。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t profiler_stop(void);
+
+/**
+ * @method profiler_is_enabled
+ * 是否正在记录。
+ *
+ * @return {bool_t} 返回TRUE表示正在记录。
+ */
+bool_t profiler_is_enabled(void);
+
+/**
+ * @method profiler_begin
+ * 进入一个作用域。
+ * @param {const char*} name 名称(常量字符串)。
+ * @param {const char*} detail 附加信息(常量字符串)，可以为NULL。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t profiler_begin(const char* name, const char* detail);
+
+/**
+ * @method profiler_skip
+ * 进入一个不记录的作用域。
+ * 没有开始记录时PROFILER_BEGIN调用本函数，保证PROFILER_END弹出的是同一个作用域。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t profiler_skip(void);
+
+/**
+ * @method profiler_end
+ * 离开当前的作用域，把它记录到环形缓冲区中。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t profiler_end(void);
+
+/**
+ * @method profiler_get_events
+ * 按时间顺序获取环形缓冲区中的事件。
+ * @param {profiler_event_t*} events 用于返回事件。
+ * @param {uint32_t} max events的大小。
+ *
+ * @return {uint32_t} 返回事件的个数。
+ */
+uint32_t profiler_get_events(profiler_event_t* events, uint32_t max);
+
+/**
+ * @method profiler_get_stats
+ * 按名称和附加信息汇总环形缓冲区中的事件，按去掉嵌套之后的总耗时从大到小排列。
+ * 比如name为"widget_paint"时得到每种控件的绘制耗时。
+ * @param {const char*} name 只汇总这个名称的事件，为NULL时汇总全部事件。
+ * @param {profiler_stat_t*} stats 用于返回统计信息。
+ * @param {uint32_t} max stats的大小。
+ *
+ * @return {uint32_t} 返回统计信息的个数。
+ */
+uint32_t profiler_get_stats(const char* name, profiler_stat_t* stats, uint32_t max);
+
+/**
+ * @method profiler_export_chrome_trace
+ * 把环形缓冲区中的事件导出为Chrome trace格式的JSON文件(可以用chrome://tracing或者Perfetto打开)。
+ * @param {const char*} filename 文件名。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t profiler_export_chrome_trace(const char* filename);
+
+/**
+ * @method profiler_deinit
+ * 停止记录并释放环形缓冲区，只能在其它线程都不再记录时调用(比如退出之前)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t profiler_deinit(void);
+
+/*
+ * 插桩用的宏，只有定义了WITH_PROFILER时才编译进来，否则什么也不做。
+ * 没有开始记录时只多一次判断，附加信息也不计算。
+ * PROFILER_BEGIN和PROFILER_END必须成对出现，中间不能直接return。
+ */
+#ifdef WITH_PROFILER
+#define PROFILER_BEGIN(name, detail)  \
+  do {                                \
+    if (profiler_is_enabled()) {      \
+      profiler_begin(name, detail);   \
+    } else {                          \
+      profiler_skip();                \
+    }                                 \
+  } while (0)
+#define PROFILER_END() profiler_end()
+#else
+#define PROFILER_BEGIN(name, detail)
+#define PROFILER_END()
+#endif /*WITH_PROFILER*/
+
+END_C_DECLS
+
+#endif /*TK_PROFILER_H*/
@@ -163,33 +163,39 @@ ret_t progress_bar_set_show_text(widget_t* widget, bool_t show_text) {
   return RET_OK;
 }
 
-static ret_t progress_bar_get_prop(widget_t* widget, const char* name, value_t* v) {
+static ret_t progress_bar_get_prop(widget_t* widget, prop_atom_t atom, value_t* v) {
   progress_bar_t* progress_bar = PROGRESS_BAR(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
-
-  if (strcmp(name, WIDGET_PROP_VALUE) == 0) {
-    value_set_uint8(v, progress_bar->value);
-    return RET_OK;
-  } else if (strcmp(name, WIDGET_PROP_VERTICAL) == 0) {
-    value_set_bool(v, progress_bar->vertical);
-    return RET_OK;
-  } else if (strcmp(name, WIDGET_PROP_SHOW_TEXT) == 0) {
-    value_set_bool(v, progress_bar->show_text);
-    return RET_OK;
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
+
+  switch (atom) {
+    case PROP_ATOM_VALUE:
+      value_set_uint8(v, progress_bar->value);
+      return RET_OK;
+    case PROP_ATOM_VERTICAL:
+      value_set_bool(v, progress_bar->vertical);
+      return RET_OK;
+    case PROP_ATOM_SHOW_TEXT:
+      value_set_bool(v, progress_bar->show_text);
+      return RET_OK;
+    default:
+      break;
   }
 
   return RET_NOT_FOUND;
 }
 
-static ret_t progress_bar_set_prop(widget_t* widget, const char* name, const value_t* v) {
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
-
-  if (strcmp(name, WIDGET_PROP_VALUE) == 0) {
-    return progress_bar_set_value(widget, value_int(v));
-  } else if (strcmp(name, WIDGET_PROP_VERTICAL) == 0) {
-    return progress_bar_set_vertical(widget, value_bool(v));
-  } else if (strcmp(name, WIDGET_PROP_SHOW_TEXT) == 0) {
-    return progress_bar_set_show_text(widget, value_bool(v));
+static ret_t progress_bar_set_prop(widget_t* widget, prop_atom_t atom, const value_t* v) {
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
+
+  switch (atom) {
+    case PROP_ATOM_VALUE:
+      return progress_bar_set_value(widget, value_int(v));
+    case PROP_ATOM_VERTICAL:
+      return progress_bar_set_vertical(widget, value_bool(v));
+    case PROP_ATOM_SHOW_TEXT:
+      return progress_bar_set_show_text(widget, value_bool(v));
+    default:
+      break;
   }
 
   return RET_NOT_FOUND;
@@ -0,0 +1,154 @@
+/**
+ * File:   prop_atom.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  interned widget property names
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-08 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/prop_atom.h"
+
+#ifndef PROP_ATOM_CAPACITY
+#define PROP_ATOM_CAPACITY 128
+#endif /*PROP_ATOM_CAPACITY*/
+
+/*桶的个数必须是2的幂，并且大于PROP_ATOM_CAPACITY，保证线性探测一定能找到空位。*/
+#define PROP_ATOM_BUCKETS (PROP_ATOM_CAPACITY * 2)
+
+static const char* s_builtin_names[PROP_ATOM_BUILTIN_NR] = {NULL,
+                                                           WIDGET_PROP_X,
+                                                           WIDGET_PROP_Y,
+                                                           WIDGET_PROP_W,
+                                                           WIDGET_PROP_H,
+                                                           WIDGET_PROP_NAME,
+                                                           WIDGET_PROP_VALUE,
+                                                           WIDGET_PROP_TEXT,
+                                                           WIDGET_PROP_STYLE,
+                                                           WIDGET_PROP_ENABLE,
+                                                           WIDGET_PROP_MARGIN,
+                                                           WIDGET_PROP_STEP,
+                                                           WIDGET_PROP_VISIBLE,
+                                                           WIDGET_PROP_ANIM_HINT,
+                                                           WIDGET_PROP_MIN,
+                                                           WIDGET_PROP_MAX,
+                                                           WIDGET_PROP_INPUT_TYPE,
+                                                           WIDGET_PROP_READONLY,
+                                                           WIDGET_PROP_VERTICAL,
+                                                           WIDGET_PROP_SHOW_TEXT,
+                                                           WIDGET_PROP_TIPS,
+                                                           WIDGET_PROP_IMAGE,
+                                                           WIDGET_PROP_DRAW_TYPE,
+                                                           WIDGET_PROP_LAYOUT,
+                                                           WIDGET_PROP_XOFFSET,
+                                                           WIDGET_PROP_YOFFSET,
+                                                           WIDGET_PROP_VIRTUAL_W,
+                                                           WIDGET_PROP_VIRTUAL_H,
+                                                           WIDGET_PROP_XSLIDABLE,
+                                                           WIDGET_PROP_YSLIDABLE,
+                                                           WIDGET_PROP_CACHE,
+                                                           WIDGET_PROP_OPACITY,
+                                                           WIDGET_PROP_LINE_WRAP};
+
+static bool_t s_inited = FALSE;
+static prop_atom_t s_nr = PROP_ATOM_BUILTIN_NR;
+static prop_atom_t s_buckets[PROP_ATOM_BUCKETS];
+static char* s_dynamic_names[PROP_ATOM_CAPACITY - PROP_ATOM_BUILTIN_NR];
+
+static uint32_t prop_atom_hash(const char* name) {
+  uint32_t hash = 5381;
+  const uint8_t* p = (const uint8_t*)name;
+
+  while (*p) {
+    hash = ((hash << 5) + hash) + *p++;
+  }
+
+  return hash;
+}
+
+const char* prop_atom_name(prop_atom_t atom) {
+  if (prop_atom_is_builtin(atom)) {
+    return s_builtin_names[atom];
+  } else if (atom >= PROP_ATOM_BUILTIN_NR && atom < s_nr) {
+    return s_dynamic_names[atom - PROP_ATOM_BUILTIN_NR];
+  }
+
+  return NULL;
+}
+
+static prop_atom_t* prop_atom_find_bucket(const char* name) {
+  uint32_t mask = PROP_ATOM_BUCKETS - 1;
+  uint32_t i = prop_atom_hash(name) & mask;
+
+  while (s_buckets[i] != PROP_ATOM_NONE) {
+    const char* iter = prop_atom_name(s_buckets[i]);
+    if (*iter == *name && strcmp(iter, name) == 0) {
+      break;
+    }
+    i = (i + 1) & mask;
+  }
+
+  return s_buckets + i;
+}
+
+static ret_t prop_atom_init(void) {
+  prop_atom_t i = 0;
+
+  for (i = PROP_ATOM_NONE + 1; i < PROP_ATOM_BUILTIN_NR; i++) {
+    *prop_atom_find_bucket(s_builtin_names[i]) = i;
+  }
+  s_inited = TRUE;
+
+  return RET_OK;
+}
+
+prop_atom_t prop_atom_lookup(const char* name) {
+  return_value_if_fail(name != NULL, PROP_ATOM_NONE);
+
+  if (!s_inited) {
+    prop_atom_init();
+  }
+
+  return *prop_atom_find_bucket(name);
+}
+
+prop_atom_t prop_atom_intern(const char* name) {
+  char* str = NULL;
+  uint32_t size = 0;
+  prop_atom_t* bucket = NULL;
+  return_value_if_fail(name != NULL && *name, PROP_ATOM_NONE);
+
+  if (!s_inited) {
+    prop_atom_init();
+  }
+
+  bucket = prop_atom_find_bucket(name);
+  if (*bucket != PROP_ATOM_NONE) {
+    return *bucket;
+  }
+
+  return_value_if_fail(s_nr < PROP_ATOM_CAPACITY, PROP_ATOM_NONE);
+
+  size = strlen(name) + 1;
+  str = (char*)TKMEM_ALLOC(size);
+  return_value_if_fail(str != NULL, PROP_ATOM_NONE);
+
+  memcpy(str, name, size);
+  s_dynamic_names[s_nr - PROP_ATOM_BUILTIN_NR] = str;
+  *bucket = s_nr++;
+
+  return *bucket;
+}
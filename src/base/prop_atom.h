@@ -0,0 +1,127 @@
+/**
+ * File:   prop_atom.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  interned widget property names
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-08 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_PROP_ATOM_H
+#define TK_PROP_ATOM_H
+
+#include "base/prop_names.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @enum prop_atom_id_t
+ * @prefix PROP_ATOM_
+ * 内置属性名对应的原子值。
+ * 二进制UI文件中保存的是这些值，所以只能在后面追加，不能修改已有的值。
+ */
+typedef enum _prop_atom_id_t {
+  /**
+   * @const PROP_ATOM_NONE
+   * 无效属性。
+   */
+  PROP_ATOM_NONE = 0,
+  PROP_ATOM_X,
+  PROP_ATOM_Y,
+  PROP_ATOM_W,
+  PROP_ATOM_H,
+  PROP_ATOM_NAME,
+  PROP_ATOM_VALUE,
+  PROP_ATOM_TEXT,
+  PROP_ATOM_STYLE,
+  PROP_ATOM_ENABLE,
+  PROP_ATOM_MARGIN,
+  PROP_ATOM_STEP,
+  PROP_ATOM_VISIBLE,
+  PROP_ATOM_ANIM_HINT,
+  PROP_ATOM_MIN,
+  PROP_ATOM_MAX,
+  PROP_ATOM_INPUT_TYPE,
+  PROP_ATOM_READONLY,
+  PROP_ATOM_VERTICAL,
+  PROP_ATOM_SHOW_TEXT,
+  PROP_ATOM_TIPS,
+  PROP_ATOM_IMAGE,
+  PROP_ATOM_DRAW_TYPE,
+  PROP_ATOM_LAYOUT,
+  PROP_ATOM_XOFFSET,
+  PROP_ATOM_YOFFSET,
+  PROP_ATOM_VIRTUAL_W,
+  PROP_ATOM_VIRTUAL_H,
+  PROP_ATOM_XSLIDABLE,
+  PROP_ATOM_YSLIDABLE,
+  PROP_ATOM_CACHE,
+  PROP_ATOM_OPACITY,
+  PROP_ATOM_LINE_WRAP,
+  /**
+   * @const PROP_ATOM_BUILTIN_NR
+   * 内置属性的个数。大于等于此值的原子由prop_atom_intern动态分配。
+   */
+  PROP_ATOM_BUILTIN_NR
+} prop_atom_id_t;
+
+/**
+ * 属性名的原子值。内置属性的原子值见prop_atom_id_t。
+ */
+typedef uint16_t prop_atom_t;
+
+/**
+ * @class prop_atom_t
+ * @fake
+ * 属性名原子化。
+ * 属性名在入口处(UI加载、脚本绑定)转换成整数，控件内部只比较整数，避免逐个strcmp。
+ */
+
+/**
+ * @method prop_atom_intern
+ * 获取属性名对应的原子，如果不存在则分配一个新的。
+ * 自定义控件应在创建时调用本函数得到自己属性的原子。
+ * @static
+ * @param {char*} name 属性名。
+ *
+ * @return {prop_atom_t} 返回原子，PROP_ATOM_NONE表示失败。
+ */
+prop_atom_t prop_atom_intern(const char* name);
+
+/**
+ * @method prop_atom_lookup
+ * 查找属性名对应的原子(不会分配新的原子)。
+ * @static
+ * @param {char*} name 属性名。
+ *
+ * @return {prop_atom_t} 返回原子，PROP_ATOM_NONE表示没有找到。
+ */
+prop_atom_t prop_atom_lookup(const char* name);
+
+/**
+ * @method prop_atom_name
+ * 获取原子对应的属性名。
+ * @static
+ * @param {prop_atom_t} atom 原子。
+ *
+ * @return {char*} 返回属性名，无效原子返回NULL。
+ */
+const char* prop_atom_name(prop_atom_t atom);
+
+#define prop_atom_is_builtin(atom) ((atom) > PROP_ATOM_NONE && (atom) < PROP_ATOM_BUILTIN_NR)
+
+END_C_DECLS
+
+#endif /*TK_PROP_ATOM_H*/
@@ -44,10 +44,24 @@ BEGIN_C_DECLS
 #define WIDGET_PROP_MAX "max"
 #define WIDGET_PROP_INPUT_TYPE "input_type"
 #define WIDGET_PROP_READONLY "readonly"
+#define WIDGET_PROP_TIPS "tips"
 
 #define WIDGET_PROP_VERTICAL "vertical"
 #define WIDGET_PROP_SHOW_TEXT "show_text"
 
+#define WIDGET_PROP_IMAGE "image"
+#define WIDGET_PROP_DRAW_TYPE "draw_type"
+#define WIDGET_PROP_LAYOUT "layout"
+#define WIDGET_PROP_XOFFSET "xoffset"
+#define WIDGET_PROP_YOFFSET "yoffset"
+#define WIDGET_PROP_VIRTUAL_W "virtual_w"
+#define WIDGET_PROP_VIRTUAL_H "virtual_h"
+#define WIDGET_PROP_XSLIDABLE "xslidable"
+#define WIDGET_PROP_YSLIDABLE "yslidable"
+#define WIDGET_PROP_CACHE "cache"
+#define WIDGET_PROP_OPACITY "opacity"
+#define WIDGET_PROP_LINE_WRAP "line_wrap"
+
 END_C_DECLS
 
 #endif /*TK_PROP_NAMES_H*/
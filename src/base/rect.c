@@ -42,6 +42,33 @@ ret_t rect_merge(rect_t* dr, rect_t* r) {
   return RET_OK;
 }
 
+ret_t rect_intersect(rect_t* dr, const rect_t* r) {
+  xy_t x = 0;
+  xy_t y = 0;
+  xy_t right = 0;
+  xy_t bottom = 0;
+  return_value_if_fail(r != NULL && dr != NULL, RET_BAD_PARAMS);
+
+  x = ftk_max(dr->x, r->x);
+  y = ftk_max(dr->y, r->y);
+  right = ftk_min((r->x + r->w), (dr->x + dr->w));
+  bottom = ftk_min((r->y + r->h), (dr->y + dr->h));
+
+  if (right > x && bottom > y) {
+    dr->x = x;
+    dr->y = y;
+    dr->w = right - x;
+    dr->h = bottom - y;
+  } else {
+    dr->x = 0;
+    dr->y = 0;
+    dr->w = 0;
+    dr->h = 0;
+  }
+
+  return RET_OK;
+}
+
 bool_t rect_contains(rect_t* r, xy_t x, xy_t y) {
   return_value_if_fail(r != NULL, FALSE);
 
@@ -0,0 +1,412 @@
+/**
+ * File:   render_thread.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  rasterize recorded frames in a render thread
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-20 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/atomic.h"
+#include "base/render_thread.h"
+
+/*
+ * 帧按顺序使用frames中的位置：GUI线程录制第submitted帧，渲染线程按同样的顺序回放。
+ * free_frames是空闲位置的个数，ready_frames是等待回放的帧数。
+ */
+
+/*在bitmap_destroy中等待的渲染线程。*/
+static render_thread_t* s_fenced = NULL;
+
+static uint32_t render_thread_frames_capacity(render_thread_t* rt) {
+  return rt->frames_nr + 1;
+}
+
+static void* render_thread_main(void* args) {
+  uint32_t r = 0;
+  render_thread_t* rt = RENDER_THREAD(args);
+  uint32_t capacity = render_thread_frames_capacity(rt);
+
+  for (;;) {
+    render_frame_t* frame = NULL;
+
+    tk_semaphore_wait(rt->ready_frames);
+    if (tk_atomic_load(&(rt->quit))) {
+      break;
+    }
+
+    frame = rt->frames + (r++ % capacity);
+    lcd_begin_frame(rt->target, &(frame->dirty), LCD_DRAW_NORMAL);
+    display_list_replay(frame->dl, rt->target, &(frame->dirty));
+    lcd_end_frame(rt->target);
+
+    tk_atomic_store(&(rt->presented), rt->presented + 1);
+    tk_semaphore_post(rt->free_frames);
+  }
+
+  return NULL;
+}
+
+ret_t render_thread_flush(render_thread_t* rt) {
+  uint32_t i = 0;
+  uint32_t nr = 0;
+  return_value_if_fail(rt != NULL, RET_BAD_PARAMS);
+
+  if (rt->direct) {
+    return RET_OK;
+  }
+
+  /*占住全部空闲位置，说明之前提交的帧都已经显示了。*/
+  nr = render_thread_frames_capacity(rt) - (rt->recording != NULL ? 1 : 0);
+  for (i = 0; i < nr; i++) {
+    tk_semaphore_wait(rt->free_frames);
+  }
+
+  for (i = 0; i < nr; i++) {
+    tk_semaphore_post(rt->free_frames);
+  }
+
+  return RET_OK;
+}
+
+static ret_t render_thread_apply_state(render_thread_t* rt, lcd_t* lcd) {
+  lcd_set_global_alpha(lcd, rt->lcd.global_alpha);
+  lcd_set_text_color(lcd, rt->lcd.text_color);
+  lcd_set_stroke_color(lcd, rt->lcd.stroke_color);
+
+  return lcd_set_fill_color(lcd, rt->lcd.fill_color);
+}
+
+/*本帧余下的部分改为在GUI线程中直接绘制，已经录制的命令先回放到target上。*/
+static ret_t render_thread_sync(render_thread_t* rt) {
+  render_frame_t* frame = rt->recording;
+
+  if (rt->direct) {
+    return RET_OK;
+  }
+
+  render_thread_flush(rt);
+  if (frame == NULL) {
+    return RET_OK;
+  }
+
+  lcd_begin_frame(rt->target, &(frame->dirty), LCD_DRAW_NORMAL);
+  display_list_replay(frame->dl, rt->target, &(frame->dirty));
+  rt->direct = TRUE;
+  rt->syncs++;
+
+  return RET_OK;
+}
+
+/*渲染线程回放时才读取图片的数据，销毁图片之前先等没有显示的帧显示完，正在录制的帧改为直接绘制。*/
+static ret_t render_thread_on_bitmap_destroy(void* ctx, bitmap_t* bitmap) {
+  render_thread_t* rt = RENDER_THREAD(ctx);
+
+  if (rt->recording != NULL) {
+    return render_thread_sync(rt);
+  }
+
+  if (rt->submitted != tk_atomic_load(&(rt->presented))) {
+    return render_thread_flush(rt);
+  }
+
+  return RET_OK;
+}
+
+static lcd_t* render_thread_current(render_thread_t* rt) {
+  if (rt->direct) {
+    return rt->target;
+  }
+
+  return rt->recording != NULL ? &(rt->recording->dl->lcd) : NULL;
+}
+
+static ret_t render_thread_begin_frame(lcd_t* lcd, rect_t* dirty_rect) {
+  lcd_t* dl = NULL;
+  render_frame_t* frame = NULL;
+  render_thread_t* rt = RENDER_THREAD(lcd);
+  return_value_if_fail(rt->recording == NULL, RET_BAD_PARAMS);
+
+  if (rt->submitted - tk_atomic_load(&(rt->presented)) >= rt->frames_nr) {
+    rt->waits++;
+  }
+
+  tk_semaphore_wait(rt->free_frames);
+  frame = rt->frames + (rt->submitted % render_thread_frames_capacity(rt));
+  if (dirty_rect != NULL) {
+    frame->dirty = *dirty_rect;
+  } else {
+    rect_init(frame->dirty, 0, 0, lcd->w, lcd->h);
+  }
+  lcd->dirty_rect = &(frame->dirty);
+  rt->recording = frame;
+
+  if (lcd->draw_mode != LCD_DRAW_NORMAL) {
+    render_thread_flush(rt);
+    rt->direct = TRUE;
+    rt->syncs++;
+    lcd_begin_frame(rt->target, &(frame->dirty), lcd->draw_mode);
+
+    return render_thread_apply_state(rt, rt->target);
+  }
+
+  /*显示列表开始录制时记录的是它自己的状态，先同步为当前的状态。*/
+  dl = &(frame->dl->lcd);
+  dl->global_alpha = lcd->global_alpha;
+  dl->text_color = lcd->text_color;
+  dl->stroke_color = lcd->stroke_color;
+  dl->fill_color = lcd->fill_color;
+
+  return lcd_begin_frame(dl, &(frame->dirty), LCD_DRAW_NORMAL);
+}
+
+static ret_t render_thread_end_frame(lcd_t* lcd) {
+  ret_t ret = RET_OK;
+  render_thread_t* rt = RENDER_THREAD(lcd);
+  return_value_if_fail(rt->recording != NULL, RET_BAD_PARAMS);
+
+  rt->recording = NULL;
+  if (rt->direct) {
+    rt->direct = FALSE;
+    ret = lcd_end_frame(rt->target);
+    tk_semaphore_post(rt->free_frames);
+  } else {
+    rt->submitted++;
+    tk_semaphore_post(rt->ready_frames);
+  }
+
+  return ret;
+}
+
+static ret_t render_thread_set_global_alpha(lcd_t* lcd, uint8_t alpha) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+
+  return current != NULL ? lcd_set_global_alpha(current, alpha) : RET_OK;
+}
+
+static ret_t render_thread_set_text_color(lcd_t* lcd, color_t color) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+
+  return current != NULL ? lcd_set_text_color(current, color) : RET_OK;
+}
+
+static ret_t render_thread_set_stroke_color(lcd_t* lcd, color_t color) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+
+  return current != NULL ? lcd_set_stroke_color(current, color) : RET_OK;
+}
+
+static ret_t render_thread_set_fill_color(lcd_t* lcd, color_t color) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+
+  return current != NULL ? lcd_set_fill_color(current, color) : RET_OK;
+}
+
+static ret_t render_thread_draw_vline(lcd_t* lcd, xy_t x, xy_t y, wh_t h) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+  return_value_if_fail(current != NULL, RET_FAIL);
+
+  return lcd_draw_vline(current, x, y, h);
+}
+
+static ret_t render_thread_draw_hline(lcd_t* lcd, xy_t x, xy_t y, wh_t w) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+  return_value_if_fail(current != NULL, RET_FAIL);
+
+  return lcd_draw_hline(current, x, y, w);
+}
+
+static ret_t render_thread_fill_rect(lcd_t* lcd, xy_t x, xy_t y, wh_t w, wh_t h) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+  return_value_if_fail(current != NULL, RET_FAIL);
+
+  return lcd_fill_rect(current, x, y, w, h);
+}
+
+static ret_t render_thread_draw_points(lcd_t* lcd, point_t* points, uint32_t nr) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+  return_value_if_fail(current != NULL, RET_FAIL);
+
+  return lcd_draw_points(current, points, nr);
+}
+
+static ret_t render_thread_draw_glyph(lcd_t* lcd, glyph_t* glyph, rect_t* src, xy_t x, xy_t y) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+  return_value_if_fail(current != NULL, RET_FAIL);
+
+  return lcd_draw_glyph(current, glyph, src, x, y);
+}
+
+static ret_t render_thread_draw_glyphs(lcd_t* lcd, lcd_glyph_t* glyphs, uint32_t nr,
+                                       rect_t* bounds) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+  return_value_if_fail(current != NULL, RET_FAIL);
+
+  return lcd_draw_glyphs(current, glyphs, nr, bounds);
+}
+
+static ret_t render_thread_draw_image(lcd_t* lcd, bitmap_t* img, rect_t* src, rect_t* dst) {
+  lcd_t* current = render_thread_current(RENDER_THREAD(lcd));
+  return_value_if_fail(current != NULL, RET_FAIL);
+
+  return lcd_draw_image(current, img, src, dst);
+}
+
+static color_t render_thread_get_point_color(lcd_t* lcd, xy_t x, xy_t y) {
+  render_thread_t* rt = RENDER_THREAD(lcd);
+
+  render_thread_sync(rt);
+
+  return lcd_get_point_color(rt->target, x, y);
+}
+
+static vgcanvas_t* render_thread_get_vgcanvas(lcd_t* lcd) {
+  render_thread_t* rt = RENDER_THREAD(lcd);
+
+  render_thread_sync(rt);
+
+  return lcd_get_vgcanvas(rt->target);
+}
+
+static ret_t render_thread_take_snapshot(lcd_t* lcd, bitmap_t* img) {
+  render_thread_t* rt = RENDER_THREAD(lcd);
+
+  render_thread_sync(rt);
+
+  return lcd_take_snapshot(rt->target, img);
+}
+
+static lcd_t* render_thread_create_layer(lcd_t* lcd, bitmap_t* img) {
+  render_thread_t* rt = RENDER_THREAD(lcd);
+
+  /*离屏缓冲区可能还被没有显示的帧引用，等它们显示完再重新绘制。*/
+  render_thread_sync(rt);
+
+  return lcd_create_layer(rt->target, img);
+}
+
+static ret_t render_thread_scroll(lcd_t* lcd, rect_t* r, xy_t dx, xy_t dy) {
+  render_thread_t* rt = RENDER_THREAD(lcd);
+
+  render_thread_sync(rt);
+
+  return lcd_scroll(rt->target, r, dx, dy);
+}
+
+static ret_t render_thread_destroy(lcd_t* lcd) {
+  uint32_t i = 0;
+  render_thread_t* rt = RENDER_THREAD(lcd);
+
+  if (s_fenced == rt) {
+    bitmap_set_destroy_fence(NULL, NULL);
+    s_fenced = NULL;
+  }
+
+  if (rt->thread != NULL) {
+    render_thread_flush(rt);
+    tk_atomic_store(&(rt->quit), TRUE);
+    tk_semaphore_post(rt->ready_frames);
+    tk_thread_join(rt->thread);
+  }
+
+  for (i = 0; i < ARRAY_SIZE(rt->frames); i++) {
+    if (rt->frames[i].dl != NULL) {
+      lcd_destroy(&(rt->frames[i].dl->lcd));
+    }
+  }
+
+  if (rt->free_frames != NULL) {
+    tk_semaphore_destroy(rt->free_frames);
+  }
+
+  if (rt->ready_frames != NULL) {
+    tk_semaphore_destroy(rt->ready_frames);
+  }
+
+  TKMEM_FREE(rt);
+
+  return RET_OK;
+}
+
+render_thread_t* render_thread_create(lcd_t* target, uint32_t frames_nr) {
+  uint32_t i = 0;
+  lcd_t* lcd = NULL;
+  render_thread_t* rt = NULL;
+  return_value_if_fail(target != NULL && target->type != LCD_VGCANVAS, NULL);
+  return_value_if_fail(frames_nr > 0 && frames_nr <= RENDER_THREAD_MAX_FRAMES, NULL);
+
+  rt = TKMEM_ZALLOC(render_thread_t);
+  return_value_if_fail(rt != NULL, NULL);
+
+  lcd = &(rt->lcd);
+  lcd->begin_frame = render_thread_begin_frame;
+  lcd->set_global_alpha = render_thread_set_global_alpha;
+  lcd->set_text_color = render_thread_set_text_color;
+  lcd->set_stroke_color = render_thread_set_stroke_color;
+  lcd->set_fill_color = render_thread_set_fill_color;
+  lcd->draw_vline = render_thread_draw_vline;
+  lcd->draw_hline = render_thread_draw_hline;
+  lcd->fill_rect = render_thread_fill_rect;
+  lcd->draw_image = render_thread_draw_image;
+  lcd->draw_glyph = render_thread_draw_glyph;
+  lcd->draw_glyphs = render_thread_draw_glyphs;
+  lcd->draw_points = render_thread_draw_points;
+  lcd->end_frame = render_thread_end_frame;
+  lcd->destroy = render_thread_destroy;
+
+  /*target不支持的功能，这里也不支持，调用者据此选择其它的绘制方式。*/
+  lcd->get_point_color = target->get_point_color != NULL ? render_thread_get_point_color : NULL;
+  lcd->get_vgcanvas = target->get_vgcanvas != NULL ? render_thread_get_vgcanvas : NULL;
+  lcd->take_snapshot = target->take_snapshot != NULL ? render_thread_take_snapshot : NULL;
+  lcd->create_layer = target->create_layer != NULL ? render_thread_create_layer : NULL;
+  lcd->scroll = target->scroll != NULL ? render_thread_scroll : NULL;
+
+  lcd->w = target->w;
+  lcd->h = target->h;
+  lcd->type = target->type;
+  lcd->ratio = target->ratio;
+  lcd->global_alpha = 0xff;
+
+  rt->target = target;
+  rt->frames_nr = frames_nr;
+  rt->free_frames = tk_semaphore_create(render_thread_frames_capacity(rt));
+  rt->ready_frames = tk_semaphore_create(0);
+  for (i = 0; i < render_thread_frames_capacity(rt); i++) {
+    rt->frames[i].dl = display_list_create(target->w, target->h);
+    if (rt->frames[i].dl == NULL) {
+      render_thread_destroy(lcd);
+      return NULL;
+    }
+  }
+
+  if (rt->free_frames == NULL || rt->ready_frames == NULL) {
+    render_thread_destroy(lcd);
+    return NULL;
+  }
+
+  rt->thread = tk_thread_create(render_thread_main, rt);
+  if (rt->thread == NULL) {
+    render_thread_destroy(lcd);
+    return NULL;
+  }
+
+  if (s_fenced == NULL) {
+    bitmap_set_destroy_fence(render_thread_on_bitmap_destroy, rt);
+    s_fenced = rt;
+  }
+
+  return rt;
+}
@@ -0,0 +1,141 @@
+/**
+ * File:   render_thread.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  rasterize recorded frames in a render thread
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-20 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_RENDER_THREAD_H
+#define TK_RENDER_THREAD_H
+
+#include "base/thread.h"
+#include "base/display_list.h"
+
+BEGIN_C_DECLS
+
+#ifndef RENDER_THREAD_MAX_FRAMES
+#define RENDER_THREAD_MAX_FRAMES 3
+#endif /*RENDER_THREAD_MAX_FRAMES*/
+
+typedef struct _render_frame_t {
+  display_list_t* dl;
+  rect_t dirty;
+} render_frame_t;
+
+/**
+ * @class render_thread_t
+ * @parent lcd_t
+ * 渲染线程。
+ * 它本身是一个lcd，代替真正的lcd交给canvas：GUI线程绘制时只把脏矩形内的绘制命令记录到显示列表，
+ * end_frame时交给渲染线程，由渲染线程在真正的lcd上回放并显示，GUI线程接着处理下一批事件。
+ *
+ * 每一帧用一个显示列表，最多有frames_nr帧在渲染线程中等待或者正在回放，
+ * 另外一个显示列表给GUI线程录制下一帧(frames_nr为1时就是双缓冲)。超过时begin_frame等待渲染线程，
+ * 避免GUI线程跑得太快，显示的内容落后太多。
+ *
+ * 需要直接访问lcd的操作(scroll/take_snapshot/create_layer/get_vgcanvas/get_point_color)
+ * 以及非正常模式(动画、离线)的帧，先等渲染线程完成之前的帧，本帧余下部分在GUI线程中直接绘制。
+ *
+ * 注意：
+ * 1.真正的lcd的begin_frame/end_frame和绘制函数在渲染线程中调用，必须可以在其它线程中使用，
+ *   适用于framebuffer和寄存器类型的lcd，不支持vgcanvas类型的lcd。
+ * 2.与display_list相同，字模和图片的数据在回放完成之前必须有效。
+ *   渲染线程在bitmap_destroy中等待引用图片的帧显示完(同时只有一个渲染线程这样做)，
+ *   不通过bitmap_destroy释放的数据，释放之前先调用render_thread_flush。
+ *
+ * 用法：
+ *
+ * ```
+ * render_thread_t* rt = render_thread_create(lcd, 1);
+ * canvas_init(&canvas, &(rt->lcd), font_manager());
+ * ```
+ */
+typedef struct _render_thread_t {
+  lcd_t lcd;
+
+  /**
+   * @property {lcd_t*} target
+   * @readonly
+   * 真正的lcd(不由渲染线程销毁)。
+   */
+  lcd_t* target;
+  /**
+   * @property {uint32_t} frames_nr
+   * @readonly
+   * 最多有多少帧交给了渲染线程但还没有显示。
+   */
+  uint32_t frames_nr;
+  /**
+   * @property {uint32_t} submitted
+   * @readonly
+   * 交给渲染线程的帧数。
+   */
+  uint32_t submitted;
+  /**
+   * @property {uint32_t} presented
+   * @readonly
+   * 渲染线程已经显示的帧数。
+   */
+  volatile uint32_t presented;
+  /**
+   * @property {uint32_t} waits
+   * @readonly
+   * 因为渲染线程来不及处理，GUI线程等待的次数。
+   */
+  uint32_t waits;
+  /**
+   * @property {uint32_t} syncs
+   * @readonly
+   * 在GUI线程中直接绘制的帧数。
+   */
+  uint32_t syncs;
+
+  /*private*/
+  render_frame_t frames[RENDER_THREAD_MAX_FRAMES + 1];
+  render_frame_t* recording;
+  bool_t direct;
+  volatile uint32_t quit;
+  tk_thread_t* thread;
+  tk_semaphore_t* free_frames;
+  tk_semaphore_t* ready_frames;
+} render_thread_t;
+
+/**
+ * @method render_thread_create
+ * @constructor
+ * 创建渲染线程。
+ * @param {lcd_t*} target 真正的lcd。
+ * @param {uint32_t} frames_nr 最多有多少帧交给了渲染线程但还没有显示(1-RENDER_THREAD_MAX_FRAMES)。
+ *
+ * @return {render_thread_t*} 返回渲染线程对象，用lcd_destroy销毁。
+ */
+render_thread_t* render_thread_create(lcd_t* target, uint32_t frames_nr);
+
+/**
+ * @method render_thread_flush
+ * 等待渲染线程显示完已经提交的帧。之后可以在GUI线程中安全地访问target。
+ * @param {render_thread_t*} rt 渲染线程对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t render_thread_flush(render_thread_t* rt);
+
+#define RENDER_THREAD(lcd) ((render_thread_t*)(lcd))
+
+END_C_DECLS
+
+#endif /*TK_RENDER_THREAD_H*/
@@ -0,0 +1,368 @@
+/**
+ * File:   scroll_view.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  scroll view
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-11 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/time.h"
+#include "base/scroll_view.h"
+#include "base/widget_vtable.h"
+#include "base/window_manager.h"
+#include "base/frame_scheduler.h"
+
+#define SCROLL_VIEW_DRAG_THRESHOLD 5
+#define SCROLL_VIEW_FLING_FRICTION 0.002f
+#define SCROLL_VIEW_FLING_MIN_VELOCITY 0.05f
+
+static int32_t scroll_view_clamp(int32_t offset, wh_t virtual_size, wh_t size) {
+  int32_t max_offset = virtual_size - size;
+
+  offset = ftk_min(offset, max_offset);
+
+  return ftk_max(offset, 0);
+}
+
+ret_t scroll_view_scroll_to(widget_t* widget, int32_t xoffset, int32_t yoffset) {
+  rect_t exposed;
+  uint32_t i = 0;
+  int32_t dx = 0;
+  int32_t dy = 0;
+  widget_t* wm = window_manager();
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+  return_value_if_fail(scroll_view != NULL, RET_BAD_PARAMS);
+
+  xoffset = scroll_view_clamp(xoffset, scroll_view->virtual_w, widget->w);
+  yoffset = scroll_view_clamp(yoffset, scroll_view->virtual_h, widget->h);
+  dx = scroll_view->xoffset - xoffset;
+  dy = scroll_view->yoffset - yoffset;
+
+  if (dx == 0 && dy == 0) {
+    return RET_OK;
+  }
+
+  scroll_view->xoffset = xoffset;
+  scroll_view->yoffset = yoffset;
+
+  /*子控件整体平移，相对位置不变，不需要触发move事件，也不需要逐个刷新。*/
+  if (widget->children != NULL) {
+    for (i = 0; i < widget->children->size; i++) {
+      widget_t* iter = (widget_t*)(widget->children->elms[i]);
+      iter->x += dx;
+      iter->y += dy;
+    }
+  }
+
+  if (wm != NULL && window_manager_scroll(wm, widget, dx, dy, &exposed) == RET_OK) {
+    return widget_invalidate(widget, &exposed);
+  }
+
+  return widget_invalidate(widget, NULL);
+}
+
+ret_t scroll_view_set_virtual_wh(widget_t* widget, wh_t w, wh_t h) {
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+  return_value_if_fail(scroll_view != NULL, RET_BAD_PARAMS);
+
+  scroll_view->virtual_w = w;
+  scroll_view->virtual_h = h;
+
+  return scroll_view_scroll_to(widget, scroll_view->xoffset, scroll_view->yoffset);
+}
+
+ret_t scroll_view_set_xslidable(widget_t* widget, bool_t xslidable) {
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+  return_value_if_fail(scroll_view != NULL, RET_BAD_PARAMS);
+
+  scroll_view->xslidable = xslidable;
+
+  return RET_OK;
+}
+
+ret_t scroll_view_set_yslidable(widget_t* widget, bool_t yslidable) {
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+  return_value_if_fail(scroll_view != NULL, RET_BAD_PARAMS);
+
+  scroll_view->yslidable = yslidable;
+
+  return RET_OK;
+}
+
+static float scroll_view_slow_down(float velocity, float friction) {
+  if (velocity > friction) {
+    return velocity - friction;
+  } else if (velocity < -friction) {
+    return velocity + friction;
+  }
+
+  return 0;
+}
+
+static bool_t scroll_view_is_slow(float velocity) {
+  return velocity < SCROLL_VIEW_FLING_MIN_VELOCITY && velocity > -SCROLL_VIEW_FLING_MIN_VELOCITY;
+}
+
+static ret_t scroll_view_on_fling(const frame_info_t* info) {
+  int32_t xoffset = 0;
+  int32_t yoffset = 0;
+  uint32_t now = info->now;
+  widget_t* widget = WIDGETP(info->ctx);
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+  uint32_t elapsed = now - scroll_view->last_time;
+  float friction = SCROLL_VIEW_FLING_FRICTION * elapsed;
+
+  xoffset = scroll_view->xoffset + (int32_t)(scroll_view->xvelocity * elapsed);
+  yoffset = scroll_view->yoffset + (int32_t)(scroll_view->yvelocity * elapsed);
+  scroll_view->last_time = now;
+  scroll_view->xvelocity = scroll_view_slow_down(scroll_view->xvelocity, friction);
+  scroll_view->yvelocity = scroll_view_slow_down(scroll_view->yvelocity, friction);
+
+  scroll_view_scroll_to(widget, xoffset, yoffset);
+
+  /*到达边界的方向停止滚动。*/
+  if (scroll_view->xoffset != xoffset) {
+    scroll_view->xvelocity = 0;
+  }
+  if (scroll_view->yoffset != yoffset) {
+    scroll_view->yvelocity = 0;
+  }
+
+  if (scroll_view_is_slow(scroll_view->xvelocity) && scroll_view_is_slow(scroll_view->yvelocity)) {
+    scroll_view->xvelocity = 0;
+    scroll_view->yvelocity = 0;
+    scroll_view->timer_id = 0;
+
+    return RET_REMOVE;
+  }
+
+  return RET_REPEAT;
+}
+
+static ret_t scroll_view_stop_fling(scroll_view_t* scroll_view) {
+  if (scroll_view->timer_id != 0) {
+    frame_scheduler_remove(frame_scheduler(), scroll_view->timer_id);
+    scroll_view->timer_id = 0;
+  }
+  scroll_view->xvelocity = 0;
+  scroll_view->yvelocity = 0;
+
+  return RET_OK;
+}
+
+ret_t scroll_view_fling(widget_t* widget, float xvelocity, float yvelocity) {
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+  return_value_if_fail(scroll_view != NULL, RET_BAD_PARAMS);
+
+  scroll_view_stop_fling(scroll_view);
+  if (scroll_view_is_slow(xvelocity) && scroll_view_is_slow(yvelocity)) {
+    return RET_OK;
+  }
+
+  scroll_view->xvelocity = xvelocity;
+  scroll_view->yvelocity = yvelocity;
+  scroll_view->last_time = frame_scheduler_now(frame_scheduler());
+  scroll_view->timer_id = frame_scheduler_add(frame_scheduler(), scroll_view_on_fling, widget, 0);
+
+  return scroll_view->timer_id != 0 ? RET_OK : RET_FAIL;
+}
+
+static ret_t scroll_view_on_pointer_move(widget_t* widget, pointer_event_t* evt) {
+  uint32_t now = 0;
+  uint32_t elapsed = 0;
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+  xy_t dx = scroll_view->xslidable ? evt->x - scroll_view->down.x : 0;
+  xy_t dy = scroll_view->yslidable ? evt->y - scroll_view->down.y : 0;
+
+  if (!scroll_view->dragging) {
+    if (dx > SCROLL_VIEW_DRAG_THRESHOLD || dx < -SCROLL_VIEW_DRAG_THRESHOLD ||
+        dy > SCROLL_VIEW_DRAG_THRESHOLD || dy < -SCROLL_VIEW_DRAG_THRESHOLD) {
+      scroll_view->dragging = TRUE;
+      widget->target = NULL;
+      widget_grab(widget->parent, widget);
+    } else {
+      return RET_OK;
+    }
+  }
+
+  now = time_now_ms();
+  elapsed = now - scroll_view->last_time;
+  if (elapsed > 0) {
+    float vx = scroll_view->xslidable ? (float)(scroll_view->last.x - evt->x) / elapsed : 0;
+    float vy = scroll_view->yslidable ? (float)(scroll_view->last.y - evt->y) / elapsed : 0;
+
+    scroll_view->xvelocity = vx * 0.8f + scroll_view->xvelocity * 0.2f;
+    scroll_view->yvelocity = vy * 0.8f + scroll_view->yvelocity * 0.2f;
+    scroll_view->last_time = now;
+    scroll_view->last.x = evt->x;
+    scroll_view->last.y = evt->y;
+  }
+
+  return scroll_view_scroll_to(widget, scroll_view->down_xoffset - dx,
+                               scroll_view->down_yoffset - dy);
+}
+
+static ret_t scroll_view_on_event(widget_t* widget, event_t* e) {
+  uint16_t type = e->type;
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+
+  switch (type) {
+    case EVT_POINTER_DOWN: {
+      pointer_event_t* evt = (pointer_event_t*)e;
+
+      scroll_view_stop_fling(scroll_view);
+      scroll_view->pressed = TRUE;
+      scroll_view->down.x = evt->x;
+      scroll_view->down.y = evt->y;
+      scroll_view->last = scroll_view->down;
+      scroll_view->down_xoffset = scroll_view->xoffset;
+      scroll_view->down_yoffset = scroll_view->yoffset;
+      scroll_view->last_time = time_now_ms();
+      break;
+    }
+    case EVT_POINTER_MOVE: {
+      if (scroll_view->pressed) {
+        scroll_view_on_pointer_move(widget, (pointer_event_t*)e);
+      }
+      break;
+    }
+    case EVT_POINTER_UP: {
+      if (scroll_view->dragging) {
+        widget_ungrab(widget->parent, widget);
+        scroll_view_fling(widget, scroll_view->xvelocity, scroll_view->yvelocity);
+      }
+      scroll_view->pressed = FALSE;
+      scroll_view->dragging = FALSE;
+      break;
+    }
+    case EVT_RESIZE:
+    case EVT_MOVE_RESIZE: {
+      scroll_view_scroll_to(widget, scroll_view->xoffset, scroll_view->yoffset);
+      break;
+    }
+    default:
+      break;
+  }
+
+  return RET_OK;
+}
+
+static widget_t* scroll_view_find_target(widget_t* widget, xy_t x, xy_t y) {
+  point_t p = {x, y};
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+
+  /*拖动时子控件不响应指针事件。*/
+  if (scroll_view->dragging) {
+    return NULL;
+  }
+
+  /*子控件可能有一部分在视图外面，外面的部分不能响应指针事件。*/
+  widget_to_local(widget, &p);
+  if (p.x < 0 || p.y < 0 || p.x >= widget->w || p.y >= widget->h) {
+    return NULL;
+  }
+
+  return widget_find_target_default(widget, x, y);
+}
+
+static ret_t scroll_view_get_prop(widget_t* widget, prop_atom_t atom, value_t* v) {
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
+
+  switch (atom) {
+    case PROP_ATOM_VIRTUAL_W:
+      value_set_int(v, scroll_view->virtual_w);
+      return RET_OK;
+    case PROP_ATOM_VIRTUAL_H:
+      value_set_int(v, scroll_view->virtual_h);
+      return RET_OK;
+    case PROP_ATOM_XOFFSET:
+      value_set_int(v, scroll_view->xoffset);
+      return RET_OK;
+    case PROP_ATOM_YOFFSET:
+      value_set_int(v, scroll_view->yoffset);
+      return RET_OK;
+    case PROP_ATOM_XSLIDABLE:
+      value_set_bool(v, scroll_view->xslidable);
+      return RET_OK;
+    case PROP_ATOM_YSLIDABLE:
+      value_set_bool(v, scroll_view->yslidable);
+      return RET_OK;
+    default:
+      break;
+  }
+
+  return RET_NOT_FOUND;
+}
+
+static ret_t scroll_view_set_prop(widget_t* widget, prop_atom_t atom, const value_t* v) {
+  scroll_view_t* scroll_view = SCROLL_VIEW(widget);
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
+
+  switch (atom) {
+    case PROP_ATOM_VIRTUAL_W:
+      return scroll_view_set_virtual_wh(widget, value_int(v), scroll_view->virtual_h);
+    case PROP_ATOM_VIRTUAL_H:
+      return scroll_view_set_virtual_wh(widget, scroll_view->virtual_w, value_int(v));
+    case PROP_ATOM_XOFFSET:
+      return scroll_view_scroll_to(widget, value_int(v), scroll_view->yoffset);
+    case PROP_ATOM_YOFFSET:
+      return scroll_view_scroll_to(widget, scroll_view->xoffset, value_int(v));
+    case PROP_ATOM_XSLIDABLE:
+      return scroll_view_set_xslidable(widget, value_bool(v));
+    case PROP_ATOM_YSLIDABLE:
+      return scroll_view_set_yslidable(widget, value_bool(v));
+    default:
+      break;
+  }
+
+  return RET_NOT_FOUND;
+}
+
+static ret_t scroll_view_on_paint_self(widget_t* widget, canvas_t* c) {
+  return widget_paint_helper(widget, c, NULL, NULL);
+}
+
+static ret_t scroll_view_destroy(widget_t* widget) {
+  return scroll_view_stop_fling(SCROLL_VIEW(widget));
+}
+
+static const widget_vtable_t s_scroll_view_vtable = {
+    .on_paint_self = scroll_view_on_paint_self,
+    .on_paint_children = widget_on_paint_children_clip,
+    .on_event = scroll_view_on_event,
+    .find_target = scroll_view_find_target,
+    .get_prop = scroll_view_get_prop,
+    .set_prop = scroll_view_set_prop,
+    .destroy = scroll_view_destroy};
+
+widget_t* scroll_view_create(widget_t* parent, xy_t x, xy_t y, wh_t w, wh_t h) {
+  widget_t* widget = NULL;
+  scroll_view_t* scroll_view = TKMEM_ZALLOC(scroll_view_t);
+  return_value_if_fail(scroll_view != NULL, NULL);
+
+  widget = WIDGETP(scroll_view);
+  widget_init(widget, parent, WIDGET_SCROLL_VIEW);
+  widget->vt = &s_scroll_view_vtable;
+  scroll_view->xslidable = TRUE;
+  scroll_view->yslidable = TRUE;
+  widget_move_resize(widget, x, y, w, h);
+
+  widget_set_state(widget, WIDGET_STATE_NORMAL);
+
+  return widget;
+}
@@ -0,0 +1,159 @@
+/**
+ * File:   scroll_view.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  scroll view
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-11 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_SCROLL_VIEW_H
+#define TK_SCROLL_VIEW_H
+
+#include "base/widget.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @class scroll_view_t
+ * @parent widget_t
+ * @scriptable
+ * 滚动视图控件。子控件位于一个大小为virtual_w x virtual_h的虚拟区域中，通过拖动或者惯性滚动浏览。
+ * LCD支持移动像素(lcd_scroll)时，滚动只重绘新露出的部分，其它部分直接在帧缓冲中移动。
+ */
+typedef struct _scroll_view_t {
+  widget_t widget;
+  /**
+   * @property {wh_t} virtual_w
+   * @readonly
+   * 虚拟宽度。
+   */
+  wh_t virtual_w;
+  /**
+   * @property {wh_t} virtual_h
+   * @readonly
+   * 虚拟高度。
+   */
+  wh_t virtual_h;
+  /**
+   * @property {int32_t} xoffset
+   * @readonly
+   * x方向的偏移量。
+   */
+  int32_t xoffset;
+  /**
+   * @property {int32_t} yoffset
+   * @readonly
+   * y方向的偏移量。
+   */
+  int32_t yoffset;
+  /**
+   * @property {bool_t} xslidable
+   * @readonly
+   * 是否允许x方向滑动。
+   */
+  bool_t xslidable;
+  /**
+   * @property {bool_t} yslidable
+   * @readonly
+   * 是否允许y方向滑动。
+   */
+  bool_t yslidable;
+
+  /*private*/
+  bool_t pressed;
+  bool_t dragging;
+  point_t down;
+  point_t last;
+  int32_t down_xoffset;
+  int32_t down_yoffset;
+  uint32_t last_time;
+  float xvelocity;
+  float yvelocity;
+  uint32_t timer_id;
+} scroll_view_t;
+
+/**
+ * @method scroll_view_create
+ * @constructor
+ * 创建scroll_view对象
+ * @param {widget_t*} parent 父控件
+ * @param {xy_t} x x坐标
+ * @param {xy_t} y y坐标
+ * @param {wh_t} w 宽度
+ * @param {wh_t} h 高度
+ *
+ * @return {widget_t*} 对象。
+ */
+widget_t* scroll_view_create(widget_t* parent, xy_t x, xy_t y, wh_t w, wh_t h);
+
+/**
+ * @method scroll_view_set_virtual_wh
+ * 设置虚拟区域的大小。
+ * @param {widget_t*} widget 控件对象。
+ * @param {wh_t} w 虚拟宽度。
+ * @param {wh_t} h 虚拟高度。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t scroll_view_set_virtual_wh(widget_t* widget, wh_t w, wh_t h);
+
+/**
+ * @method scroll_view_set_xslidable
+ * 设置是否允许x方向滑动。
+ * @param {widget_t*} widget 控件对象。
+ * @param {bool_t} xslidable 是否允许滑动。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t scroll_view_set_xslidable(widget_t* widget, bool_t xslidable);
+
+/**
+ * @method scroll_view_set_yslidable
+ * 设置是否允许y方向滑动。
+ * @param {widget_t*} widget 控件对象。
+ * @param {bool_t} yslidable 是否允许滑动。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t scroll_view_set_yslidable(widget_t* widget, bool_t yslidable);
+
+/**
+ * @method scroll_view_scroll_to
+ * 滚动到指定的偏移量。
+ * @param {widget_t*} widget 控件对象。
+ * @param {int32_t} xoffset x方向的偏移量(会被限制在有效范围内)。
+ * @param {int32_t} yoffset y方向的偏移量(会被限制在有效范围内)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t scroll_view_scroll_to(widget_t* widget, int32_t xoffset, int32_t yoffset);
+
+/**
+ * @method scroll_view_fling
+ * 以指定的初速度惯性滚动。
+ * @param {widget_t*} widget 控件对象。
+ * @param {float} xvelocity x方向的速度(像素/毫秒)。
+ * @param {float} yvelocity y方向的速度(像素/毫秒)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t scroll_view_fling(widget_t* widget, float xvelocity, float yvelocity);
+
+#define SCROLL_VIEW(widget) ((scroll_view_t*)(widget))
+
+END_C_DECLS
+
+#endif /*TK_SCROLL_VIEW_H*/
@@ -287,43 +287,49 @@ ret_t slider_set_vertical(widget_t* widget, bool_t vertical) {
   return RET_OK;
 }
 
-static ret_t slider_get_prop(widget_t* widget, const char* name, value_t* v) {
+static ret_t slider_get_prop(widget_t* widget, prop_atom_t atom, value_t* v) {
   slider_t* slider = SLIDER(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
-
-  if (strcmp(name, "value") == 0) {
-    value_set_int(v, slider->value);
-    return RET_OK;
-  } else if (strcmp(name, "vertical") == 0) {
-    value_set_bool(v, slider->vertical);
-    return RET_OK;
-  } else if (strcmp(name, "min") == 0) {
-    value_set_int(v, slider->min);
-    return RET_OK;
-  } else if (strcmp(name, "max") == 0) {
-    value_set_int(v, slider->max);
-    return RET_OK;
-  } else if (strcmp(name, "step") == 0) {
-    value_set_int(v, slider->step);
-    return RET_OK;
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
+
+  switch (atom) {
+    case PROP_ATOM_VALUE:
+      value_set_int(v, slider->value);
+      return RET_OK;
+    case PROP_ATOM_VERTICAL:
+      value_set_bool(v, slider->vertical);
+      return RET_OK;
+    case PROP_ATOM_MIN:
+      value_set_int(v, slider->min);
+      return RET_OK;
+    case PROP_ATOM_MAX:
+      value_set_int(v, slider->max);
+      return RET_OK;
+    case PROP_ATOM_STEP:
+      value_set_int(v, slider->step);
+      return RET_OK;
+    default:
+      break;
   }
 
   return RET_NOT_FOUND;
 }
 
-static ret_t slider_set_prop(widget_t* widget, const char* name, const value_t* v) {
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
-
-  if (strcmp(name, "value") == 0) {
-    return slider_set_value(widget, value_int(v));
-  } else if (strcmp(name, "vertical") == 0) {
-    return slider_set_vertical(widget, value_bool(v));
-  } else if (strcmp(name, "min") == 0) {
-    return slider_set_min(widget, value_int(v));
-  } else if (strcmp(name, "max") == 0) {
-    return slider_set_max(widget, value_int(v));
-  } else if (strcmp(name, "step") == 0) {
-    return slider_set_step(widget, value_int(v));
+static ret_t slider_set_prop(widget_t* widget, prop_atom_t atom, const value_t* v) {
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
+
+  switch (atom) {
+    case PROP_ATOM_VALUE:
+      return slider_set_value(widget, value_int(v));
+    case PROP_ATOM_VERTICAL:
+      return slider_set_vertical(widget, value_bool(v));
+    case PROP_ATOM_MIN:
+      return slider_set_min(widget, value_int(v));
+    case PROP_ATOM_MAX:
+      return slider_set_max(widget, value_int(v));
+    case PROP_ATOM_STEP:
+      return slider_set_step(widget, value_int(v));
+    default:
+      break;
   }
 
   return RET_NOT_FOUND;
@@ -0,0 +1,162 @@
+/**
+ * File:   task_queue.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  post tasks to the gui thread
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-19 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/atomic.h"
+#include "base/task_queue.h"
+
+/*
+ * 每个位置有一个序号：等于pos时可以投递，等于pos+1时任务已经写好可以执行，
+ * 执行完后设为pos+capacity，留给下一圈使用。
+ */
+
+static task_queue_t* s_task_queue = NULL;
+
+task_queue_t* task_queue(void) {
+  return s_task_queue;
+}
+
+ret_t task_queue_set(task_queue_t* q) {
+  s_task_queue = q;
+
+  return RET_OK;
+}
+
+task_queue_t* task_queue_create(uint32_t capacity) {
+  uint32_t i = 0;
+  uint32_t size = 2;
+  task_queue_t* q = NULL;
+  return_value_if_fail(capacity > 0, NULL);
+
+  while (size < capacity) {
+    size <<= 1;
+  }
+
+  q = TKMEM_ZALLOC(task_queue_t);
+  return_value_if_fail(q != NULL, NULL);
+
+  q->slots = TKMEM_ZALLOCN(task_slot_t, size);
+  if (q->slots == NULL) {
+    TKMEM_FREE(q);
+    return NULL;
+  }
+
+  q->capacity = size;
+  for (i = 0; i < size; i++) {
+    q->slots[i].seq = i;
+  }
+
+  return q;
+}
+
+ret_t task_queue_set_wakeup(task_queue_t* q, task_wakeup_t wakeup, void* ctx) {
+  return_value_if_fail(q != NULL, RET_BAD_PARAMS);
+
+  q->wakeup = wakeup;
+  q->wakeup_ctx = ctx;
+
+  return RET_OK;
+}
+
+ret_t task_queue_post(task_queue_t* q, task_func_t func, void* ctx) {
+  uint32_t pos = 0;
+  task_slot_t* slot = NULL;
+  return_value_if_fail(q != NULL && func != NULL, RET_BAD_PARAMS);
+
+  pos = tk_atomic_load(&(q->w));
+  for (;;) {
+    int32_t diff = 0;
+
+    slot = q->slots + (pos & (q->capacity - 1));
+    diff = (int32_t)(tk_atomic_load(&(slot->seq)) - pos);
+
+    if (diff == 0) {
+      /*抢到这个位置。失败时pos被更新为最新的值。*/
+      if (tk_atomic_cas_u32(&(q->w), &pos, pos + 1)) {
+        break;
+      }
+    } else if (diff < 0) {
+      return RET_FAIL;
+    } else {
+      pos = tk_atomic_load(&(q->w));
+    }
+  }
+
+  slot->func = func;
+  slot->ctx = ctx;
+  tk_atomic_store(&(slot->seq), pos + 1);
+
+  if (q->wakeup != NULL && !tk_atomic_exchange_u32(&(q->signaled), TRUE)) {
+    q->wakeup(q->wakeup_ctx);
+  }
+
+  return RET_OK;
+}
+
+uint32_t task_queue_dispatch(task_queue_t* q) {
+  uint32_t nr = 0;
+  uint32_t end = 0;
+
+  if (q == NULL) {
+    return 0;
+  }
+
+  tk_atomic_store(&(q->signaled), FALSE);
+  end = tk_atomic_load(&(q->w));
+
+  while (q->r != end) {
+    void* ctx = NULL;
+    task_func_t func = NULL;
+    task_slot_t* slot = q->slots + (q->r & (q->capacity - 1));
+
+    /*位置已经被占了，但是任务还没有写完，后面的任务留到下一次，保证顺序。*/
+    if (tk_atomic_load(&(slot->seq)) != q->r + 1) {
+      break;
+    }
+
+    func = slot->func;
+    ctx = slot->ctx;
+    tk_atomic_store(&(slot->seq), q->r + q->capacity);
+    q->r++;
+
+    func(ctx);
+    nr++;
+  }
+
+  return nr;
+}
+
+ret_t task_queue_destroy(task_queue_t* q) {
+  return_value_if_fail(q != NULL, RET_BAD_PARAMS);
+
+  if (s_task_queue == q) {
+    s_task_queue = NULL;
+  }
+
+  TKMEM_FREE(q->slots);
+  TKMEM_FREE(q);
+
+  return RET_OK;
+}
+
+ret_t tk_post_task(task_func_t func, void* ctx) {
+  return task_queue_post(task_queue(), func, ctx);
+}
@@ -0,0 +1,145 @@
+/**
+ * File:   task_queue.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  post tasks to the gui thread
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-19 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_TASK_QUEUE_H
+#define TK_TASK_QUEUE_H
+
+#include "base/types_def.h"
+
+BEGIN_C_DECLS
+
+typedef ret_t (*task_func_t)(void* ctx);
+typedef ret_t (*task_wakeup_t)(void* ctx);
+
+typedef struct _task_slot_t {
+  volatile uint32_t seq;
+  task_func_t func;
+  void* ctx;
+} task_slot_t;
+
+/**
+ * @class task_queue_t
+ * @scriptable no
+ * 其它线程向GUI线程投递任务的队列。
+ *
+ * 控件树只能在GUI线程中访问，其它线程(比如数据采集线程)通过task_queue_post投递任务，
+ * 主循环每次循环调用task_queue_dispatch在GUI线程中执行这些任务。
+ *
+ * 多生产者/单消费者的无锁有界队列，投递时不分配内存(TKMEM不是线程安全的)，队列满时投递失败。
+ * 顺序：同一个线程投递的任务按投递的顺序执行；不同线程投递的任务按占到位置的先后执行。
+ */
+typedef struct _task_queue_t {
+  /*下一个投递的位置(生产者之间竞争)*/
+  volatile uint32_t w;
+  /*下一个执行的位置(只由GUI线程修改)*/
+  uint32_t r;
+  uint32_t capacity;
+  /*已经请求过唤醒，GUI线程处理之前不再重复唤醒*/
+  volatile uint32_t signaled;
+  task_wakeup_t wakeup;
+  void* wakeup_ctx;
+  task_slot_t* slots;
+} task_queue_t;
+
+/**
+ * @method task_queue
+ * 获取缺省的任务队列。
+ * @return {task_queue_t*} 返回任务队列对象。
+ */
+task_queue_t* task_queue(void);
+
+/**
+ * @method task_queue_set
+ * 设置缺省的任务队列。
+ * @param {task_queue_t*} q 任务队列对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t task_queue_set(task_queue_t* q);
+
+/**
+ * @method task_queue_create
+ * @constructor
+ * 创建任务队列。
+ * @param {uint32_t} capacity 最多可以容纳的任务个数(向上取整为2的幂)。
+ *
+ * @return {task_queue_t*} 返回任务队列对象。
+ */
+task_queue_t* task_queue_create(uint32_t capacity);
+
+/**
+ * @method task_queue_set_wakeup
+ * 设置唤醒函数。主循环在等待时，有新的任务投递进来，调用它唤醒主循环。
+ * 唤醒函数在投递任务的线程中调用，每次task_queue_dispatch之后最多调用一次。
+ * @param {task_queue_t*} q 任务队列对象。
+ * @param {task_wakeup_t} wakeup 唤醒函数。
+ * @param {void*} ctx 唤醒函数的上下文。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t task_queue_set_wakeup(task_queue_t* q, task_wakeup_t wakeup, void* ctx);
+
+/**
+ * @method task_queue_post
+ * 投递一个任务(任何线程都可以调用)。
+ * @param {task_queue_t*} q 任务队列对象。
+ * @param {task_func_t} func 任务函数(在GUI线程中执行)。
+ * @param {void*} ctx 任务函数的上下文。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，队列满时返回RET_FAIL。
+ */
+ret_t task_queue_post(task_queue_t* q, task_func_t func, void* ctx);
+
+/**
+ * @method task_queue_dispatch
+ * 执行开始调用时已经投递的任务(只能在GUI线程调用)。
+ * 执行任务时新投递的任务留到下一次执行，避免一直占住主循环。
+ * @param {task_queue_t*} q 任务队列对象。
+ *
+ * @return {uint32_t} 返回执行的任务个数。
+ */
+uint32_t task_queue_dispatch(task_queue_t* q);
+
+/**
+ * @method task_queue_destroy
+ * @deconstructor
+ * 销毁任务队列，没有执行的任务被丢掉。
+ * @param {task_queue_t*} q 任务队列对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t task_queue_destroy(task_queue_t* q);
+
+/**
+ * @method tk_post_task
+ * 向缺省的任务队列投递一个任务(任何线程都可以调用)，任务在GUI线程中执行。
+ * @global
+ * @scriptable no
+ * @param {task_func_t} func 任务函数。
+ * @param {void*} ctx 任务函数的上下文。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，队列满时返回RET_FAIL。
+ */
+ret_t tk_post_task(task_func_t func, void* ctx);
+
+END_C_DECLS
+
+#endif /*TK_TASK_QUEUE_H*/
@@ -0,0 +1,352 @@
+/**
+ * File:   text_layout.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  text layout cache
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-18 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/utils.h"
+#include "base/text_layout.h"
+
+text_layout_t* text_layout_create(void) {
+  text_layout_t* layout = TKMEM_ZALLOC(text_layout_t);
+  return_value_if_fail(layout != NULL, NULL);
+
+  return text_layout_init(layout);
+}
+
+text_layout_t* text_layout_init(text_layout_t* layout) {
+  return_value_if_fail(layout != NULL, NULL);
+
+  memset(layout, 0x00, sizeof(text_layout_t));
+
+  return layout;
+}
+
+ret_t text_layout_invalidate(text_layout_t* layout) {
+  return_value_if_fail(layout != NULL, RET_BAD_PARAMS);
+
+  layout->valid = FALSE;
+
+  return RET_OK;
+}
+
+static bool_t text_layout_font_name_equal(const char* name1, const char* name2) {
+  if (name1 == name2) {
+    return TRUE;
+  }
+
+  return name1 != NULL && name2 != NULL && str_fast_equal(name1, name2);
+}
+
+static ret_t text_layout_set_font_name(text_layout_t* layout, const char* name) {
+  char* str = NULL;
+  uint32_t size = 0;
+
+  if (text_layout_font_name_equal(layout->font_name, name)) {
+    return RET_OK;
+  }
+
+  if (name == NULL) {
+    TKMEM_FREE(layout->font_name);
+    layout->font_name = NULL;
+    return RET_OK;
+  }
+
+  size = strlen(name) + 1;
+  str = TKMEM_REALLOC(char, layout->font_name, size);
+  return_value_if_fail(str != NULL, RET_OOM);
+
+  memcpy(str, name, size);
+  layout->font_name = str;
+
+  return RET_OK;
+}
+
+static bool_t text_layout_is_valid(text_layout_t* layout, canvas_t* c, const wchar_t* str,
+                                   uint32_t size, wh_t max_w) {
+  return layout->valid && layout->str == str && layout->size == size && layout->max_w == max_w &&
+         layout->font_size == c->font_size &&
+         text_layout_font_name_equal(layout->font_name, c->font_name);
+}
+
+static ret_t text_layout_add_line(text_layout_t* layout, uint32_t start, uint32_t nr, wh_t w) {
+  text_layout_line_t* line = NULL;
+
+  if (layout->lines_nr >= layout->lines_capacity) {
+    uint32_t capacity = layout->lines_capacity ? layout->lines_capacity * 2 : 4;
+    text_layout_line_t* lines = TKMEM_REALLOC(text_layout_line_t, layout->lines, capacity);
+    return_value_if_fail(lines != NULL, RET_OOM);
+
+    layout->lines = lines;
+    layout->lines_capacity = capacity;
+  }
+
+  line = layout->lines + layout->lines_nr++;
+  line->start = start;
+  line->nr = nr;
+  line->w = w;
+  layout->w = ftk_max(layout->w, w);
+
+  return RET_OK;
+}
+
+static ret_t text_layout_measure_chars(text_layout_t* layout, canvas_t* c) {
+  uint32_t i = 0;
+  const wchar_t* str = layout->str;
+
+  if (layout->size > layout->advances_capacity) {
+    uint16_t* advances = TKMEM_REALLOC(uint16_t, layout->advances, layout->size);
+    return_value_if_fail(advances != NULL, RET_OOM);
+
+    layout->advances = advances;
+    layout->advances_capacity = layout->size;
+  }
+
+  for (i = 0; i < layout->size; i++) {
+    wchar_t chr = str[i];
+
+    if (chr == '\r' || chr == '\n') {
+      layout->advances[i] = 0;
+    } else {
+      layout->advances[i] = canvas_measure_text(c, (wchar_t*)str + i, 1);
+    }
+  }
+
+  return RET_OK;
+}
+
+/*遇到换行符时换行。设置了max_w时，优先在最后一个空格处断行，没有空格时在字符间断行。*/
+static ret_t text_layout_break_lines(text_layout_t* layout) {
+  wh_t x = 0;
+  wh_t brk_x = 0;
+  uint32_t i = 0;
+  uint32_t brk = 0;
+  uint32_t start = 0;
+  bool_t has_brk = FALSE;
+  wh_t max_w = layout->max_w;
+  const wchar_t* str = layout->str;
+
+  for (i = 0; i < layout->size; i++) {
+    wchar_t chr = str[i];
+    wh_t adv = layout->advances[i];
+
+    if (chr == '\r' || chr == '\n') {
+      return_value_if_fail(text_layout_add_line(layout, start, i - start, x) == RET_OK, RET_OOM);
+      if (chr == '\r' && (i + 1) < layout->size && str[i + 1] == '\n') {
+        i++;
+      }
+      start = i + 1;
+      x = 0;
+      has_brk = FALSE;
+      continue;
+    }
+
+    if (max_w > 0 && (x + adv) > max_w && i > start) {
+      if (chr == ' ') {
+        /*行尾的空格直接丢掉*/
+        return_value_if_fail(text_layout_add_line(layout, start, i - start, x) == RET_OK, RET_OOM);
+        start = i + 1;
+        x = 0;
+        has_brk = FALSE;
+        continue;
+      } else if (has_brk) {
+        return_value_if_fail(text_layout_add_line(layout, start, brk - start, brk_x) == RET_OK,
+                             RET_OOM);
+        x -= brk_x + layout->advances[brk];
+        start = brk + 1;
+        has_brk = FALSE;
+      }
+
+      if ((x + adv) > max_w && i > start) {
+        return_value_if_fail(text_layout_add_line(layout, start, i - start, x) == RET_OK, RET_OOM);
+        start = i;
+        x = 0;
+      }
+    }
+
+    if (chr == ' ') {
+      brk = i;
+      brk_x = x;
+      has_brk = TRUE;
+    }
+    x += adv;
+  }
+
+  return text_layout_add_line(layout, start, layout->size - start, x);
+}
+
+ret_t text_layout_update(text_layout_t* layout, canvas_t* c, const wchar_t* str, uint32_t size,
+                         wh_t max_w) {
+  return_value_if_fail(layout != NULL && c != NULL && (str != NULL || size == 0), RET_BAD_PARAMS);
+
+  if (text_layout_is_valid(layout, c, str, size, max_w)) {
+    return RET_OK;
+  }
+
+  layout->w = 0;
+  layout->h = 0;
+  layout->str = str;
+  layout->size = size;
+  layout->max_w = max_w;
+  layout->lines_nr = 0;
+  layout->valid = FALSE;
+  layout->font_size = c->font_size;
+
+  return_value_if_fail(text_layout_set_font_name(layout, c->font_name) == RET_OK, RET_OOM);
+  return_value_if_fail(text_layout_measure_chars(layout, c) == RET_OK, RET_OOM);
+  return_value_if_fail(text_layout_break_lines(layout) == RET_OK, RET_OOM);
+
+  layout->h = layout->lines_nr * layout->font_size;
+  layout->valid = TRUE;
+
+  return RET_OK;
+}
+
+wh_t text_layout_measure(text_layout_t* layout, uint32_t start, uint32_t nr) {
+  wh_t w = 0;
+  uint32_t i = 0;
+  return_value_if_fail(layout != NULL && layout->valid, 0);
+  return_value_if_fail(start + nr <= layout->size, 0);
+
+  for (i = start; i < start + nr; i++) {
+    w += layout->advances[i];
+  }
+
+  return w;
+}
+
+static ret_t text_layout_draw_line(text_layout_t* layout, canvas_t* c, text_layout_line_t* line,
+                                   xy_t x, xy_t y, xy_t left, xy_t right) {
+  xy_t xx = 0;
+  uint32_t nr = 0;
+  uint32_t start = line->start;
+  uint32_t end = line->start + line->nr;
+  const uint16_t* advances = layout->advances;
+
+  /*跳过左边看不到的字符*/
+  while (start < end && (x + advances[start]) <= left) {
+    x += advances[start];
+    start++;
+  }
+
+  xx = x;
+  while ((start + nr) < end && xx < right) {
+    xx += advances[start + nr];
+    nr++;
+  }
+
+  if (nr > 0) {
+    return canvas_draw_text(c, (wchar_t*)(layout->str) + start, nr, x, y);
+  }
+
+  return RET_OK;
+}
+
+ret_t text_layout_draw(text_layout_t* layout, canvas_t* c, rect_t* r, align_h_t align_h,
+                       align_v_t align_v) {
+  xy_t y = 0;
+  xy_t top = 0;
+  xy_t left = 0;
+  xy_t right = 0;
+  xy_t bottom = 0;
+  xy_t slack = 0;
+  uint32_t i = 0;
+  uint32_t first = 0;
+  uint32_t last = 0;
+  wh_t line_h = 0;
+  return_value_if_fail(layout != NULL && c != NULL && r != NULL && layout->valid, RET_BAD_PARAMS);
+
+  line_h = layout->font_size;
+  if (layout->lines_nr == 0 || line_h == 0) {
+    return RET_OK;
+  }
+
+  switch (align_v) {
+    case ALIGN_V_TOP:
+      y = r->y;
+      break;
+    case ALIGN_V_BOTTOM:
+      y = r->y + r->h - layout->h;
+      break;
+    default:
+      y = r->y + ((r->h - layout->h) >> 1);
+      break;
+  }
+
+  /*裁剪区换算到当前的坐标系。字形可能超出行框，四周各放宽半行。*/
+  slack = line_h >> 1;
+  top = c->clip_top - c->oy - slack;
+  bottom = c->clip_bottom - c->oy + slack;
+  left = c->clip_left - c->ox - slack;
+  right = c->clip_right - c->ox + slack;
+
+  first = top > y ? (top - y) / line_h : 0;
+  last = bottom > y ? (bottom - y + line_h - 1) / line_h : 0;
+  last = ftk_min(last, layout->lines_nr);
+
+  for (i = first; i < last; i++) {
+    xy_t x = 0;
+    text_layout_line_t* line = layout->lines + i;
+
+    switch (align_h) {
+      case ALIGN_H_LEFT:
+        x = r->x;
+        break;
+      case ALIGN_H_RIGHT:
+        x = r->x + r->w - line->w;
+        break;
+      default:
+        x = r->x + ((r->w - line->w) >> 1);
+        break;
+    }
+
+    text_layout_draw_line(layout, c, line, x, y + i * line_h, left, right);
+  }
+
+  return RET_OK;
+}
+
+ret_t text_layout_deinit(text_layout_t* layout) {
+  return_value_if_fail(layout != NULL, RET_BAD_PARAMS);
+
+  if (layout->advances != NULL) {
+    TKMEM_FREE(layout->advances);
+  }
+
+  if (layout->lines != NULL) {
+    TKMEM_FREE(layout->lines);
+  }
+
+  if (layout->font_name != NULL) {
+    TKMEM_FREE(layout->font_name);
+  }
+
+  memset(layout, 0x00, sizeof(text_layout_t));
+
+  return RET_OK;
+}
+
+ret_t text_layout_destroy(text_layout_t* layout) {
+  return_value_if_fail(layout != NULL, RET_BAD_PARAMS);
+
+  text_layout_deinit(layout);
+  TKMEM_FREE(layout);
+
+  return RET_OK;
+}
@@ -0,0 +1,215 @@
+/**
+ * File:   text_layout.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  text layout cache
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-18 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_TEXT_LAYOUT_H
+#define TK_TEXT_LAYOUT_H
+
+#include "base/canvas.h"
+#include "base/theme.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @class text_layout_line_t
+ * @scriptable no
+ * 排版后的一行文本。
+ */
+typedef struct _text_layout_line_t {
+  /**
+   * @property {uint32_t} start
+   * 第一个字符在字符串中的位置。
+   */
+  uint32_t start;
+  /**
+   * @property {uint32_t} nr
+   * 字符个数(不包括换行符)。
+   */
+  uint32_t nr;
+  /**
+   * @property {wh_t} w
+   * 宽度。
+   */
+  wh_t w;
+} text_layout_line_t;
+
+/**
+ * @class text_layout_t
+ * @scriptable no
+ * 文本排版缓存。
+ * 对同一个(字符串，字体，字号，换行宽度)只测量一次每个字符的宽度并分好行，之后绘制时直接使用，
+ * 而且只绘制与裁剪区相交的行和字符。
+ *
+ * 注意：缓存只比较字符串的指针和长度，直接修改字符串内容后要调用text_layout_invalidate。
+ */
+typedef struct _text_layout_t {
+  /**
+   * @property {wchar_t*} str
+   * @private
+   * 排版的字符串(只保存指针)。
+   */
+  const wchar_t* str;
+  /**
+   * @property {uint32_t} size
+   * 字符个数。
+   */
+  uint32_t size;
+  /**
+   * @property {char*} font_name
+   * @private
+   * 排版时的字体名称(复制一份，主题或资源重新加载后原来的字符串可能已经释放)。
+   */
+  char* font_name;
+  /**
+   * @property {uint16_t} font_size
+   * 排版时的字号，也是行高。
+   */
+  uint16_t font_size;
+  /**
+   * @property {wh_t} max_w
+   * 自动换行的宽度，0表示不自动换行。
+   */
+  wh_t max_w;
+  /**
+   * @property {bool_t} valid
+   * @private
+   * 排版结果是否有效。
+   */
+  bool_t valid;
+
+  /**
+   * @property {uint16_t*} advances
+   * @private
+   * 每个字符的宽度。
+   */
+  uint16_t* advances;
+  uint32_t advances_capacity;
+  /**
+   * @property {text_layout_line_t*} lines
+   * @private
+   * 全部行。
+   */
+  text_layout_line_t* lines;
+  uint32_t lines_capacity;
+  /**
+   * @property {uint32_t} lines_nr
+   * 行数。
+   */
+  uint32_t lines_nr;
+  /**
+   * @property {wh_t} w
+   * 最宽的行的宽度。
+   */
+  wh_t w;
+  /**
+   * @property {wh_t} h
+   * 全部行的高度。
+   */
+  wh_t h;
+} text_layout_t;
+
+/**
+ * @method text_layout_create
+ * @constructor
+ * 创建文本排版对象。
+ *
+ * @return {text_layout_t*} 文本排版对象。
+ */
+text_layout_t* text_layout_create(void);
+
+/**
+ * @method text_layout_init
+ * 初始化文本排版对象。
+ * @param {text_layout_t*} layout 文本排版对象。
+ *
+ * @return {text_layout_t*} 文本排版对象。
+ */
+text_layout_t* text_layout_init(text_layout_t* layout);
+
+/**
+ * @method text_layout_invalidate
+ * 让排版结果失效，下次text_layout_update时重新排版。
+ * @param {text_layout_t*} layout 文本排版对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t text_layout_invalidate(text_layout_t* layout);
+
+/**
+ * @method text_layout_update
+ * 用canvas当前的字体排版文本。参数与上次相同时直接返回。
+ * @param {text_layout_t*} layout 文本排版对象。
+ * @param {canvas_t*} c canvas对象(已经设置好字体)。
+ * @param {wchar_t*} str 字符串。
+ * @param {uint32_t} size 字符个数。
+ * @param {wh_t} max_w 自动换行的宽度，0表示只在换行符处换行。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t text_layout_update(text_layout_t* layout, canvas_t* c, const wchar_t* str, uint32_t size,
+                         wh_t max_w);
+
+/**
+ * @method text_layout_measure
+ * 计算排版结果中一段字符的宽度。
+ * @param {text_layout_t*} layout 文本排版对象。
+ * @param {uint32_t} start 第一个字符的位置。
+ * @param {uint32_t} nr 字符个数。
+ *
+ * @return {wh_t} 返回宽度。
+ */
+wh_t text_layout_measure(text_layout_t* layout, uint32_t start, uint32_t nr);
+
+/**
+ * @method text_layout_draw
+ * 在指定的矩形内按对齐方式绘制排版好的文本，只绘制与裁剪区相交的行和字符。
+ * @param {text_layout_t*} layout 文本排版对象。
+ * @param {canvas_t*} c canvas对象。
+ * @param {rect_t*} r 文本区域。
+ * @param {align_h_t} align_h 水平对齐方式。
+ * @param {align_v_t} align_v 垂直对齐方式。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t text_layout_draw(text_layout_t* layout, canvas_t* c, rect_t* r, align_h_t align_h,
+                       align_v_t align_v);
+
+/**
+ * @method text_layout_deinit
+ * 释放文本排版对象的内部资源。
+ * @param {text_layout_t*} layout 文本排版对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t text_layout_deinit(text_layout_t* layout);
+
+/**
+ * @method text_layout_destroy
+ * @deconstructor
+ * 销毁文本排版对象。
+ * @param {text_layout_t*} layout 文本排版对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t text_layout_destroy(text_layout_t* layout);
+
+END_C_DECLS
+
+#endif /*TK_TEXT_LAYOUT_H*/
@@ -0,0 +1,99 @@
+/**
+ * File:   thread.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  thread and semaphore
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-20 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_THREAD_H
+#define TK_THREAD_H
+
+#include "base/types_def.h"
+
+BEGIN_C_DECLS
+
+struct _tk_thread_t;
+typedef struct _tk_thread_t tk_thread_t;
+
+struct _tk_semaphore_t;
+typedef struct _tk_semaphore_t tk_semaphore_t;
+
+typedef void* (*tk_thread_entry_t)(void* args);
+
+/*
+ * 线程和信号量的平台抽象，由平台实现(参见platforms/thread_default.c)。
+ * 只在支持多线程的平台上使用，create/destroy只能在GUI线程中调用(TKMEM不是线程安全的)。
+ */
+
+/**
+ * @method tk_thread_create
+ * 创建并启动线程。
+ * @param {tk_thread_entry_t} entry 线程函数。
+ * @param {void*} args 线程函数的参数。
+ *
+ * @return {tk_thread_t*} 返回线程对象。
+ */
+tk_thread_t* tk_thread_create(tk_thread_entry_t entry, void* args);
+
+/**
+ * @method tk_thread_join
+ * 等待线程结束，并销毁线程对象。
+ * @param {tk_thread_t*} thread 线程对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t tk_thread_join(tk_thread_t* thread);
+
+/**
+ * @method tk_semaphore_create
+ * 创建信号量。
+ * @param {uint32_t} value 初始值。
+ *
+ * @return {tk_semaphore_t*} 返回信号量对象。
+ */
+tk_semaphore_t* tk_semaphore_create(uint32_t value);
+
+/**
+ * @method tk_semaphore_wait
+ * 信号量的值大于0时减1，否则等待。
+ * @param {tk_semaphore_t*} sem 信号量对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t tk_semaphore_wait(tk_semaphore_t* sem);
+
+/**
+ * @method tk_semaphore_post
+ * 信号量的值加1，唤醒一个等待的线程。
+ * @param {tk_semaphore_t*} sem 信号量对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t tk_semaphore_post(tk_semaphore_t* sem);
+
+/**
+ * @method tk_semaphore_destroy
+ * 销毁信号量。
+ * @param {tk_semaphore_t*} sem 信号量对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t tk_semaphore_destroy(tk_semaphore_t* sem);
+
+END_C_DECLS
+
+#endif /*TK_THREAD_H*/
@@ -0,0 +1,179 @@
+/**
+ * File:   tile_renderer.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  replay display list in tiles on worker threads
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-20 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/atomic.h"
+#include "base/tile_renderer.h"
+
+static ret_t tile_renderer_run(tile_renderer_t* tr, lcd_t* view) {
+  rect_t tile;
+  rect_t* r = &(tr->r);
+
+  for (;;) {
+    uint32_t i = tk_atomic_fetch_add_u32(&(tr->next_tile), 1);
+    if (i >= tr->tiles_nr) {
+      break;
+    }
+
+    tile.x = r->x;
+    tile.w = r->w;
+    tile.y = r->y + i * TILE_RENDERER_TILE_H;
+    tile.h = ftk_min(TILE_RENDERER_TILE_H, r->y + r->h - tile.y);
+    display_list_replay(tr->dl, view, &tile);
+  }
+
+  return RET_OK;
+}
+
+/*先醒来的线程可能领走其它线程的start，没关系，每个线程用自己的view，领到几次就完成几次。*/
+static void* tile_renderer_main(void* args) {
+  tile_worker_t* worker = (tile_worker_t*)args;
+  tile_renderer_t* tr = worker->renderer;
+
+  for (;;) {
+    tk_semaphore_wait(tr->start);
+    if (tk_atomic_load(&(tr->quit))) {
+      break;
+    }
+
+    tile_renderer_run(tr, worker->view);
+    tk_semaphore_post(tr->done);
+  }
+
+  return NULL;
+}
+
+static ret_t tile_renderer_destroy_views(tile_renderer_t* tr) {
+  uint32_t i = 0;
+
+  for (i = 0; i < tr->threads_nr; i++) {
+    tile_worker_t* worker = tr->workers + i;
+    if (worker->view != NULL) {
+      lcd_destroy(worker->view);
+      worker->view = NULL;
+    }
+  }
+
+  return RET_OK;
+}
+
+ret_t tile_renderer_replay(tile_renderer_t* tr, display_list_t* dl, lcd_t* lcd, rect_t* r) {
+  uint32_t i = 0;
+  uint32_t helpers = 0;
+  return_value_if_fail(tr != NULL && dl != NULL && lcd != NULL && r != NULL, RET_BAD_PARAMS);
+
+  if (tr->threads_nr < 2 || lcd->create_view == NULL ||
+      (uint32_t)(r->w * r->h) < TILE_RENDERER_MIN_PIXELS) {
+    return display_list_replay(dl, lcd, r);
+  }
+
+  for (i = 0; i < tr->threads_nr; i++) {
+    tr->workers[i].view = lcd_create_view(lcd);
+    if (tr->workers[i].view == NULL) {
+      tile_renderer_destroy_views(tr);
+      return display_list_replay(dl, lcd, r);
+    }
+  }
+
+  tr->dl = dl;
+  tr->r = *r;
+  tr->tiles_nr = (r->h + TILE_RENDERER_TILE_H - 1) / TILE_RENDERER_TILE_H;
+  tk_atomic_store(&(tr->next_tile), 0);
+
+  helpers = ftk_min(tr->threads_nr, tr->tiles_nr) - 1;
+  for (i = 0; i < helpers; i++) {
+    tk_semaphore_post(tr->start);
+  }
+
+  tile_renderer_run(tr, tr->workers[0].view);
+
+  for (i = 0; i < helpers; i++) {
+    tk_semaphore_wait(tr->done);
+  }
+
+  tr->dl = NULL;
+  tr->tiled++;
+
+  return tile_renderer_destroy_views(tr);
+}
+
+ret_t tile_renderer_destroy(tile_renderer_t* tr) {
+  uint32_t i = 0;
+  return_value_if_fail(tr != NULL, RET_BAD_PARAMS);
+
+  tk_atomic_store(&(tr->quit), TRUE);
+  for (i = 1; i < tr->threads_nr; i++) {
+    if (tr->workers[i].thread != NULL) {
+      tk_semaphore_post(tr->start);
+    }
+  }
+
+  for (i = 1; i < tr->threads_nr; i++) {
+    if (tr->workers[i].thread != NULL) {
+      tk_thread_join(tr->workers[i].thread);
+    }
+  }
+
+  if (tr->start != NULL) {
+    tk_semaphore_destroy(tr->start);
+  }
+
+  if (tr->done != NULL) {
+    tk_semaphore_destroy(tr->done);
+  }
+
+  TKMEM_FREE(tr);
+
+  return RET_OK;
+}
+
+tile_renderer_t* tile_renderer_create(uint32_t threads_nr) {
+  uint32_t i = 0;
+  tile_renderer_t* tr = NULL;
+  return_value_if_fail(threads_nr > 0 && threads_nr <= TILE_RENDERER_MAX_THREADS, NULL);
+
+  tr = TKMEM_ZALLOC(tile_renderer_t);
+  return_value_if_fail(tr != NULL, NULL);
+
+  tr->threads_nr = threads_nr;
+  tr->start = tk_semaphore_create(0);
+  tr->done = tk_semaphore_create(0);
+  if (tr->start == NULL || tr->done == NULL) {
+    tile_renderer_destroy(tr);
+    return NULL;
+  }
+
+  /*workers[0]是调用者的线程。*/
+  for (i = 0; i < threads_nr; i++) {
+    tile_worker_t* worker = tr->workers + i;
+
+    worker->renderer = tr;
+    if (i > 0) {
+      worker->thread = tk_thread_create(tile_renderer_main, worker);
+      if (worker->thread == NULL) {
+        tile_renderer_destroy(tr);
+        return NULL;
+      }
+    }
+  }
+
+  return tr;
+}
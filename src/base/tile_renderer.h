@@ -0,0 +1,121 @@
+/**
+ * File:   tile_renderer.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  replay display list in tiles on worker threads
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-20 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_TILE_RENDERER_H
+#define TK_TILE_RENDERER_H
+
+#include "base/thread.h"
+#include "base/display_list.h"
+
+BEGIN_C_DECLS
+
+#ifndef TILE_RENDERER_MAX_THREADS
+#define TILE_RENDERER_MAX_THREADS 8
+#endif /*TILE_RENDERER_MAX_THREADS*/
+
+/*每个tile的高度(行数)。*/
+#ifndef TILE_RENDERER_TILE_H
+#define TILE_RENDERER_TILE_H 32
+#endif /*TILE_RENDERER_TILE_H*/
+
+/*小于这个面积(像素个数)的区域在调用者的线程中直接回放。*/
+#ifndef TILE_RENDERER_MIN_PIXELS
+#define TILE_RENDERER_MIN_PIXELS (256 * 256)
+#endif /*TILE_RENDERER_MIN_PIXELS*/
+
+struct _tile_renderer_t;
+typedef struct _tile_renderer_t tile_renderer_t;
+
+typedef struct _tile_worker_t {
+  tile_renderer_t* renderer;
+  tk_thread_t* thread;
+  lcd_t* view;
+} tile_worker_t;
+
+/**
+ * @class tile_renderer_t
+ * 分块并行回放显示列表。
+ * 把较大的区域按行切成高度为TILE_RENDERER_TILE_H的tile，调用者的线程和工作线程轮流领取tile，
+ * 每个tile回放整个显示列表(裁剪到tile内)，各自通过lcd_create_view得到的lcd写入同一个framebuffer。
+ * tile之间没有重叠，所以不需要加锁。
+ * 只支持提供了create_view的lcd，其它lcd和较小的区域在调用者的线程中直接回放。
+ */
+struct _tile_renderer_t {
+  /**
+   * @property {uint32_t} threads_nr
+   * @readonly
+   * 参与回放的线程数(包括调用者的线程)。
+   */
+  uint32_t threads_nr;
+  /**
+   * @property {uint32_t} tiled
+   * @readonly
+   * 分块回放的次数。
+   */
+  uint32_t tiled;
+
+  /*private*/
+  display_list_t* dl;
+  rect_t r;
+  uint32_t tiles_nr;
+  volatile uint32_t next_tile;
+  volatile uint32_t quit;
+  tk_semaphore_t* start;
+  tk_semaphore_t* done;
+  tile_worker_t workers[TILE_RENDERER_MAX_THREADS];
+};
+
+/**
+ * @method tile_renderer_create
+ * @constructor
+ * 创建分块回放对象。
+ * @param {uint32_t} threads_nr 参与回放的线程数(包括调用者的线程，1-TILE_RENDERER_MAX_THREADS)。
+ *
+ * @return {tile_renderer_t*} 返回分块回放对象。
+ */
+tile_renderer_t* tile_renderer_create(uint32_t threads_nr);
+
+/**
+ * @method tile_renderer_replay
+ * 在lcd上回放显示列表中与r相交的部分，返回时已经全部绘制完成。
+ * 调用者负责lcd的begin_frame/end_frame。
+ * @param {tile_renderer_t*} tr 分块回放对象。
+ * @param {display_list_t*} dl 显示列表对象。
+ * @param {lcd_t*} lcd 目标lcd对象。
+ * @param {rect_t*} r 回放的区域。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t tile_renderer_replay(tile_renderer_t* tr, display_list_t* dl, lcd_t* lcd, rect_t* r);
+
+/**
+ * @method tile_renderer_destroy
+ * @deconstructor
+ * 销毁分块回放对象(等待工作线程退出)。
+ * @param {tile_renderer_t*} tr 分块回放对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t tile_renderer_destroy(tile_renderer_t* tr);
+
+END_C_DECLS
+
+#endif /*TK_TILE_RENDERER_H*/
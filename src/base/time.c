@@ -22,6 +22,14 @@
 #include "base/time.h"
 #include "base/platform.h"
 
-uint32_t time_now_ms(void) { return get_time_ms(); }
+static time_now_ms_t s_now_ms = NULL;
 
-uint32_t time_now_s(void) { return get_time_ms() / 1000; }
+uint32_t time_now_ms(void) { return s_now_ms != NULL ? s_now_ms() : get_time_ms(); }
+
+uint32_t time_now_s(void) { return time_now_ms() / 1000; }
+
+ret_t time_set_source(time_now_ms_t now_ms) {
+  s_now_ms = now_ms;
+
+  return RET_OK;
+}
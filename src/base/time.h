@@ -26,9 +26,14 @@
 
 BEGIN_C_DECLS
 
+typedef uint32_t (*time_now_ms_t)(void);
+
 uint32_t time_now_s(void);
 uint32_t time_now_ms(void);
 
+/*替换时间源(比如无头模式下的虚拟时钟)，NULL表示恢复平台的时钟。*/
+ret_t time_set_source(time_now_ms_t now_ms);
+
 END_C_DECLS
 
 #endif /*TK_TIME_H*/
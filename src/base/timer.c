@@ -22,6 +22,9 @@
 #include "base/mem.h"
 #include "base/timer.h"
 #include "base/array.h"
+#include "base/profiler.h"
+#include "base/perf_stats.h"
+#include "base/input_trace.h"
 
 static uint32_t s_timer_id = 1;
 static array_t* s_timer_manager = NULL;
@@ -104,6 +107,7 @@ ret_t timer_check() {
   uint32_t k = 0;
   uint32_t nr = 0;
   uint32_t now = 0;
+  uint32_t fired = 0;
   timer_info_t** timers = NULL;
   return_value_if_fail(s_get_time != NULL && ensure_timer_manager() == RET_OK, RET_BAD_PARAMS);
 
@@ -123,6 +127,10 @@ ret_t timer_check() {
 
     end = iter->start + iter->duration_ms;
     if (end <= now) {
+      /*只记录触发了定时器的检查，空转的检查太多。*/
+      if (fired++ == 0) {
+        PROFILER_BEGIN("timer_check", NULL);
+      }
       iter->repeat = RET_REPEAT == iter->on_timer(iter);
       if (iter->repeat) {
         iter->start = now;
@@ -142,6 +150,14 @@ ret_t timer_check() {
   }
   s_timer_manager->size = k;
 
+  if (fired > 0) {
+    PROFILER_END();
+    perf_stats_add(PERF_COUNTER_TIMERS_FIRED, fired);
+    if (input_trace() != NULL) {
+      input_trace_add(input_trace(), INPUT_TRACE_TIMER, 0, 0, fired);
+    }
+  }
+
   return RET_OK;
 }
 
@@ -24,56 +24,55 @@
 #include "base/utils.h"
 #include "base/enums.h"
 #include "base/locale.h"
+#include "base/layout.h"
 #include "base/widget.h"
-#include "base/prop_names.h"
+#include "base/profiler.h"
+#include "base/prop_atom.h"
+#include "base/widget_cache.h"
 #include "base/widget_vtable.h"
 #include "base/image_manager.h"
 
-ret_t widget_move(widget_t* widget, xy_t x, xy_t y) {
-  event_t e = {EVT_MOVE, widget};
-  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+static ret_t widget_do_move_resize(widget_t* widget, xy_t x, xy_t y, wh_t w, wh_t h,
+                                   uint16_t type) {
+  event_t e = {type, widget};
+
+  if (widget_layout_defer_move_resize(widget, x, y, w, h, type) != RET_NOT_FOUND) {
+    return RET_OK;
+  }
 
   widget->x = x;
   widget->y = y;
-
+  widget->w = w;
+  widget->h = h;
   widget_invalidate(widget, NULL);
   widget_dispatch(widget, &e);
 
   return RET_OK;
 }
 
-ret_t widget_resize(widget_t* widget, wh_t w, wh_t h) {
-  event_t e = {EVT_RESIZE, widget};
+ret_t widget_move(widget_t* widget, xy_t x, xy_t y) {
   return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
 
-  widget->w = w;
-  widget->h = h;
+  return widget_do_move_resize(widget, x, y, widget->w, widget->h, EVT_MOVE);
+}
 
-  widget_invalidate(widget, NULL);
-  widget_dispatch(widget, &e);
+ret_t widget_resize(widget_t* widget, wh_t w, wh_t h) {
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
 
-  return RET_OK;
+  return widget_do_move_resize(widget, widget->x, widget->y, w, h, EVT_RESIZE);
 }
 
 ret_t widget_move_resize(widget_t* widget, xy_t x, xy_t y, wh_t w, wh_t h) {
-  event_t e = {EVT_MOVE_RESIZE, widget};
   return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
 
-  widget->x = x;
-  widget->y = y;
-  widget->w = w;
-  widget->h = h;
-  widget_invalidate(widget, NULL);
-  widget_dispatch(widget, &e);
-
-  return RET_OK;
+  return widget_do_move_resize(widget, x, y, w, h, EVT_MOVE_RESIZE);
 }
 
 ret_t widget_set_value(widget_t* widget, uint32_t value) {
   value_t v;
   return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
 
-  return widget_set_prop(widget, WIDGET_PROP_VALUE, value_set_uint32(&v, value));
+  return widget_set_prop_atom(widget, PROP_ATOM_VALUE, value_set_uint32(&v, value));
 }
 
 ret_t widget_use_style(widget_t* widget, const char* value) {
@@ -89,7 +88,7 @@ ret_t widget_set_text(widget_t* widget, const wchar_t* text) {
   value_t v;
   return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
 
-  return widget_set_prop(widget, WIDGET_PROP_TEXT, value_set_wstr(&v, text));
+  return widget_set_prop_atom(widget, PROP_ATOM_TEXT, value_set_wstr(&v, text));
 }
 
 ret_t widget_set_tr_text(widget_t* widget, const char* text) {
@@ -102,7 +101,7 @@ ret_t widget_set_tr_text(widget_t* widget, const char* text) {
   str_set(&(widget->tr_key), text);
 #endif /*WITH_DYNAMIC_TR*/
 
-  return widget_set_prop(widget, WIDGET_PROP_TEXT, value_set_str(&v, tr_text));
+  return widget_set_prop_atom(widget, PROP_ATOM_TEXT, value_set_str(&v, tr_text));
 }
 
 ret_t widget_re_translate_text(widget_t* widget) {
@@ -110,7 +109,7 @@ ret_t widget_re_translate_text(widget_t* widget) {
   if (widget->tr_key.size) {
     value_t v;
     const char* tr_text = locale_tr(locale(), widget->tr_key.str);
-    widget_set_prop(widget, WIDGET_PROP_TEXT, value_set_str(&v, tr_text));
+    widget_set_prop_atom(widget, PROP_ATOM_TEXT, value_set_str(&v, tr_text));
     widget_invalidate(widget, NULL);
   }
 
@@ -133,14 +132,14 @@ uint32_t widget_get_value(widget_t* widget) {
   value_t v;
   return_value_if_fail(widget != NULL, 0);
 
-  return widget_get_prop(widget, WIDGET_PROP_VALUE, &v) == RET_OK ? value_int(&v) : 0;
+  return widget_get_prop_atom(widget, PROP_ATOM_VALUE, &v) == RET_OK ? value_int(&v) : 0;
 }
 
 const wchar_t* widget_get_text(widget_t* widget) {
   value_t v;
   return_value_if_fail(widget != NULL, 0);
 
-  return widget_get_prop(widget, WIDGET_PROP_TEXT, &v) == RET_OK ? value_wstr(&v) : 0;
+  return widget_get_prop_atom(widget, PROP_ATOM_TEXT, &v) == RET_OK ? value_wstr(&v) : 0;
 }
 
 ret_t widget_set_name(widget_t* widget, const char* name) {
@@ -162,6 +161,49 @@ ret_t widget_set_enable(widget_t* widget, bool_t enable) {
   return RET_OK;
 }
 
+ret_t widget_set_opacity(widget_t* widget, uint8_t opacity) {
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  if (widget->opacity != opacity) {
+    widget->opacity = opacity;
+    widget_invalidate(widget, NULL);
+  }
+
+  return RET_OK;
+}
+
+ret_t widget_set_cache(widget_t* widget, bool_t cache) {
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  if (widget->cache != !!cache) {
+    widget_cache_enable(widget, cache);
+    widget_invalidate(widget, NULL);
+  }
+
+  return RET_OK;
+}
+
+ret_t widget_set_line_wrap(widget_t* widget, bool_t line_wrap) {
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  if (widget->line_wrap != !!line_wrap) {
+    widget->line_wrap = !!line_wrap;
+    widget_invalidate(widget, NULL);
+  }
+
+  return RET_OK;
+}
+
+ret_t widget_invalidate_text_layout(widget_t* widget) {
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  if (widget->text_layout != NULL) {
+    text_layout_invalidate(widget->text_layout);
+  }
+
+  return RET_OK;
+}
+
 ret_t widget_set_focused(widget_t* widget, bool_t focused) {
   return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
 
@@ -202,6 +244,33 @@ ret_t widget_destroy_children(widget_t* widget) {
   return RET_OK;
 }
 
+static ret_t widget_mark_ancestors_dirty(widget_t* widget) {
+  widget_t* iter = widget->parent;
+
+  while (iter != NULL && !(iter->subtree_dirty)) {
+    iter->subtree_dirty = TRUE;
+    iter = iter->parent;
+  }
+
+  return RET_OK;
+}
+
+static bool_t widget_children_need_paint(widget_t* widget) {
+  uint32_t i = 0;
+  uint32_t nr = 0;
+
+  if (widget->children != NULL) {
+    for (i = 0, nr = widget->children->size; i < nr; i++) {
+      widget_t* iter = (widget_t*)(widget->children->elms[i]);
+      if (iter->dirty || iter->subtree_dirty) {
+        return TRUE;
+      }
+    }
+  }
+
+  return FALSE;
+}
+
 ret_t widget_add_child(widget_t* widget, widget_t* child) {
   return_value_if_fail(widget != NULL && child != NULL, RET_BAD_PARAMS);
 
@@ -210,6 +279,10 @@ ret_t widget_add_child(widget_t* widget, widget_t* child) {
     widget->children = array_create(4);
   }
 
+  if (child->dirty || child->subtree_dirty) {
+    widget_mark_ancestors_dirty(child);
+  }
+
   return array_push(widget->children, child);
 }
 
@@ -368,12 +441,27 @@ ret_t widget_off_by_func(widget_t* widget, event_type_t type, event_func_t on_ev
   return emitter_off_by_func(widget->emitter, type, on_event, ctx);
 }
 
+static text_layout_t* widget_get_text_layout(widget_t* widget, canvas_t* c, wstr_t* text,
+                                             wh_t max_w) {
+  if (widget->text_layout == NULL) {
+    widget->text_layout = text_layout_create();
+    return_value_if_fail(widget->text_layout != NULL, NULL);
+  }
+
+  if (text_layout_update(widget->text_layout, c, text->str, text->size, max_w) != RET_OK) {
+    return NULL;
+  }
+
+  return widget->text_layout;
+}
+
 ret_t widget_draw_icon_text(widget_t* widget, canvas_t* c, const char* icon, wstr_t* text) {
   xy_t x = 0;
   xy_t y = 0;
   wh_t w = 0;
   rect_t dst;
   bitmap_t img;
+  text_layout_t* layout = NULL;
   style_t* style = &(widget->style);
   color_t trans = color_init(0, 0, 0, 0);
   color_t tc = style_get_color(style, STYLE_ID_TEXT_COLOR, trans);
@@ -405,7 +493,8 @@ ret_t widget_draw_icon_text(widget_t* widget, canvas_t* c, const char* icon, wst
         cy = dst.h >> 1;
         canvas_draw_icon(c, &img, cx, cy);
 
-        w = canvas_measure_text(c, text->str, text->size);
+        layout = widget_get_text_layout(widget, c, text, 0);
+        w = layout != NULL ? layout->w : canvas_measure_text(c, text->str, text->size);
         x = (widget->w - w) >> 1;
         y = widget->h - font_size;
         canvas_draw_text(c, text->str, text->size, x, y);
@@ -430,32 +519,12 @@ ret_t widget_draw_icon_text(widget_t* widget, canvas_t* c, const char* icon, wst
     int32_t align_v = style_get_int(style, STYLE_ID_TEXT_ALIGN_V, ALIGN_V_MIDDLE);
     int32_t margin = style_get_int(style, STYLE_ID_MARGIN, 2);
 
-    w = canvas_measure_text(c, text->str, text->size);
-    switch (align_v) {
-      case ALIGN_V_TOP:
-        y = margin;
-        break;
-      case ALIGN_V_BOTTOM:
-        y = widget->h - margin - font_size;
-        break;
-      default:
-        y = (widget->h - font_size) >> 1;
-        break;
-    }
-
-    switch (align_h) {
-      case ALIGN_H_LEFT:
-        x = margin;
-        break;
-      case ALIGN_H_RIGHT:
-        x = widget->w - margin - w;
-        break;
-      default:
-        x = (widget->w - w) >> 1;
-        break;
+    /*排版结果缓存在控件上，文本、字体和宽度不变时不再测量，绘制时只画裁剪区内的行。*/
+    rect_init(dst, margin, margin, widget->w - 2 * margin, widget->h - 2 * margin);
+    layout = widget_get_text_layout(widget, c, text, widget->line_wrap ? dst.w : 0);
+    if (layout != NULL) {
+      text_layout_draw(layout, c, &dst, (align_h_t)align_h, (align_v_t)align_v);
     }
-
-    canvas_draw_text(c, text->str, text->size, x, y);
   }
 
   return RET_OK;
@@ -505,10 +574,15 @@ ret_t widget_paint_helper(widget_t* widget, canvas_t* c, const char* icon, wstr_
   return RET_OK;
 }
 
-ret_t widget_paint(widget_t* widget, canvas_t* c) {
-  return_value_if_fail(widget != NULL && c != NULL, RET_BAD_PARAMS);
+#ifdef WITH_PROFILER
+static const char* widget_type_name(widget_t* widget) {
+  const key_type_value_t* item = widget_type_find_by_value(widget->type);
 
-  canvas_translate(c, widget->x, widget->y);
+  return item != NULL ? item->name : NULL;
+}
+#endif /*WITH_PROFILER*/
+
+static ret_t widget_paint_subtree(widget_t* widget, canvas_t* c) {
 #ifdef FAST_MODE
   if (widget->dirty) {
     widget_t* parent = widget->parent;
@@ -525,50 +599,96 @@ ret_t widget_paint(widget_t* widget, canvas_t* c) {
     widget_on_paint_background(widget, c);
     widget_on_paint_self(widget, c);
   }
+
+  if (widget->dirty || widget->subtree_dirty) {
+    widget_on_paint_children(widget, c);
+  }
 #else
   widget_on_paint_background(widget, c);
   widget_on_paint_self(widget, c);
-#endif
   widget_on_paint_children(widget, c);
+#endif
   widget_on_paint_done(widget, c);
 
+  return RET_OK;
+}
+
+ret_t widget_paint(widget_t* widget, canvas_t* c) {
+  return_value_if_fail(widget != NULL && c != NULL, RET_BAD_PARAMS);
+
+  PROFILER_BEGIN("widget_paint", widget_type_name(widget));
+  /*父控件重绘时，子控件也要重绘。*/
+  if (widget->parent != NULL && widget->parent->dirty) {
+    widget->dirty = TRUE;
+  }
+
+  canvas_translate(c, widget->x, widget->y);
+  /*缓存有效时直接拷贝位图，不需要绘制子控件。*/
+  if (!(widget->cache) || widget_cache_paint(widget, c) != RET_OK) {
+    widget_paint_subtree(widget, c);
+  }
+
   canvas_untranslate(c, widget->x, widget->y);
   widget->dirty = FALSE;
+  /*没有画到的子控件(比如不可见的)保持原来的状态，祖先的标志也要保留。*/
+  widget->subtree_dirty = widget_children_need_paint(widget);
+  PROFILER_END();
 
   return RET_OK;
 }
 
-ret_t widget_set_prop(widget_t* widget, const char* name, const value_t* v) {
+ret_t widget_set_prop_atom(widget_t* widget, prop_atom_t atom, const value_t* v) {
   ret_t ret = RET_OK;
   event_t e = {EVT_PROP_CHANGED, widget};
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(widget != NULL && atom != PROP_ATOM_NONE && v != NULL, RET_BAD_PARAMS);
   return_value_if_fail(widget->vt != NULL, RET_BAD_PARAMS);
 
-  if (str_fast_equal(name, WIDGET_PROP_X)) {
-    widget->x = (wh_t)value_int(v);
-  } else if (str_fast_equal(name, WIDGET_PROP_Y)) {
-    widget->y = (wh_t)value_int(v);
-  } else if (str_fast_equal(name, WIDGET_PROP_W)) {
-    widget->w = (wh_t)value_int(v);
-  } else if (str_fast_equal(name, WIDGET_PROP_H)) {
-    widget->h = (wh_t)value_int(v);
-  } else if (str_fast_equal(name, WIDGET_PROP_VISIBLE)) {
-    widget->visible = !!value_int(v);
-  } else if (str_fast_equal(name, WIDGET_PROP_STYLE)) {
-    widget->style_type = value_int(v);
-    widget_update_style(widget);
-  } else if (str_fast_equal(name, WIDGET_PROP_ENABLE)) {
-    widget->enable = !!value_int(v);
-  } else if (str_fast_equal(name, WIDGET_PROP_NAME)) {
-    widget_set_name(widget, value_str(v));
-  } else if (str_fast_equal(name, WIDGET_PROP_TEXT)) {
-    wstr_from_value(&(widget->text), v);
-  } else {
-    ret = RET_NOT_FOUND;
+  switch (atom) {
+    case PROP_ATOM_X:
+      widget->x = (wh_t)value_int(v);
+      break;
+    case PROP_ATOM_Y:
+      widget->y = (wh_t)value_int(v);
+      break;
+    case PROP_ATOM_W:
+      widget->w = (wh_t)value_int(v);
+      break;
+    case PROP_ATOM_H:
+      widget->h = (wh_t)value_int(v);
+      break;
+    case PROP_ATOM_VISIBLE:
+      widget->visible = !!value_int(v);
+      break;
+    case PROP_ATOM_STYLE:
+      widget->style_type = value_int(v);
+      widget_update_style(widget);
+      break;
+    case PROP_ATOM_ENABLE:
+      widget->enable = !!value_int(v);
+      break;
+    case PROP_ATOM_NAME:
+      widget_set_name(widget, value_str(v));
+      break;
+    case PROP_ATOM_TEXT:
+      wstr_from_value(&(widget->text), v);
+      widget_invalidate_text_layout(widget);
+      break;
+    case PROP_ATOM_CACHE:
+      widget_set_cache(widget, value_bool(v));
+      break;
+    case PROP_ATOM_LINE_WRAP:
+      widget_set_line_wrap(widget, value_bool(v));
+      break;
+    case PROP_ATOM_OPACITY:
+      widget_set_opacity(widget, (uint8_t)value_int(v));
+      break;
+    default:
+      ret = RET_NOT_FOUND;
+      break;
   }
 
   if (widget->vt->set_prop) {
-    ret_t ret1 = widget->vt->set_prop(widget, name, v);
+    ret_t ret1 = widget->vt->set_prop(widget, atom, v);
     if (ret == RET_NOT_FOUND) {
       ret = ret1;
     }
@@ -581,40 +701,86 @@ ret_t widget_set_prop(widget_t* widget, const char* name, const value_t* v) {
   return ret;
 }
 
-ret_t widget_get_prop(widget_t* widget, const char* name, value_t* v) {
-  ret_t ret = RET_OK;
+ret_t widget_set_prop(widget_t* widget, const char* name, const value_t* v) {
+  prop_atom_t atom = PROP_ATOM_NONE;
   return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+
+  /*没有原子化的属性名，不可能有控件认识它。*/
+  atom = prop_atom_lookup(name);
+  if (atom == PROP_ATOM_NONE) {
+    return RET_NOT_FOUND;
+  }
+
+  return widget_set_prop_atom(widget, atom, v);
+}
+
+ret_t widget_get_prop_atom(widget_t* widget, prop_atom_t atom, value_t* v) {
+  ret_t ret = RET_OK;
+  return_value_if_fail(widget != NULL && atom != PROP_ATOM_NONE && v != NULL, RET_BAD_PARAMS);
   return_value_if_fail(widget->vt != NULL, RET_BAD_PARAMS);
 
-  if (str_fast_equal(name, WIDGET_PROP_X)) {
-    value_set_int32(v, widget->x);
-  } else if (str_fast_equal(name, WIDGET_PROP_Y)) {
-    value_set_int32(v, widget->y);
-  } else if (str_fast_equal(name, WIDGET_PROP_W)) {
-    value_set_int32(v, widget->w);
-  } else if (str_fast_equal(name, WIDGET_PROP_H)) {
-    value_set_int32(v, widget->h);
-  } else if (str_fast_equal(name, WIDGET_PROP_VISIBLE)) {
-    value_set_bool(v, widget->visible);
-  } else if (str_fast_equal(name, WIDGET_PROP_STYLE)) {
-    value_set_int(v, widget->style_type);
-  } else if (str_fast_equal(name, WIDGET_PROP_ENABLE)) {
-    value_set_bool(v, widget->enable);
-  } else if (str_fast_equal(name, WIDGET_PROP_NAME)) {
-    value_set_str(v, widget->name.str);
-  } else if (str_fast_equal(name, WIDGET_PROP_TEXT)) {
-    value_set_wstr(v, widget->text.str);
-  } else {
-    if (widget->vt->get_prop) {
-      ret = widget->vt->get_prop(widget, name, v);
-    } else {
-      ret = RET_NOT_FOUND;
+  switch (atom) {
+    case PROP_ATOM_X:
+      value_set_int32(v, widget->x);
+      break;
+    case PROP_ATOM_Y:
+      value_set_int32(v, widget->y);
+      break;
+    case PROP_ATOM_W:
+      value_set_int32(v, widget->w);
+      break;
+    case PROP_ATOM_H:
+      value_set_int32(v, widget->h);
+      break;
+    case PROP_ATOM_VISIBLE:
+      value_set_bool(v, widget->visible);
+      break;
+    case PROP_ATOM_STYLE:
+      value_set_int(v, widget->style_type);
+      break;
+    case PROP_ATOM_ENABLE:
+      value_set_bool(v, widget->enable);
+      break;
+    case PROP_ATOM_NAME:
+      value_set_str(v, widget->name.str);
+      break;
+    case PROP_ATOM_TEXT:
+      value_set_wstr(v, widget->text.str);
+      break;
+    case PROP_ATOM_CACHE:
+      value_set_bool(v, widget->cache);
+      break;
+    case PROP_ATOM_LINE_WRAP:
+      value_set_bool(v, widget->line_wrap);
+      break;
+    case PROP_ATOM_OPACITY:
+      value_set_int(v, widget->opacity);
+      break;
+    default: {
+      if (widget->vt->get_prop) {
+        ret = widget->vt->get_prop(widget, atom, v);
+      } else {
+        ret = RET_NOT_FOUND;
+      }
+      break;
     }
   }
 
   return ret;
 }
 
+ret_t widget_get_prop(widget_t* widget, const char* name, value_t* v) {
+  prop_atom_t atom = PROP_ATOM_NONE;
+  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+
+  atom = prop_atom_lookup(name);
+  if (atom == PROP_ATOM_NONE) {
+    return RET_NOT_FOUND;
+  }
+
+  return widget_get_prop_atom(widget, atom, v);
+}
+
 ret_t widget_on_paint_background(widget_t* widget, canvas_t* c) {
   ret_t ret = RET_OK;
   return_value_if_fail(widget != NULL && c != NULL, RET_BAD_PARAMS);
@@ -636,6 +802,7 @@ ret_t widget_on_paint_self(widget_t* widget, canvas_t* c) {
   return_value_if_fail(widget != NULL && c != NULL, RET_BAD_PARAMS);
   return_value_if_fail(widget->vt != NULL, RET_BAD_PARAMS);
 
+  PROFILER_BEGIN("widget_on_paint_self", widget_type_name(widget));
   if (widget->vt->on_paint_self) {
     ret = widget->vt->on_paint_self(widget, c);
   } else {
@@ -646,6 +813,7 @@ ret_t widget_on_paint_self(widget_t* widget, canvas_t* c) {
 
     widget_dispatch(widget, (event_t*)&paint);
   }
+  PROFILER_END();
 
   return ret;
 }
@@ -852,6 +1020,17 @@ ret_t widget_destroy(widget_t* widget) {
     TKMEM_FREE(widget->layout_params);
   }
 
+  if (widget->cache) {
+    widget_cache_enable(widget, FALSE);
+  }
+
+  if (widget->text_layout != NULL) {
+    text_layout_destroy(widget->text_layout);
+  }
+
+  /*在布局事务中销毁的控件，事务结束时不能再访问它。*/
+  widget_layout_forget(widget);
+
   str_reset(&(widget->name));
 #ifdef WITH_DYNAMIC_TR
   str_reset(&(widget->tr_key));
@@ -864,19 +1043,12 @@ ret_t widget_destroy(widget_t* widget) {
 }
 
 static ret_t widget_set_dirty(widget_t* widget) {
-  uint32_t i = 0;
-  uint32_t n = 0;
   return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
 
+  /*子控件不需要标记，绘制时从父控件继承。*/
   widget->dirty = TRUE;
-  if (widget->children != NULL) {
-    for (i = 0, n = widget->children->size; i < n; i++) {
-      widget_t* iter = (widget_t*)(widget->children->elms[i]);
-      widget_set_dirty(iter);
-    }
-  }
 
-  return RET_OK;
+  return widget_mark_ancestors_dirty(widget);
 }
 
 ret_t widget_invalidate(widget_t* widget, rect_t* r) {
@@ -890,7 +1062,15 @@ ret_t widget_invalidate(widget_t* widget, rect_t* r) {
   return_value_if_fail(r->x >= 0 && r->y >= 0, RET_BAD_PARAMS);
   return_value_if_fail((r->x + r->w) <= widget->w && (r->y + r->h) <= widget->h, RET_BAD_PARAMS);
 
+  widget_cache_invalidate(widget);
+
+  /*在布局事务中只记录脏矩形，事务结束时统一刷新。*/
+  if (widget_layout_defer_invalidate(widget, r) != RET_NOT_FOUND) {
+    return RET_OK;
+  }
+
   widget_set_dirty(widget);
+
   if (widget->vt && widget->vt->invalidate) {
     return widget->vt->invalidate(widget, r);
   } else {
@@ -923,6 +1103,7 @@ widget_t* widget_init(widget_t* widget, widget_t* parent, uint8_t type) {
   widget->emitter = NULL;
   widget->children = NULL;
   widget->state = WIDGET_STATE_NORMAL;
+  widget->opacity = 0xff;
 
   if (parent) {
     widget_add_child(parent, widget);
@@ -30,7 +30,8 @@
 #include "base/emitter.h"
 #include "base/canvas.h"
 #include "base/theme.h"
-#include "base/prop_names.h"
+#include "base/text_layout.h"
+#include "base/prop_atom.h"
 #include "base/layout_def.h"
 
 BEGIN_C_DECLS
@@ -205,6 +206,16 @@ typedef enum _widget_type_t {
    * 通用容器和自绘控件。
    */
   WIDGET_VIEW,
+  /**
+   * @const WIDGET_LIST_VIEW
+   * 列表视图。
+   */
+  WIDGET_LIST_VIEW,
+  /**
+   * @const WIDGET_SCROLL_VIEW
+   * 滚动视图。
+   */
+  WIDGET_SCROLL_VIEW,
 
   WIDGET_NR
 } widget_type_t;
@@ -225,8 +236,8 @@ typedef ret_t (*widget_on_pointer_down_t)(widget_t* widget, pointer_event_t* e);
 typedef ret_t (*widget_on_pointer_move_t)(widget_t* widget, pointer_event_t* e);
 typedef ret_t (*widget_on_pointer_up_t)(widget_t* widget, pointer_event_t* e);
 typedef ret_t (*widget_on_layout_children_t)(widget_t* widget);
-typedef ret_t (*widget_get_prop_t)(widget_t* widget, const char* name, value_t* v);
-typedef ret_t (*widget_set_prop_t)(widget_t* widget, const char* name, const value_t* v);
+typedef ret_t (*widget_get_prop_t)(widget_t* widget, prop_atom_t atom, value_t* v);
+typedef ret_t (*widget_set_prop_t)(widget_t* widget, prop_atom_t atom, const value_t* v);
 typedef ret_t (*widget_grab_t)(widget_t* widget, widget_t* child);
 typedef ret_t (*widget_ungrab_t)(widget_t* widget, widget_t* child);
 typedef widget_t* (*widget_find_target_t)(widget_t* widget, xy_t x, xy_t y);
@@ -302,6 +313,12 @@ struct _widget_t {
    * 控件的状态。
    */
   uint8_t state;
+  /**
+   * @property {uint8_t} opacity
+   * @readonly
+   * 不透明度(0-255)。目前只有窗口管理器的合成模式对窗口使用它。
+   */
+  uint8_t opacity;
   /**
    * @property {bool_t} enable
    * @readonly
@@ -336,6 +353,37 @@ struct _widget_t {
    */
   uint8_t dirty : 1;
 
+  /**
+   * @property {bool_t} subtree_dirty
+   * @private
+   * @scriptable no
+   * 标识有子控件(或更深的后代)需要重绘。
+   * 设置时由下往上传播，遇到已经设置的祖先就停止，所以重复刷新同一个控件是O(1)的。
+   */
+  uint8_t subtree_dirty : 1;
+
+  /**
+   * @property {bool_t} layout_pending
+   * @private
+   * @scriptable no
+   * 标识控件在布局事务中有尚未分发的位置/大小变化事件。
+   */
+  uint8_t layout_pending : 1;
+
+  /**
+   * @property {bool_t} cache
+   * @readonly
+   * 是否把控件和子控件缓存为位图(适合内容很少变化的控件)。请参考widget_cache_t。
+   */
+  uint8_t cache : 1;
+
+  /**
+   * @property {bool_t} line_wrap
+   * @readonly
+   * 文本超出控件宽度时是否自动换行。
+   */
+  uint8_t line_wrap : 1;
+
   /**
    * @property {str_t} name
    * @private
@@ -388,6 +436,13 @@ struct _widget_t {
    * 文本。用途视具体情况而定。
    */
   wstr_t text;
+  /**
+   * @property {text_layout_t*} text_layout
+   * @private
+   * @scriptable no
+   * 文本排版缓存，第一次绘制文本时创建。
+   */
+  text_layout_t* text_layout;
 #ifdef WITH_DYNAMIC_TR
   /**
    * @property {str_t} tr_key
@@ -594,6 +649,45 @@ ret_t widget_set_name(widget_t* widget, const char* name);
  */
 ret_t widget_set_enable(widget_t* widget, bool_t enable);
 
+/**
+ * @method widget_set_opacity
+ * 设置控件的不透明度。
+ * @param {widget_t*} widget 控件对象。
+ * @param {uint8_t} opacity 不透明度(0-255)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_set_opacity(widget_t* widget, uint8_t opacity);
+
+/**
+ * @method widget_set_cache
+ * 设置是否把控件和子控件缓存为位图。
+ * @param {widget_t*} widget 控件对象。
+ * @param {bool_t} cache 是否缓存。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_set_cache(widget_t* widget, bool_t cache);
+
+/**
+ * @method widget_set_line_wrap
+ * 设置文本超出控件宽度时是否自动换行。
+ * @param {widget_t*} widget 控件对象。
+ * @param {bool_t} line_wrap 是否自动换行。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_set_line_wrap(widget_t* widget, bool_t line_wrap);
+
+/**
+ * @method widget_invalidate_text_layout
+ * 让文本排版缓存失效。子类直接修改widget->text的内容后需要调用。
+ * @param {widget_t*} widget 控件对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_invalidate_text_layout(widget_t* widget);
+
 /**
  * @method widget_set_focused
  * 设置控件的是否聚焦。
@@ -775,7 +869,7 @@ ret_t widget_dispatch(widget_t* widget, event_t* e);
 
 /**
  * @method widget_get_prop
- * 通用的获取控件属性的函数。
+ * 通用的获取控件属性的函数。属性名先转换成原子，再调用widget_get_prop_atom。
  * @param {widget_t*} widget 控件对象。
  * @param {char*} name 属性的名称。
  * @param {value_t*} v 属性的值。
@@ -786,7 +880,7 @@ ret_t widget_get_prop(widget_t* widget, const char* name, value_t* v);
 
 /**
  * @method widget_set_prop
- * 通用的设置控件属性的函数。
+ * 通用的设置控件属性的函数。属性名先转换成原子，再调用widget_set_prop_atom。
  * @param {widget_t*} widget 控件对象。
  * @param {char*} name 属性的名称。
  * @param {value_t*} v 属性的值。
@@ -795,6 +889,30 @@ ret_t widget_get_prop(widget_t* widget, const char* name, value_t* v);
  */
 ret_t widget_set_prop(widget_t* widget, const char* name, const value_t* v);
 
+/**
+ * @method widget_get_prop_atom
+ * 通用的获取控件属性的函数(属性名已经原子化)。
+ * @scriptable no
+ * @param {widget_t*} widget 控件对象。
+ * @param {prop_atom_t} atom 属性名的原子。
+ * @param {value_t*} v 属性的值。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_get_prop_atom(widget_t* widget, prop_atom_t atom, value_t* v);
+
+/**
+ * @method widget_set_prop_atom
+ * 通用的设置控件属性的函数(属性名已经原子化)。
+ * @scriptable no
+ * @param {widget_t*} widget 控件对象。
+ * @param {prop_atom_t} atom 属性名的原子。
+ * @param {value_t*} v 属性的值。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_set_prop_atom(widget_t* widget, prop_atom_t atom, const value_t* v);
+
 /**
  * @method widget_grab
  * 让指定子控件抓住事件。抓住之后，事件由窗口直接分发给该控件。
@@ -0,0 +1,289 @@
+/**
+ * File:   widget_cache.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  cache static widget subtree as bitmap
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-13 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/array.h"
+#include "base/widget_cache.h"
+
+#ifndef WIDGET_CACHE_BUDGET
+#define WIDGET_CACHE_BUDGET (512 * 1024)
+#endif /*WIDGET_CACHE_BUDGET*/
+
+#ifndef WIDGET_CACHE_MIN_FREE
+#define WIDGET_CACHE_MIN_FREE (32 * 1024)
+#endif /*WIDGET_CACHE_MIN_FREE*/
+
+typedef struct _widget_cache_entry_t {
+  widget_t* widget;
+  bitmap_t img;
+  uint32_t size;
+  uint32_t last_used;
+  bool_t stale;
+} widget_cache_entry_t;
+
+static array_t s_entries;
+static uint32_t s_used = 0;
+static uint32_t s_clock = 0;
+static uint32_t s_enabled_nr = 0;
+static uint32_t s_bpp = 4;
+static uint32_t s_budget = WIDGET_CACHE_BUDGET;
+
+static int widget_cache_entry_compare(const void* a, const void* b) {
+  const widget_cache_entry_t* entry = (const widget_cache_entry_t*)a;
+
+  return entry->widget == b ? 0 : -1;
+}
+
+static widget_cache_entry_t* widget_cache_find(widget_t* widget) {
+  if (s_entries.size == 0) {
+    return NULL;
+  }
+
+  return (widget_cache_entry_t*)array_find(&s_entries, widget_cache_entry_compare, widget);
+}
+
+static ret_t widget_cache_entry_destroy(widget_cache_entry_t* entry) {
+  s_used -= entry->size;
+  if (entry->img.destroy != NULL) {
+    bitmap_destroy(&(entry->img));
+  }
+  TKMEM_FREE(entry);
+
+  return RET_OK;
+}
+
+static ret_t widget_cache_remove(widget_t* widget) {
+  widget_cache_entry_t* entry = widget_cache_find(widget);
+
+  if (entry != NULL) {
+    array_remove(&s_entries, NULL, entry);
+    widget_cache_entry_destroy(entry);
+  }
+
+  return RET_OK;
+}
+
+static ret_t widget_cache_evict_lru(void) {
+  uint32_t i = 0;
+  widget_cache_entry_t* lru = NULL;
+
+  for (i = 0; i < s_entries.size; i++) {
+    widget_cache_entry_t* iter = (widget_cache_entry_t*)(s_entries.elms[i]);
+    if (lru == NULL || iter->last_used < lru->last_used) {
+      lru = iter;
+    }
+  }
+
+  return_value_if_fail(lru != NULL, RET_NOT_FOUND);
+  array_remove(&s_entries, NULL, lru);
+
+  return widget_cache_entry_destroy(lru);
+}
+
+static ret_t widget_cache_reserve(uint32_t size) {
+  if (size > s_budget) {
+    return RET_OOM;
+  }
+
+  while (s_used + size > s_budget) {
+    return_value_if_fail(widget_cache_evict_lru() == RET_OK, RET_OOM);
+  }
+
+#ifndef HAS_STD_MALLOC
+  /*堆快用完时，缓存让位给其它模块。*/
+  if (mem_stat().free < size + WIDGET_CACHE_MIN_FREE) {
+    widget_cache_clear();
+    if (mem_stat().free < size + WIDGET_CACHE_MIN_FREE) {
+      return RET_OOM;
+    }
+  }
+#endif /*HAS_STD_MALLOC*/
+
+  return RET_OK;
+}
+
+static widget_cache_entry_t* widget_cache_create(widget_t* widget) {
+  widget_cache_entry_t* entry = NULL;
+  uint32_t size = widget->w * widget->h * s_bpp;
+
+  /*超出预算的控件直接正常绘制。*/
+  if (widget_cache_reserve(size) != RET_OK) {
+    return NULL;
+  }
+
+  entry = TKMEM_ZALLOC(widget_cache_entry_t);
+  return_value_if_fail(entry != NULL, NULL);
+
+  entry->widget = widget;
+  entry->stale = TRUE;
+  entry->img.w = widget->w;
+  entry->img.h = widget->h;
+
+  if (array_push(&s_entries, entry) != RET_OK) {
+    TKMEM_FREE(entry);
+    return NULL;
+  }
+
+  return entry;
+}
+
+static ret_t widget_cache_render(widget_cache_entry_t* entry, canvas_t* c) {
+  rect_t r;
+  canvas_t lc;
+  lcd_t* layer = NULL;
+  widget_t* widget = entry->widget;
+  color_t black = color_init(0, 0, 0, 0xff);
+  color_t bg = black;
+
+  layer = lcd_create_layer(c->lcd, &(entry->img));
+  if (layer == NULL) {
+    /*内存不足时释放全部缓存，本次正常绘制，下次绘制时再试。*/
+    widget_cache_clear();
+    return RET_OOM;
+  }
+
+  if (entry->size == 0) {
+    s_bpp = entry->img.format == BITMAP_FMT_RGB565 ? 2 : 4;
+    entry->size = entry->img.w * entry->img.h * s_bpp;
+    s_used += entry->size;
+  }
+
+  if (widget->parent != NULL) {
+    bg = style_get_color(&(widget->parent->style), STYLE_ID_BG_COLOR, black);
+  }
+
+  rect_init(r, 0, 0, widget->w, widget->h);
+  canvas_init(&lc, layer, c->font_manager);
+  canvas_begin_frame(&lc, &r, LCD_DRAW_OFFLINE);
+  canvas_set_fill_color(&lc, bg);
+  canvas_fill_rect(&lc, 0, 0, widget->w, widget->h);
+
+  widget->dirty = TRUE;
+  widget_on_paint_background(widget, &lc);
+  widget_on_paint_self(widget, &lc);
+  widget_on_paint_children(widget, &lc);
+  widget_on_paint_done(widget, &lc);
+
+  canvas_end_frame(&lc);
+  lcd_destroy(layer);
+  entry->stale = FALSE;
+
+  return RET_OK;
+}
+
+ret_t widget_cache_set_budget(uint32_t budget) {
+  s_budget = budget;
+
+  while (s_used > s_budget) {
+    if (widget_cache_evict_lru() != RET_OK) {
+      break;
+    }
+  }
+
+  return RET_OK;
+}
+
+uint32_t widget_cache_get_used(void) {
+  return s_used;
+}
+
+ret_t widget_cache_clear(void) {
+  while (s_entries.size > 0) {
+    widget_cache_entry_destroy((widget_cache_entry_t*)array_pop(&s_entries));
+  }
+
+  return RET_OK;
+}
+
+ret_t widget_cache_enable(widget_t* widget, bool_t enable) {
+  return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
+
+  enable = !!enable;
+  if (widget->cache == enable) {
+    return RET_OK;
+  }
+
+  widget->cache = enable;
+  if (enable) {
+    s_enabled_nr++;
+  } else {
+    s_enabled_nr--;
+    widget_cache_remove(widget);
+  }
+
+  return RET_OK;
+}
+
+ret_t widget_cache_invalidate(widget_t* widget) {
+  widget_t* iter = widget;
+
+  /*没有控件启用缓存时什么都不做。*/
+  if (s_enabled_nr == 0) {
+    return RET_OK;
+  }
+
+  while (iter != NULL) {
+    if (iter->cache) {
+      widget_cache_entry_t* entry = widget_cache_find(iter);
+      if (entry != NULL) {
+        entry->stale = TRUE;
+      }
+    }
+    iter = iter->parent;
+  }
+
+  return RET_OK;
+}
+
+ret_t widget_cache_paint(widget_t* widget, canvas_t* c) {
+  rect_t r;
+  widget_cache_entry_t* entry = NULL;
+  return_value_if_fail(widget != NULL && c != NULL && c->lcd != NULL, RET_BAD_PARAMS);
+
+  if (c->lcd->create_layer == NULL || widget->w <= 0 || widget->h <= 0) {
+    return RET_NOT_FOUND;
+  }
+
+  entry = widget_cache_find(widget);
+  if (entry != NULL && (entry->img.w != widget->w || entry->img.h != widget->h)) {
+    widget_cache_remove(widget);
+    entry = NULL;
+  }
+
+  if (entry == NULL) {
+    entry = widget_cache_create(widget);
+    if (entry == NULL) {
+      return RET_OOM;
+    }
+  }
+
+  if (entry->stale) {
+    if (widget_cache_render(entry, c) != RET_OK) {
+      return RET_OOM;
+    }
+  }
+
+  rect_init(r, 0, 0, widget->w, widget->h);
+  canvas_draw_image(c, &(entry->img), &r, &r);
+  entry->last_used = ++s_clock;
+
+  return RET_OK;
+}
@@ -0,0 +1,98 @@
+/**
+ * File:   widget_cache.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  cache static widget subtree as bitmap
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-13 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_WIDGET_CACHE_H
+#define TK_WIDGET_CACHE_H
+
+#include "base/widget.h"
+
+BEGIN_C_DECLS
+
+/**
+ * @class widget_cache_t
+ * @annotation ["fake"]
+ * 控件缓存。
+ * 设置了cache属性的控件，第一次绘制时把自己和全部子控件绘制到一张与lcd格式相同的离屏位图上，
+ * 之后直接把位图拷贝到屏幕上。控件或者子控件调用widget_invalidate时缓存失效，下次绘制时重新生成。
+ *
+ * 注意：
+ * 1.只有提供了create_layer的lcd(framebuffer类型)才支持，其它lcd正常绘制。
+ * 2.离屏位图没有透明度，控件需要用不透明的背景覆盖自己的区域。
+ * 3.全部缓存占用的内存不超过预算，超出时按最近最少使用的原则释放。
+ */
+
+/**
+ * @method widget_cache_set_budget
+ * 设置缓存可以使用的内存大小，超出的部分会立即释放。
+ * @param {uint32_t} budget 内存大小(字节)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_cache_set_budget(uint32_t budget);
+
+/**
+ * @method widget_cache_get_used
+ * 获取缓存已经使用的内存大小。
+ *
+ * @return {uint32_t} 返回内存大小(字节)。
+ */
+uint32_t widget_cache_get_used(void);
+
+/**
+ * @method widget_cache_clear
+ * 释放全部缓存(内存不足时调用)。控件下次绘制时重新生成。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_cache_clear(void);
+
+/**
+ * @method widget_cache_enable
+ * 启用/禁用控件的缓存。
+ * @param {widget_t*} widget 控件对象。
+ * @param {bool_t} enable 是否启用。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_cache_enable(widget_t* widget, bool_t enable);
+
+/**
+ * @method widget_cache_invalidate
+ * 控件需要重绘时，让它自己和祖先控件的缓存失效。
+ * @param {widget_t*} widget 控件对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t widget_cache_invalidate(widget_t* widget);
+
+/**
+ * @method widget_cache_paint
+ * 用缓存绘制控件(canvas已经平移到控件的位置)。
+ * @param {widget_t*} widget 控件对象。
+ * @param {canvas_t*} c 画布对象。
+ *
+ * @return {ret_t} 返回RET_OK表示已经绘制，否则需要按正常的方式绘制。
+ */
+ret_t widget_cache_paint(widget_t* widget, canvas_t* c);
+
+END_C_DECLS
+
+#endif /*TK_WIDGET_CACHE_H*/
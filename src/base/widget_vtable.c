@@ -66,6 +66,34 @@ ret_t widget_on_paint_children_default(widget_t* widget, canvas_t* c) {
   return RET_OK;
 }
 
+ret_t widget_on_paint_children_clip(widget_t* widget, canvas_t* c) {
+  xy_t clip_left = 0;
+  xy_t clip_top = 0;
+  xy_t clip_right = 0;
+  xy_t clip_bottom = 0;
+  return_value_if_fail(widget != NULL && c != NULL, RET_BAD_PARAMS);
+
+  clip_left = c->clip_left;
+  clip_top = c->clip_top;
+  clip_right = c->clip_right;
+  clip_bottom = c->clip_bottom;
+
+  /*部分可见的子控件不能画到控件外面。*/
+  c->clip_left = ftk_max(clip_left, c->ox);
+  c->clip_top = ftk_max(clip_top, c->oy);
+  c->clip_right = ftk_min(clip_right, c->ox + widget->w);
+  c->clip_bottom = ftk_min(clip_bottom, c->oy + widget->h);
+
+  widget_on_paint_children_default(widget, c);
+
+  c->clip_left = clip_left;
+  c->clip_top = clip_top;
+  c->clip_right = clip_right;
+  c->clip_bottom = clip_bottom;
+
+  return RET_OK;
+}
+
 ret_t widget_on_keydown_default(widget_t* widget, key_event_t* e) {
   return_value_if_fail(widget != NULL && e != NULL, RET_BAD_PARAMS);
 
@@ -102,14 +130,14 @@ ret_t widget_on_pointer_up_default(widget_t* widget, pointer_event_t* e) {
   return RET_OK;
 }
 
-ret_t widget_get_prop_default(widget_t* widget, const char* name, value_t* v) {
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+ret_t widget_get_prop_default(widget_t* widget, prop_atom_t atom, value_t* v) {
+  return_value_if_fail(widget != NULL && atom != PROP_ATOM_NONE && v != NULL, RET_BAD_PARAMS);
 
   return RET_NOT_FOUND;
 }
 
-ret_t widget_set_prop_default(widget_t* widget, const char* name, const value_t* v) {
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+ret_t widget_set_prop_default(widget_t* widget, prop_atom_t atom, const value_t* v) {
+  return_value_if_fail(widget != NULL && atom != PROP_ATOM_NONE && v != NULL, RET_BAD_PARAMS);
 
   return RET_NOT_FOUND;
 }
@@ -30,14 +30,15 @@ ret_t widget_invalidate_default(widget_t* widget, rect_t* r);
 ret_t widget_on_event_default(widget_t* widget, event_t* e);
 ret_t widget_on_paint_self_default(widget_t* widget, canvas_t* c);
 ret_t widget_on_paint_children_default(widget_t* widget, canvas_t* c);
+ret_t widget_on_paint_children_clip(widget_t* widget, canvas_t* c);
 ret_t widget_on_keydown_default(widget_t* widget, key_event_t* e);
 ret_t widget_on_keyup_default(widget_t* widget, key_event_t* e);
 ret_t widget_on_click_default(widget_t* widget, pointer_event_t* e);
 ret_t widget_on_pointer_down_default(widget_t* widget, pointer_event_t* e);
 ret_t widget_on_pointer_move_default(widget_t* widget, pointer_event_t* e);
 ret_t widget_on_pointer_up_default(widget_t* widget, pointer_event_t* e);
-ret_t widget_get_prop_default(widget_t* widget, const char* name, value_t* v);
-ret_t widget_set_prop_default(widget_t* widget, const char* name, const value_t* v);
+ret_t widget_get_prop_default(widget_t* widget, prop_atom_t atom, value_t* v);
+ret_t widget_set_prop_default(widget_t* widget, prop_atom_t atom, const value_t* v);
 widget_t* widget_find_target_default(widget_t* widget, xy_t x, xy_t y);
 
 const widget_vtable_t* widget_vtable_default(void);
@@ -30,11 +30,11 @@ static ret_t window_on_paint_self(widget_t* widget, canvas_t* c) {
   return widget_paint_helper(widget, c, NULL, NULL);
 }
 
-static ret_t window_get_prop(widget_t* widget, const char* name, value_t* v) {
+static ret_t window_get_prop(widget_t* widget, prop_atom_t atom, value_t* v) {
   window_t* window = WINDOW(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
 
-  if (str_fast_equal(name, WIDGET_PROP_ANIM_HINT)) {
+  if (atom == PROP_ATOM_ANIM_HINT) {
     value_set_str(v, window->anim_hint.str);
     return RET_OK;
   }
@@ -42,11 +42,11 @@ static ret_t window_get_prop(widget_t* widget, const char* name, value_t* v) {
   return RET_NOT_FOUND;
 }
 
-static ret_t window_set_prop(widget_t* widget, const char* name, const value_t* v) {
+static ret_t window_set_prop(widget_t* widget, prop_atom_t atom, const value_t* v) {
   window_t* window = WINDOW(widget);
-  return_value_if_fail(widget != NULL && name != NULL && v != NULL, RET_BAD_PARAMS);
+  return_value_if_fail(widget != NULL && v != NULL, RET_BAD_PARAMS);
 
-  if (str_fast_equal(name, WIDGET_PROP_ANIM_HINT)) {
+  if (atom == PROP_ATOM_ANIM_HINT) {
     str_from_value(&(window->anim_hint), v);
     return RET_OK;
   }
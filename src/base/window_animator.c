@@ -21,14 +21,52 @@
 
 #include "base/window_animator.h"
 
-ret_t window_animator_update(window_animator_t* wa, uint32_t time_ms) {
+static ret_t window_animator_update_stat(window_animator_t* wa, uint32_t time_ms) {
+  window_animator_stat_t* stat = &(wa->stat);
+
+  if (stat->frames > 0) {
+    uint32_t elapsed = time_ms - wa->last_frame_time;
+    if (elapsed > WINDOW_ANIMATOR_FRAME_INTERVAL) {
+      stat->dropped_frames += (elapsed - 1) / WINDOW_ANIMATOR_FRAME_INTERVAL;
+    }
+  }
+
+  stat->frames++;
+  stat->cost = time_ms - wa->start_time;
+  stat->fps = stat->cost > 0 ? (stat->frames - 1) * 1000 / stat->cost : 0;
+  wa->last_frame_time = time_ms;
+
+  return RET_OK;
+}
+
+/*framebuffer的内容在帧之间保持不变，只需要更新当前窗口上一帧和这一帧覆盖的区域。*/
+static ret_t window_animator_update_dirty_rect(window_animator_t* wa) {
   rect_t r;
-  widget_t* wm = NULL;
+  widget_t* wm = wa->curr_win->parent;
+  lcd_t* lcd = wa->canvas->lcd;
+
+  rect_init(wa->dirty_rect, wm->x, wm->y, wm->w, wm->h);
+  if (wa->get_dirty_rect == NULL || lcd->type != LCD_FRAMEBUFFER) {
+    return RET_OK;
+  }
+
+  wa->get_dirty_rect(wa, &r);
+  rect_intersect(&r, &(wa->dirty_rect));
+
+  if (wa->stat.frames > 0) {
+    wa->dirty_rect = r;
+    rect_merge(&(wa->dirty_rect), &(wa->last_rect));
+  }
+  wa->last_rect = r;
+
+  return RET_OK;
+}
+
+ret_t window_animator_update(window_animator_t* wa, uint32_t time_ms) {
   canvas_t* c = NULL;
   return_value_if_fail(wa != NULL, RET_FAIL);
 
   c = wa->canvas;
-  wm = wa->curr_win->parent;
   if (wa->start_time == 0) {
     wa->start_time = time_ms;
   }
@@ -44,8 +82,9 @@ ret_t window_animator_update(window_animator_t* wa, uint32_t time_ms) {
     wa->percent = wa->time_percent;
   }
 
-  rect_init(r, wm->x, wm->y, wm->w, wm->h);
-  ENSURE(canvas_begin_frame(c, &r, LCD_DRAW_ANIMATION) == RET_OK);
+  window_animator_update_dirty_rect(wa);
+  window_animator_update_stat(wa, time_ms);
+  ENSURE(canvas_begin_frame(c, &(wa->dirty_rect), LCD_DRAW_ANIMATION) == RET_OK);
 
   if (wa->draw_prev_window != NULL) {
     wa->draw_prev_window(wa);
@@ -60,6 +99,14 @@ ret_t window_animator_update(window_animator_t* wa, uint32_t time_ms) {
   return wa->time_percent >= 1 ? RET_DONE : RET_OK;
 }
 
+ret_t window_animator_get_stat(window_animator_t* wa, window_animator_stat_t* stat) {
+  return_value_if_fail(wa != NULL && stat != NULL, RET_BAD_PARAMS);
+
+  *stat = wa->stat;
+
+  return RET_OK;
+}
+
 ret_t window_animator_destroy(window_animator_t* wa) {
   return_value_if_fail(wa != NULL && wa->destroy != NULL, RET_FAIL);
 
@@ -33,6 +33,11 @@ typedef struct _window_animator_t window_animator_t;
 typedef ret_t (*window_animator_update_percent_t)(window_animator_t* wa);
 typedef ret_t (*window_animator_draw_window_t)(window_animator_t* wa);
 typedef ret_t (*window_animator_destroy_t)(window_animator_t* wa);
+typedef ret_t (*window_animator_get_dirty_rect_t)(window_animator_t* wa, rect_t* r);
+
+#ifndef WINDOW_ANIMATOR_FRAME_INTERVAL
+#define WINDOW_ANIMATOR_FRAME_INTERVAL 16
+#endif /*WINDOW_ANIMATOR_FRAME_INTERVAL*/
 
 /**
  * @enum window_animator_type_t
@@ -72,6 +77,37 @@ typedef ret_t (*window_animator_destroy_t)(window_animator_t* wa);
  */
 #define WINDOW_ANIMATOR_VTRANSLATE "vtranslate"
 
+/**
+ * @class window_animator_stat_t
+ * 窗口动画的统计信息。
+ */
+typedef struct _window_animator_stat_t {
+  /**
+   * @property {uint32_t} frames
+   * @readonly
+   * 绘制的帧数。
+   */
+  uint32_t frames;
+  /**
+   * @property {uint32_t} dropped_frames
+   * @readonly
+   * 丢掉的帧数(按每WINDOW_ANIMATOR_FRAME_INTERVAL毫秒一帧计算)。
+   */
+  uint32_t dropped_frames;
+  /**
+   * @property {uint32_t} cost
+   * @readonly
+   * 从第一帧到最后一帧的时间(毫秒)。
+   */
+  uint32_t cost;
+  /**
+   * @property {uint32_t} fps
+   * @readonly
+   * 平均帧率。
+   */
+  uint32_t fps;
+} window_animator_stat_t;
+
 /**
  * @class window_animator_t
  * 窗口动画。
@@ -81,6 +117,8 @@ typedef struct _window_animator_t {
   window_animator_draw_window_t draw_prev_window;
   window_animator_draw_window_t draw_curr_window;
   window_animator_destroy_t destroy;
+  /*返回本帧当前窗口所在的区域。为NULL时每帧更新整个屏幕(比如平移动画)。*/
+  window_animator_get_dirty_rect_t get_dirty_rect;
 
   uint32_t duration;
   uint32_t start_time;
@@ -100,6 +138,13 @@ typedef struct _window_animator_t {
   float_t percent;
   canvas_t* canvas;
   float_t time_percent;
+
+  /*本帧需要更新的区域，framebuffer只更新和提交这个区域。*/
+  rect_t dirty_rect;
+  /*上一帧当前窗口所在的区域。*/
+  rect_t last_rect;
+  uint32_t last_frame_time;
+  window_animator_stat_t stat;
 } window_animator_t;
 
 /**
@@ -141,6 +186,16 @@ window_animator_t* window_animator_create_for_close(const char* type, canvas_t*
  */
 ret_t window_animator_update(window_animator_t* wa, uint32_t time_ms);
 
+/**
+ * @method window_animator_get_stat
+ * 获取动画的统计信息(帧率和丢帧数)。
+ * @param {window_animator_t*} wa 窗口动画对象。
+ * @param {window_animator_stat_t*} stat 返回统计信息。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t window_animator_get_stat(window_animator_t* wa, window_animator_stat_t* stat);
+
 /**
  * @method window_animator_destroy
  * 销毁窗口动画对象。
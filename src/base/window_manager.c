@@ -22,10 +22,14 @@
 #include "base/keys.h"
 #include "base/mem.h"
 #include "base/idle.h"
-#include "base/time.h"
 #include "base/timer.h"
 #include "base/locale.h"
+#include "base/layout.h"
 #include "base/prop_names.h"
+#include "base/utf8.h"
+#include "base/perf_stats.h"
+#include "base/input_trace.h"
+#include "base/frame_scheduler.h"
 #include "base/window_manager.h"
 
 static widget_t* window_manager_find_prev_window(widget_t* widget) {
@@ -102,16 +106,129 @@ static ret_t window_manager_check_if_need_close_animation(window_manager_t* wm,
   return RET_FAIL;
 }
 
+static bool_t window_manager_is_compositing(window_manager_t* wm) {
+  return wm->compositor && wm->canvas != NULL && wm->canvas->lcd->create_layer != NULL;
+}
+
+static int window_surface_compare(const void* a, const void* b) {
+  const window_surface_t* s = (const window_surface_t*)a;
+
+  return s->window == b ? 0 : -1;
+}
+
+static window_surface_t* window_manager_find_surface(window_manager_t* wm, widget_t* window) {
+  if (wm->surfaces.size == 0) {
+    return NULL;
+  }
+
+  return (window_surface_t*)array_find(&(wm->surfaces), window_surface_compare, window);
+}
+
+static ret_t window_surface_destroy(window_surface_t* s) {
+  if (s->img.destroy != NULL) {
+    bitmap_destroy(&(s->img));
+  }
+  TKMEM_FREE(s);
+
+  return RET_OK;
+}
+
+static ret_t window_manager_remove_surface(window_manager_t* wm, widget_t* window) {
+  window_surface_t* s = window_manager_find_surface(wm, window);
+
+  if (s != NULL) {
+    array_remove(&(wm->surfaces), NULL, s);
+    window_surface_destroy(s);
+  }
+
+  return RET_OK;
+}
+
+static ret_t window_manager_clear_surfaces(window_manager_t* wm) {
+  while (wm->surfaces.size > 0) {
+    window_surface_destroy((window_surface_t*)array_pop(&(wm->surfaces)));
+  }
+
+  return RET_OK;
+}
+
+static window_surface_t* window_manager_ensure_surface(window_manager_t* wm, widget_t* window) {
+  window_surface_t* s = window_manager_find_surface(wm, window);
+
+  if (s == NULL) {
+    s = TKMEM_ZALLOC(window_surface_t);
+    return_value_if_fail(s != NULL, NULL);
+
+    s->window = window;
+    if (array_push(&(wm->surfaces), s) != RET_OK) {
+      TKMEM_FREE(s);
+      return NULL;
+    }
+  }
+
+  return s;
+}
+
+/*缓冲区没有清除，也按不透明的位图合成，只有背景色不透明(保证写每个像素)的窗口才能使用缓冲区。*/
+static bool_t window_manager_is_opaque_window(widget_t* win) {
+  color_t trans = color_init(0, 0, 0, 0);
+  color_t bg = style_get_color(&(win->style), STYLE_ID_BG_COLOR, trans);
+
+  return bg.rgba.a == 0xff;
+}
+
+/*只重绘缓冲区中脏的部分。*/
+static ret_t window_manager_update_surface(window_surface_t* s, canvas_t* c) {
+  canvas_t lc;
+  lcd_t* layer = NULL;
+  widget_t* win = s->window;
+
+  if (s->img.w != win->w || s->img.h != win->h) {
+    if (s->img.destroy != NULL) {
+      bitmap_destroy(&(s->img));
+    }
+    memset(&(s->img), 0x00, sizeof(bitmap_t));
+    s->img.w = win->w;
+    s->img.h = win->h;
+    rect_init(s->dirty, 0, 0, win->w, win->h);
+  }
+
+  if (s->dirty.w <= 0 || s->dirty.h <= 0) {
+    return RET_OK;
+  }
+
+  layer = lcd_create_layer(c->lcd, &(s->img));
+  return_value_if_fail(layer != NULL, RET_OOM);
+
+  canvas_init(&lc, layer, c->font_manager);
+  ENSURE(canvas_begin_frame(&lc, &(s->dirty), LCD_DRAW_OFFLINE) == RET_OK);
+  canvas_translate(&lc, -win->x, -win->y);
+  win->dirty = TRUE;
+  widget_paint(win, &lc);
+  canvas_untranslate(&lc, -win->x, -win->y);
+  ENSURE(canvas_end_frame(&lc) == RET_OK);
+  lcd_destroy(layer);
+
+  rect_init(s->dirty, 0, 0, 0, 0);
+
+  return RET_OK;
+}
+
 static ret_t window_manager_remove_child_real(widget_t* wm, widget_t* window) {
   ret_t ret = RET_OK;
   return_value_if_fail(wm != NULL && window != NULL, RET_BAD_PARAMS);
 
+  window_manager_remove_surface(WINDOW_MANAGER(wm), window);
   ret = widget_remove_child(wm, window);
   if (ret == RET_OK) {
+    rect_t r;
     widget_t* top = window_manager_get_top_window(wm);
-    if (top) {
-      rect_t r;
-      rect_init(r, window->x, window->y, window->w, window->h);
+
+    rect_init(r, window->x, window->y, window->w, window->h);
+    if (window_manager_is_compositing(WINDOW_MANAGER(wm))) {
+      /*下面的窗口已经绘制在缓冲区中，只需要重新合成。*/
+      wm->vt->invalidate(wm, &r);
+    } else if (top) {
       widget_invalidate(top, &r);
     }
   }
@@ -208,8 +325,109 @@ widget_t* window_manager_find_target(widget_t* widget, xy_t x, xy_t y) {
   return NULL;
 }
 
+static bool_t window_manager_should_tile(window_manager_t* wm, canvas_t* c, rect_t* r) {
+  return wm->tile_renderer != NULL && wm->tile_renderer->threads_nr > 1 &&
+         c->lcd->create_view != NULL && (uint32_t)(r->w * r->h) >= TILE_RENDERER_MIN_PIXELS;
+}
+
+/*先录制到显示列表，再分块并行回放到lcd上。*/
+static ret_t window_manager_paint_tiled(window_manager_t* wm, canvas_t* c, rect_t* r) {
+  canvas_t dc;
+  lcd_t* lcd = c->lcd;
+
+  if (wm->tile_dl == NULL) {
+    wm->tile_dl = display_list_create(lcd->w, lcd->h);
+    if (wm->tile_dl == NULL) {
+      return widget_paint(WIDGETP(wm), c);
+    }
+  }
+
+  canvas_init(&dc, &(wm->tile_dl->lcd), c->font_manager);
+  ENSURE(canvas_begin_frame(&dc, r, LCD_DRAW_NORMAL) == RET_OK);
+  ENSURE(widget_paint(WIDGETP(wm), &dc) == RET_OK);
+  ENSURE(canvas_end_frame(&dc) == RET_OK);
+
+  return tile_renderer_replay(wm->tile_renderer, wm->tile_dl, lcd, r);
+}
+
+#define PERF_STATS_FONT_SIZE 12
+#define PERF_STATS_LINE_HEIGHT 14
+#define PERF_STATS_WIDTH 168
+#define PERF_STATS_INTERVAL 1000
+
+static rect_t window_manager_get_perf_stats_rect(window_manager_t* wm) {
+  rect_t r;
+  widget_t* widget = WIDGETP(wm);
+  wh_t h = WINDOW_MANAGER_PERF_STATS_LINES * PERF_STATS_LINE_HEIGHT + 4;
+
+  rect_init(r, 0, 0, ftk_min(widget->w, PERF_STATS_WIDTH), ftk_min(widget->h, h));
+
+  return r;
+}
+
+static bool_t window_manager_perf_stats_expired(window_manager_t* wm) {
+  uint32_t now = frame_scheduler_now(frame_scheduler());
+
+  return wm->show_perf_stats && (wm->perf_stats_text[0][0] == '\0' ||
+                                 now - wm->perf_stats_time >= PERF_STATS_INTERVAL);
+}
+
+/*每秒采样一次，文字保存下来，部分重绘时浮层的内容才不会变得一半新一半旧。*/
+static ret_t window_manager_update_perf_stats(window_manager_t* wm) {
+  rect_t r = window_manager_get_perf_stats_rect(wm);
+  perf_stats_t* s = perf_stats_get();
+  uint32_t size = WINDOW_MANAGER_PERF_STATS_LINE_MAX;
+
+  snprintf(wm->perf_stats_text[0], size, "fps %u paint %u.%03ums", s->fps, s->paint_time / 1000,
+           s->paint_time % 1000);
+  snprintf(wm->perf_stats_text[1], size, "dirty %u fill %u", s->dirty_pixels, s->pixels_filled);
+  snprintf(wm->perf_stats_text[2], size, "blend %u copy %u", s->pixels_blended,
+           s->pixels_copied);
+  snprintf(wm->perf_stats_text[3], size, "glyph %u%% image %u%%", s->glyph_hit_rate,
+           s->image_hit_rate);
+  snprintf(wm->perf_stats_text[4], size, "timer %u idle %u", s->timer_count, s->idle_count);
+  if (s->mem_used + s->mem_free > 0) {
+    snprintf(wm->perf_stats_text[5], size, "heap %uK frag %u%%", s->mem_used / 1024,
+             s->mem_fragmentation);
+  } else {
+    snprintf(wm->perf_stats_text[5], size, "heap -");
+  }
+
+  wm->perf_stats_time = frame_scheduler_now(frame_scheduler());
+  rect_merge(&(wm->dirty_rect), &r);
+
+  return RET_OK;
+}
+
+static ret_t window_manager_paint_perf_stats(window_manager_t* wm, canvas_t* c) {
+  uint32_t i = 0;
+  wchar_t text[WINDOW_MANAGER_PERF_STATS_LINE_MAX];
+  rect_t r = window_manager_get_perf_stats_rect(wm);
+
+  if (!wm->show_perf_stats || r.w <= 0 || r.h <= 0) {
+    return RET_OK;
+  }
+
+  canvas_set_fill_color(c, color_init(0, 0, 0, 0xff));
+  canvas_fill_rect(c, r.x, r.y, r.w, r.h);
+
+  canvas_set_font(c, NULL, PERF_STATS_FONT_SIZE);
+  if (c->font == NULL && c->lcd->set_font_name == NULL) {
+    return RET_OK;
+  }
+
+  canvas_set_text_color(c, color_init(0, 0xff, 0, 0xff));
+  for (i = 0; i < WINDOW_MANAGER_PERF_STATS_LINES; i++) {
+    utf8_to_utf16(wm->perf_stats_text[i], text, ARRAY_SIZE(text));
+    canvas_draw_text(c, text, -1, r.x + 4, r.y + 2 + i * PERF_STATS_LINE_HEIGHT);
+  }
+
+  return RET_OK;
+}
+
 static ret_t window_manager_paint_normal(widget_t* widget, canvas_t* c) {
   rect_t r;
+  uint32_t i = 0;
   rect_t* dr = NULL;
   rect_t* ldr = NULL;
   window_manager_t* wm = WINDOW_MANAGER(widget);
@@ -222,14 +440,130 @@ static ret_t window_manager_paint_normal(widget_t* widget, canvas_t* c) {
     r = *dr;
     rect_merge(&r, ldr);
 
+    if (c->lcd->scroll == NULL) {
+      for (i = 0; i < wm->scrolls_nr; i++) {
+        rect_merge(&r, &(wm->scrolls[i].r));
+      }
+      wm->scrolls_nr = 0;
+    }
+
     if (r.w > 0 && r.h > 0) {
       ENSURE(canvas_begin_frame(c, &r, LCD_DRAW_NORMAL) == RET_OK);
-      ENSURE(widget_paint(WIDGETP(wm), c) == RET_OK);
+      /*先移动已经绘制好的像素，再绘制移入的部分。*/
+      for (i = 0; i < wm->scrolls_nr; i++) {
+        window_manager_scroll_t* s = wm->scrolls + i;
+        lcd_scroll(c->lcd, &(s->r), s->dx, s->dy);
+      }
+      if (window_manager_should_tile(wm, c, &r)) {
+        ENSURE(window_manager_paint_tiled(wm, c, &r) == RET_OK);
+      } else {
+        ENSURE(widget_paint(WIDGETP(wm), c) == RET_OK);
+      }
+      window_manager_paint_perf_stats(wm, c);
       ENSURE(canvas_end_frame(c) == RET_OK);
+      perf_stats_add(PERF_COUNTER_DIRTY_PIXELS, r.w * r.h);
+    }
+    log_debug("%s x=%d y=%d w=%d h=%d\n", __func__, r.x, r.y, r.w, r.h);
+  }
+
+  wm->scrolls_nr = 0;
+  wm->last_dirty_rect = wm->dirty_rect;
+  rectp_init(dr, widget->w, widget->h, 0, 0);
+
+  return RET_OK;
+}
+
+static int32_t window_manager_get_paint_start(widget_t* widget);
+
+/*只保留需要绘制的窗口和前一个普通窗口(关闭动画要用)的缓冲区。*/
+static ret_t window_manager_gc_surfaces(window_manager_t* wm, int32_t start) {
+  int32_t i = 0;
+  widget_t* widget = WIDGETP(wm);
+  widget_t* prev = window_manager_find_prev_window(widget);
+
+  for (i = wm->surfaces.size - 1; i >= 0; i--) {
+    window_surface_t* s = (window_surface_t*)(wm->surfaces.elms[i]);
+    if (s->window != prev && array_find_index(widget->children, NULL, s->window) < start) {
+      window_manager_remove_surface(wm, s->window);
+    }
+  }
+
+  return RET_OK;
+}
+
+static ret_t window_manager_composite(window_manager_t* wm, canvas_t* c, int32_t start) {
+  rect_t src;
+  rect_t dst;
+  int32_t i = 0;
+  widget_t* widget = WIDGETP(wm);
+  int32_t nr = widget->children->size;
+
+  for (i = start; i < nr; i++) {
+    widget_t* iter = (widget_t*)(widget->children->elms[i]);
+    window_surface_t* s = window_manager_find_surface(wm, iter);
+
+    if (iter->visible && iter->opacity > 0) {
+      canvas_set_global_alpha(c, iter->opacity);
+      if (s != NULL) {
+        rect_init(src, 0, 0, iter->w, iter->h);
+        rect_init(dst, iter->x, iter->y, iter->w, iter->h);
+        canvas_draw_image(c, &(s->img), &src, &dst);
+      } else {
+        /*没有缓冲区的窗口直接绘制到屏幕上。*/
+        iter->dirty = TRUE;
+        widget_paint(iter, c);
+      }
+    }
+  }
+  canvas_set_global_alpha(c, 0xff);
+
+  return RET_OK;
+}
+
+static ret_t window_manager_paint_compositor(widget_t* widget, canvas_t* c) {
+  rect_t r;
+  int32_t i = 0;
+  int32_t nr = 0;
+  int32_t start = 0;
+  window_manager_t* wm = WINDOW_MANAGER(widget);
+  rect_t* dr = &(wm->dirty_rect);
+
+  if (dr->w && dr->h && widget->children != NULL) {
+    r = *dr;
+    rect_merge(&r, &(wm->last_dirty_rect));
+
+    start = window_manager_get_paint_start(widget);
+    nr = widget->children->size;
+    for (i = start; i < nr; i++) {
+      widget_t* iter = (widget_t*)(widget->children->elms[i]);
+      window_surface_t* s = NULL;
+
+      if (!window_manager_is_opaque_window(iter)) {
+        window_manager_remove_surface(wm, iter);
+      } else if (iter->visible) {
+        s = window_manager_ensure_surface(wm, iter);
+        if (s == NULL || window_manager_update_surface(s, c) != RET_OK) {
+          /*内存不足时放弃缓冲区，按正常方式绘制。*/
+          window_manager_clear_surfaces(wm);
+          widget->dirty = TRUE;
+          return window_manager_paint_normal(widget, c);
+        }
+      }
     }
+
+    ENSURE(canvas_begin_frame(c, &r, LCD_DRAW_NORMAL) == RET_OK);
+    window_manager_composite(wm, c, start);
+    window_manager_paint_perf_stats(wm, c);
+    ENSURE(canvas_end_frame(c) == RET_OK);
+    perf_stats_add(PERF_COUNTER_DIRTY_PIXELS, r.w * r.h);
+
+    window_manager_gc_surfaces(wm, start);
     log_debug("%s x=%d y=%d w=%d h=%d\n", __func__, r.x, r.y, r.w, r.h);
   }
 
+  widget->dirty = FALSE;
+  widget->subtree_dirty = FALSE;
+  wm->scrolls_nr = 0;
   wm->last_dirty_rect = wm->dirty_rect;
   rectp_init(dr, widget->w, widget->h, 0, 0);
 
@@ -246,11 +580,19 @@ static ret_t timer_enable_user_input(const timer_info_t* timer) {
 }
 
 static ret_t window_manager_paint_animation(widget_t* widget, canvas_t* c) {
-  uint32_t time_ms = time_now_ms();
+  uint32_t time_ms = frame_scheduler_now(frame_scheduler());
   window_manager_t* wm = WINDOW_MANAGER(widget);
 
   ret_t ret = window_animator_update(wm->animator, time_ms);
+
+  /*动画会重绘整个屏幕。*/
+  wm->scrolls_nr = 0;
   if (ret == RET_DONE) {
+    window_animator_stat_t* stat = &(wm->animator_stat);
+
+    window_animator_get_stat(wm->animator, stat);
+    log_debug("animation: %u frames %u ms %u fps %u dropped\n", stat->frames, stat->cost, stat->fps,
+              stat->dropped_frames);
     window_animator_destroy(wm->animator);
     wm->animator = NULL;
     wm->animating = FALSE;
@@ -267,11 +609,155 @@ ret_t window_manager_paint(widget_t* widget, canvas_t* c) {
   wm->canvas = c;
   if (wm->animator != NULL) {
     return window_manager_paint_animation(widget, c);
+  }
+
+  if (window_manager_perf_stats_expired(wm)) {
+    window_manager_update_perf_stats(wm);
+  }
+
+  if (window_manager_is_compositing(wm)) {
+    return window_manager_paint_compositor(widget, c);
   } else {
     return window_manager_paint_normal(widget, c);
   }
 }
 
+bool_t window_manager_need_paint(widget_t* widget) {
+  window_manager_t* wm = WINDOW_MANAGER(widget);
+  return_value_if_fail(wm != NULL, FALSE);
+
+  return wm->animator != NULL || (wm->dirty_rect.w > 0 && wm->dirty_rect.h > 0) ||
+         window_manager_perf_stats_expired(wm);
+}
+
+/*target所在的窗口必须是最上层的窗口，并且target完全可见，移动的像素才不会包含其它控件。*/
+static bool_t window_manager_get_scroll_rect(window_manager_t* wm, widget_t* target, rect_t* r) {
+  widget_t* iter = target;
+  widget_t* widget = WIDGETP(wm);
+
+  rectp_init(r, 0, 0, target->w, target->h);
+  while (iter != widget) {
+    widget_t* parent = iter->parent;
+
+    r->x += iter->x;
+    r->y += iter->y;
+    if (parent == NULL) {
+      return FALSE;
+    }
+
+    if (r->x < 0 || r->y < 0 || (r->x + r->w) > parent->w || (r->y + r->h) > parent->h) {
+      return FALSE;
+    }
+
+    if (parent == widget && iter != widget_get_child(widget, widget->children->size - 1)) {
+      return FALSE;
+    }
+
+    iter = parent;
+  }
+
+  return TRUE;
+}
+
+static ret_t window_manager_remove_scroll(window_manager_t* wm, window_manager_scroll_t* s) {
+  uint32_t i = s - wm->scrolls;
+
+  for (; i + 1 < wm->scrolls_nr; i++) {
+    wm->scrolls[i] = wm->scrolls[i + 1];
+  }
+  wm->scrolls_nr--;
+
+  return RET_FAIL;
+}
+
+ret_t window_manager_scroll(widget_t* widget, widget_t* target, xy_t dx, xy_t dy, rect_t* exposed) {
+  rect_t r;
+  rect_t d;
+  uint32_t i = 0;
+  window_manager_scroll_t* s = NULL;
+  window_manager_t* wm = WINDOW_MANAGER(widget);
+  return_value_if_fail(wm != NULL && target != NULL && exposed != NULL, RET_BAD_PARAMS);
+
+  if (wm->animator != NULL || wm->canvas == NULL || wm->canvas->lcd->scroll == NULL) {
+    return RET_FAIL;
+  }
+
+  /*合成模式下屏幕上的像素来自窗口的缓冲区，不能直接移动。*/
+  if (window_manager_is_compositing(wm)) {
+    return RET_FAIL;
+  }
+
+  if (!window_manager_get_scroll_rect(wm, target, &r)) {
+    return RET_FAIL;
+  }
+
+  /*性能统计浮层画在最上面，移动像素会把浮层也一起移走。*/
+  if (wm->show_perf_stats) {
+    d = window_manager_get_perf_stats_rect(wm);
+    rect_intersect(&d, &r);
+    if (d.w > 0 && d.h > 0) {
+      return RET_FAIL;
+    }
+  }
+
+  for (i = 0; i < wm->scrolls_nr; i++) {
+    window_manager_scroll_t* iter = wm->scrolls + i;
+    if (iter->r.x == r.x && iter->r.y == r.y && iter->r.w == r.w && iter->r.h == r.h) {
+      s = iter;
+      break;
+    }
+  }
+
+  /*区域内还有等待重绘的内容，它们的位置已经变了，不能直接移动像素。*/
+  d = wm->dirty_rect;
+  rect_intersect(&d, &r);
+  if (s != NULL) {
+    rect_t e = s->exposed;
+    if (d.w > 0 && d.h > 0 && (d.x < e.x || d.y < e.y || d.x + d.w > e.x + e.w ||
+                               d.y + d.h > e.y + e.h)) {
+      return window_manager_remove_scroll(wm, s);
+    }
+  } else {
+    if ((d.w > 0 && d.h > 0) || wm->scrolls_nr >= WINDOW_MANAGER_MAX_SCROLLS) {
+      return RET_FAIL;
+    }
+
+    s = wm->scrolls + wm->scrolls_nr++;
+    memset(s, 0x00, sizeof(*s));
+    s->r = r;
+  }
+
+  s->dx += dx;
+  s->dy += dy;
+  if (s->dx >= r.w || s->dx <= -r.w || s->dy >= r.h || s->dy <= -r.h) {
+    return window_manager_remove_scroll(wm, s);
+  }
+
+  /*同时在两个方向上移动时，露出的区域是L形的，简单起见刷新整个区域。*/
+  s->exposed = r;
+  if (s->dy == 0) {
+    if (s->dx > 0) {
+      s->exposed.w = s->dx;
+    } else {
+      s->exposed.x = r.x + r.w + s->dx;
+      s->exposed.w = -s->dx;
+    }
+  } else if (s->dx == 0) {
+    if (s->dy > 0) {
+      s->exposed.h = s->dy;
+    } else {
+      s->exposed.y = r.y + r.h + s->dy;
+      s->exposed.h = -s->dy;
+    }
+  }
+
+  *exposed = s->exposed;
+  exposed->x -= r.x;
+  exposed->y -= r.y;
+
+  return RET_OK;
+}
+
 static widget_t* s_window_manager = NULL;
 
 widget_t* window_manager(void) { return s_window_manager; }
@@ -304,11 +790,28 @@ static ret_t window_manager_ungrab(widget_t* widget, widget_t* child) {
 }
 
 static ret_t window_manager_invalidate(widget_t* widget, rect_t* r) {
+  uint32_t i = 0;
   window_manager_t* wm = WINDOW_MANAGER(widget);
   rect_t* dr = &(wm->dirty_rect);
 
   rect_merge(dr, r);
 
+  /*需要重绘的窗口(来自窗口自己的刷新)，同时记录它的缓冲区中脏的部分。*/
+  for (i = 0; i < wm->surfaces.size; i++) {
+    window_surface_t* s = (window_surface_t*)(wm->surfaces.elms[i]);
+    widget_t* win = s->window;
+
+    if (win->dirty || win->subtree_dirty) {
+      rect_t d;
+      rect_t b;
+
+      rect_init(d, r->x - win->x, r->y - win->y, r->w, r->h);
+      rect_init(b, 0, 0, win->w, win->h);
+      rect_intersect(&d, &b);
+      rect_merge(&(s->dirty), &d);
+    }
+  }
+
   return RET_OK;
 }
 
@@ -336,6 +839,13 @@ widget_t* window_manager_get_top_window(widget_t* widget) {
   return widget_get_child(widget, index);
 }
 
+/*最上面的普通窗口之下的窗口被完全遮挡，不需要绘制。*/
+static int32_t window_manager_get_paint_start(widget_t* widget) {
+  int32_t i = window_manager_find_top_window_index(widget);
+
+  return i < 0 ? 0 : i;
+}
+
 ret_t window_manager_on_paint_children(widget_t* widget, canvas_t* c) {
   int32_t i = 0;
   int32_t nr = 0;
@@ -344,18 +854,7 @@ ret_t window_manager_on_paint_children(widget_t* widget, canvas_t* c) {
   if (widget->children != NULL && widget->children->size > 0) {
     nr = widget->children->size;
 
-    for (i = nr - 1; i >= 0; i--) {
-      widget_t* iter = (widget_t*)(widget->children->elms[i]);
-      if (iter->type == WIDGET_NORMAL_WINDOW) {
-        break;
-      }
-    }
-
-    if (i < 0) {
-      i = 0;
-    }
-
-    for (; i < nr; i++) {
+    for (i = window_manager_get_paint_start(widget); i < nr; i++) {
       widget_t* iter = (widget_t*)(widget->children->elms[i]);
       if (iter->visible) {
         widget_paint(iter, c);
@@ -366,11 +865,25 @@ ret_t window_manager_on_paint_children(widget_t* widget, canvas_t* c) {
   return RET_OK;
 }
 
+static ret_t window_manager_destroy(widget_t* widget) {
+  window_manager_t* wm = WINDOW_MANAGER(widget);
+
+  window_manager_clear_surfaces(wm);
+  array_deinit(&(wm->surfaces));
+  array_deinit(&(wm->graps));
+  if (wm->tile_dl != NULL) {
+    lcd_destroy(&(wm->tile_dl->lcd));
+  }
+
+  return RET_OK;
+}
+
 static const widget_vtable_t s_wm_vtable = {.invalidate = window_manager_invalidate,
                                             .on_paint_children = window_manager_on_paint_children,
                                             .grab = window_manager_grab,
                                             .find_target = window_manager_find_target,
-                                            .ungrab = window_manager_ungrab};
+                                            .ungrab = window_manager_ungrab,
+                                            .destroy = window_manager_destroy};
 
 static ret_t wm_on_locale_changed(void* ctx, event_t* e) {
   int32_t i = 0;
@@ -379,6 +892,7 @@ static ret_t wm_on_locale_changed(void* ctx, event_t* e) {
   return_value_if_fail(widget != NULL, RET_BAD_PARAMS);
 
   if (widget->children != NULL && widget->children->size > 0) {
+    widget_layout_begin(widget);
     widget_re_translate_text(widget);
 
     nr = widget->children->size;
@@ -387,6 +901,7 @@ static ret_t wm_on_locale_changed(void* ctx, event_t* e) {
 
       widget_dispatch(iter, e);
     }
+    widget_layout_end(widget);
   }
 
   return RET_OK;
@@ -398,6 +913,7 @@ widget_t* window_manager_init(window_manager_t* wm) {
 
   widget_init(w, NULL, WIDGET_WINDOW_MANAGER);
   array_init(&(wm->graps), 5);
+  array_init(&(wm->surfaces), 2);
   w->vt = &s_wm_vtable;
 
 #ifdef WITH_DYNAMIC_TR
@@ -418,6 +934,24 @@ ret_t window_manager_resize(widget_t* widget, wh_t w, wh_t h) {
   wm->last_dirty_rect = wm->dirty_rect;
   widget_move_resize(widget, 0, 0, w, h);
 
+  if (widget->children != NULL) {
+    uint32_t i = 0;
+    uint32_t nr = widget->children->size;
+
+    widget_layout_begin(widget);
+    for (i = 0; i < nr; i++) {
+      widget_t* iter = (widget_t*)(widget->children->elms[i]);
+
+      if (iter->type == WIDGET_NORMAL_WINDOW) {
+        widget_move_resize(iter, 0, 0, w, h);
+      } else if (iter->type == WIDGET_DIALOG) {
+        widget_move(iter, (w - iter->w) >> 1, (h - iter->h) >> 1);
+      }
+      widget_layout_children(iter);
+    }
+    widget_layout_end(widget);
+  }
+
   return RET_OK;
 }
 
@@ -478,6 +1012,10 @@ ret_t window_manager_dispatch_input_event(widget_t* widget, event_t* e) {
   window_manager_t* wm = WINDOW_MANAGER(widget);
   return_value_if_fail(wm != NULL && e != NULL, RET_BAD_PARAMS);
 
+  if (input_trace() != NULL) {
+    input_trace_on_input(input_trace(), e);
+  }
+
   if (wm->ignore_user_input) {
     log_debug("animating ignore input\n");
     return RET_OK;
@@ -539,6 +1077,59 @@ ret_t window_manager_dispatch_input_event(widget_t* widget, event_t* e) {
   return RET_OK;
 }
 
+ret_t window_manager_set_compositor(widget_t* widget, bool_t compositor) {
+  window_manager_t* wm = WINDOW_MANAGER(widget);
+  return_value_if_fail(wm != NULL, RET_BAD_PARAMS);
+
+  wm->compositor = compositor;
+  if (!compositor) {
+    window_manager_clear_surfaces(wm);
+  }
+
+  return widget_invalidate(widget, NULL);
+}
+
+ret_t window_manager_set_tile_renderer(widget_t* widget, tile_renderer_t* tr) {
+  window_manager_t* wm = WINDOW_MANAGER(widget);
+  return_value_if_fail(wm != NULL, RET_BAD_PARAMS);
+
+  wm->tile_renderer = tr;
+  if (tr == NULL && wm->tile_dl != NULL) {
+    lcd_destroy(&(wm->tile_dl->lcd));
+    wm->tile_dl = NULL;
+  }
+
+  return RET_OK;
+}
+
+bitmap_t* window_manager_get_surface(widget_t* widget, widget_t* window) {
+  window_surface_t* s = NULL;
+  window_manager_t* wm = WINDOW_MANAGER(widget);
+  return_value_if_fail(wm != NULL && window != NULL && window->parent == widget, NULL);
+
+  if (!window_manager_is_compositing(wm) || !window_manager_is_opaque_window(window)) {
+    return NULL;
+  }
+
+  s = window_manager_ensure_surface(wm, window);
+  return_value_if_fail(s != NULL, NULL);
+  return_value_if_fail(window_manager_update_surface(s, wm->canvas) == RET_OK, NULL);
+
+  return &(s->img);
+}
+
+ret_t window_manager_set_show_perf_stats(widget_t* widget, bool_t show) {
+  rect_t r;
+  window_manager_t* wm = WINDOW_MANAGER(widget);
+  return_value_if_fail(wm != NULL, RET_BAD_PARAMS);
+
+  r = window_manager_get_perf_stats_rect(wm);
+  wm->show_perf_stats = show;
+  wm->perf_stats_text[0][0] = '\0';
+
+  return widget_invalidate(widget, &r);
+}
+
 ret_t window_manager_set_animating(widget_t* widget, bool_t animating) {
   window_manager_t* wm = WINDOW_MANAGER(widget);
   return_value_if_fail(wm != NULL, RET_BAD_PARAMS);
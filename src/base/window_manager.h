@@ -24,10 +24,32 @@
 
 #include "base/widget.h"
 #include "base/canvas.h"
+#include "base/tile_renderer.h"
 #include "base/window_animator.h"
 
 BEGIN_C_DECLS
 
+#define WINDOW_MANAGER_MAX_SCROLLS 4
+
+/*性能统计浮层的行数和每行的最大长度。*/
+#define WINDOW_MANAGER_PERF_STATS_LINES 6
+#define WINDOW_MANAGER_PERF_STATS_LINE_MAX 32
+
+/*一帧内需要用lcd_scroll移动的区域(屏幕坐标)。*/
+typedef struct _window_manager_scroll_t {
+  rect_t r;
+  rect_t exposed;
+  xy_t dx;
+  xy_t dy;
+} window_manager_scroll_t;
+
+/*合成模式下窗口的后备缓冲区(窗口坐标)。*/
+typedef struct _window_surface_t {
+  widget_t* window;
+  bitmap_t img;
+  rect_t dirty;
+} window_surface_t;
+
 /**
  * @class window_manager_t
  * @parent widget_t
@@ -49,7 +71,41 @@ typedef struct _window_manager_t {
   bool_t animating;
   bool_t ignore_user_input;
   window_animator_t* animator;
+  /**
+   * @property {window_animator_stat_t} animator_stat
+   * @readonly
+   * 最近一次窗口动画的统计信息(帧率和丢帧数)。
+   */
+  window_animator_stat_t animator_stat;
   canvas_t* canvas;
+
+  uint32_t scrolls_nr;
+  window_manager_scroll_t scrolls[WINDOW_MANAGER_MAX_SCROLLS];
+
+  /**
+   * @property {bool_t} compositor
+   * @readonly
+   * 是否启用合成模式。请参考window_manager_set_compositor。
+   */
+  bool_t compositor;
+  array_t surfaces;
+
+  /**
+   * @property {tile_renderer_t*} tile_renderer
+   * @readonly
+   * 分块并行回放对象。请参考window_manager_set_tile_renderer。
+   */
+  tile_renderer_t* tile_renderer;
+  display_list_t* tile_dl;
+
+  /**
+   * @property {bool_t} show_perf_stats
+   * @readonly
+   * 是否在屏幕左上角显示性能统计信息。请参考window_manager_set_show_perf_stats。
+   */
+  bool_t show_perf_stats;
+  uint32_t perf_stats_time;
+  char perf_stats_text[WINDOW_MANAGER_PERF_STATS_LINES][WINDOW_MANAGER_PERF_STATS_LINE_MAX];
 } window_manager_t;
 
 widget_t* window_manager(void);
@@ -63,10 +119,68 @@ ret_t window_manager_resize(widget_t* widget, wh_t w, wh_t h);
 ret_t window_manager_add_child(widget_t* widget, widget_t* window);
 ret_t window_manager_remove_child(widget_t* widget, widget_t* window);
 ret_t window_manager_paint(widget_t* widget, canvas_t* c);
+bool_t window_manager_need_paint(widget_t* widget);
 ret_t window_manager_dispatch_input_event(widget_t* widget, event_t* e);
 
 ret_t window_manager_set_animating(widget_t* widget, bool_t animating);
 
+/*
+ * 请求在下一帧把target已经绘制好的像素移动(dx, dy)，而不是全部重绘。
+ * 返回RET_OK时，调用者只需要刷新exposed(target的坐标系)指定的区域，否则需要刷新整个target。
+ */
+ret_t window_manager_scroll(widget_t* widget, widget_t* target, xy_t dx, xy_t dy, rect_t* exposed);
+
+/**
+ * @method window_manager_set_compositor
+ * 启用/禁用合成模式。
+ * 合成模式下每个窗口绘制到自己的后备缓冲区中，窗口管理器再按窗口的顺序和不透明度把它们合成到lcd上。
+ * 窗口内的控件变化只需要重绘这个窗口的缓冲区，对话框关闭或移动时，下面的窗口只需要重新合成，不需要重绘。
+ * 窗口动画也直接使用缓冲区，不再重新截图。
+ * 每个可见的窗口需要一块与窗口同样大小的内存，只有提供了create_layer的lcd才支持，否则按正常方式绘制。
+ * 缓冲区按不透明的位图合成，只有背景色不透明的窗口才使用缓冲区，其它窗口(比如透明背景的对话框和弹出窗口)
+ * 在合成时按正常方式直接绘制到lcd上。
+ * @param {widget_t*} widget 窗口管理器对象。
+ * @param {bool_t} compositor 是否启用。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t window_manager_set_compositor(widget_t* widget, bool_t compositor);
+
+/**
+ * @method window_manager_set_tile_renderer
+ * 设置分块并行回放对象(NULL表示禁用)。
+ * 较大的脏矩形(比如切换窗口、主题和语言)先录制到显示列表，再由tr分块并行绘制到lcd上，
+ * 较小的脏矩形和不支持create_view的lcd仍然按正常方式绘制。
+ * tr由调用者创建和销毁。
+ * @param {widget_t*} widget 窗口管理器对象。
+ * @param {tile_renderer_t*} tr 分块并行回放对象。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t window_manager_set_tile_renderer(widget_t* widget, tile_renderer_t* tr);
+
+/**
+ * @method window_manager_get_surface
+ * 获取窗口在合成模式下的后备缓冲区，必要时先把它更新到最新的状态。
+ * 缓冲区属于窗口管理器，调用者不能销毁它，窗口关闭后它也随之失效。
+ * @param {widget_t*} widget 窗口管理器对象。
+ * @param {widget_t*} window 窗口对象。
+ *
+ * @return {bitmap_t*} 返回缓冲区，没有启用合成模式、lcd不支持或者窗口的背景色不是不透明的时返回NULL。
+ */
+bitmap_t* window_manager_get_surface(widget_t* widget, widget_t* window);
+
+/**
+ * @method window_manager_set_show_perf_stats
+ * 显示/隐藏性能统计信息(帧率、绘制时间、像素数、缓存命中率、定时器和堆，请参考perf_stats_t)。
+ * 统计信息画在所有窗口之上，每秒更新一次，更新时即使界面没有变化也会绘制一帧。窗口动画期间不显示。
+ * @param {widget_t*} widget 窗口管理器对象。
+ * @param {bool_t} show 是否显示。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t window_manager_set_show_perf_stats(widget_t* widget, bool_t show);
+
 #define WINDOW_MANAGER(widget) ((window_manager_t*)(widget))
 
 END_C_DECLS
@@ -19,64 +19,386 @@
  *
  */
 
+#include <wctype.h>
 #include "font/font_bitmap.h"
 #include "base/mem.h"
 
-typedef struct _font_bitmap_t {
-  font_t base;
+/*
+ * 字符到索引的查找表。
+ * 0x00-0xff直接查表。其它字符按高8位分页，只给有字符的页分配空间，页内用位图标记有哪些字符，
+ * 字符的索引=本页第一个字符的索引+位图中排在它前面的字符数，查找时间与字符数无关。
+ */
+typedef struct _font_bitmap_page_t {
+  uint16_t base;
+  uint8_t counts[8];
+  uint32_t bits[8];
+} font_bitmap_page_t;
+
+typedef struct _font_bitmap_face_t {
   const uint8_t* buff;
   uint32_t buff_size;
+  uint8_t format;
+  bool_t wide;
+  const uint8_t* advances;
+  font_bitmap_header_t* header;
+
+  uint16_t* latin;
+  uint32_t pages_nr;
+  font_bitmap_page_t** pages;
+  font_bitmap_page_t* pages_data;
+} font_bitmap_face_t;
+
+typedef struct _font_bitmap_t {
+  font_t base;
+  uint32_t faces_nr;
+  font_bitmap_face_t faces[FONT_BITMAP_FACES_NR];
 } font_bitmap_t;
 
-static font_bitmap_index_t* find_glyph(font_bitmap_index_t* elms, uint32_t nr, wchar_t c) {
-  int low = 0;
-  int mid = 0;
-  int result = 0;
-  int high = nr - 1;
+static uint32_t font_bitmap_popcount(uint32_t v) {
+  v = v - ((v >> 1) & 0x55555555);
+  v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+  v = (v + (v >> 4)) & 0x0f0f0f0f;
+
+  return (v * 0x01010101) >> 24;
+}
+
+static uint32_t font_bitmap_face_get_char(font_bitmap_face_t* face, uint32_t i) {
+  if (face->wide) {
+    return ((const font_bitmap_index32_t*)(face->header->index))[i].c;
+  } else {
+    return face->header->index[i].c;
+  }
+}
+
+static uint32_t font_bitmap_face_get_offset(font_bitmap_face_t* face, uint32_t i) {
+  if (face->wide) {
+    return ((const font_bitmap_index32_t*)(face->header->index))[i].offset;
+  } else {
+    return face->header->index[i].offset;
+  }
+}
 
-  while (low <= high) {
-    mid = low + ((high - low) >> 1);
-    result = elms[mid].c - c;
+/*返回字符在索引中的位置，没有这个字符时返回-1。*/
+static int32_t font_bitmap_face_lookup(font_bitmap_face_t* face, wchar_t c) {
+  uint32_t lo = 0;
+  uint32_t hi = 0;
+  uint32_t bit = 0;
+  uint32_t group = 0;
+  uint32_t index = 0;
+  font_bitmap_page_t* page = NULL;
+
+  if ((uint32_t)c > 0xffff) {
+    return -1;
+  }
+
+  hi = (uint32_t)c >> 8;
+  lo = (uint32_t)c & 0xff;
+  if (hi == 0) {
+    index = face->latin[lo];
+    return (int32_t)index - 1;
+  }
+
+  if (hi >= face->pages_nr || face->pages[hi] == NULL) {
+    return -1;
+  }
+
+  page = face->pages[hi];
+  group = lo >> 5;
+  bit = 1u << (lo & 0x1f);
+  if (!(page->bits[group] & bit)) {
+    return -1;
+  }
+
+  index = page->base + page->counts[group] + font_bitmap_popcount(page->bits[group] & (bit - 1));
+
+  return (int32_t)index;
+}
+
+/*读取footer中的字模格式和advance表，没有footer(旧格式)时字模为8位。*/
+static ret_t font_bitmap_face_load_footer(font_bitmap_face_t* face) {
+  uint32_t magic = 0;
+  uint32_t offset = 0;
+  uint32_t format = GLYPH_FMT_A8;
+  uint32_t footer_size = 0;
+  const uint8_t* p = NULL;
+  const uint8_t* buff = face->buff;
+  uint32_t buff_size = face->buff_size;
+  font_bitmap_header_t* header = face->header;
+
+  face->format = GLYPH_FMT_A8;
+  face->advances = NULL;
+  if (buff_size < sizeof(font_bitmap_header_t) + FONT_BITMAP_FOOTER_SIZE) {
+    return RET_OK;
+  }
 
-    if (result == 0) {
-      return elms + mid;
-    } else if (result < 0) {
-      low = mid + 1;
+  p = buff + buff_size - 4;
+  load_uint32(p, magic);
+
+  if (magic == FONT_BITMAP_METRICS_MAGIC) {
+    footer_size = FONT_BITMAP_FOOTER_SIZE;
+    p = buff + buff_size - footer_size;
+  } else if (magic == FONT_BITMAP_FORMAT_MAGIC &&
+             buff_size >= sizeof(font_bitmap_header_t) + FONT_BITMAP_FORMAT_FOOTER_SIZE) {
+    footer_size = FONT_BITMAP_FORMAT_FOOTER_SIZE;
+    p = buff + buff_size - footer_size;
+    load_uint32(p, format);
+  } else {
+    return RET_OK;
+  }
+
+  load_uint32(p, offset);
+  if (offset + header->char_nr > buff_size - footer_size) {
+    return RET_OK;
+  }
+
+  face->format = format;
+  face->advances = buff + offset;
+
+  return RET_OK;
+}
+
+static ret_t font_bitmap_face_build_pages(font_bitmap_face_t* face) {
+  uint32_t i = 0;
+  uint32_t j = 0;
+  uint32_t used = 0;
+  font_bitmap_page_t* pages = NULL;
+  font_bitmap_header_t* header = face->header;
+  uint32_t nr = header->char_nr;
+
+  face->latin = TKMEM_ZALLOCN(uint16_t, 256);
+  return_value_if_fail(face->latin != NULL, RET_OOM);
+
+  /*索引按字符排好序，最后一个字符决定页表的大小。*/
+  if (nr > 0) {
+    face->pages_nr = (font_bitmap_face_get_char(face, nr - 1) >> 8) + 1;
+  }
+
+  for (i = 0; i < nr; i++) {
+    uint32_t c = font_bitmap_face_get_char(face, i);
+    if (c > 0xff && (i == 0 || (font_bitmap_face_get_char(face, i - 1) >> 8) != (c >> 8))) {
+      used++;
+    }
+  }
+
+  if (used > 0) {
+    face->pages = TKMEM_ZALLOCN(font_bitmap_page_t*, face->pages_nr);
+    face->pages_data = TKMEM_ZALLOCN(font_bitmap_page_t, used);
+    return_value_if_fail(face->pages != NULL && face->pages_data != NULL, RET_OOM);
+    pages = face->pages_data;
+  }
+
+  for (i = 0; i < nr; i++) {
+    uint32_t c = font_bitmap_face_get_char(face, i);
+    uint32_t hi = c >> 8;
+    uint32_t lo = c & 0xff;
+
+    if (hi == 0) {
+      face->latin[lo] = i + 1;
     } else {
-      high = mid - 1;
+      font_bitmap_page_t* page = face->pages[hi];
+      if (page == NULL) {
+        page = pages++;
+        page->base = i;
+        face->pages[hi] = page;
+      }
+      page->bits[lo >> 5] |= 1u << (lo & 0x1f);
+    }
+  }
+
+  for (i = 1; i < face->pages_nr; i++) {
+    font_bitmap_page_t* page = face->pages[i];
+    if (page != NULL) {
+      for (j = 1; j < ARRAY_SIZE(page->counts); j++) {
+        page->counts[j] = page->counts[j - 1] + font_bitmap_popcount(page->bits[j - 1]);
+      }
+    }
+  }
+
+  return RET_OK;
+}
+
+static ret_t font_bitmap_face_deinit(font_bitmap_face_t* face) {
+  if (face->pages != NULL) {
+    TKMEM_FREE(face->pages);
+  }
+
+  if (face->pages_data != NULL) {
+    TKMEM_FREE(face->pages_data);
+  }
+
+  if (face->latin != NULL) {
+    TKMEM_FREE(face->latin);
+  }
+
+  memset(face, 0x00, sizeof(font_bitmap_face_t));
+
+  return RET_OK;
+}
+
+static ret_t font_bitmap_add_face(font_bitmap_t* font, const uint8_t* buff, uint32_t buff_size,
+                                  bool_t wide) {
+  uint32_t char_nr = 0;
+  font_bitmap_face_t* face = NULL;
+  uint32_t index_size = wide ? sizeof(font_bitmap_index32_t) : sizeof(font_bitmap_index_t);
+  return_value_if_fail(buff_size >= sizeof(font_bitmap_header_t), RET_BAD_PARAMS);
+  return_value_if_fail(font->faces_nr < FONT_BITMAP_FACES_NR, RET_FAIL);
+
+  face = font->faces + font->faces_nr;
+  char_nr = ((font_bitmap_header_t*)buff)->char_nr;
+  return_value_if_fail(4 + char_nr * index_size <= buff_size, RET_BAD_PARAMS);
+
+  face->buff = buff;
+  face->wide = wide;
+  face->buff_size = buff_size;
+  face->header = (font_bitmap_header_t*)buff;
+  font_bitmap_face_load_footer(face);
+
+  if (font_bitmap_face_build_pages(face) != RET_OK) {
+    font_bitmap_face_deinit(face);
+    return RET_OOM;
+  }
+
+  font->faces_nr++;
+
+  return RET_OK;
+}
+
+static font_bitmap_face_t* font_bitmap_find_face(font_bitmap_t* font, uint16_t font_size) {
+  uint32_t i = 0;
+
+  for (i = 0; i < font->faces_nr; i++) {
+    font_bitmap_face_t* iter = font->faces + i;
+    if (iter->header->font_size == font_size) {
+      return iter;
     }
   }
 
   return NULL;
 }
 
+static int32_t font_bitmap_find_index(font_bitmap_face_t* face, wchar_t c) {
+  int32_t index = font_bitmap_face_lookup(face, c);
+
+  /*字体中没有这个字符是正常的情况。*/
+  if (index < 0) {
+    return -1;
+  }
+
+  /*旧格式没有保存空白字符的字模。*/
+  if (face->advances == NULL && iswspace(c)) {
+    return -1;
+  }
+
+  /*字模必须在字体数据内。*/
+  if (font_bitmap_face_get_offset(face, index) + 4 > face->buff_size) {
+    return -1;
+  }
+
+  return index;
+}
+
+static ret_t font_bitmap_load_metrics(font_bitmap_face_t* face, int32_t index,
+                                      glyph_metrics_t* m) {
+  const uint8_t* p = face->buff + font_bitmap_face_get_offset(face, index);
+
+  m->x = (int8_t)p[0];
+  m->y = (int8_t)p[1];
+  m->w = p[2];
+  m->h = p[3];
+
+  if (face->advances != NULL) {
+    m->advance = face->advances[index];
+  } else {
+    m->advance = m->w + 1;
+  }
+
+  return RET_OK;
+}
+
+static ret_t font_bitmap_get_metrics(font_t* f, wchar_t c, glyph_metrics_t* m,
+                                     uint16_t font_size) {
+  int32_t index = 0;
+  font_bitmap_face_t* face = font_bitmap_find_face((font_bitmap_t*)f, font_size);
+  return_value_if_fail(face != NULL, RET_NOT_FOUND);
+
+  index = font_bitmap_find_index(face, c);
+  if (index < 0) {
+    return RET_NOT_FOUND;
+  }
+
+  return font_bitmap_load_metrics(face, index, m);
+}
+
 static ret_t font_bitmap_find_glyph(font_t* f, wchar_t c, glyph_t* g, uint16_t font_size) {
-  const uint8_t* p = NULL;
-  font_bitmap_t* font = (font_bitmap_t*)f;
-  font_bitmap_header_t* header = (font_bitmap_header_t*)(font->buff);
-  font_bitmap_index_t* index = find_glyph(header->index, header->char_nr, c);
-  return_value_if_fail(index != NULL, RET_NOT_FOUND);
-  return_value_if_fail(header->font_size == font_size, RET_NOT_FOUND);
+  glyph_metrics_t m;
+  int32_t index = 0;
+  font_bitmap_face_t* face = font_bitmap_find_face((font_bitmap_t*)f, font_size);
+  return_value_if_fail(face != NULL, RET_NOT_FOUND);
 
-  p = (font->buff + index->offset);
-  memcpy(g, p, sizeof(glyph_t));
-  g->data = font->buff + index->offset + 4;
+  index = font_bitmap_find_index(face, c);
+  if (index < 0) {
+    return RET_NOT_FOUND;
+  }
+
+  font_bitmap_load_metrics(face, index, &m);
+  g->x = m.x;
+  g->y = m.y;
+  g->w = m.w;
+  g->h = m.h;
+  g->advance = m.advance;
+  g->format = face->format;
+  g->data = face->buff + font_bitmap_face_get_offset(face, index) + 4;
 
   return RET_OK;
 }
 
 static bool_t font_bitmap_match(font_t* f, const char* name, uint16_t font_size) {
   font_bitmap_t* font = (font_bitmap_t*)f;
-  font_bitmap_header_t* header = (font_bitmap_header_t*)(font->buff);
   if (name == NULL || strcmp(name, font->base.name) == 0) {
-    return header->font_size == font_size;
+    return font_bitmap_find_face(font, font_size) != NULL;
   }
 
   return FALSE;
 }
 
 static ret_t font_bitmap_destroy(font_t* f) {
+  uint32_t i = 0;
+  font_bitmap_t* font = (font_bitmap_t*)f;
+
+  for (i = 0; i < font->faces_nr; i++) {
+    font_bitmap_face_deinit(font->faces + i);
+  }
   TKMEM_FREE(f);
+
+  return RET_OK;
+}
+
+ret_t font_bitmap_add(font_t* f, const uint8_t* buff, uint32_t buff_size) {
+  uint32_t i = 0;
+  uint32_t nr = 0;
+  uint32_t magic = 0;
+  const uint8_t* p = buff;
+  font_bitmap_t* font = (font_bitmap_t*)f;
+  return_value_if_fail(font != NULL && buff != NULL && buff_size >= 8, RET_BAD_PARAMS);
+
+  load_uint32(p, magic);
+  if (magic != FONT_BITMAP_CONTAINER_MAGIC) {
+    return font_bitmap_add_face(font, buff, buff_size, FALSE);
+  }
+
+  load_uint32(p, nr);
+  return_value_if_fail(8 + nr * 8 <= buff_size, RET_BAD_PARAMS);
+
+  for (i = 0; i < nr; i++) {
+    uint32_t offset = 0;
+    uint32_t size = 0;
+
+    load_uint32(p, offset);
+    load_uint32(p, size);
+    return_value_if_fail(offset + size <= buff_size, RET_BAD_PARAMS);
+    return_value_if_fail(font_bitmap_add_face(font, buff + offset, size, TRUE) == RET_OK, RET_FAIL);
+  }
+
   return RET_OK;
 }
 
@@ -84,13 +406,17 @@ font_t* font_bitmap_init(font_bitmap_t* f, const char* name, const uint8_t* buff
                          uint32_t buff_size) {
   return_value_if_fail(f != NULL && buff != NULL, NULL);
 
-  f->buff = buff;
   f->base.name = name;
-  f->buff_size = buff_size;
   f->base.match = font_bitmap_match;
   f->base.find_glyph = font_bitmap_find_glyph;
+  f->base.get_metrics = font_bitmap_get_metrics;
   f->base.destroy = font_bitmap_destroy;
 
+  if (font_bitmap_add(&(f->base), buff, buff_size) != RET_OK) {
+    font_bitmap_destroy(&(f->base));
+    return NULL;
+  }
+
   return &(f->base);
 }
 
@@ -31,14 +31,67 @@ typedef struct _font_bitmap_index_t {
   uint16_t offset;
 } font_bitmap_index_t;
 
+/*多字号容器中的单字号字体使用32位的索引，字模可以超过64K。*/
+typedef struct _font_bitmap_index32_t {
+  uint32_t c;
+  uint32_t offset;
+} font_bitmap_index32_t;
+
 typedef struct _font_bitmap_header_t {
   uint16_t char_nr;
   uint16_t font_size;
   font_bitmap_index_t index[1];
 } font_bitmap_header_t;
 
+/*
+ * 位图字体的格式：
+ * font_bitmap_header_t | 字模(x, y, w, h, data)... | advance表(每个字符一个字节) | footer
+ *
+ * footer由advance表的偏移和FONT_BITMAP_METRICS_MAGIC组成(都是uint32_t)。
+ * 没有footer的旧格式仍然可以使用：字符的宽度按w+1计算，空白字符当作不存在。
+ *
+ * 字模不是8位(GLYPH_FMT_A8)时，footer为：字模格式 | advance表的偏移 | FONT_BITMAP_FORMAT_MAGIC。
+ */
+#define FONT_BITMAP_METRICS_MAGIC 0x4d54524d
+#define FONT_BITMAP_FOOTER_SIZE 8
+#define FONT_BITMAP_FORMAT_MAGIC 0x544d5246
+#define FONT_BITMAP_FORMAT_FOOTER_SIZE 12
+
+/*
+ * 多字号的位图字体：
+ * magic | nr | nr个(offset, size) | nr个单字号的位图字体(起始位置4字节对齐)
+ *
+ * 全部字段都是uint32_t。容器中的单字号字体的索引是font_bitmap_index32_t，
+ * 不在容器中的单字号字体(旧格式)的索引是font_bitmap_index_t，字模的偏移不能超过0xffff。
+ */
+#define FONT_BITMAP_CONTAINER_MAGIC 0x434d4246
+
+#ifndef FONT_BITMAP_FACES_NR
+#define FONT_BITMAP_FACES_NR 8
+#endif /*FONT_BITMAP_FACES_NR*/
+
+/**
+ * @method font_bitmap_create
+ * 创建位图字体。buff可以是单字号的位图字体，也可以是多字号的位图字体。
+ * @param {char*} name 字体名。
+ * @param {uint8_t*} buff 字体数据(字体销毁前必须有效)。
+ * @param {uint32_t} buff_size 字体数据的长度。
+ *
+ * @return {font_t*} 返回字体对象。
+ */
 font_t* font_bitmap_create(const char* name, const uint8_t* buff, uint32_t buff_size);
 
+/**
+ * @method font_bitmap_add
+ * 向位图字体中加入其它字号(比如同名字体的多个资源)。
+ * @param {font_t*} f 位图字体对象。
+ * @param {uint8_t*} buff 字体数据(字体销毁前必须有效)。
+ * @param {uint32_t} buff_size 字体数据的长度。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t font_bitmap_add(font_t* f, const uint8_t* buff, uint32_t buff_size);
+
 END_C_DECLS
 
 #endif /*TK_FONT_BITMAP_H*/
@@ -22,12 +22,34 @@
 #define STB_TRUETYPE_IMPLEMENTATION
 
 #include "base/mem.h"
+#include "base/perf_stats.h"
 #include "font/font_stb.h"
 #include "stb/stb_truetype.h"
 
+#ifndef FONT_STB_SIZES_NR
+#define FONT_STB_SIZES_NR 4
+#endif /*FONT_STB_SIZES_NR*/
+
+#define FONT_STB_TABLE_CHARS 128
+
+#define FONT_STB_METRICS_UNKNOWN 0
+#define FONT_STB_METRICS_FOUND 1
+#define FONT_STB_METRICS_MISSING 2
+
+/*一种字号的缩放比例和ASCII字符的度量信息，用到时才计算。*/
+typedef struct _font_stb_size_t {
+  uint16_t font_size;
+  float scale;
+  uint8_t state[FONT_STB_TABLE_CHARS];
+  glyph_metrics_t metrics[FONT_STB_TABLE_CHARS];
+} font_stb_size_t;
+
 typedef struct _font_stb_t {
   font_t base;
   stbtt_fontinfo stb_font;
+
+  uint32_t next_size;
+  font_stb_size_t* sizes[FONT_STB_SIZES_NR];
 } font_stb_t;
 
 static bool_t font_stb_match(font_t* f, const char* name, uint16_t font_size) {
@@ -35,25 +57,140 @@ static bool_t font_stb_match(font_t* f, const char* name, uint16_t font_size) {
   return (name == NULL || strcmp(name, f->name) == 0);
 }
 
+static font_stb_size_t* font_stb_get_size(font_stb_t* font, uint16_t font_size) {
+  uint32_t i = 0;
+  font_stb_size_t* size = NULL;
+
+  for (i = 0; i < FONT_STB_SIZES_NR; i++) {
+    size = font->sizes[i];
+    if (size != NULL && size->font_size == font_size) {
+      return size;
+    }
+  }
+
+  /*字号比缓存的多时轮流替换。*/
+  i = font->next_size;
+  font->next_size = (i + 1) % FONT_STB_SIZES_NR;
+
+  size = font->sizes[i];
+  if (size == NULL) {
+    size = TKMEM_ZALLOC(font_stb_size_t);
+    return_value_if_fail(size != NULL, NULL);
+    font->sizes[i] = size;
+  }
+
+  memset(size, 0x00, sizeof(font_stb_size_t));
+  size->font_size = font_size;
+  size->scale = stbtt_ScaleForPixelHeight(&(font->stb_font), font_size);
+
+  return size;
+}
+
+static ret_t font_stb_calc_metrics(font_stb_t* font, font_stb_size_t* size, wchar_t c,
+                                   glyph_metrics_t* m) {
+  int x0 = 0;
+  int y0 = 0;
+  int x1 = 0;
+  int y1 = 0;
+  int lsb = 0;
+  int advance = 0;
+  float scale = size->scale;
+  stbtt_fontinfo* sf = &(font->stb_font);
+  int index = stbtt_FindGlyphIndex(sf, c);
+
+  if (index == 0) {
+    return RET_NOT_FOUND;
+  }
+
+  stbtt_GetGlyphHMetrics(sf, index, &advance, &lsb);
+  stbtt_GetGlyphBitmapBox(sf, index, scale, scale, &x0, &y0, &x1, &y1);
+
+  m->x = x0;
+  m->y = y0;
+  m->w = x1 - x0;
+  m->h = y1 - y0;
+  m->advance = (uint8_t)(advance * scale + 0.5f);
+
+  return RET_OK;
+}
+
+static ret_t font_stb_get_metrics_of_size(font_stb_t* font, font_stb_size_t* size, wchar_t c,
+                                          glyph_metrics_t* m) {
+  ret_t ret = RET_OK;
+
+  if ((uint32_t)c >= FONT_STB_TABLE_CHARS) {
+    perf_stats_add(PERF_COUNTER_GLYPH_MISSES, 1);
+    return font_stb_calc_metrics(font, size, c, m);
+  }
+
+  if (size->state[c] == FONT_STB_METRICS_UNKNOWN) {
+    perf_stats_add(PERF_COUNTER_GLYPH_MISSES, 1);
+    ret = font_stb_calc_metrics(font, size, c, size->metrics + c);
+    size->state[c] = ret == RET_OK ? FONT_STB_METRICS_FOUND : FONT_STB_METRICS_MISSING;
+  } else {
+    perf_stats_add(PERF_COUNTER_GLYPH_HITS, 1);
+  }
+
+  if (size->state[c] == FONT_STB_METRICS_MISSING) {
+    return RET_NOT_FOUND;
+  }
+
+  *m = size->metrics[c];
+
+  return RET_OK;
+}
+
+static ret_t font_stb_get_metrics(font_t* f, wchar_t c, glyph_metrics_t* m, uint16_t font_size) {
+  font_stb_t* font = (font_stb_t*)f;
+  font_stb_size_t* size = font_stb_get_size(font, font_size);
+  return_value_if_fail(size != NULL, RET_OOM);
+
+  return font_stb_get_metrics_of_size(font, size, c, m);
+}
+
 static ret_t font_stb_find_glyph(font_t* f, wchar_t c, glyph_t* g, uint16_t font_size) {
   int x = 0;
   int y = 0;
   int w = 0;
   int h = 0;
-  int s = font_size;
+  glyph_metrics_t m;
   font_stb_t* font = (font_stb_t*)f;
   stbtt_fontinfo* sf = &(font->stb_font);
+  font_stb_size_t* size = font_stb_get_size(font, font_size);
+  return_value_if_fail(size != NULL, RET_OOM);
+
+  if (font_stb_get_metrics_of_size(font, size, c, &m) != RET_OK) {
+    return RET_NOT_FOUND;
+  }
+
+  g->x = m.x;
+  g->y = m.y;
+  g->w = m.w;
+  g->h = m.h;
+  g->advance = m.advance;
+  g->format = GLYPH_FMT_A8;
+  g->data = NULL;
 
-  g->data = stbtt_GetCodepointBitmap(sf, 0, stbtt_ScaleForPixelHeight(sf, s), c, &w, &h, &x, &y);
-  g->x = x;
-  g->y = y;
-  g->w = w;
-  g->h = h;
+  /*空格之类的字符只有宽度，没有字模。*/
+  if (m.w == 0 || m.h == 0) {
+    return RET_OK;
+  }
+
+  g->data = stbtt_GetCodepointBitmap(sf, 0, size->scale, c, &w, &h, &x, &y);
 
   return g->data != NULL ? RET_OK : RET_NOT_FOUND;
 }
 
 static ret_t font_stb_destroy(font_t* f) {
+  uint32_t i = 0;
+  font_stb_t* font = (font_stb_t*)f;
+
+  for (i = 0; i < FONT_STB_SIZES_NR; i++) {
+    if (font->sizes[i] != NULL) {
+      TKMEM_FREE(font->sizes[i]);
+    }
+  }
+
   TKMEM_FREE(f);
 
   return RET_OK;
@@ -69,6 +206,7 @@ font_t* font_stb_create(const char* name, const uint8_t* buff, uint32_t buff_siz
   f->base.name = name;
   f->base.match = font_stb_match;
   f->base.find_glyph = font_stb_find_glyph;
+  f->base.get_metrics = font_stb_get_metrics;
   f->base.destroy = font_stb_destroy;
 
   stbtt_InitFont(&(f->stb_font), buff, stbtt_GetFontOffsetForIndex(buff, 0));
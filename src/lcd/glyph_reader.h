@@ -0,0 +1,168 @@
+/**
+ * File:   glyph_reader.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  read coverage from packed glyphs
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-19 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_GLYPH_READER_H
+#define TK_GLYPH_READER_H
+
+#include "base/font.h"
+
+/*
+ * 从字模的(sx, sy)开始逐行读取覆盖率(0-0xff)，直接从1/2/4位或者压缩的数据中读取，
+ * 不需要先展开成8位的字模。格式参见GLYPH_FMT_*。
+ */
+typedef struct _glyph_reader_t {
+  const uint8_t* row;
+  const uint8_t* p;
+  uint32_t stride;
+  uint32_t pos;
+  uint32_t row_start;
+  uint16_t w;
+  uint16_t sx;
+  uint8_t bpp;
+  uint8_t mask;
+  uint8_t scale;
+  uint8_t shift;
+  bool_t rle;
+  uint8_t run_alpha;
+  uint16_t run_left;
+} glyph_reader_t;
+
+static inline void glyph_reader_seek_col(glyph_reader_t* r) {
+  uint32_t bits = r->sx * r->bpp;
+
+  r->p = r->row + (bits >> 3);
+  r->shift = 8 - r->bpp - (bits & 0x07);
+}
+
+static inline void glyph_reader_load_run(glyph_reader_t* r) {
+  uint8_t b = *(r->p)++;
+
+  r->run_alpha = (b >> (8 - r->bpp)) * r->scale;
+  r->run_left = (b & (0xff >> r->bpp)) + 1;
+}
+
+/*压缩的字模只能顺序读取，跳过n个像素。*/
+static inline void glyph_reader_skip(glyph_reader_t* r, uint32_t n) {
+  r->pos += n;
+  while (n > 0) {
+    uint32_t k = 0;
+    if (r->run_left == 0) {
+      glyph_reader_load_run(r);
+    }
+
+    k = ftk_min(n, r->run_left);
+    r->run_left -= k;
+    n -= k;
+  }
+}
+
+static inline void glyph_reader_init(glyph_reader_t* r, glyph_t* glyph, uint32_t sx, uint32_t sy) {
+  memset(r, 0x00, sizeof(glyph_reader_t));
+
+  r->w = glyph->w;
+  r->sx = sx;
+  r->bpp = GLYPH_FMT_BPP(glyph->format);
+  r->mask = 0xff >> (8 - r->bpp);
+  r->scale = 0xff / r->mask;
+  r->rle = (glyph->format & GLYPH_FMT_RLE) && r->bpp < 8;
+  r->stride = (glyph->w * r->bpp + 7) >> 3;
+
+  if (r->rle) {
+    r->p = glyph->data;
+    r->row_start = sy * glyph->w;
+    glyph_reader_skip(r, r->row_start + sx);
+  } else {
+    r->row = glyph->data + sy * r->stride;
+    glyph_reader_seek_col(r);
+  }
+}
+
+/*读取下一个像素的覆盖率。*/
+static inline uint8_t glyph_reader_read(glyph_reader_t* r) {
+  uint8_t v = 0;
+
+  if (r->rle) {
+    if (r->run_left == 0) {
+      glyph_reader_load_run(r);
+    }
+    r->pos++;
+    r->run_left--;
+
+    return r->run_alpha;
+  }
+
+  if (r->bpp == 8) {
+    return *(r->p)++;
+  }
+
+  v = (*(r->p) >> r->shift) & r->mask;
+  if (r->shift == 0) {
+    r->p++;
+    r->shift = 8 - r->bpp;
+  } else {
+    r->shift -= r->bpp;
+  }
+
+  return v * r->scale;
+}
+
+/*
+ * 读取一段覆盖率相同的像素(最多max个)，返回像素个数。
+ * 压缩的字模一次返回整个行程，1/2/4位的字模整个字节全空或者全满时一次返回一个字节。
+ */
+static inline uint32_t glyph_reader_read_run(glyph_reader_t* r, uint32_t max, uint8_t* alpha) {
+  uint32_t n = 0;
+
+  if (!r->rle) {
+    n = 8 / r->bpp;
+    if (r->bpp < 8 && r->shift == 8 - r->bpp && max >= n && (*(r->p) == 0 || *(r->p) == 0xff)) {
+      *alpha = *(r->p)++;
+      return n;
+    }
+
+    *alpha = glyph_reader_read(r);
+    return 1;
+  }
+
+  if (r->run_left == 0) {
+    glyph_reader_load_run(r);
+  }
+
+  n = ftk_min(max, r->run_left);
+  *alpha = r->run_alpha;
+  r->run_left -= n;
+  r->pos += n;
+
+  return n;
+}
+
+/*移到下一行的sx处。*/
+static inline void glyph_reader_next_row(glyph_reader_t* r) {
+  if (r->rle) {
+    r->row_start += r->w;
+    glyph_reader_skip(r, r->row_start + r->sx - r->pos);
+  } else {
+    r->row += r->stride;
+    glyph_reader_seek_col(r);
+  }
+}
+
+#endif /*TK_GLYPH_READER_H*/
@@ -26,14 +26,83 @@
 
 BEGIN_C_DECLS
 
+#ifndef LCD_MEM_POOL_NR
+#define LCD_MEM_POOL_NR 2
+#endif /*LCD_MEM_POOL_NR*/
+
+/*过度绘制的统计信息，调试时才分配。*/
+typedef struct _lcd_mem_overdraw_t {
+  /*本帧中每个像素被写的次数(到255为止)。*/
+  uint8_t* counts;
+  /*本帧写像素的总次数。分块绘制时多个线程同时累加。*/
+  volatile uint32_t writes;
+  /*本帧脏矩形的面积。*/
+  uint32_t dirty_pixels;
+  /*帧结束时把热图叠加到屏幕上。*/
+  bool_t show;
+} lcd_mem_overdraw_t;
+
 typedef struct _lcd_mem_t {
   lcd_t base;
   uint8_t* pixels;
   vgcanvas_t* vgcanvas;
+
+  /*释放后留下来重用的全屏离屏缓冲区(窗口动画等)，避免反复分配大块内存。*/
+  uint8_t* pool[LCD_MEM_POOL_NR];
+  /*离屏lcd所属的屏幕lcd，缓冲区池在它里面。*/
+  struct _lcd_mem_t* owner;
+  /*过度绘制的统计信息，视图和屏幕lcd共用，离屏lcd不统计。*/
+  lcd_mem_overdraw_t* overdraw;
 } lcd_mem_t;
 
 lcd_t* lcd_mem_create(wh_t w, wh_t h, bool_t alloc);
 
+/**
+ * @method lcd_mem_set_overdraw
+ * 开启/关闭过度绘制的统计(调试用)。
+ * 开启后每一帧记录每个像素被写的次数，每个绘制操作覆盖的像素都算写一次(包括混合)。
+ * show为TRUE时，帧结束时把写了两次以上的像素按次数用蓝、绿、粉、红色叠加到屏幕上。
+ * 叠加了热图的像素不能再被移动，所以显示热图期间不支持lcd_scroll(滚动时全部重绘)。
+ * @param {lcd_t*} lcd 用lcd_mem_create创建的lcd对象。
+ * @param {bool_t} enable 是否统计。
+ * @param {bool_t} show 是否显示热图。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t lcd_mem_set_overdraw(lcd_t* lcd, bool_t enable, bool_t show);
+
+/**
+ * @method lcd_mem_get_overdraw_ratio
+ * 获取最近一帧的过度绘制率：写像素的总次数/脏矩形的面积，用百分比表示。
+ * 每个脏像素正好写一次时为100，没有开启统计或者没有脏矩形时为0。
+ * @param {lcd_t*} lcd lcd对象。
+ *
+ * @return {uint32_t} 返回过度绘制率。
+ */
+uint32_t lcd_mem_get_overdraw_ratio(lcd_t* lcd);
+
+/**
+ * @method lcd_mem_get_overdraw
+ * 获取最近一帧中指定像素被写的次数。
+ * @param {lcd_t*} lcd lcd对象。
+ * @param {xy_t} x x坐标。
+ * @param {xy_t} y y坐标。
+ *
+ * @return {uint32_t} 返回写的次数。
+ */
+uint32_t lcd_mem_get_overdraw(lcd_t* lcd, xy_t x, xy_t y);
+
+/**
+ * @method lcd_mem_get_overdraw_heatmap
+ * 把最近一帧的写像素次数生成RGBA格式的热图：没有写过的为黑色，写一次的为灰色，
+ * 两次到五次以上的依次为蓝、绿、粉、红色。用bitmap_destroy释放。
+ * @param {lcd_t*} lcd lcd对象。
+ * @param {bitmap_t*} img 返回热图。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t lcd_mem_get_overdraw_heatmap(lcd_t* lcd, bitmap_t* img);
+
 END_C_DECLS
 
 #endif /*LCD_TKMEM_H*/
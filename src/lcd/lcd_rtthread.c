@@ -78,6 +78,16 @@ static ret_t lcd_rtthread_draw_glyph(lcd_t* lcd, glyph_t* glyph, rect_t* src, xy
   return lcd_draw_glyph(mem, glyph, src, x, y);
 }
 
+static ret_t lcd_rtthread_draw_glyphs(lcd_t* lcd, lcd_glyph_t* glyphs, uint32_t nr,
+                                      rect_t* bounds) {
+  lcd_rtthread_t* rtt = (lcd_rtthread_t*)lcd;
+  lcd_t* mem = (lcd_t*)(rtt->lcd_mem);
+  mem->text_color = lcd->text_color;
+  mem->fill_color = lcd->fill_color;
+
+  return lcd_draw_glyphs(mem, glyphs, nr, bounds);
+}
+
 static ret_t lcd_rtthread_draw_image(lcd_t* lcd, bitmap_t* img, rect_t* src, rect_t* dst) {
   lcd_rtthread_t* rtt = (lcd_rtthread_t*)lcd;
   lcd_t* mem = (lcd_t*)(rtt->lcd_mem);
@@ -120,6 +130,7 @@ lcd_t* lcd_rtthread_init(struct rtgui_graphic_driver* driver) {
   base->fill_rect = lcd_rtthread_fill_rect;
   base->draw_image = lcd_rtthread_draw_image;
   base->draw_glyph = lcd_rtthread_draw_glyph;
+  base->draw_glyphs = lcd_rtthread_draw_glyphs;
   base->draw_points = lcd_rtthread_draw_points;
   base->end_frame = lcd_rtthread_end_frame;
   base->destroy = lcd_rtthread_destroy;
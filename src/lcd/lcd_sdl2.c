@@ -87,6 +87,15 @@ static ret_t lcd_sdl2_draw_glyph(lcd_t* lcd, glyph_t* glyph, rect_t* src, xy_t x
   return lcd_draw_glyph(mem, glyph, src, x, y);
 }
 
+static ret_t lcd_sdl2_draw_glyphs(lcd_t* lcd, lcd_glyph_t* glyphs, uint32_t nr, rect_t* bounds) {
+  lcd_sdl2_t* sdl = (lcd_sdl2_t*)lcd;
+  lcd_t* mem = (lcd_t*)(sdl->lcd_mem);
+  mem->text_color = lcd->text_color;
+  mem->fill_color = lcd->fill_color;
+
+  return lcd_draw_glyphs(mem, glyphs, nr, bounds);
+}
+
 static ret_t lcd_sdl2_draw_image(lcd_t* lcd, bitmap_t* img, rect_t* src, rect_t* dst) {
   lcd_sdl2_t* sdl = (lcd_sdl2_t*)lcd;
   lcd_t* mem = (lcd_t*)(sdl->lcd_mem);
@@ -123,6 +132,18 @@ static ret_t lcd_sdl_take_snapshot(lcd_t* lcd, bitmap_t* img) {
   return lcd_take_snapshot((lcd_t*)(mem->lcd_mem), img);
 }
 
+static lcd_t* lcd_sdl2_create_layer(lcd_t* lcd, bitmap_t* img) {
+  lcd_sdl2_t* mem = (lcd_sdl2_t*)lcd;
+
+  return lcd_create_layer((lcd_t*)(mem->lcd_mem), img);
+}
+
+static lcd_t* lcd_sdl2_create_view(lcd_t* lcd) {
+  lcd_sdl2_t* mem = (lcd_sdl2_t*)lcd;
+
+  return lcd_create_view((lcd_t*)(mem->lcd_mem));
+}
+
 static vgcanvas_t* lcd_sdl2_get_vgcanvas(lcd_t* lcd) {
   lcd_sdl2_t* mem = (lcd_sdl2_t*)lcd;
 
@@ -145,11 +166,14 @@ lcd_t* lcd_sdl2_init(SDL_Renderer* render) {
   base->fill_rect = lcd_sdl2_fill_rect;
   base->draw_image = lcd_sdl2_draw_image;
   base->draw_glyph = lcd_sdl2_draw_glyph;
+  base->draw_glyphs = lcd_sdl2_draw_glyphs;
   base->draw_points = lcd_sdl2_draw_points;
   base->get_point_color = lcd_sdl2_get_point_color;
   base->end_frame = lcd_sdl2_end_frame;
   base->get_vgcanvas = lcd_sdl2_get_vgcanvas;
   base->take_snapshot = lcd_sdl_take_snapshot;
+  base->create_layer = lcd_sdl2_create_layer;
+  base->create_view = lcd_sdl2_create_view;
   base->destroy = lcd_sdl2_destroy;
 
   SDL_GetRendererOutputSize(render, &w, &h);
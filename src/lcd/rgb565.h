@@ -53,6 +53,16 @@ static inline pixel_t blend_pixel(pixel_t pixel, color_t c) {
   return rgb_to_pixel(r, g, b);
 }
 
+/*按a在两个像素之间插值。把像素展开成0x07e0f81f的形式，三个通道用一次乘法同时计算。*/
+static inline pixel_t lerp_pixel(pixel_t d, pixel_t s, uint8_t a) {
+  uint32_t a5 = (a + 4) >> 3;
+  uint32_t dd = (d | ((uint32_t)d << 16)) & 0x07e0f81f;
+  uint32_t ss = (s | ((uint32_t)s << 16)) & 0x07e0f81f;
+  uint32_t r = ((ss * a5 + dd * (32 - a5)) >> 5) & 0x07e0f81f;
+
+  return (pixel_t)(r | (r >> 16));
+}
+
 static inline pixel_t blend_alpha(color_t fg, uint8_t a) {
   uint8_t r = (fg.rgba.r * a) >> 8;
   uint8_t g = (fg.rgba.g * a) >> 8;
@@ -61,6 +61,19 @@ static inline pixel_t blend_pixel(pixel_t pixel, color_t c) {
   return rgb_to_pixel(r, g, b);
 }
 
+/*按a在两个像素之间插值，结果与blend_pixel相同。r/b和g/a两个通道放在一个32位整数中同时计算。*/
+static inline pixel_t lerp_pixel(pixel_t d, pixel_t s, uint8_t a) {
+  uint32_t minus_a = 0xff - a;
+  uint32_t rb = ((d >> 8) & 0x00ff00ff) * minus_a + ((s >> 8) & 0x00ff00ff) * a;
+  uint32_t ga = (d & 0x00ff00ff) * minus_a + (s & 0x00ff00ff) * a;
+
+  /*每个通道除以0xff: x/0xff == (x + 1 + (x >> 8)) >> 8 (x < 0xffff)*/
+  rb = ((rb + 0x00010001 + ((rb >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+  ga = ((ga + 0x00010001 + ((ga >> 8) & 0x00ff00ff)) >> 8) & 0x00ff00ff;
+
+  return (rb << 8) | ga;
+}
+
 static inline pixel_t blend_alpha(color_t fg, uint8_t a) {
   uint16_t rr = (fg.rgba.r + a) / 0xff;
   uint16_t gg = (fg.rgba.g + a) / 0xff;
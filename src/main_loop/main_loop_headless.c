@@ -0,0 +1,298 @@
+/**
+ * File:   main_loop_headless.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  main loop without display, driven by a virtual clock
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-21 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/idle.h"
+#include "base/time.h"
+#include "base/timer.h"
+#include "lcd/lcd_mem.h"
+#include "base/platform.h"
+#include "base/task_queue.h"
+#include "base/input_trace.h"
+#include "base/font_manager.h"
+#include "base/window_manager.h"
+#include "base/frame_scheduler.h"
+#include "main_loop/main_loop_headless.h"
+
+static uint32_t s_headless_now = MAIN_LOOP_HEADLESS_START_TIME;
+
+uint32_t main_loop_headless_now(void) {
+  return s_headless_now;
+}
+
+/*record不为NULL时，强制运行录制的帧，并计算校验和。*/
+static ret_t main_loop_headless_paint(main_loop_headless_t* loop, input_trace_record_t* record) {
+  rect_t dirty;
+  mem_stat_t before;
+  mem_stat_t after;
+  uint32_t frames = 0;
+  bool_t painted = FALSE;
+  frame_scheduler_t* fs = frame_scheduler();
+  return_value_if_fail(fs != NULL, RET_BAD_PARAMS);
+
+  frames = fs->stat.frames;
+  dirty = WINDOW_MANAGER(loop->wm)->dirty_rect;
+  before = mem_stat();
+  if (record != NULL) {
+    frame_scheduler_run_frame(fs, s_headless_now, loop->wm, &(loop->canvas));
+  } else {
+    frame_scheduler_dispatch(fs, s_headless_now, loop->wm, &(loop->canvas));
+  }
+  after = mem_stat();
+  painted = fs->stat.frames != frames;
+
+  if (record != NULL && painted != (record->x != 0)) {
+    log_warn("frame at %u: painted=%d, expected %d\n", record->time, painted, record->x);
+    loop->mismatches++;
+  }
+
+  if (painted) {
+    headless_frame_t frame;
+
+    frame.checksum = 0;
+    frame.expected = 0;
+    if (record != NULL) {
+      frame.checksum = input_trace_checksum(loop->lcd);
+      frame.expected = record->value;
+      if (frame.expected == 0) {
+        record->value = frame.checksum;
+      } else if (frame.expected != frame.checksum) {
+        log_warn("frame at %u: checksum %08x, expected %08x\n", record->time, frame.checksum,
+                 frame.expected);
+        loop->mismatches++;
+      }
+    }
+
+    frame.index = loop->frames_nr++;
+    frame.time = s_headless_now;
+    frame.dirty = dirty;
+    frame.cost = fs->stat.cost;
+    frame.cpu_time = fs->stat.cpu_time;
+    frame.alloc_times = after.alloc_times - before.alloc_times;
+    frame.free_times = after.free_times - before.free_times;
+
+    if (loop->on_frame != NULL) {
+      loop->on_frame(loop->on_frame_ctx, &frame);
+    }
+  }
+
+  return RET_OK;
+}
+
+static ret_t main_loop_headless_flush(main_loop_headless_t* loop) {
+  if (task_queue() != NULL) {
+    task_queue_dispatch(task_queue());
+  }
+
+  return idle_dispatch();
+}
+
+static ret_t main_loop_headless_iterate(main_loop_headless_t* loop) {
+  timer_check();
+  main_loop_headless_flush(loop);
+
+  return main_loop_headless_paint(loop, NULL);
+}
+
+ret_t main_loop_headless_step(main_loop_t* l, uint32_t ms) {
+  uint32_t interval = 0;
+  uint32_t end = s_headless_now + ms;
+  main_loop_headless_t* loop = (main_loop_headless_t*)l;
+  return_value_if_fail(loop != NULL && frame_scheduler() != NULL, RET_BAD_PARAMS);
+
+  interval = frame_scheduler()->interval;
+  main_loop_headless_iterate(loop);
+  while (s_headless_now != end) {
+    s_headless_now += ftk_min(interval, end - s_headless_now);
+    main_loop_headless_iterate(loop);
+  }
+
+  return RET_OK;
+}
+
+ret_t main_loop_headless_pointer(main_loop_t* l, uint16_t type, xy_t x, xy_t y) {
+  pointer_event_t event;
+  main_loop_headless_t* loop = (main_loop_headless_t*)l;
+  return_value_if_fail(loop != NULL, RET_BAD_PARAMS);
+
+  if (type == EVT_POINTER_DOWN) {
+    loop->pressed = 1;
+  }
+
+  memset(&event, 0x00, sizeof(event));
+  event.e.type = type;
+  event.x = x;
+  event.y = y;
+  event.pressed = loop->pressed;
+  window_manager_dispatch_input_event(loop->wm, (event_t*)&event);
+
+  if (type == EVT_POINTER_UP) {
+    loop->pressed = 0;
+  }
+
+  return RET_OK;
+}
+
+ret_t main_loop_headless_key(main_loop_t* l, uint16_t type, uint32_t key) {
+  key_event_t event;
+  main_loop_headless_t* loop = (main_loop_headless_t*)l;
+  return_value_if_fail(loop != NULL, RET_BAD_PARAMS);
+
+  memset(&event, 0x00, sizeof(event));
+  event.e.type = type;
+  event.key = key;
+
+  return window_manager_dispatch_input_event(loop->wm, (event_t*)&event);
+}
+
+ret_t main_loop_headless_replay(main_loop_t* l, input_trace_t* trace, bool_t update) {
+  uint32_t i = 0;
+  uint32_t start = s_headless_now;
+  main_loop_headless_t* loop = (main_loop_headless_t*)l;
+  return_value_if_fail(loop != NULL && trace != NULL && input_trace() == NULL, RET_BAD_PARAMS);
+
+  if (trace->w != loop->lcd->w || trace->h != loop->lcd->h) {
+    log_warn("trace is recorded at %dx%d, replay at %dx%d\n", trace->w, trace->h, loop->lcd->w,
+             loop->lcd->h);
+  }
+
+  /*按录制时一次循环的顺序回放：检查定时器、分发输入事件、处理任务和idle、绘制。*/
+  loop->mismatches = 0;
+  for (i = 0; i < trace->size; i++) {
+    input_trace_record_t* r = trace->records + i;
+    uint32_t t = start + r->time;
+
+    if (t != s_headless_now) {
+      main_loop_headless_flush(loop);
+      frame_scheduler_check_idle(frame_scheduler(), t, loop->wm);
+      s_headless_now = t;
+    }
+
+    switch (r->type) {
+      case INPUT_TRACE_TIMER: {
+        timer_check();
+        break;
+      }
+      case EVT_POINTER_DOWN:
+      case EVT_POINTER_MOVE:
+      case EVT_POINTER_UP: {
+        main_loop_headless_pointer(l, r->type, r->x, r->y);
+        break;
+      }
+      case EVT_KEY_DOWN:
+      case EVT_KEY_UP: {
+        main_loop_headless_key(l, r->type, r->value);
+        break;
+      }
+      case INPUT_TRACE_FRAME: {
+        main_loop_headless_flush(loop);
+        if (update) {
+          r->value = 0;
+        }
+        main_loop_headless_paint(loop, r);
+        break;
+      }
+      default:
+        break;
+    }
+  }
+  main_loop_headless_flush(loop);
+
+  return loop->mismatches == 0 ? RET_OK : RET_FAIL;
+}
+
+ret_t main_loop_headless_set_on_frame(main_loop_t* l, headless_on_frame_t on_frame, void* ctx) {
+  main_loop_headless_t* loop = (main_loop_headless_t*)l;
+  return_value_if_fail(loop != NULL, RET_BAD_PARAMS);
+
+  loop->on_frame = on_frame;
+  loop->on_frame_ctx = ctx;
+
+  return RET_OK;
+}
+
+static ret_t main_loop_headless_run(main_loop_t* l) {
+  while (l->running) {
+    main_loop_headless_step(l, frame_scheduler()->interval);
+  }
+
+  return RET_OK;
+}
+
+static ret_t main_loop_headless_quit(main_loop_t* l) {
+  return RET_OK;
+}
+
+/*缓冲区没有初始化，先清成黑色，同样的输入总是得到同样的像素。*/
+static ret_t main_loop_headless_clear(main_loop_headless_t* loop, wh_t w, wh_t h) {
+  rect_t r;
+  canvas_t* c = &(loop->canvas);
+
+  rect_init(r, 0, 0, w, h);
+  canvas_begin_frame(c, &r, LCD_DRAW_NORMAL);
+  canvas_set_fill_color(c, color_init(0, 0, 0, 0xff));
+  canvas_fill_rect(c, 0, 0, w, h);
+
+  return canvas_end_frame(c);
+}
+
+static ret_t main_loop_headless_destroy(main_loop_t* l) {
+  main_loop_headless_t* loop = (main_loop_headless_t*)l;
+
+  time_set_source(NULL);
+  timer_init(get_time_ms);
+  lcd_destroy(loop->lcd);
+  TKMEM_FREE(loop);
+
+  return RET_OK;
+}
+
+main_loop_t* main_loop_headless_create(wh_t w, wh_t h) {
+  main_loop_headless_t* loop = NULL;
+  return_value_if_fail(window_manager() != NULL && frame_scheduler() != NULL, NULL);
+
+  loop = TKMEM_ZALLOC(main_loop_headless_t);
+  return_value_if_fail(loop != NULL, NULL);
+
+  loop->lcd = lcd_mem_create(w, h, TRUE);
+  if (loop->lcd == NULL) {
+    TKMEM_FREE(loop);
+    return NULL;
+  }
+
+  loop->base.run = main_loop_headless_run;
+  loop->base.quit = main_loop_headless_quit;
+  loop->base.destroy = main_loop_headless_destroy;
+  loop->wm = window_manager();
+  canvas_init(&(loop->canvas), loop->lcd, font_manager());
+  main_loop_headless_clear(loop, w, h);
+
+  s_headless_now = MAIN_LOOP_HEADLESS_START_TIME;
+  time_set_source(main_loop_headless_now);
+  timer_init(main_loop_headless_now);
+  /*时钟重新开始，之前的刷新时机作废。*/
+  frame_scheduler_set_interval(frame_scheduler(), frame_scheduler()->interval);
+
+  window_manager_resize(loop->wm, w, h);
+  main_loop_set_default(&(loop->base));
+
+  return &(loop->base);
+}
@@ -0,0 +1,218 @@
+/**
+ * File:   main_loop_headless.h
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  main loop without display, driven by a virtual clock
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-21 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#ifndef TK_MAIN_LOOP_HEADLESS_H
+#define TK_MAIN_LOOP_HEADLESS_H
+
+#include "base/canvas.h"
+#include "base/main_loop.h"
+#include "base/input_trace.h"
+
+BEGIN_C_DECLS
+
+/*虚拟时钟的起点，避开0(有的地方用0表示没有设置时间)。*/
+#define MAIN_LOOP_HEADLESS_START_TIME 10000
+
+/**
+ * @class headless_frame_t
+ * 无头模式下绘制的一帧的信息。
+ */
+typedef struct _headless_frame_t {
+  /**
+   * @property {uint32_t} index
+   * @readonly
+   * 帧的序号(从0开始)。
+   */
+  uint32_t index;
+  /**
+   * @property {uint32_t} time
+   * @readonly
+   * 虚拟时间(毫秒)。
+   */
+  uint32_t time;
+  /**
+   * @property {rect_t} dirty
+   * @readonly
+   * 本帧的脏矩形。
+   */
+  rect_t dirty;
+  /**
+   * @property {uint32_t} cost
+   * @readonly
+   * 动画回调和绘制的耗时(毫秒，真实时间)。
+   */
+  uint32_t cost;
+  /**
+   * @property {uint32_t} cpu_time
+   * @readonly
+   * 动画回调和绘制的CPU时间(微秒)。
+   */
+  uint32_t cpu_time;
+  /**
+   * @property {uint32_t} alloc_times
+   * @readonly
+   * 本帧内存分配的次数。
+   */
+  uint32_t alloc_times;
+  /**
+   * @property {uint32_t} free_times
+   * @readonly
+   * 本帧内存释放的次数。
+   */
+  uint32_t free_times;
+  /**
+   * @property {uint32_t} checksum
+   * @readonly
+   * 回放输入轨迹时framebuffer的校验和，其它时候为0。
+   */
+  uint32_t checksum;
+  /**
+   * @property {uint32_t} expected
+   * @readonly
+   * 回放输入轨迹时录制的校验和，0表示没有。
+   */
+  uint32_t expected;
+} headless_frame_t;
+
+typedef ret_t (*headless_on_frame_t)(void* ctx, const headless_frame_t* frame);
+
+/**
+ * @class main_loop_headless_t
+ * @parent main_loop_t
+ * 无头模式的主循环。
+ *
+ * 绘制到lcd_mem_create创建的内存lcd上，不需要显示设备。
+ * 用虚拟时钟驱动timer、time_now_ms和帧调度器，时间只在main_loop_headless_step中前进，
+ * 所以同样的输入序列总是得到同样的帧序列，适合做性能测试和回归测试。
+ */
+typedef struct _main_loop_headless_t {
+  main_loop_t base;
+
+  widget_t* wm;
+  canvas_t canvas;
+  /**
+   * @property {lcd_t*} lcd
+   * @readonly
+   * 内存lcd对象。
+   */
+  lcd_t* lcd;
+  /**
+   * @property {uint32_t} frames_nr
+   * @readonly
+   * 已经绘制的帧数。
+   */
+  uint32_t frames_nr;
+  /**
+   * @property {uint32_t} mismatches
+   * @readonly
+   * 最近一次回放中和录制时不一致的帧数(是否绘制或者校验和不同)。
+   */
+  uint32_t mismatches;
+
+  /*private*/
+  uint8_t pressed;
+  headless_on_frame_t on_frame;
+  void* on_frame_ctx;
+} main_loop_headless_t;
+
+/**
+ * @method main_loop_headless_create
+ * @constructor
+ * 创建无头模式的主循环，并设置为缺省的主循环。
+ * 调用之前需要设置好window manager、font manager和frame scheduler。
+ * @param {wh_t} w 宽度。
+ * @param {wh_t} h 高度。
+ *
+ * @return {main_loop_t*} 返回主循环对象。
+ */
+main_loop_t* main_loop_headless_create(wh_t w, wh_t h);
+
+/**
+ * @method main_loop_headless_set_on_frame
+ * 设置每绘制一帧的回调函数。
+ * @param {main_loop_t*} l 主循环对象。
+ * @param {headless_on_frame_t} on_frame 回调函数。
+ * @param {void*} ctx 回调函数的上下文。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t main_loop_headless_set_on_frame(main_loop_t* l, headless_on_frame_t on_frame, void* ctx);
+
+/**
+ * @method main_loop_headless_now
+ * 获取虚拟时钟的当前时间。
+ *
+ * @return {uint32_t} 返回时间(毫秒)。
+ */
+uint32_t main_loop_headless_now(void);
+
+/**
+ * @method main_loop_headless_step
+ * 让虚拟时间前进ms毫秒，每个刷新周期运行一次循环(定时器、任务、idle和绘制)。
+ * ms为0时只运行一次循环。
+ * @param {main_loop_t*} l 主循环对象。
+ * @param {uint32_t} ms 前进的时间(毫秒)。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t main_loop_headless_step(main_loop_t* l, uint32_t ms);
+
+/**
+ * @method main_loop_headless_replay
+ * 回放输入轨迹(参考input_trace_t)。
+ * 在录制时的时刻(相对于回放开始时的虚拟时间)检查定时器、分发输入事件和运行每一帧，
+ * 每绘制一帧调用on_frame，并比较framebuffer的校验和。
+ * 录制中没有校验和的帧(比如lcd不支持take_snapshot)用回放得到的校验和填上。
+ * 回放之前的界面(打开的窗口等)需要和开始录制时一样。
+ * @param {main_loop_t*} l 主循环对象。
+ * @param {input_trace_t*} trace 输入轨迹对象。
+ * @param {bool_t} update 为TRUE时不比较，用回放得到的校验和替换录制的校验和。
+ *
+ * @return {ret_t} 返回RET_OK表示帧序列和校验和都一致，RET_FAIL表示有不一致的帧。
+ */
+ret_t main_loop_headless_replay(main_loop_t* l, input_trace_t* trace, bool_t update);
+
+/**
+ * @method main_loop_headless_pointer
+ * 分发指针事件。
+ * @param {main_loop_t*} l 主循环对象。
+ * @param {uint16_t} type 事件类型(EVT_POINTER_DOWN/EVT_POINTER_MOVE/EVT_POINTER_UP)。
+ * @param {xy_t} x x坐标。
+ * @param {xy_t} y y坐标。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t main_loop_headless_pointer(main_loop_t* l, uint16_t type, xy_t x, xy_t y);
+
+/**
+ * @method main_loop_headless_key
+ * 分发按键事件。
+ * @param {main_loop_t*} l 主循环对象。
+ * @param {uint16_t} type 事件类型(EVT_KEY_DOWN/EVT_KEY_UP)。
+ * @param {uint32_t} key 键值。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t main_loop_headless_key(main_loop_t* l, uint16_t type, uint32_t key);
+
+END_C_DECLS
+
+#endif /*TK_MAIN_LOOP_HEADLESS_H*/
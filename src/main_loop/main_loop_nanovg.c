@@ -26,6 +26,10 @@
 #include "base/window_manager.h"
 #include "lcd/lcd_nanovg.h"
 #include "base/timer.h"
+#include "base/task_queue.h"
+#include "base/time.h"
+#include "base/frame_scheduler.h"
+#include "base/input_trace.h"
 #include "base/idle.h"
 
 #include "glad/glad.h"
@@ -142,23 +146,39 @@ static ret_t main_loop_nanovg_dispatch(main_loop_nanovg_t* loop) {
 }
 
 static ret_t main_loop_nanovg_paint(main_loop_nanovg_t* loop) {
-  ret_t ret = window_manager_paint(loop->wm, &(loop->canvas));
+  ret_t ret = frame_scheduler_dispatch(frame_scheduler(), time_now_ms(), loop->wm, &(loop->canvas));
 
   return ret;
 }
 
+/*在投递任务的线程中调用(SDL_PushEvent是线程安全的)，让主循环从等待中醒来。*/
+static ret_t main_loop_nanovg_wakeup(void* ctx) {
+  SDL_Event event;
+
+  memset(&event, 0x00, sizeof(event));
+  event.type = SDL_USEREVENT;
+  SDL_PushEvent(&event);
+  (void)ctx;
+
+  return RET_OK;
+}
+
 static ret_t main_loop_nanovg_run(main_loop_t* l) {
   main_loop_nanovg_t* loop = (main_loop_nanovg_t*)l;
 
   while (l->running) {
+    if (input_trace() != NULL) {
+      input_trace_tick(input_trace());
+    }
+
     timer_check();
     main_loop_nanovg_dispatch(loop);
+    task_queue_dispatch(task_queue());
     idle_dispatch();
 
     main_loop_nanovg_paint(loop);
-    if (!WINDOW_MANAGER(loop->wm)->animating) {
-      SDL_Delay(30);
-    }
+    SDL_WaitEventTimeout(NULL, frame_scheduler_get_wait_time(frame_scheduler(), time_now_ms(),
+                                                             loop->wm, 30));
   }
 
   return RET_OK;
@@ -247,6 +267,10 @@ main_loop_t* main_loop_init(int w, int h) {
   main_loop_nanovg_create_window(&loop, fm, w, h);
   main_loop_set_default(base);
 
+  if (task_queue() != NULL) {
+    task_queue_set_wakeup(task_queue(), main_loop_nanovg_wakeup, &loop);
+  }
+
   log_debug("%s:%s\n", __FILE__, __func__);
 
   return base;
@@ -20,6 +20,10 @@
  */
 
 #include "base/timer.h"
+#include "base/task_queue.h"
+#include "base/time.h"
+#include "base/input_trace.h"
+#include "base/frame_scheduler.h"
 #include "rtgui/event.h"
 #include "lcd/lcd_rtthread.h"
 #include <rtgui/widgets/window.h>
@@ -133,15 +137,20 @@ static ret_t main_loop_rtthread_dispatch(main_loop_rtthread_t* loop) {
 static ret_t main_loop_rtthread_paint(main_loop_rtthread_t* loop) {
   canvas_t* c = &(loop->canvas);
 
-  return window_manager_paint(loop->wm, c);
+  return frame_scheduler_dispatch(frame_scheduler(), time_now_ms(), loop->wm, c);
 }
 
 static ret_t main_loop_rtthread_run(main_loop_t* l) {
   main_loop_rtthread_t* loop = (main_loop_rtthread_t*)l;
 
   while (l->running) {
+    if (input_trace() != NULL) {
+      input_trace_tick(input_trace());
+    }
+
     timer_check();
     main_loop_rtthread_dispatch(loop);
+    task_queue_dispatch(task_queue());
     main_loop_rtthread_paint(loop);
   }
 
@@ -25,6 +25,10 @@
 #include "lcd/lcd_sdl2.h"
 #include "base/idle.h"
 #include "base/timer.h"
+#include "base/task_queue.h"
+#include "base/time.h"
+#include "base/frame_scheduler.h"
+#include "base/input_trace.h"
 #include <SDL2/SDL.h>
 
 typedef struct _main_loop_sdl2_t {
@@ -136,23 +140,39 @@ static ret_t main_loop_sdl2_dispatch(main_loop_sdl2_t* loop) {
 }
 
 static ret_t main_loop_sdl2_paint(main_loop_sdl2_t* loop) {
-  ret_t ret = window_manager_paint(loop->wm, &(loop->canvas));
+  ret_t ret = frame_scheduler_dispatch(frame_scheduler(), time_now_ms(), loop->wm, &(loop->canvas));
 
   return ret;
 }
 
+/*在投递任务的线程中调用(SDL_PushEvent是线程安全的)，让主循环从等待中醒来。*/
+static ret_t main_loop_sdl2_wakeup(void* ctx) {
+  SDL_Event event;
+
+  memset(&event, 0x00, sizeof(event));
+  event.type = SDL_USEREVENT;
+  SDL_PushEvent(&event);
+  (void)ctx;
+
+  return RET_OK;
+}
+
 static ret_t main_loop_sdl2_run(main_loop_t* l) {
   main_loop_sdl2_t* loop = (main_loop_sdl2_t*)l;
 
   while (l->running) {
+    if (input_trace() != NULL) {
+      input_trace_tick(input_trace());
+    }
+
     timer_check();
     main_loop_sdl2_dispatch(loop);
+    task_queue_dispatch(task_queue());
     idle_dispatch();
 
     main_loop_sdl2_paint(loop);
-    if (!WINDOW_MANAGER(loop->wm)->animating) {
-      SDL_Delay(30);
-    }
+    SDL_WaitEventTimeout(NULL, frame_scheduler_get_wait_time(frame_scheduler(), time_now_ms(),
+                                                             loop->wm, 30));
   }
 
   return RET_OK;
@@ -217,6 +237,10 @@ main_loop_t* main_loop_init(int w, int h) {
   main_loop_sdl2_create_window(&loop, fm, w, h);
   main_loop_set_default(base);
 
+  if (task_queue() != NULL) {
+    task_queue_set_wakeup(task_queue(), main_loop_sdl2_wakeup, &loop);
+  }
+
   log_debug("%s:%s\n", __FILE__, __func__);
 
   return base;
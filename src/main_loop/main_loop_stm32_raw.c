@@ -34,6 +34,10 @@
 
 #include "base/idle.h"
 #include "base/timer.h"
+#include "base/task_queue.h"
+#include "base/time.h"
+#include "base/input_trace.h"
+#include "base/frame_scheduler.h"
 #include "lcd/lcd_reg.h"
 #include "base/event_queue.h"
 #include "base/font_manager.h"
@@ -130,20 +134,25 @@ static ret_t main_loop_stm32_raw_paint(main_loop_stm32_raw_t* loop) {
   canvas_t* c = &(loop->canvas);
 
   // return canvas_test_paint(c, loop->pressed, loop->touch_x, loop->touch_y);
-  return window_manager_paint(loop->wm, c);
+  return frame_scheduler_dispatch(frame_scheduler(), time_now_ms(), loop->wm, c);
 }
 
 static ret_t main_loop_stm32_raw_run(main_loop_t* l) {
   main_loop_stm32_raw_t* loop = (main_loop_stm32_raw_t*)l;
 
   while (l->running) {
+    if (input_trace() != NULL) {
+      input_trace_tick(input_trace());
+    }
+
     timer_check();
     main_loop_stm32_raw_dispatch(loop);
+    task_queue_dispatch(task_queue());
     idle_dispatch();
 
     main_loop_stm32_raw_paint(loop);
 
-    delay_ms(100);
+    delay_ms(frame_scheduler_get_wait_time(frame_scheduler(), time_now_ms(), loop->wm, 100));
   }
 
   return RET_OK;
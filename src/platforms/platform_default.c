@@ -61,3 +61,10 @@ uint32_t get_time_ms() {
 
   return tv.tv_sec * 1000 + tv.tv_usec / 1000;
 }
+
+uint64_t get_time_us() {
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+
+  return (uint64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
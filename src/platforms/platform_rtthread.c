@@ -32,3 +32,5 @@ uint32_t get_time_ms() {
   /**/
   return 0;
 }
+
+uint64_t get_time_us() { return (uint64_t)get_time_ms() * 1000; }
@@ -53,3 +53,5 @@ ret_t platform_prepare() {
 }
 
 uint32_t get_time_ms() { return RTC_GetCounter(); }
+
+uint64_t get_time_us() { return (uint64_t)get_time_ms() * 1000; }
@@ -31,3 +31,5 @@ ret_t platform_prepare() {
 }
 
 uint32_t get_time_ms() { return HAL_GetTick(); }
+
+uint64_t get_time_us() { return (uint64_t)get_time_ms() * 1000; }
@@ -0,0 +1,189 @@
+/**
+ * File:   thread_default.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  thread and semaphore on pthread/win32
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-20 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "base/mem.h"
+#include "base/thread.h"
+
+#ifdef WIN32
+#include <windows.h>
+
+struct _tk_thread_t {
+  HANDLE handle;
+  tk_thread_entry_t entry;
+  void* args;
+};
+
+struct _tk_semaphore_t {
+  HANDLE handle;
+};
+
+static DWORD WINAPI tk_thread_main(LPVOID args) {
+  tk_thread_t* thread = (tk_thread_t*)args;
+
+  thread->entry(thread->args);
+
+  return 0;
+}
+
+tk_thread_t* tk_thread_create(tk_thread_entry_t entry, void* args) {
+  tk_thread_t* thread = NULL;
+  return_value_if_fail(entry != NULL, NULL);
+
+  thread = TKMEM_ZALLOC(tk_thread_t);
+  return_value_if_fail(thread != NULL, NULL);
+
+  thread->entry = entry;
+  thread->args = args;
+  thread->handle = CreateThread(NULL, 0, tk_thread_main, thread, 0, NULL);
+  if (thread->handle == NULL) {
+    TKMEM_FREE(thread);
+    return NULL;
+  }
+
+  return thread;
+}
+
+ret_t tk_thread_join(tk_thread_t* thread) {
+  return_value_if_fail(thread != NULL, RET_BAD_PARAMS);
+
+  WaitForSingleObject(thread->handle, INFINITE);
+  CloseHandle(thread->handle);
+  TKMEM_FREE(thread);
+
+  return RET_OK;
+}
+
+tk_semaphore_t* tk_semaphore_create(uint32_t value) {
+  tk_semaphore_t* sem = TKMEM_ZALLOC(tk_semaphore_t);
+  return_value_if_fail(sem != NULL, NULL);
+
+  sem->handle = CreateSemaphore(NULL, value, 0x7fffffff, NULL);
+  if (sem->handle == NULL) {
+    TKMEM_FREE(sem);
+    return NULL;
+  }
+
+  return sem;
+}
+
+ret_t tk_semaphore_wait(tk_semaphore_t* sem) {
+  return_value_if_fail(sem != NULL, RET_BAD_PARAMS);
+
+  return WaitForSingleObject(sem->handle, INFINITE) == WAIT_OBJECT_0 ? RET_OK : RET_FAIL;
+}
+
+ret_t tk_semaphore_post(tk_semaphore_t* sem) {
+  return_value_if_fail(sem != NULL, RET_BAD_PARAMS);
+
+  return ReleaseSemaphore(sem->handle, 1, NULL) ? RET_OK : RET_FAIL;
+}
+
+ret_t tk_semaphore_destroy(tk_semaphore_t* sem) {
+  return_value_if_fail(sem != NULL, RET_BAD_PARAMS);
+
+  CloseHandle(sem->handle);
+  TKMEM_FREE(sem);
+
+  return RET_OK;
+}
+#else
+#include <pthread.h>
+
+struct _tk_thread_t {
+  pthread_t id;
+};
+
+/*MacOS不支持匿名的POSIX信号量，用mutex和cond实现。*/
+struct _tk_semaphore_t {
+  uint32_t value;
+  pthread_mutex_t mutex;
+  pthread_cond_t cond;
+};
+
+tk_thread_t* tk_thread_create(tk_thread_entry_t entry, void* args) {
+  tk_thread_t* thread = NULL;
+  return_value_if_fail(entry != NULL, NULL);
+
+  thread = TKMEM_ZALLOC(tk_thread_t);
+  return_value_if_fail(thread != NULL, NULL);
+
+  if (pthread_create(&(thread->id), NULL, entry, args) != 0) {
+    TKMEM_FREE(thread);
+    return NULL;
+  }
+
+  return thread;
+}
+
+ret_t tk_thread_join(tk_thread_t* thread) {
+  return_value_if_fail(thread != NULL, RET_BAD_PARAMS);
+
+  pthread_join(thread->id, NULL);
+  TKMEM_FREE(thread);
+
+  return RET_OK;
+}
+
+tk_semaphore_t* tk_semaphore_create(uint32_t value) {
+  tk_semaphore_t* sem = TKMEM_ZALLOC(tk_semaphore_t);
+  return_value_if_fail(sem != NULL, NULL);
+
+  sem->value = value;
+  pthread_mutex_init(&(sem->mutex), NULL);
+  pthread_cond_init(&(sem->cond), NULL);
+
+  return sem;
+}
+
+ret_t tk_semaphore_wait(tk_semaphore_t* sem) {
+  return_value_if_fail(sem != NULL, RET_BAD_PARAMS);
+
+  pthread_mutex_lock(&(sem->mutex));
+  while (sem->value == 0) {
+    pthread_cond_wait(&(sem->cond), &(sem->mutex));
+  }
+  sem->value--;
+  pthread_mutex_unlock(&(sem->mutex));
+
+  return RET_OK;
+}
+
+ret_t tk_semaphore_post(tk_semaphore_t* sem) {
+  return_value_if_fail(sem != NULL, RET_BAD_PARAMS);
+
+  pthread_mutex_lock(&(sem->mutex));
+  sem->value++;
+  pthread_cond_signal(&(sem->cond));
+  pthread_mutex_unlock(&(sem->mutex));
+
+  return RET_OK;
+}
+
+ret_t tk_semaphore_destroy(tk_semaphore_t* sem) {
+  return_value_if_fail(sem != NULL, RET_BAD_PARAMS);
+
+  pthread_cond_destroy(&(sem->cond));
+  pthread_mutex_destroy(&(sem->mutex));
+  TKMEM_FREE(sem);
+
+  return RET_OK;
+}
+#endif /*WIN32*/
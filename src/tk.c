@@ -25,6 +25,9 @@
 #include "base/locale.h"
 #include "base/platform.h"
 #include "base/main_loop.h"
+#include "base/task_queue.h"
+#include "base/input_trace.h"
+#include "base/frame_scheduler.h"
 #include "font/font_bitmap.h"
 #include "base/font_manager.h"
 #include "base/image_manager.h"
@@ -88,12 +91,40 @@ ret_t tk_init(wh_t w, wh_t h, uint32_t* heap, uint32_t size) {
   return_value_if_fail(font_manager_set(font_manager_create()) == RET_OK, RET_FAIL);
   return_value_if_fail(image_manager_set(image_manager_create(loader)) == RET_OK, RET_FAIL);
   return_value_if_fail(window_manager_set(window_manager_create()) == RET_OK, RET_FAIL);
+  return_value_if_fail(task_queue_set(task_queue_create(TK_TASK_QUEUE_CAPACITY)) == RET_OK,
+                       RET_FAIL);
+  return_value_if_fail(frame_scheduler_set(frame_scheduler_create(TK_FRAME_INTERVAL)) == RET_OK,
+                       RET_FAIL);
 
   return main_loop_init(w, h) != NULL ? RET_OK : RET_FAIL;
 }
 
+static char s_input_trace_filename[MAX_PATH + 1];
+
+ret_t tk_record_input_trace(const char* filename) {
+  input_trace_t* trace = NULL;
+  widget_t* wm = window_manager();
+  return_value_if_fail(filename != NULL && wm != NULL && input_trace() == NULL, RET_BAD_PARAMS);
+
+  trace = input_trace_create(wm->w, wm->h);
+  return_value_if_fail(trace != NULL, RET_OOM);
+
+  strncpy(s_input_trace_filename, filename, MAX_PATH);
+
+  return input_trace_start(trace);
+}
+
 static ret_t tk_exit(void) {
+  if (input_trace() != NULL) {
+    input_trace_t* trace = input_trace();
+    input_trace_stop(trace);
+    input_trace_save(trace, s_input_trace_filename);
+    input_trace_destroy(trace);
+  }
+
   main_loop_destroy(main_loop());
+  task_queue_destroy(task_queue());
+  frame_scheduler_destroy(frame_scheduler());
   font_manager_destroy(font_manager());
   image_manager_destroy(image_manager());
   resource_manager_destroy(resource_manager());
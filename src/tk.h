@@ -59,8 +59,29 @@ ret_t tk_run(void);
  */
 ret_t tk_quit(void);
 
+/**
+ * @method tk_record_input_trace
+ * 开始录制输入轨迹(参考input_trace_t)，退出主循环时保存到指定的文件。
+ * 在tk_init之后、打开窗口之前调用，回放时才能从同样的界面开始。
+ * @global
+ * @scriptable no
+ * @param {const char*} filename 文件名。
+ *
+ * @return {ret_t} 返回RET_OK表示成功，否则表示失败。
+ */
+ret_t tk_record_input_trace(const char* filename);
+
 ret_t tk_init_resources(void);
 
+#ifndef TK_TASK_QUEUE_CAPACITY
+#define TK_TASK_QUEUE_CAPACITY 256
+#endif /*TK_TASK_QUEUE_CAPACITY*/
+
+/*显示的刷新周期(毫秒)，每个周期最多绘制一帧。*/
+#ifndef TK_FRAME_INTERVAL
+#define TK_FRAME_INTERVAL 16
+#endif /*TK_FRAME_INTERVAL*/
+
 END_C_DECLS
 
 #endif /*TK_MAIN_H*/
@@ -34,6 +34,19 @@ ret_t ui_builder_on_widget_prop(ui_builder_t* b, const char* name, const char* v
   return b->on_widget_prop(b, name, value);
 }
 
+ret_t ui_builder_on_widget_prop_atom(ui_builder_t* b, prop_atom_t atom, const char* value) {
+  return_value_if_fail(b != NULL && atom != PROP_ATOM_NONE && value != NULL, RET_BAD_PARAMS);
+
+  if (b->on_widget_prop_atom) {
+    return b->on_widget_prop_atom(b, atom, value);
+  } else {
+    const char* name = prop_atom_name(atom);
+    return_value_if_fail(name != NULL, RET_BAD_PARAMS);
+
+    return ui_builder_on_widget_prop(b, name, value);
+  }
+}
+
 ret_t ui_builder_on_widget_prop_end(ui_builder_t* b) {
   return_value_if_fail(b != NULL && b->on_widget_prop_end != NULL, RET_BAD_PARAMS);
 
@@ -39,6 +39,8 @@ typedef struct _widget_desc_t {
 typedef ret_t (*ui_builder_on_start_t)(ui_builder_t* b);
 typedef ret_t (*ui_builder_on_widget_start_t)(ui_builder_t* b, const widget_desc_t* desc);
 typedef ret_t (*ui_builder_on_widget_prop_t)(ui_builder_t* b, const char* name, const char* value);
+typedef ret_t (*ui_builder_on_widget_prop_atom_t)(ui_builder_t* b, prop_atom_t atom,
+                                                  const char* value);
 typedef ret_t (*ui_builder_on_widget_prop_end_t)(ui_builder_t* b);
 typedef ret_t (*ui_builder_on_widget_end_t)(ui_builder_t* b);
 typedef ret_t (*ui_builder_on_end_t)(ui_builder_t* b);
@@ -47,6 +49,7 @@ struct _ui_builder_t {
   ui_builder_on_start_t on_start;
   ui_builder_on_widget_start_t on_widget_start;
   ui_builder_on_widget_prop_t on_widget_prop;
+  ui_builder_on_widget_prop_atom_t on_widget_prop_atom;
   ui_builder_on_widget_prop_end_t on_widget_prop_end;
   ui_builder_on_widget_end_t on_widget_end;
   ui_builder_on_end_t on_end;
@@ -56,6 +59,7 @@ struct _ui_builder_t {
 
 ret_t ui_builder_on_widget_start(ui_builder_t* b, const widget_desc_t* desc);
 ret_t ui_builder_on_widget_prop(ui_builder_t* b, const char* name, const char* value);
+ret_t ui_builder_on_widget_prop_atom(ui_builder_t* b, prop_atom_t atom, const char* value);
 ret_t ui_builder_on_widget_prop_end(ui_builder_t* b);
 ret_t ui_builder_on_widget_end(ui_builder_t* b);
 ret_t ui_builder_on_start(ui_builder_t* b);
@@ -63,6 +67,9 @@ ret_t ui_builder_on_end(ui_builder_t* b);
 
 #define UI_DATA_MAGIC 0x11221212
 
+/*二进制UI中内置属性名用UI_PROP_ATOM_MARK加一个字节的原子表示，其它属性名仍然保存为字符串。*/
+#define UI_PROP_ATOM_MARK 0xff
+
 END_C_DECLS
 
 #endif /*TK_UI_BUILDER_H*/
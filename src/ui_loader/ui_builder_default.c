@@ -31,6 +31,8 @@
 #include "base/slider.h"
 #include "base/edit.h"
 #include "base/group_box.h"
+#include "base/list_view.h"
+#include "base/scroll_view.h"
 #include "base/check_button.h"
 #include "base/progress_bar.h"
 #include "base/resource_manager.h"
@@ -93,6 +95,12 @@ static ret_t ui_builder_default_on_widget_start(ui_builder_t* b, const widget_de
     case WIDGET_VIEW:
       widget = view_create(parent, x, y, w, h);
       break;
+    case WIDGET_LIST_VIEW:
+      widget = list_view_create(parent, x, y, w, h);
+      break;
+    case WIDGET_SCROLL_VIEW:
+      widget = scroll_view_create(parent, x, y, w, h);
+      break;
     case WIDGET_CHECK_BUTTON:
       widget = check_button_create(parent, x, y, w, h);
       break;
@@ -119,22 +127,36 @@ static ret_t ui_builder_default_on_widget_start(ui_builder_t* b, const widget_de
   return RET_OK;
 }
 
-static ret_t ui_builder_default_on_widget_prop(ui_builder_t* b, const char* name,
-                                               const char* value) {
+static ret_t ui_builder_default_on_widget_prop_atom(ui_builder_t* b, prop_atom_t atom,
+                                                    const char* value) {
   value_t v;
-  if (strcmp(name, "layout") == 0) {
+  if (atom == PROP_ATOM_LAYOUT) {
     /*2 2 5 10 10*/
     children_layout_t cl;
     children_layout_parser(&cl, value);
     widget_set_children_layout_params(b->widget, cl.rows, cl.cols, cl.margin, cl.cell_spacing);
   } else {
     value_set_str(&v, value);
-    widget_set_prop(b->widget, name, &v);
+    widget_set_prop_atom(b->widget, atom, &v);
   }
 
   return RET_OK;
 }
 
+static ret_t ui_builder_default_on_widget_prop(ui_builder_t* b, const char* name,
+                                               const char* value) {
+  /*自定义控件的属性名可能还没有原子化，分配一个，保证控件能收到。*/
+  prop_atom_t atom = prop_atom_intern(name);
+
+  if (atom != PROP_ATOM_NONE) {
+    return ui_builder_default_on_widget_prop_atom(b, atom, value);
+  }
+
+  log_warn("prop %s=%s is dropped: too many property names\n", name, value);
+
+  return RET_FAIL;
+}
+
 static ret_t ui_builder_default_on_widget_prop_end(ui_builder_t* b) {
   (void)b;
   return RET_OK;
@@ -160,6 +182,7 @@ ui_builder_t* ui_builder_default() {
 
   s_ui_builder.on_widget_start = ui_builder_default_on_widget_start;
   s_ui_builder.on_widget_prop = ui_builder_default_on_widget_prop;
+  s_ui_builder.on_widget_prop_atom = ui_builder_default_on_widget_prop_atom;
   s_ui_builder.on_widget_prop_end = ui_builder_default_on_widget_prop_end;
   s_ui_builder.on_widget_end = ui_builder_default_on_widget_end;
   s_ui_builder.on_end = ui_builder_default_on_end;
@@ -39,8 +39,16 @@ static ret_t ui_builder_writer_on_widget_start(ui_builder_t* b, const widget_des
 static ret_t ui_builder_writer_on_widget_prop(ui_builder_t* b, const char* name,
                                               const char* value) {
   ui_builder_writer_t* writer = (ui_builder_writer_t*)b;
+  prop_atom_t atom = prop_atom_lookup(name);
+
+  /*只有内置原子的值是固定的，动态分配的原子不能写入文件。*/
+  if (prop_atom_is_builtin(atom)) {
+    wbuffer_write_uint8(writer->wbuffer, UI_PROP_ATOM_MARK);
+    wbuffer_write_uint8(writer->wbuffer, (uint8_t)atom);
+  } else {
+    wbuffer_write_string(writer->wbuffer, name);
+  }
 
-  wbuffer_write_string(writer->wbuffer, name);
   return wbuffer_write_string(writer->wbuffer, value);
 }
 
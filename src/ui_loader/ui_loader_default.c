@@ -37,18 +37,30 @@ ret_t ui_loader_load_default(ui_loader_t* loader, const uint8_t* data, uint32_t
 
   ui_builder_on_start(b);
   while (rbuffer_has_more(&rbuffer)) {
+    uint8_t mark = 0;
     const char* key = NULL;
     const char* value = NULL;
     return_value_if_fail(rbuffer_read_binary(&rbuffer, &desc, sizeof(desc)) == RET_OK,
                          RET_BAD_PARAMS);
     ui_builder_on_widget_start(b, &desc);
 
-    return_value_if_fail(rbuffer_read_string(&rbuffer, &key) == RET_OK, RET_BAD_PARAMS);
-    while (*key) {
-      return_value_if_fail(rbuffer_read_string(&rbuffer, &value) == RET_OK, RET_BAD_PARAMS);
-      ui_builder_on_widget_prop(b, key, value);
-      return_value_if_fail(rbuffer_read_string(&rbuffer, &key) == RET_OK, RET_BAD_PARAMS);
+    return_value_if_fail(rbuffer_peek_uint8(&rbuffer, &mark) == RET_OK, RET_BAD_PARAMS);
+    while (mark) {
+      if (mark == UI_PROP_ATOM_MARK) {
+        uint8_t atom = 0;
+        rbuffer_read_uint8(&rbuffer, &mark);
+        return_value_if_fail(rbuffer_read_uint8(&rbuffer, &atom) == RET_OK, RET_BAD_PARAMS);
+        return_value_if_fail(prop_atom_is_builtin(atom), RET_BAD_PARAMS);
+        return_value_if_fail(rbuffer_read_string(&rbuffer, &value) == RET_OK, RET_BAD_PARAMS);
+        ui_builder_on_widget_prop_atom(b, atom, value);
+      } else {
+        return_value_if_fail(rbuffer_read_string(&rbuffer, &key) == RET_OK, RET_BAD_PARAMS);
+        return_value_if_fail(rbuffer_read_string(&rbuffer, &value) == RET_OK, RET_BAD_PARAMS);
+        ui_builder_on_widget_prop(b, key, value);
+      }
+      return_value_if_fail(rbuffer_peek_uint8(&rbuffer, &mark) == RET_OK, RET_BAD_PARAMS);
     }
+    rbuffer_read_uint8(&rbuffer, &mark);
     ui_builder_on_widget_prop_end(b);
 
     return_value_if_fail(rbuffer_peek_uint8(&rbuffer, &widget_end_mark) == RET_OK, RET_BAD_PARAMS);
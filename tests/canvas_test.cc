@@ -270,6 +270,37 @@ TEST(Canvas, draw_glyph) {
   lcd_destroy(lcd);
 }
 
+TEST(Canvas, draw_text) {
+  rect_t r;
+  canvas_t c;
+  wchar_t ab[] = L"ab";
+  wchar_t abc[] = L"abc";
+  uint16_t font_size = 10;
+  font_manager_t font_manager;
+  lcd_t* lcd = lcd_log_init(800, 600);
+  font_manager_init(&font_manager);
+  canvas_init(&c, lcd, &font_manager);
+  font_dummy_init();
+  font_manager_add(&font_manager, font_dummy_0("demo0", font_size));
+
+  rect_init(r, 100, 100, 200, 200);
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  canvas_set_font(&c, "demo0", font_size);
+
+  /*lcd没有实现draw_glyphs时逐个绘制。*/
+  lcd_log_reset(lcd);
+  canvas_draw_text(&c, ab, 2, 110, 110);
+  ASSERT_EQ(lcd_log_get_commands(lcd), "dg(0,0,12,12,110,112);dg(0,0,12,12,123,112);");
+
+  lcd_log_reset(lcd);
+  canvas_draw_text(&c, abc, 3, 280, 110);
+  ASSERT_EQ(lcd_log_get_commands(lcd), "dg(0,0,12,12,280,112);dg(0,0,7,12,293,112);");
+
+  canvas_end_frame(&c);
+  font_manager_deinit(&font_manager);
+  lcd_destroy(lcd);
+}
+
 TEST(Canvas, draw_image) {
   rect_t r;
   rect_t s;
@@ -0,0 +1,196 @@
+#include "base/time.h"
+#include "base/view.h"
+#include "base/label.h"
+#include "base/button.h"
+#include "base/slider.h"
+#include "base/canvas.h"
+#include "base/group_box.h"
+#include "base/progress_bar.h"
+#include "base/check_button.h"
+#include "base/display_list.h"
+#include "lcd/lcd_mem.h"
+#include "lcd_log.h"
+#include "gtest/gtest.h"
+
+static const uint8_t s_glyph_data[4 * 4] = {0};
+
+static void test_record(display_list_t* dl) {
+  rect_t r;
+  rect_t src;
+  rect_t dst;
+  glyph_t g;
+  canvas_t c;
+  bitmap_t img;
+  font_manager_t font_manager;
+  point_t points[] = {{10, 10}, {60, 60}};
+
+  font_manager_init(&font_manager);
+  canvas_init(&c, &(dl->lcd), &font_manager);
+
+  rect_init(r, 0, 0, 100, 100);
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  canvas_set_fill_color(&c, color_init(0xff, 0, 0, 0xff));
+  canvas_fill_rect(&c, 0, 0, 100, 100);
+  canvas_translate(&c, 20, 20);
+  canvas_set_stroke_color(&c, color_init(0, 0xff, 0, 0xff));
+  canvas_draw_hline(&c, 0, 0, 50);
+  canvas_draw_vline(&c, 0, 0, 50);
+  canvas_draw_points(&c, points, ARRAY_SIZE(points));
+  canvas_untranslate(&c, 20, 20);
+
+  memset(&g, 0x00, sizeof(g));
+  g.w = 4;
+  g.h = 4;
+  g.data = s_glyph_data;
+  rect_init(src, 0, 0, 4, 4);
+  lcd_draw_glyph(&(dl->lcd), &g, &src, 40, 40);
+
+  memset(&img, 0x00, sizeof(img));
+  img.w = 10;
+  img.h = 10;
+  rect_init(src, 0, 0, 10, 10);
+  rect_init(dst, 50, 50, 20, 20);
+  canvas_draw_image(&c, &img, &src, &dst);
+  canvas_end_frame(&c);
+}
+
+TEST(DisplayList, record) {
+  display_list_t* dl = display_list_create(100, 100);
+  lcd_t* lcd = lcd_log_init(100, 100);
+
+  test_record(dl);
+
+  /*4个状态命令+2个颜色命令+6个绘制命令。*/
+  ASSERT_EQ(dl->cmds_nr, 12);
+  ASSERT_EQ(dl->bounds.x, 0);
+  ASSERT_EQ(dl->bounds.y, 0);
+  ASSERT_EQ(dl->bounds.w, 100);
+  ASSERT_EQ(dl->bounds.h, 100);
+
+  ASSERT_EQ(display_list_replay(dl, lcd, NULL), RET_OK);
+  ASSERT_EQ(lcd_log_get_commands(lcd),
+            "fr(0,0,100,100);dhl(20,20,50);dvl(20,20,50);dps((30,30)(80,80));"
+            "dg(0,0,4,4,40,40);dg(0,0,10,10,50,50,20,20);");
+  ASSERT_EQ(lcd->fill_color.color, color_init(0xff, 0, 0, 0xff).color);
+  ASSERT_EQ(lcd->stroke_color.color, color_init(0, 0xff, 0, 0xff).color);
+
+  /*每次begin_frame重新录制。*/
+  test_record(dl);
+  ASSERT_EQ(dl->cmds_nr, 12);
+
+  lcd_destroy(lcd);
+  lcd_destroy(&(dl->lcd));
+}
+
+TEST(DisplayList, replay_clip) {
+  rect_t r;
+  display_list_t* dl = display_list_create(100, 100);
+  lcd_t* lcd = lcd_log_init(100, 100);
+
+  test_record(dl);
+
+  rect_init(r, 30, 25, 30, 30);
+  ASSERT_EQ(display_list_replay(dl, lcd, &r), RET_OK);
+  ASSERT_EQ(lcd_log_get_commands(lcd),
+            "fr(30,25,30,30);dps((30,30));dg(0,0,4,4,40,40);"
+            "dg(0,0,5,2,50,50,10,5);");
+
+  lcd_log_reset(lcd);
+  rect_init(r, 42, 90, 10, 10);
+  ASSERT_EQ(display_list_replay(dl, lcd, &r), RET_OK);
+  ASSERT_EQ(lcd_log_get_commands(lcd), "fr(42,90,10,10);");
+
+  lcd_log_reset(lcd);
+  rect_init(r, 42, 41, 10, 10);
+  ASSERT_EQ(display_list_replay(dl, lcd, &r), RET_OK);
+  ASSERT_EQ(lcd_log_get_commands(lcd), "fr(42,41,10,10);dg(2,1,2,3,42,41);");
+
+  lcd_destroy(lcd);
+  lcd_destroy(&(dl->lcd));
+}
+
+static widget_t* test_create_ui(wh_t w, wh_t h) {
+  uint32_t i = 0;
+  widget_t* root = view_create(NULL, 0, 0, w, h);
+
+  for (i = 0; i < 8; i++) {
+    xy_t y = i * (h / 8);
+    widget_t* group = group_box_create(root, 0, y, w, h / 8);
+    widget_t* label = label_create(group, 5, 5, 100, 20);
+    widget_t* button = button_create(group, 110, 5, 80, 30);
+    widget_t* check = check_button_create(group, 200, 5, 100, 20);
+    widget_t* slider = slider_create(group, 5, 30, 150, 20);
+    widget_t* progress = progress_bar_create(group, 165, 30, 140, 20);
+
+    widget_set_text(label, L"Hello AWTK");
+    widget_set_text(button, L"OK");
+    widget_set_text(check, L"Check");
+    widget_set_value(slider, i * 10);
+    widget_set_value(progress, i * 12);
+  }
+
+  return root;
+}
+
+static uint32_t test_checksum(lcd_t* lcd) {
+  uint32_t i = 0;
+  uint32_t sum = 0;
+  uint32_t* p = (uint32_t*)(((lcd_mem_t*)lcd)->pixels);
+
+  for (i = 0; i < (uint32_t)(lcd->w * lcd->h); i++) {
+    sum = sum * 31 + p[i];
+  }
+
+  return sum;
+}
+
+TEST(DisplayList, benchmark) {
+  rect_t r;
+  canvas_t c;
+  uint32_t i = 0;
+  uint32_t start = 0;
+  uint32_t direct_cost = 0;
+  uint32_t replay_cost = 0;
+  uint32_t times = 50;
+  wh_t w = 320;
+  wh_t h = 480;
+  widget_t* ui = test_create_ui(w, h);
+  lcd_t* direct = lcd_mem_create(w, h, TRUE);
+  lcd_t* replay = lcd_mem_create(w, h, TRUE);
+  display_list_t* dl = display_list_create(w, h);
+
+  rect_init(r, 0, 0, w, h);
+  memset(((lcd_mem_t*)direct)->pixels, 0x00, w * h * 4);
+  memset(((lcd_mem_t*)replay)->pixels, 0x00, w * h * 4);
+
+  canvas_init(&c, direct, font_manager());
+  start = time_now_ms();
+  for (i = 0; i < times; i++) {
+    canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+    widget_paint(ui, &c);
+    canvas_end_frame(&c);
+  }
+  direct_cost = time_now_ms() - start;
+
+  canvas_init(&c, &(dl->lcd), font_manager());
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  widget_paint(ui, &c);
+  canvas_end_frame(&c);
+
+  start = time_now_ms();
+  for (i = 0; i < times; i++) {
+    lcd_begin_frame(replay, &r, LCD_DRAW_NORMAL);
+    display_list_replay(dl, replay, &r);
+    lcd_end_frame(replay);
+  }
+  replay_cost = time_now_ms() - start;
+
+  log_debug("paint %u frames: direct %u ms, replay %u ms (%u cmds, %u bytes)\n", times,
+            direct_cost, replay_cost, dl->cmds_nr, dl->size);
+  ASSERT_EQ(test_checksum(direct), test_checksum(replay));
+
+  widget_destroy(ui);
+  lcd_destroy(&(dl->lcd));
+  lcd_destroy(direct);
+  lcd_destroy(replay);
+}
@@ -1,5 +1,6 @@
 #include "gtest/gtest.h"
 #include "base/event_queue.h"
+#include <thread>
 
 #define NR 10
 TEST(EventQueue, basic) {
@@ -11,7 +12,7 @@ TEST(EventQueue, basic) {
   ASSERT_EQ(q != NULL, true);
   ASSERT_EQ(q->r, 0);
   ASSERT_EQ(q->w, 0);
-  ASSERT_EQ(q->full, FALSE);
+  ASSERT_EQ(event_queue_size(q), 0);
   ASSERT_EQ(q->capacity, 10);
 
   memset(&r, 0x00, sizeof(r));
@@ -31,14 +32,15 @@ TEST(EventQueue, basic) {
     w.e.pointer_event.e.type = i;
     ASSERT_EQ(event_queue_send(q, &w), RET_OK);
   }
-  ASSERT_EQ(q->full, TRUE);
+  ASSERT_EQ(event_queue_size(q), NR);
   ASSERT_EQ(event_queue_send(q, &w), RET_FAIL);
+  ASSERT_EQ(q->dropped, 1);
   for (i = 0; i < NR; i++) {
     ASSERT_EQ(event_queue_recv(q, &r), RET_OK);
     ASSERT_EQ(r.e.pointer_event.e.type, i);
   }
   ASSERT_EQ(event_queue_recv(q, &r), RET_FAIL);
-  ASSERT_EQ(q->full, FALSE);
+  ASSERT_EQ(event_queue_size(q), 0);
 
   w.e.pointer_event.e.type = 1;
   ASSERT_EQ(event_queue_send(q, &w), RET_OK);
@@ -51,3 +53,118 @@ TEST(EventQueue, basic) {
 
   event_queue_destroy(q);
 }
+
+static void test_send(event_queue_t* q, uint16_t type, xy_t x) {
+  event_all_t e;
+
+  memset(&e, 0x00, sizeof(e));
+  e.e.pointer_event.e.type = type;
+  e.e.pointer_event.x = x;
+  e.e.pointer_event.y = x;
+  event_queue_send(q, &e);
+}
+
+TEST(EventQueue, coalesce_move) {
+  event_all_t r;
+  event_queue_t* q = event_queue_create(NR);
+
+  /*连续的移动事件只收到最后一个，按下和松开不受影响。*/
+  test_send(q, EVT_POINTER_DOWN, 1);
+  test_send(q, EVT_POINTER_MOVE, 2);
+  test_send(q, EVT_POINTER_MOVE, 3);
+  test_send(q, EVT_POINTER_MOVE, 4);
+  test_send(q, EVT_POINTER_UP, 5);
+  test_send(q, EVT_POINTER_MOVE, 6);
+
+  ASSERT_EQ(event_queue_recv(q, &r), RET_OK);
+  ASSERT_EQ(r.e.event.type, EVT_POINTER_DOWN);
+  ASSERT_EQ(event_queue_recv(q, &r), RET_OK);
+  ASSERT_EQ(r.e.event.type, EVT_POINTER_MOVE);
+  ASSERT_EQ(r.e.pointer_event.x, 4);
+  ASSERT_EQ(event_queue_recv(q, &r), RET_OK);
+  ASSERT_EQ(r.e.event.type, EVT_POINTER_UP);
+  ASSERT_EQ(event_queue_recv(q, &r), RET_OK);
+  ASSERT_EQ(r.e.pointer_event.x, 6);
+  ASSERT_EQ(event_queue_recv(q, &r), RET_FAIL);
+
+  event_queue_destroy(q);
+}
+
+TEST(EventQueue, drop_move) {
+  uint16_t i = 0;
+  event_all_t r;
+  event_queue_t* q = event_queue_create(NR);
+
+  /*快满时丢掉移动事件，给松开事件留出空间。*/
+  test_send(q, EVT_POINTER_DOWN, 0);
+  for (i = 1; i < NR; i++) {
+    test_send(q, EVT_POINTER_MOVE, i);
+  }
+  ASSERT_EQ(event_queue_size(q), NR - q->move_reserved);
+  ASSERT_EQ(q->dropped, q->move_reserved);
+
+  test_send(q, EVT_POINTER_UP, 100);
+  ASSERT_EQ(event_queue_size(q), NR - q->move_reserved + 1);
+
+  ASSERT_EQ(event_queue_recv(q, &r), RET_OK);
+  ASSERT_EQ(r.e.event.type, EVT_POINTER_DOWN);
+  ASSERT_EQ(event_queue_recv(q, &r), RET_OK);
+  ASSERT_EQ(r.e.event.type, EVT_POINTER_MOVE);
+  ASSERT_EQ(r.e.pointer_event.x, NR - q->move_reserved - 1);
+  ASSERT_EQ(event_queue_recv(q, &r), RET_OK);
+  ASSERT_EQ(r.e.pointer_event.x, 100);
+  ASSERT_EQ(event_queue_recv(q, &r), RET_FAIL);
+
+  event_queue_destroy(q);
+}
+
+#define STRESS_NR 1000000
+
+/*
+ * 一个线程发送，一个线程接收：按键事件一个不丢、按顺序收到，事件内容完整。
+ * 中间夹着的移动事件可能被合并或者丢掉，但是不会乱序。
+ */
+TEST(EventQueue, stress) {
+  xy_t last_x = -1;
+  uint32_t received = 0;
+  event_queue_t* q = event_queue_create(16);
+  std::thread producer([q]() {
+    uint32_t i = 0;
+    event_all_t e;
+
+    memset(&e, 0x00, sizeof(e));
+    for (i = 0; i < STRESS_NR; i++) {
+      e.e.key_event.e.type = EVT_KEY_DOWN;
+      e.e.key_event.key = i;
+      e.e.key_event.e.target = (void*)(uintptr_t)(~i);
+      while (event_queue_send(q, &e) != RET_OK) {
+        std::this_thread::yield();
+      }
+      test_send(q, EVT_POINTER_MOVE, i);
+    }
+  });
+
+  while (received < STRESS_NR) {
+    event_all_t e;
+    if (event_queue_recv(q, &e) == RET_OK) {
+      if (e.e.event.type == EVT_POINTER_MOVE) {
+        ASSERT_EQ(e.e.pointer_event.x, e.e.pointer_event.y);
+        ASSERT_EQ(e.e.pointer_event.x > last_x, true);
+        ASSERT_EQ(e.e.pointer_event.x < (xy_t)received, true);
+        last_x = e.e.pointer_event.x;
+        continue;
+      }
+
+      ASSERT_EQ(e.e.key_event.e.type, EVT_KEY_DOWN);
+      ASSERT_EQ(e.e.key_event.key, received);
+      ASSERT_EQ(e.e.key_event.e.target, (void*)(uintptr_t)(~received));
+      received++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  producer.join();
+  ASSERT_EQ(event_queue_size(q), 0);
+  event_queue_destroy(q);
+}
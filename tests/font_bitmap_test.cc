@@ -0,0 +1,147 @@
+#include <wctype.h>
+#include "base/mem.h"
+#include "font/font_bitmap.h"
+#include "gtest/gtest.h"
+
+#define CJK_START 0x4e00
+#define CJK_NR 16000
+#define GLYPHS_NR 16
+
+/*
+ * 生成一个位图字体：字符从start开始每隔step一个，第i个字符的字模的x等于i%GLYPHS_NR。
+ * wide为TRUE时生成容器中使用的32位索引。
+ */
+static uint8_t* test_gen_font_ex(uint16_t font_size, uint32_t start, uint32_t step, uint32_t nr,
+                                 bool_t wide, uint32_t* size) {
+  uint32_t i = 0;
+  uint32_t glyphs = 4 + nr * (wide ? sizeof(font_bitmap_index32_t) : sizeof(font_bitmap_index_t));
+  uint8_t* buff = (uint8_t*)TKMEM_ALLOC(glyphs + GLYPHS_NR * 4);
+  font_bitmap_header_t* header = (font_bitmap_header_t*)buff;
+  font_bitmap_index32_t* index32 = (font_bitmap_index32_t*)(header->index);
+
+  header->char_nr = nr;
+  header->font_size = font_size;
+  for (i = 0; i < nr; i++) {
+    if (wide) {
+      index32[i].c = start + i * step;
+      index32[i].offset = glyphs + (i % GLYPHS_NR) * 4;
+    } else {
+      header->index[i].c = start + i * step;
+      header->index[i].offset = glyphs + (i % GLYPHS_NR) * 4;
+    }
+  }
+
+  for (i = 0; i < GLYPHS_NR; i++) {
+    uint8_t* p = buff + glyphs + i * 4;
+    p[0] = i;
+    p[1] = 0;
+    p[2] = 0;
+    p[3] = 0;
+  }
+  *size = glyphs + GLYPHS_NR * 4;
+
+  return buff;
+}
+
+static uint8_t* test_gen_font(uint16_t font_size, uint32_t start, uint32_t step, uint32_t nr,
+                              uint32_t* size) {
+  return test_gen_font_ex(font_size, start, step, nr, FALSE, size);
+}
+
+TEST(FontBitmap, lookup) {
+  glyph_t g;
+  uint32_t i = 0;
+  uint32_t size = 0;
+  uint8_t* buff = test_gen_font(16, CJK_START, 1, CJK_NR, &size);
+  font_t* font = font_bitmap_create("cjk", buff, size);
+
+  ASSERT_TRUE(font != NULL);
+  for (i = 0; i < CJK_NR; i++) {
+    ASSERT_EQ(font_find_glyph(font, CJK_START + i, &g, 16), RET_OK);
+    ASSERT_EQ(g.x, i % GLYPHS_NR);
+  }
+
+  ASSERT_EQ(font_find_glyph(font, 'a', &g, 16), RET_NOT_FOUND);
+  ASSERT_EQ(font_find_glyph(font, CJK_START - 1, &g, 16), RET_NOT_FOUND);
+  ASSERT_EQ(font_find_glyph(font, CJK_START + CJK_NR, &g, 16), RET_NOT_FOUND);
+  ASSERT_EQ(font_find_glyph(font, 0xffff, &g, 16), RET_NOT_FOUND);
+  ASSERT_EQ(font_find_glyph(font, CJK_START, &g, 18), RET_NOT_FOUND);
+
+  font_destroy(font);
+  TKMEM_FREE(buff);
+}
+
+TEST(FontBitmap, sparse) {
+  glyph_t g;
+  uint32_t i = 0;
+  uint32_t size = 0;
+  uint8_t* buff = test_gen_font(16, 0x20, 7, 4000, &size);
+  font_t* font = font_bitmap_create("sparse", buff, size);
+
+  /*有字符的页和没有字符的页，页内有和没有的字符都要正确处理。旧格式没有空白字符。*/
+  for (i = 0x20; i < 0x20 + 7 * 4000; i++) {
+    uint32_t n = i - 0x20;
+    if (n % 7 == 0 && !iswspace(i)) {
+      ASSERT_EQ(font_find_glyph(font, i, &g, 16), RET_OK);
+      ASSERT_EQ(g.x, (n / 7) % GLYPHS_NR);
+    } else {
+      ASSERT_EQ(font_find_glyph(font, i, &g, 16), RET_NOT_FOUND);
+    }
+  }
+
+  font_destroy(font);
+  TKMEM_FREE(buff);
+}
+
+TEST(FontBitmap, sizes) {
+  glyph_t g;
+  uint32_t size1 = 0;
+  uint32_t size2 = 0;
+  uint8_t* buff1 = test_gen_font_ex(16, 'a', 1, 26, TRUE, &size1);
+  uint8_t* buff2 = test_gen_font_ex(24, 'a', 2, 13, TRUE, &size2);
+  uint32_t offset2 = 8 + 2 * 8 + ((size1 + 3) & ~3);
+  uint32_t size = offset2 + size2;
+  uint8_t* buff = (uint8_t*)TKMEM_ALLOC(size);
+  uint8_t* p = buff;
+  font_t* font = NULL;
+
+  save_uint32(p, FONT_BITMAP_CONTAINER_MAGIC);
+  save_uint32(p, 2);
+  save_uint32(p, 24);
+  save_uint32(p, size1);
+  save_uint32(p, offset2);
+  save_uint32(p, size2);
+  memcpy(buff + 24, buff1, size1);
+  memcpy(buff + offset2, buff2, size2);
+
+  /*一个资源里包含多个字号。*/
+  font = font_bitmap_create("multi", buff, size);
+  ASSERT_TRUE(font != NULL);
+  ASSERT_EQ(font_match(font, "multi", 16), TRUE);
+  ASSERT_EQ(font_match(font, "multi", 24), TRUE);
+  ASSERT_EQ(font_match(font, "multi", 20), FALSE);
+  ASSERT_EQ(font_find_glyph(font, 'b', &g, 16), RET_OK);
+  ASSERT_EQ(g.x, 1);
+  ASSERT_EQ(font_find_glyph(font, 'b', &g, 24), RET_NOT_FOUND);
+  ASSERT_EQ(font_find_glyph(font, 'c', &g, 24), RET_OK);
+  ASSERT_EQ(g.x, 1);
+  font_destroy(font);
+
+  TKMEM_FREE(buff1);
+  TKMEM_FREE(buff2);
+  buff1 = test_gen_font(16, 'a', 1, 26, &size1);
+  buff2 = test_gen_font(24, 'a', 2, 13, &size2);
+
+  /*单字号的资源合并到一个字体对象。*/
+  font = font_bitmap_create("merged", buff1, size1);
+  ASSERT_EQ(font_match(font, "merged", 24), FALSE);
+  ASSERT_EQ(font_bitmap_add(font, buff2, size2), RET_OK);
+  ASSERT_EQ(font_match(font, "merged", 24), TRUE);
+  ASSERT_EQ(font_find_glyph(font, 'e', &g, 24), RET_OK);
+  ASSERT_EQ(g.x, 2);
+  font_destroy(font);
+
+  TKMEM_FREE(buff);
+  TKMEM_FREE(buff1);
+  TKMEM_FREE(buff2);
+}
@@ -14,22 +14,27 @@ ret_t font_dummy_init() {
   s_glyph_0.y = -10;
   s_glyph_0.w = 10;
   s_glyph_0.h = 10;
+  s_glyph_0.advance = 11;
 
   s_glyph_1.x = 0;
   s_glyph_1.y = -11;
   s_glyph_1.w = 11;
   s_glyph_1.h = 11;
+  s_glyph_1.advance = 12;
 
   s_glyph_2.x = 0;
   s_glyph_2.y = -5;
   s_glyph_2.w = 12;
   s_glyph_2.h = 12;
+  s_glyph_2.advance = 13;
 
   return RET_OK;
 }
 
 static ret_t font_dummy_find_glyph(font_t* f, wchar_t chr, glyph_t* g, uint16_t font_size) {
-  if (chr == 0) {
+  if (chr == ' ') {
+    return RET_NOT_FOUND;
+  } else if (chr == 0) {
     *g = s_glyph_0;
   } else if (chr == 1) {
     *g = s_glyph_1;
@@ -5,6 +5,7 @@
 #include "base/widget.h"
 #include "font/font_bitmap.h"
 #include "font/font_stb.h"
+#include "lcd/lcd_mem.h"
 #include "tools/common/utils.h"
 #include "tools/font_gen/font_gen.h"
 #include "gtest/gtest.h"
@@ -48,3 +49,213 @@ TEST(FontGen, basic) {
   TKMEM_FREE(bmp_buff);
   TKMEM_FREE(ttf_buff);
 }
+
+TEST(FontGen, metrics) {
+  uint32_t size = 0;
+  uint16_t font_size = 20;
+  uint8_t* bmp_buff = (uint8_t*)TKMEM_ALLOC(BUFF_SIZE);
+  uint8_t* ttf_buff = (uint8_t*)read_file(TTF_FILE, &size);
+  font_t* ttf_font = font_stb_create("default", ttf_buff, size);
+  const char* str = "hello world, HELLO WORLD 1243541";
+
+  uint32_t ret = font_gen_buff(ttf_font, font_size, str, bmp_buff, BUFF_SIZE);
+  font_t* bmp_font = font_bitmap_create("default", bmp_buff, ret);
+  font_t* old_font = font_bitmap_create("default", bmp_buff, ret - FONT_BITMAP_FOOTER_SIZE);
+
+  for (uint32_t i = 0; str[i]; i++) {
+    glyph_t g;
+    glyph_metrics_t m1;
+    glyph_metrics_t m2;
+    char c = str[i];
+
+    /*位图字体保存了与TTF字体相同的度量信息。*/
+    ASSERT_EQ(font_get_metrics(ttf_font, c, &m1, font_size), RET_OK);
+    ASSERT_EQ(font_get_metrics(bmp_font, c, &m2, font_size), RET_OK);
+    ASSERT_EQ(m1.x, m2.x);
+    ASSERT_EQ(m1.y, m2.y);
+    ASSERT_EQ(m1.w, m2.w);
+    ASSERT_EQ(m1.h, m2.h);
+    ASSERT_EQ(m1.advance, m2.advance);
+    ASSERT_EQ(m1.advance > 0, true);
+
+    ASSERT_EQ(font_find_glyph(ttf_font, c, &g, font_size), RET_OK);
+    ASSERT_EQ(g.w, m1.w);
+    ASSERT_EQ(g.h, m1.h);
+    ASSERT_EQ(g.advance, m1.advance);
+
+    /*没有宽度表的旧格式按w+1计算，没有空格。*/
+    if (c == ' ') {
+      ASSERT_EQ(m1.w, 0);
+      ASSERT_EQ(font_get_metrics(old_font, c, &m2, font_size), RET_NOT_FOUND);
+    } else {
+      ASSERT_EQ(font_get_metrics(old_font, c, &m2, font_size), RET_OK);
+      ASSERT_EQ(m2.advance, m1.w + 1);
+    }
+  }
+
+  font_destroy(ttf_font);
+  font_destroy(bmp_font);
+  font_destroy(old_font);
+  TKMEM_FREE(bmp_buff);
+  TKMEM_FREE(ttf_buff);
+}
+
+TEST(FontGen, sizes) {
+  uint32_t size = 0;
+  uint16_t sizes[] = {16, 20, 24};
+  uint8_t* bmp_buff = (uint8_t*)TKMEM_ALLOC(BUFF_SIZE);
+  uint8_t* ttf_buff = (uint8_t*)read_file(TTF_FILE, &size);
+  font_t* ttf_font = font_stb_create("default", ttf_buff, size);
+  const char* str = "hello world";
+
+  uint32_t ret = font_gen_buff_sizes(ttf_font, sizes, ARRAY_SIZE(sizes), GLYPH_FMT_A8, str,
+                                     bmp_buff, BUFF_SIZE);
+  font_t* bmp_font = font_bitmap_create("default", bmp_buff, ret);
+
+  ASSERT_EQ(ret > 0, true);
+  ASSERT_EQ(font_match(bmp_font, "default", 18), FALSE);
+  for (uint32_t i = 0; i < ARRAY_SIZE(sizes); i++) {
+    ASSERT_EQ(font_match(bmp_font, "default", sizes[i]), TRUE);
+
+    for (uint32_t j = 0; str[j]; j++) {
+      glyph_t g1;
+      glyph_t g2;
+      char c = str[j];
+      ASSERT_EQ(font_find_glyph(ttf_font, c, &g1, sizes[i]), RET_OK);
+      ASSERT_EQ(font_find_glyph(bmp_font, c, &g2, sizes[i]), RET_OK);
+
+      ASSERT_EQ(g1.w, g2.w);
+      ASSERT_EQ(g1.h, g2.h);
+      ASSERT_EQ(g1.advance, g2.advance);
+      ASSERT_EQ(memcmp(g1.data, g2.data, g1.w * g1.h), 0);
+    }
+  }
+
+  font_destroy(ttf_font);
+  font_destroy(bmp_font);
+  TKMEM_FREE(bmp_buff);
+  TKMEM_FREE(ttf_buff);
+}
+
+/*把8位的覆盖率量化后再展开，作为低位深字模的期望结果。*/
+static void test_quantize(glyph_t* g, uint8_t format, uint8_t* data) {
+  uint32_t bpp = GLYPH_FMT_BPP(format);
+  uint32_t max = (1 << bpp) - 1;
+
+  for (uint32_t i = 0; i < (uint32_t)(g->w * g->h); i++) {
+    data[i] = ((g->data[i] * max + 0x7f) / 0xff) * (0xff / max);
+  }
+}
+
+TEST(FontGen, formats) {
+  uint32_t size = 0;
+  uint16_t font_size = 20;
+  uint8_t formats[] = {GLYPH_FMT_A4, GLYPH_FMT_A2, GLYPH_FMT_A1,
+                       GLYPH_FMT_A4 | GLYPH_FMT_RLE, GLYPH_FMT_A2 | GLYPH_FMT_RLE,
+                       GLYPH_FMT_A1 | GLYPH_FMT_RLE};
+  uint8_t* a8_buff = (uint8_t*)TKMEM_ALLOC(BUFF_SIZE);
+  uint8_t* bmp_buff = (uint8_t*)TKMEM_ALLOC(BUFF_SIZE);
+  uint8_t* ttf_buff = (uint8_t*)read_file(TTF_FILE, &size);
+  font_t* ttf_font = font_stb_create("default", ttf_buff, size);
+  const char* str = "helloworldHELLOWORLD1243541@#&";
+  uint32_t a8_size = font_gen_buff(ttf_font, font_size, str, a8_buff, BUFF_SIZE);
+  lcd_t* lcd = lcd_mem_create(64, 64, TRUE);
+  lcd_t* expected = lcd_mem_create(64, 64, TRUE);
+  uint32_t lcd_size = 64 * 64 * sizeof(uint32_t);
+
+  lcd->text_color = color_init(0x20, 0x80, 0xf0, 0xff);
+  expected->text_color = lcd->text_color;
+
+  for (uint32_t f = 0; f < ARRAY_SIZE(formats); f++) {
+    uint8_t format = formats[f];
+    uint32_t ret = font_gen_buff_ex(ttf_font, font_size, format, str, bmp_buff, BUFF_SIZE);
+    font_t* bmp_font = font_bitmap_create("default", bmp_buff, ret);
+
+    ASSERT_EQ(ret > 0, true);
+    ASSERT_EQ(ret < a8_size, true);
+
+    for (uint32_t i = 0; str[i]; i++) {
+      rect_t src;
+      glyph_t g1;
+      glyph_t g2;
+      glyph_metrics_t m;
+      uint8_t data[256 * 256];
+      char c = str[i];
+
+      ASSERT_EQ(font_find_glyph(ttf_font, c, &g1, font_size), RET_OK);
+      ASSERT_EQ(font_find_glyph(bmp_font, c, &g2, font_size), RET_OK);
+      ASSERT_EQ(font_get_metrics(bmp_font, c, &m, font_size), RET_OK);
+      ASSERT_EQ(g2.format, format);
+      ASSERT_EQ(g1.w, g2.w);
+      ASSERT_EQ(g1.h, g2.h);
+      ASSERT_EQ(g1.advance, m.advance);
+
+      /*直接从低位深的字模混合，结果与量化后的8位字模相同，包括只画一部分的情况。*/
+      test_quantize(&g1, format, data);
+      g1.data = data;
+      for (uint32_t k = 0; k < 3; k++) {
+        rect_init(src, k, k * 2, g1.w - k, g1.h - k * 2);
+        memset(((lcd_mem_t*)lcd)->pixels, 0x00, lcd_size);
+        memset(((lcd_mem_t*)expected)->pixels, 0x00, lcd_size);
+        ASSERT_EQ(lcd_draw_glyph(lcd, &g2, &src, 5, 5), RET_OK);
+        ASSERT_EQ(lcd_draw_glyph(expected, &g1, &src, 5, 5), RET_OK);
+        ASSERT_EQ(memcmp(((lcd_mem_t*)lcd)->pixels, ((lcd_mem_t*)expected)->pixels, lcd_size), 0);
+      }
+    }
+
+    font_destroy(bmp_font);
+  }
+
+  lcd_destroy(lcd);
+  lcd_destroy(expected);
+  font_destroy(ttf_font);
+  TKMEM_FREE(a8_buff);
+  TKMEM_FREE(bmp_buff);
+  TKMEM_FREE(ttf_buff);
+}
+
+TEST(FontGen, large) {
+  char str[128];
+  uint32_t size = 0;
+  uint32_t face_size = 0;
+  uint16_t sizes[] = {96};
+  uint8_t* bmp_buff = (uint8_t*)TKMEM_ALLOC(BUFF_SIZE);
+  uint8_t* ttf_buff = (uint8_t*)read_file(TTF_FILE, &size);
+  font_t* ttf_font = font_stb_create("default", ttf_buff, size);
+  font_t* bmp_font = NULL;
+  const uint8_t* p = bmp_buff + 12;
+  uint32_t ret = 0;
+
+  for (uint32_t i = 0; i < 94; i++) {
+    str[i] = '!' + i;
+  }
+  str[94] = '\0';
+
+  /*旧格式的字模偏移只有16位，超过64K时报错，不生成错误的字体。*/
+  ASSERT_EQ(font_gen_buff_ex(ttf_font, sizes[0], GLYPH_FMT_A8, str, bmp_buff, BUFF_SIZE), 0);
+
+  ret = font_gen_buff_sizes(ttf_font, sizes, ARRAY_SIZE(sizes), GLYPH_FMT_A8, str, bmp_buff,
+                            BUFF_SIZE);
+  ASSERT_EQ(ret > 0, true);
+  load_uint32(p, face_size);
+  ASSERT_EQ(face_size > 0xffff, true);
+
+  bmp_font = font_bitmap_create("default", bmp_buff, ret);
+  ASSERT_TRUE(bmp_font != NULL);
+  for (uint32_t i = 0; str[i]; i++) {
+    glyph_t g1;
+    glyph_t g2;
+    char c = str[i];
+    ASSERT_EQ(font_find_glyph(ttf_font, c, &g1, sizes[0]), RET_OK);
+    ASSERT_EQ(font_find_glyph(bmp_font, c, &g2, sizes[0]), RET_OK);
+
+    ASSERT_EQ(g1.w, g2.w);
+    ASSERT_EQ(g1.h, g2.h);
+    ASSERT_EQ(memcmp(g1.data, g2.data, g1.w * g1.h), 0);
+  }
+
+  font_destroy(ttf_font);
+  font_destroy(bmp_font);
+  TKMEM_FREE(bmp_buff);
+  TKMEM_FREE(ttf_buff);
+}
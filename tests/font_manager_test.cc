@@ -28,3 +28,57 @@ TEST(FontManager, basic) {
 
   font_manager_deinit(&font_manager);
 }
+
+TEST(FontManager, cache) {
+  font_manager_t font_manager;
+  font_dummy_init();
+  font_manager_init(&font_manager);
+  font_manager_add(&font_manager, font_dummy_0("demo0", 10));
+
+  /*没有匹配的字体时使用第一个字体，结果同样缓存。*/
+  ASSERT_EQ(font_manager_find(&font_manager, "demo1", 11), font_dummy_0("demo0", 10));
+  ASSERT_EQ(font_manager_find(&font_manager, "demo1", 11), font_dummy_0("demo0", 10));
+
+  /*加入新字体后缓存失效。*/
+  font_manager_add(&font_manager, font_dummy_1("demo1", 11));
+  ASSERT_EQ(font_manager_find(&font_manager, "demo1", 11), font_dummy_1("demo1", 11));
+  ASSERT_EQ(font_manager_find(&font_manager, "demo0", 10), font_dummy_0("demo0", 10));
+  ASSERT_EQ(font_manager_find(&font_manager, "demo1", 11), font_dummy_1("demo1", 11));
+
+  /*名字太长的不缓存，但仍然可以找到。*/
+  ASSERT_EQ(font_manager_find(&font_manager, "a_very_long_font_name", 11),
+            font_dummy_1("demo1", 11));
+
+  font_manager_deinit(&font_manager);
+}
+
+/*只设置包围盒，不设置advance的字体。*/
+static ret_t font_box_find_glyph(font_t* f, wchar_t chr, glyph_t* g, uint16_t font_size) {
+  g->x = 1;
+  g->y = -8;
+  g->w = 6;
+  g->h = 8;
+  (void)f;
+  (void)chr;
+  (void)font_size;
+
+  return RET_OK;
+}
+
+TEST(FontManager, metricsFallback) {
+  font_t font;
+  glyph_metrics_t m;
+
+  memset(&font, 0x00, sizeof(font));
+  memset(&m, 0xff, sizeof(m));
+  font.find_glyph = font_box_find_glyph;
+
+  ASSERT_EQ(font_get_metrics(&font, 'a', &m, 10), RET_OK);
+  ASSERT_EQ(m.x, 1);
+  ASSERT_EQ(m.w, 6);
+  ASSERT_EQ(m.advance, 7);
+
+  font_dummy_init();
+  ASSERT_EQ(font_get_metrics(font_dummy_0("demo0", 10), 1, &m, 10), RET_OK);
+  ASSERT_EQ(m.advance, 12);
+}
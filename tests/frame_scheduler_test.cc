@@ -0,0 +1,182 @@
+#include "base/idle.h"
+#include "base/view.h"
+#include "base/window.h"
+#include "base/canvas.h"
+#include "base/frame_scheduler.h"
+#include "base/window_manager.h"
+#include "lcd/lcd_mem.h"
+#include "gtest/gtest.h"
+
+typedef struct _test_frame_ctx_t {
+  uint32_t times;
+  uint32_t last_now;
+  uint32_t remove_id;
+  frame_scheduler_t* fs;
+} test_frame_ctx_t;
+
+static ret_t test_on_frame(const frame_info_t* info) {
+  test_frame_ctx_t* ctx = (test_frame_ctx_t*)(info->ctx);
+
+  ctx->times++;
+  ctx->last_now = info->now;
+  if (ctx->remove_id != 0) {
+    frame_scheduler_remove(ctx->fs, ctx->remove_id);
+    ctx->remove_id = 0;
+  }
+
+  return ctx->times < 3 ? RET_REPEAT : RET_REMOVE;
+}
+
+static ret_t test_on_paint(void* ctx, event_t* e) {
+  (*(uint32_t*)ctx)++;
+
+  return RET_OK;
+}
+
+TEST(FrameScheduler, callbacks) {
+  test_frame_ctx_t every;
+  test_frame_ctx_t slow;
+  frame_scheduler_t* fs = frame_scheduler_create(16);
+
+  memset(&every, 0x00, sizeof(every));
+  memset(&slow, 0x00, sizeof(slow));
+  every.fs = fs;
+  slow.fs = fs;
+
+  ASSERT_NE(frame_scheduler_add(fs, test_on_frame, &every, 0), 0);
+  ASSERT_NE(frame_scheduler_add(fs, test_on_frame, &slow, 100000), 0);
+
+  /*每帧调用的回调函数看到的是同一个时间。*/
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1000, NULL, NULL), RET_OK);
+  ASSERT_EQ(every.times, 1);
+  ASSERT_EQ(every.last_now, 1000);
+
+  /*没到刷新时机不调用。*/
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1010, NULL, NULL), RET_NOT_FOUND);
+  ASSERT_EQ(every.times, 1);
+
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1016, NULL, NULL), RET_OK);
+  ASSERT_EQ(every.times, 2);
+  ASSERT_EQ(every.last_now, 1016);
+
+  /*返回RET_REMOVE后删除。*/
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1032, NULL, NULL), RET_OK);
+  ASSERT_EQ(every.times, 3);
+  ASSERT_EQ(fs->frames.size, 1);
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1048, NULL, NULL), RET_NOT_FOUND);
+  ASSERT_EQ(every.times, 3);
+
+  frame_scheduler_destroy(fs);
+}
+
+TEST(FrameScheduler, interval) {
+  uint32_t t = 0;
+  uint32_t id = 0;
+  test_frame_ctx_t slow;
+  frame_scheduler_t* fs = frame_scheduler_create(16);
+
+  memset(&slow, 0x00, sizeof(slow));
+  slow.fs = fs;
+  id = frame_scheduler_add(fs, test_on_frame, &slow, 100);
+  t = ((frame_info_t*)(fs->frames.elms[0]))->next;
+
+  /*间隔为100ms的回调函数在到期后的刷新时机上调用，空闲时等到它到期。*/
+  ASSERT_EQ(frame_scheduler_get_wait_time(fs, t - 100, NULL, 30), 30);
+  ASSERT_EQ(frame_scheduler_get_wait_time(fs, t - 10, NULL, 30), 10);
+  ASSERT_EQ(frame_scheduler_dispatch(fs, t - 10, NULL, NULL), RET_NOT_FOUND);
+  ASSERT_EQ(slow.times, 0);
+  ASSERT_EQ(frame_scheduler_dispatch(fs, t + 1, NULL, NULL), RET_OK);
+  ASSERT_EQ(slow.times, 1);
+  ASSERT_EQ(slow.last_now, t + 1);
+
+  /*连续绘制时等到下一个刷新时机，之后没有工作就回到空闲状态。*/
+  ASSERT_EQ(frame_scheduler_get_wait_time(fs, t + 5, NULL, 30), 12);
+  ASSERT_EQ(frame_scheduler_dispatch(fs, t + 17, NULL, NULL), RET_NOT_FOUND);
+  ASSERT_EQ(frame_scheduler_get_wait_time(fs, t + 17, NULL, 30), 30);
+
+  ASSERT_EQ(frame_scheduler_remove(fs, id), RET_OK);
+  ASSERT_EQ(fs->frames.size, 0);
+
+  frame_scheduler_destroy(fs);
+}
+
+TEST(FrameScheduler, removeInCallback) {
+  test_frame_ctx_t a;
+  test_frame_ctx_t b;
+  frame_scheduler_t* fs = frame_scheduler_create(16);
+
+  memset(&a, 0x00, sizeof(a));
+  memset(&b, 0x00, sizeof(b));
+  a.fs = fs;
+  b.fs = fs;
+
+  frame_scheduler_add(fs, test_on_frame, &a, 0);
+  a.remove_id = frame_scheduler_add(fs, test_on_frame, &b, 0);
+
+  /*在回调函数中删除后面的回调函数，本帧就不再调用。*/
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1000, NULL, NULL), RET_OK);
+  ASSERT_EQ(a.times, 1);
+  ASSERT_EQ(b.times, 0);
+  ASSERT_EQ(fs->frames.size, 1);
+
+  frame_scheduler_destroy(fs);
+}
+
+TEST(FrameScheduler, coalesce) {
+  uint32_t i = 0;
+  canvas_t canvas;
+  uint32_t paints = 0;
+  font_manager_t font_manager;
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  frame_scheduler_t* fs = frame_scheduler_create(16);
+  widget_t* win = NULL;
+  widget_t* view = NULL;
+
+  window_manager_set(wm);
+  window_manager_resize(wm, 100, 100);
+  win = window_create(wm, 0, 0, 100, 100);
+  view = view_create(win, 0, 0, 100, 100);
+  widget_on(view, EVT_PAINT, test_on_paint, &paints);
+  idle_dispatch();
+
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1000, wm, c), RET_OK);
+  ASSERT_EQ(paints, 1);
+  ASSERT_EQ(fs->stat.frames, 1);
+
+  /*一个刷新周期内的多次invalidate合并成一帧。*/
+  for (i = 1; i < 16; i++) {
+    widget_invalidate(view, NULL);
+    frame_scheduler_dispatch(fs, 1000 + i, wm, c);
+  }
+  ASSERT_EQ(paints, 1);
+  ASSERT_EQ(window_manager_need_paint(wm), TRUE);
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1016, wm, c), RET_OK);
+  ASSERT_EQ(paints, 2);
+  ASSERT_EQ(window_manager_need_paint(wm), FALSE);
+  ASSERT_EQ(fs->stat.missed, 0);
+
+  /*连续绘制时落后3个周期。*/
+  widget_invalidate(view, NULL);
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1032 + 50, wm, c), RET_OK);
+  ASSERT_EQ(paints, 3);
+  ASSERT_EQ(fs->stat.frames, 3);
+  ASSERT_EQ(fs->stat.missed, 3);
+  ASSERT_EQ(fs->deadline, 1082 + 16);
+
+  /*没有需要绘制的内容就回到空闲状态，新的invalidate立即绘制。*/
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1098, wm, c), RET_NOT_FOUND);
+  widget_invalidate(view, NULL);
+  ASSERT_EQ(frame_scheduler_get_wait_time(fs, 1200, wm, 30), 0);
+  ASSERT_EQ(frame_scheduler_dispatch(fs, 1200, wm, c), RET_OK);
+  ASSERT_EQ(paints, 4);
+  ASSERT_EQ(fs->stat.missed, 3);
+
+  frame_scheduler_destroy(fs);
+  widget_destroy(win);
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
@@ -0,0 +1,182 @@
+#include "base/fs.h"
+#include "base/idle.h"
+#include "base/time.h"
+#include "base/view.h"
+#include "base/timer.h"
+#include "base/window.h"
+#include "base/input_trace.h"
+#include "base/frame_scheduler.h"
+#include "base/window_manager.h"
+#include "lcd/lcd_mem.h"
+#include "main_loop/main_loop_headless.h"
+#include "gtest/gtest.h"
+
+static ret_t test_on_timer(const timer_info_t* timer) {
+  return RET_REMOVE;
+}
+
+TEST(InputTrace, saveLoad) {
+  const char* filename = "input_trace_test.trace";
+  input_trace_t* trace = input_trace_create(320, 480);
+  input_trace_t* loaded = NULL;
+
+  trace->now = 10;
+  ASSERT_EQ(input_trace_add(trace, INPUT_TRACE_TIMER, 0, 0, 2), RET_OK);
+  ASSERT_EQ(input_trace_add(trace, EVT_POINTER_DOWN, 10, -20, 0), RET_OK);
+  trace->now = 26;
+  ASSERT_EQ(input_trace_add(trace, EVT_KEY_UP, 0, 0, 13), RET_OK);
+  ASSERT_EQ(input_trace_add(trace, INPUT_TRACE_FRAME, 1, 0, 0xfedcba98), RET_OK);
+  ASSERT_EQ(input_trace_save(trace, filename), RET_OK);
+
+  loaded = input_trace_load(filename);
+  ASSERT_TRUE(loaded != NULL);
+  ASSERT_EQ(loaded->w, 320);
+  ASSERT_EQ(loaded->h, 480);
+  ASSERT_EQ(loaded->size, 4);
+  for (uint32_t i = 0; i < loaded->size; i++) {
+    input_trace_record_t* a = loaded->records + i;
+    input_trace_record_t* b = trace->records + i;
+    ASSERT_EQ(a->time, b->time);
+    ASSERT_EQ(a->type, b->type);
+    ASSERT_EQ(a->x, b->x);
+    ASSERT_EQ(a->y, b->y);
+    ASSERT_EQ(a->value, b->value);
+  }
+  ASSERT_EQ(loaded->records[3].time, 26);
+
+  input_trace_destroy(loaded);
+  input_trace_destroy(trace);
+  fs_unlink(filename);
+}
+
+TEST(InputTrace, record) {
+  canvas_t canvas;
+  pointer_event_t e;
+  font_manager_t font_manager;
+  input_trace_t* trace = input_trace_create(100, 100);
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  frame_scheduler_t* fs = frame_scheduler_create(16);
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  widget_t* win = NULL;
+
+  window_manager_set(wm);
+  window_manager_resize(wm, 100, 100);
+  win = window_create(wm, 0, 0, 100, 100);
+  idle_dispatch();
+
+  /*录制期间同一次循环内的时间都相同。*/
+  ASSERT_EQ(input_trace_start(trace), RET_OK);
+  ASSERT_EQ(input_trace(), trace);
+  ASSERT_EQ(time_now_ms(), trace->now);
+
+  timer_add(test_on_timer, NULL, 0);
+  timer_check();
+
+  memset(&e, 0x00, sizeof(e));
+  e.e.type = EVT_POINTER_MOVE;
+  e.x = 10;
+  e.y = 20;
+  window_manager_dispatch_input_event(wm, (event_t*)&e);
+  ASSERT_EQ(frame_scheduler_run_frame(fs, time_now_ms(), wm, c), RET_OK);
+  ASSERT_EQ(input_trace_stop(trace), RET_OK);
+  ASSERT_TRUE(input_trace() == NULL);
+
+  ASSERT_EQ(trace->size, 3);
+  ASSERT_EQ(trace->records[0].type, INPUT_TRACE_TIMER);
+  ASSERT_EQ(trace->records[0].value, 1);
+  ASSERT_EQ(trace->records[1].type, EVT_POINTER_MOVE);
+  ASSERT_EQ(trace->records[1].x, 10);
+  ASSERT_EQ(trace->records[1].y, 20);
+  ASSERT_EQ(trace->records[2].type, INPUT_TRACE_FRAME);
+  ASSERT_EQ(trace->records[2].x, 1);
+  ASSERT_EQ(trace->records[2].value, input_trace_checksum(lcd));
+
+  input_trace_destroy(trace);
+  frame_scheduler_destroy(fs);
+  widget_destroy(win);
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
+
+typedef struct _test_replay_ctx_t {
+  widget_t* view;
+  uint32_t downs;
+  xy_t step;
+} test_replay_ctx_t;
+
+static ret_t test_replay_on_down(void* ctx, event_t* e) {
+  test_replay_ctx_t* info = (test_replay_ctx_t*)ctx;
+
+  info->downs++;
+  widget_invalidate(info->view, NULL);
+
+  return RET_OK;
+}
+
+static ret_t test_replay_on_paint(void* ctx, event_t* e) {
+  test_replay_ctx_t* info = (test_replay_ctx_t*)ctx;
+  canvas_t* c = ((paint_event_t*)e)->c;
+
+  canvas_set_fill_color(c, color_init(0, 0, 0, 0xff));
+  canvas_fill_rect(c, 0, 0, info->view->w, info->view->h);
+  canvas_set_fill_color(c, color_init(0xff, 0xff, 0xff, 0xff));
+  canvas_fill_rect(c, info->downs * info->step, 0, 10, 10);
+
+  return RET_OK;
+}
+
+TEST(InputTrace, replay) {
+  test_replay_ctx_t ctx;
+  input_trace_t* trace = input_trace_create(100, 100);
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  main_loop_t* l = NULL;
+  widget_t* win = NULL;
+
+  window_manager_set(wm);
+  l = main_loop_headless_create(100, 100);
+  ASSERT_TRUE(l != NULL);
+  win = window_create(wm, 0, 0, 100, 100);
+  ctx.view = view_create(win, 0, 0, 100, 100);
+  ctx.downs = 0;
+  ctx.step = 10;
+  widget_on(ctx.view, EVT_POINTER_DOWN, test_replay_on_down, &ctx);
+  widget_on(ctx.view, EVT_PAINT, test_replay_on_paint, &ctx);
+  idle_dispatch();
+
+  trace->now = 0;
+  input_trace_add(trace, INPUT_TRACE_FRAME, 1, 0, 0);
+  trace->now = 20;
+  input_trace_add(trace, EVT_POINTER_DOWN, 20, 20, 0);
+  input_trace_add(trace, EVT_POINTER_UP, 20, 20, 0);
+  input_trace_add(trace, INPUT_TRACE_FRAME, 1, 0, 0);
+
+  /*第一次回放生成校验和。*/
+  ASSERT_EQ(main_loop_headless_replay(l, trace, TRUE), RET_OK);
+  ASSERT_EQ(ctx.downs, 1);
+  ASSERT_NE(trace->records[0].value, 0);
+  ASSERT_NE(trace->records[3].value, 0);
+  ASSERT_NE(trace->records[0].value, trace->records[3].value);
+
+  /*同样的界面和输入得到同样的帧。*/
+  ctx.downs = 0;
+  widget_invalidate(win, NULL);
+  ASSERT_EQ(main_loop_headless_replay(l, trace, FALSE), RET_OK);
+  ASSERT_EQ(((main_loop_headless_t*)l)->mismatches, 0);
+
+  /*绘制的结果变了。*/
+  ctx.downs = 0;
+  ctx.step = 20;
+  widget_invalidate(win, NULL);
+  ASSERT_EQ(main_loop_headless_replay(l, trace, FALSE), RET_FAIL);
+  ASSERT_EQ(((main_loop_headless_t*)l)->mismatches, 1);
+
+  input_trace_destroy(trace);
+  widget_destroy(win);
+  main_loop_destroy(l);
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+}
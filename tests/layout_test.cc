@@ -368,3 +368,134 @@ TEST(Layuout, layout_children_parse) {
   ASSERT_EQ(layout.margin, 3);
   ASSERT_EQ(layout.cell_spacing, 4);
 }
+
+static ret_t on_layout_event(void* ctx, event_t* e) {
+  int32_t* counts = (int32_t*)ctx;
+
+  if (e->type == EVT_MOVE) {
+    counts[0]++;
+  } else if (e->type == EVT_RESIZE) {
+    counts[1]++;
+  } else if (e->type == EVT_MOVE_RESIZE) {
+    counts[2]++;
+  }
+
+  return RET_OK;
+}
+
+TEST(Layuout, transaction) {
+  int32_t c1[3] = {0, 0, 0};
+  int32_t c2[3] = {0, 0, 0};
+  widget_t* win = group_box_create(NULL, 0, 0, 200, 200);
+  widget_t* g1 = group_box_create(win, 0, 0, 10, 10);
+  widget_t* g2 = group_box_create(win, 0, 0, 10, 10);
+
+  widget_on(g1, EVT_MOVE, on_layout_event, c1);
+  widget_on(g1, EVT_RESIZE, on_layout_event, c1);
+  widget_on(g1, EVT_MOVE_RESIZE, on_layout_event, c1);
+  widget_on(g2, EVT_MOVE, on_layout_event, c2);
+  widget_on(g2, EVT_RESIZE, on_layout_event, c2);
+  widget_on(g2, EVT_MOVE_RESIZE, on_layout_event, c2);
+
+  ASSERT_EQ(widget_layout_begin(win), RET_OK);
+  widget_move(g1, 5, 5);
+  widget_resize(g1, 20, 20);
+  widget_move(g1, 6, 6);
+  widget_move_resize(g2, 0, 0, 10, 10);
+  ASSERT_EQ(g1->x, 6);
+  ASSERT_EQ(g1->w, 20);
+  ASSERT_EQ(c1[0] + c1[1] + c1[2], 0);
+
+  ASSERT_EQ(widget_layout_begin(win), RET_OK);
+  widget_move(g2, 1, 1);
+  ASSERT_EQ(widget_layout_end(win), RET_OK);
+  ASSERT_EQ(c2[0], 0);
+
+  ASSERT_EQ(widget_layout_end(win), RET_OK);
+  ASSERT_EQ(c1[0], 0);
+  ASSERT_EQ(c1[1], 0);
+  ASSERT_EQ(c1[2], 1);
+  ASSERT_EQ(c2[0], 1);
+  ASSERT_EQ(c2[2], 0);
+
+  widget_move(g2, 2, 2);
+  ASSERT_EQ(c2[0], 2);
+
+  widget_destroy(win);
+}
+
+TEST(Layuout, transaction_skip_unchanged) {
+  int32_t c1[3] = {0, 0, 0};
+  int32_t c2[3] = {0, 0, 0};
+  widget_layout_t layout;
+  widget_t* win = group_box_create(NULL, 0, 0, 200, 200);
+  widget_t* g1 = group_box_create(win, 0, 0, 0, 0);
+  widget_t* g2 = group_box_create(win, 0, 0, 0, 0);
+
+  widget_set_children_layout_params(win, 1, 0, 10, 10);
+  widget_set_parsed_self_layout_params(g1, widget_layout_parse(&layout, "0", "0", "10", "4"));
+  widget_set_parsed_self_layout_params(g2, widget_layout_parse(&layout, "0", "0", "10", "4"));
+  widget_layout_children(win);
+
+  widget_on(g1, EVT_MOVE_RESIZE, on_layout_event, c1);
+  widget_on(g2, EVT_MOVE_RESIZE, on_layout_event, c2);
+  widget_layout_children(win);
+  ASSERT_EQ(c1[2], 0);
+  ASSERT_EQ(c2[2], 0);
+
+  widget_set_parsed_self_layout_params(g2, widget_layout_parse(&layout, "0", "0", "20", "4"));
+  widget_layout_children(win);
+  ASSERT_EQ(c1[2], 0);
+  ASSERT_EQ(c2[2], 1);
+  ASSERT_EQ(g2->w, 20);
+  ASSERT_EQ(g1->layout_pending, FALSE);
+  ASSERT_EQ(g2->layout_pending, FALSE);
+
+  widget_destroy(win);
+}
+
+static ret_t on_move_destroy(void* ctx, event_t* e) {
+  widget_t** victim = (widget_t**)ctx;
+
+  if (*victim != NULL) {
+    widget_remove_child((*victim)->parent, *victim);
+    widget_destroy(*victim);
+    *victim = NULL;
+  }
+
+  return RET_OK;
+}
+
+TEST(Layuout, transaction_destroy) {
+  int32_t c[3] = {0, 0, 0};
+  widget_t* win = group_box_create(NULL, 0, 0, 200, 200);
+  widget_t* g1 = group_box_create(win, 0, 0, 10, 10);
+  widget_t* g2 = group_box_create(win, 0, 0, 10, 10);
+  widget_t* g3 = group_box_create(win, 0, 0, 10, 10);
+  widget_t* victim = NULL;
+
+  /*事务中销毁的控件从记录中去掉。*/
+  widget_on(g2, EVT_MOVE, on_layout_event, c);
+  ASSERT_EQ(widget_layout_begin(win), RET_OK);
+  widget_move(g1, 5, 5);
+  widget_move(g2, 5, 5);
+  ASSERT_TRUE(g1->layout_pending);
+  widget_remove_child(win, g1);
+  widget_destroy(g1);
+  ASSERT_EQ(widget_layout_end(win), RET_OK);
+  ASSERT_EQ(c[0], 1);
+
+  /*分发事件时销毁后面还没有分发的控件。*/
+  victim = g3;
+  widget_on(g2, EVT_MOVE, on_move_destroy, &victim);
+  widget_on(g3, EVT_MOVE, on_layout_event, c);
+  ASSERT_EQ(widget_layout_begin(win), RET_OK);
+  widget_move(g2, 6, 6);
+  widget_move(g3, 6, 6);
+  ASSERT_EQ(widget_layout_end(win), RET_OK);
+  ASSERT_TRUE(victim == NULL);
+  ASSERT_EQ(c[0], 2);
+  ASSERT_EQ(widget_count_children(win), 1);
+
+  widget_destroy(win);
+}
@@ -74,3 +74,306 @@ TEST(LCDMem, basic) {
 
   lcd_destroy(lcd);
 }
+
+TEST(LCDMem, scroll) {
+  rect_t r;
+  canvas_t canvas;
+  color_t bg;
+  color_t fg;
+  font_manager_t font_manager;
+  font_manager_init(&font_manager);
+  lcd_t* lcd = lcd_mem_create(200, 200, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, &font_manager);
+
+  ASSERT_NE(lcd->scroll, (lcd_scroll_t)NULL);
+  ASSERT_EQ(canvas_begin_frame(c, NULL, LCD_DRAW_NORMAL), RET_OK);
+  ASSERT_EQ(canvas_set_fill_color(c, color_init(0, 0, 0xff, 0xff)), RET_OK);
+  ASSERT_EQ(canvas_fill_rect(c, 0, 0, 200, 200), RET_OK);
+  ASSERT_EQ(canvas_set_fill_color(c, color_init(0xff, 0xff, 0, 0xff)), RET_OK);
+  ASSERT_EQ(canvas_fill_rect(c, 50, 50, 10, 10), RET_OK);
+  bg = lcd_get_point_color(lcd, 0, 0);
+  fg = lcd_get_point_color(lcd, 55, 55);
+  ASSERT_NE(bg.color, fg.color);
+
+  /*向下移动，行之间重叠。*/
+  rect_init(r, 0, 0, 200, 200);
+  ASSERT_EQ(lcd_scroll(lcd, &r, 0, 5), RET_OK);
+  ASSERT_EQ(lcd_get_point_color(lcd, 55, 54).color, bg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 55, 55).color, fg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 55, 64).color, fg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 55, 65).color, bg.color);
+
+  /*向左移动，同一行内重叠。*/
+  ASSERT_EQ(lcd_scroll(lcd, &r, -5, 0), RET_OK);
+  ASSERT_EQ(lcd_get_point_color(lcd, 44, 60).color, bg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 45, 60).color, fg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 54, 60).color, fg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 55, 60).color, bg.color);
+
+  /*只移动指定的区域。*/
+  rect_init(r, 0, 0, 52, 200);
+  ASSERT_EQ(lcd_scroll(lcd, &r, 0, -10), RET_OK);
+  ASSERT_EQ(lcd_get_point_color(lcd, 50, 50).color, fg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 50, 45).color, fg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 52, 50).color, bg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 52, 60).color, fg.color);
+
+  rect_init(r, 150, 150, 100, 100);
+  ASSERT_EQ(lcd_scroll(lcd, &r, 0, 10), RET_BAD_PARAMS);
+
+  lcd_destroy(lcd);
+}
+
+TEST(LCDMem, layer) {
+  rect_t r;
+  bitmap_t img;
+  bitmap_t sub;
+  canvas_t canvas;
+  font_manager_t font_manager;
+  const uint8_t* data = NULL;
+  color_t fg = color_init(0xff, 0, 0, 0xff);
+  lcd_t* lcd = lcd_mem_create(100, 80, TRUE);
+  lcd_t* layer = NULL;
+  lcd_t* sub_layer = NULL;
+  canvas_t* c = NULL;
+
+  font_manager_init(&font_manager);
+  memset(&img, 0x00, sizeof(img));
+  img.w = lcd->w;
+  img.h = lcd->h;
+  layer = lcd_create_layer(lcd, &img);
+  ASSERT_TRUE(layer != NULL);
+  ASSERT_TRUE(img.data != NULL);
+  ASSERT_EQ(img.flags & BITMAP_FLAG_LCD_NATIVE, BITMAP_FLAG_LCD_NATIVE);
+
+  c = canvas_init(&canvas, layer, &font_manager);
+  rect_init(r, 0, 0, 100, 80);
+  ASSERT_EQ(canvas_begin_frame(c, &r, LCD_DRAW_OFFLINE), RET_OK);
+  ASSERT_EQ(canvas_set_fill_color(c, fg), RET_OK);
+  ASSERT_EQ(canvas_fill_rect(c, 10, 10, 20, 20), RET_OK);
+  ASSERT_EQ(canvas_end_frame(c), RET_OK);
+
+  /*离屏lcd上创建的全屏缓冲区也来自屏幕lcd的缓冲区池。*/
+  memset(&sub, 0x00, sizeof(sub));
+  sub.w = lcd->w;
+  sub.h = lcd->h;
+  sub_layer = lcd_create_layer(layer, &sub);
+  ASSERT_TRUE(sub_layer != NULL);
+  lcd_destroy(sub_layer);
+  lcd_destroy(layer);
+
+  /*按原来的像素格式直接拷贝。*/
+  c = canvas_init(&canvas, lcd, &font_manager);
+  ASSERT_EQ(canvas_begin_frame(c, &r, LCD_DRAW_NORMAL), RET_OK);
+  ASSERT_EQ(canvas_draw_image(c, &img, &r, &r), RET_OK);
+  ASSERT_EQ(canvas_end_frame(c), RET_OK);
+  ASSERT_EQ(lcd_get_point_color(lcd, 10, 10).color, fg.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 29, 29).color, fg.color);
+  ASSERT_NE(lcd_get_point_color(lcd, 30, 30).color, fg.color);
+
+  /*释放的全屏缓冲区放回池中，再次创建时重用，不需要分配。*/
+  data = img.data;
+  ASSERT_EQ(bitmap_destroy(&img), RET_OK);
+  ASSERT_EQ(bitmap_destroy(&sub), RET_OK);
+  memset(&img, 0x00, sizeof(img));
+  img.w = lcd->w;
+  img.h = lcd->h;
+  layer = lcd_create_layer(lcd, &img);
+  ASSERT_TRUE(img.data == data || img.data == sub.data);
+  lcd_destroy(layer);
+  ASSERT_EQ(bitmap_destroy(&img), RET_OK);
+
+  lcd_destroy(lcd);
+}
+
+TEST(LCDMem, layer_alpha) {
+  rect_t r;
+  bitmap_t img;
+  lcd_t* lcd = lcd_mem_create(64, 64, TRUE);
+  lcd_t* layer = NULL;
+  uint32_t i = 0;
+
+  memset(&img, 0x00, sizeof(img));
+  img.w = 64;
+  img.h = 64;
+  layer = lcd_create_layer(lcd, &img);
+  ASSERT_TRUE(layer != NULL);
+  for (i = 0; i < 64 * 64; i++) {
+    ((uint32_t*)(img.data))[i] = (i * 2654435761u) | 0xff;
+    ((uint32_t*)(((lcd_mem_t*)lcd)->pixels))[i] = (i * 40503u) << 8 | 0xff;
+  }
+
+  /*半透明的离屏位图与blend_pixel的结果相同。*/
+  rect_init(r, 0, 0, 64, 64);
+  for (i = 1; i < 0xff; i += 0x1f) {
+    uint32_t k = 0;
+    uint32_t nr = 64 * 64;
+    color_t* expected = (color_t*)malloc(nr * sizeof(color_t));
+
+    for (k = 0; k < nr; k++) {
+      color_t bg = lcd_get_point_color(lcd, k % 64, k / 64);
+      color_t fg = lcd_get_point_color(layer, k % 64, k / 64);
+      uint8_t a = i;
+
+      expected[k].rgba.r = (bg.rgba.r * (0xff - a) + fg.rgba.r * a) / 0xff;
+      expected[k].rgba.g = (bg.rgba.g * (0xff - a) + fg.rgba.g * a) / 0xff;
+      expected[k].rgba.b = (bg.rgba.b * (0xff - a) + fg.rgba.b * a) / 0xff;
+      expected[k].rgba.a = 0xff;
+    }
+
+    lcd_begin_frame(lcd, &r, LCD_DRAW_NORMAL);
+    lcd_set_global_alpha(lcd, i);
+    lcd_draw_image(lcd, &img, &r, &r);
+    lcd_end_frame(lcd);
+
+    for (k = 0; k < nr; k++) {
+      ASSERT_EQ(lcd_get_point_color(lcd, k % 64, k / 64).color, expected[k].color);
+    }
+    free(expected);
+  }
+
+  lcd_destroy(layer);
+  bitmap_destroy(&img);
+  lcd_destroy(lcd);
+}
+
+/*逐个通道按a混合，作为字模混合的参考结果。*/
+static uint32_t test_blend(uint32_t bg, uint32_t fg, uint8_t a) {
+  uint32_t s = 0;
+  uint32_t ret = 0xff;
+
+  for (s = 8; s <= 24; s += 8) {
+    uint32_t v = (((bg >> s) & 0xff) * (0xff - a) + ((fg >> s) & 0xff) * a) / 0xff;
+    ret |= v << s;
+  }
+
+  return ret;
+}
+
+TEST(LCDMem, draw_glyphs) {
+  rect_t r;
+  uint32_t i = 0;
+  uint32_t k = 0;
+  uint8_t data[13 * 9];
+  lcd_glyph_t glyphs[3];
+  lcd_t* lcd = lcd_mem_create(64, 32, TRUE);
+  uint32_t* pixels = (uint32_t*)(((lcd_mem_t*)lcd)->pixels);
+  uint32_t* expected = (uint32_t*)malloc(64 * 32 * sizeof(uint32_t));
+  uint32_t fg = 0x2080f0ff;
+
+  for (i = 0; i < sizeof(data); i++) {
+    data[i] = i % 3 == 0 ? 0xff : (i * 37) & 0xff;
+  }
+
+  memset(glyphs, 0x00, sizeof(glyphs));
+  for (i = 0; i < ARRAY_SIZE(glyphs); i++) {
+    lcd_glyph_t* iter = glyphs + i;
+    iter->glyph.w = 13;
+    iter->glyph.h = 9;
+    iter->glyph.data = data;
+    rect_init(iter->src, i, 0, 13 - i, 9 - i);
+    iter->x = 2 + i * 14;
+    iter->y = 3 + i;
+  }
+
+  for (i = 0; i < 64 * 32; i++) {
+    pixels[i] = (i * 2654435761u) | 0xff;
+  }
+  memcpy(expected, pixels, 64 * 32 * sizeof(uint32_t));
+
+  /*期望的结果逐个像素计算，不经过lcd_mem的混合函数。*/
+  for (i = 0; i < ARRAY_SIZE(glyphs); i++) {
+    lcd_glyph_t* iter = glyphs + i;
+    for (k = 0; k < (uint32_t)(iter->src.w * iter->src.h); k++) {
+      uint32_t sx = iter->src.x + k % iter->src.w;
+      uint32_t sy = iter->src.y + k / iter->src.w;
+      uint32_t* d = expected + (iter->y + k / iter->src.w) * 64 + iter->x + k % iter->src.w;
+      *d = test_blend(*d, fg, data[sy * iter->glyph.w + sx]);
+    }
+  }
+
+  rect_init(r, 2, 3, 42, 9);
+  lcd->text_color = color_init(0x20, 0x80, 0xf0, 0xff);
+  ASSERT_EQ(lcd_draw_glyphs(lcd, glyphs, ARRAY_SIZE(glyphs), &r), RET_OK);
+  for (i = 0; i < 64 * 32; i++) {
+    ASSERT_EQ(pixels[i], expected[i]);
+  }
+
+  /*完全覆盖的像素是文字颜色，部分覆盖(37/255)的像素按比例混合。*/
+  ASSERT_EQ(pixels[3 * 64 + 2], fg);
+  ASSERT_EQ(pixels[3 * 64 + 3], 0x754abaffu);
+
+  free(expected);
+  lcd_destroy(lcd);
+}
+
+TEST(LCDMem, overdraw) {
+  rect_t r;
+  bitmap_t img;
+  color_t red = color_init(0xff, 0, 0, 0xff);
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  lcd_t* view = NULL;
+  const color_t* data = NULL;
+
+  ASSERT_EQ(lcd_mem_get_overdraw_ratio(lcd), 0);
+  ASSERT_EQ(lcd_mem_set_overdraw(lcd, TRUE, FALSE), RET_OK);
+
+  rect_init(r, 0, 0, 100, 100);
+  lcd_begin_frame(lcd, &r, LCD_DRAW_NORMAL);
+  lcd->fill_color = red;
+  lcd_fill_rect(lcd, 0, 0, 100, 100);
+  lcd_fill_rect(lcd, 10, 10, 20, 20);
+  lcd_fill_rect(lcd, 15, 15, 10, 10);
+  lcd_end_frame(lcd);
+
+  ASSERT_EQ(lcd_mem_get_overdraw(lcd, 0, 0), 1);
+  ASSERT_EQ(lcd_mem_get_overdraw(lcd, 10, 10), 2);
+  ASSERT_EQ(lcd_mem_get_overdraw(lcd, 15, 15), 3);
+  ASSERT_EQ(lcd_mem_get_overdraw(lcd, 100, 0), 0);
+  ASSERT_EQ(lcd_mem_get_overdraw_ratio(lcd), 105);
+  ASSERT_EQ(lcd_get_point_color(lcd, 15, 15).color, red.color);
+
+  ASSERT_EQ(lcd_mem_get_overdraw_heatmap(lcd, &img), RET_OK);
+  data = (const color_t*)(img.data);
+  ASSERT_EQ(img.w, 100);
+  ASSERT_EQ(img.format, BITMAP_FMT_RGBA);
+  ASSERT_EQ(data[0].rgba.r, 0x80);
+  ASSERT_EQ(data[15 * 100 + 15].rgba.g, 0xd0);
+  ASSERT_EQ(bitmap_destroy(&img), RET_OK);
+
+  /*每一帧重新统计，视图写的像素也算在屏幕lcd上。*/
+  rect_init(r, 0, 0, 50, 50);
+  lcd_begin_frame(lcd, &r, LCD_DRAW_NORMAL);
+  ASSERT_EQ(lcd_mem_get_overdraw(lcd, 15, 15), 0);
+  view = lcd_create_view(lcd);
+  view->fill_color = red;
+  lcd_fill_rect(view, 0, 0, 50, 50);
+  lcd_destroy(view);
+  lcd_end_frame(lcd);
+  ASSERT_EQ(lcd_mem_get_overdraw(lcd, 15, 15), 1);
+  ASSERT_EQ(lcd_mem_get_overdraw_ratio(lcd), 100);
+
+  /*热图叠加在写了两次以上的像素上，离屏绘制时不叠加。*/
+  ASSERT_TRUE(lcd->scroll != NULL);
+  ASSERT_EQ(lcd_mem_set_overdraw(lcd, TRUE, TRUE), RET_OK);
+  ASSERT_TRUE(lcd->scroll == NULL);
+  lcd_begin_frame(lcd, &r, LCD_DRAW_OFFLINE);
+  lcd_fill_rect(lcd, 0, 0, 50, 50);
+  lcd_fill_rect(lcd, 0, 0, 10, 10);
+  lcd_end_frame(lcd);
+  ASSERT_EQ(lcd_get_point_color(lcd, 5, 5).color, red.color);
+
+  lcd_begin_frame(lcd, &r, LCD_DRAW_NORMAL);
+  lcd_fill_rect(lcd, 0, 0, 50, 50);
+  lcd_fill_rect(lcd, 0, 0, 10, 10);
+  lcd_end_frame(lcd);
+  ASSERT_NE(lcd_get_point_color(lcd, 5, 5).color, red.color);
+  ASSERT_EQ(lcd_get_point_color(lcd, 20, 20).color, red.color);
+
+  ASSERT_EQ(lcd_mem_set_overdraw(lcd, FALSE, FALSE), RET_OK);
+  ASSERT_TRUE(lcd->scroll != NULL);
+  ASSERT_EQ(lcd_mem_get_overdraw_ratio(lcd), 0);
+  ASSERT_EQ(lcd_mem_get_overdraw_heatmap(lcd, &img), RET_BAD_PARAMS);
+
+  lcd_destroy(lcd);
+}
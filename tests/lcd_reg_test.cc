@@ -0,0 +1,115 @@
+#include "base/mem.h"
+#include "base/color.h"
+#include "lcd/lcd_reg.h"
+#include "gtest/gtest.h"
+
+#define PANEL_W 64
+#define PANEL_H 32
+
+/*模拟寄存器接口的屏：设置窗口后按行写入像素。*/
+static uint32_t s_panel[PANEL_W * PANEL_H];
+static uint32_t s_windows_nr;
+static xy_t s_x1;
+static xy_t s_x2;
+static xy_t s_x;
+static xy_t s_y;
+
+static void test_set_window(xy_t x1, xy_t y1, xy_t x2, xy_t y2) {
+  (void)y2;
+  s_x1 = x1;
+  s_x2 = x2;
+  s_x = x1;
+  s_y = y1;
+  s_windows_nr++;
+}
+
+static void test_write_data(uint32_t pixel) {
+  s_panel[s_y * PANEL_W + s_x] = pixel;
+  if (s_x++ == s_x2) {
+    s_x = s_x1;
+    s_y++;
+  }
+}
+
+#define set_window_func test_set_window
+#define write_data_func test_write_data
+
+#include "lcd/rgba.h"
+#include "lcd/lcd_reg.inc"
+
+/*逐个通道按a混合，作为字模混合的参考结果。*/
+static uint32_t test_blend(uint32_t bg, uint32_t fg, uint8_t a) {
+  uint32_t s = 0;
+  uint32_t ret = 0xff;
+
+  for (s = 8; s <= 24; s += 8) {
+    uint32_t v = (((bg >> s) & 0xff) * (0xff - a) + ((fg >> s) & 0xff) * a) / 0xff;
+    ret |= v << s;
+  }
+
+  return ret;
+}
+
+TEST(LCDReg, draw_glyphs) {
+  rect_t r;
+  uint32_t i = 0;
+  uint32_t k = 0;
+  uint8_t data[13 * 9];
+  lcd_glyph_t glyphs[3];
+  uint32_t expected[PANEL_W * PANEL_H];
+  uint32_t fg = 0x2080f0ff;
+  uint32_t bg = 0x102030ff;
+  lcd_t* lcd = lcd_reg_create(PANEL_W, PANEL_H);
+
+  for (i = 0; i < sizeof(data); i++) {
+    data[i] = i % 3 == 0 ? 0xff : (i * 37) & 0xff;
+  }
+
+  /*第二个字模和第一个重叠一列，重叠的列按第一个字模写入。*/
+  memset(glyphs, 0x00, sizeof(glyphs));
+  for (i = 0; i < ARRAY_SIZE(glyphs); i++) {
+    lcd_glyph_t* iter = glyphs + i;
+    iter->glyph.w = 13;
+    iter->glyph.h = 9;
+    iter->glyph.data = data;
+    rect_init(iter->src, i, 0, 13 - i, 9 - i);
+    iter->x = 2 + i * 12 + (i > 1 ? 2 : 0);
+    iter->y = 3 + i;
+  }
+
+  for (i = 0; i < PANEL_W * PANEL_H; i++) {
+    s_panel[i] = i;
+  }
+  memcpy(expected, s_panel, sizeof(expected));
+
+  /*区域内先填充背景色，再按从左到右的顺序写入字模，跳过和前一个字模重叠的列。*/
+  rect_init(r, 1, 2, 44, 11);
+  for (i = 0; i < (uint32_t)(r.w * r.h); i++) {
+    expected[(r.y + i / r.w) * PANEL_W + r.x + i % r.w] = bg;
+  }
+  for (i = ARRAY_SIZE(glyphs); i > 0; i--) {
+    lcd_glyph_t* iter = glyphs + i - 1;
+    for (k = 0; k < (uint32_t)(iter->src.w * iter->src.h); k++) {
+      uint32_t sx = iter->src.x + k % iter->src.w;
+      uint32_t sy = iter->src.y + k / iter->src.w;
+      uint32_t* d = expected + (iter->y + k / iter->src.w) * PANEL_W + iter->x + k % iter->src.w;
+      *d = test_blend(bg, fg, data[sy * iter->glyph.w + sx]);
+    }
+  }
+
+  s_windows_nr = 0;
+  lcd->text_color = color_init(0x20, 0x80, 0xf0, 0xff);
+  lcd->fill_color = color_init(0x10, 0x20, 0x30, 0xff);
+  ASSERT_EQ(lcd_draw_glyphs(lcd, glyphs, ARRAY_SIZE(glyphs), &r), RET_OK);
+
+  /*整个区域只设置一次窗口。*/
+  ASSERT_EQ(s_windows_nr, 1u);
+  for (i = 0; i < PANEL_W * PANEL_H; i++) {
+    ASSERT_EQ(s_panel[i], expected[i]);
+  }
+
+  ASSERT_EQ(s_panel[3 * PANEL_W + 2], fg);
+  ASSERT_EQ(s_panel[2 * PANEL_W + 1], bg);
+
+  lcd_destroy(lcd);
+}
@@ -0,0 +1,249 @@
+#include "base/time.h"
+#include "base/label.h"
+#include "base/list_view.h"
+#include "base/frame_scheduler.h"
+#include "gtest/gtest.h"
+
+typedef struct _list_view_test_ctx_t {
+  uint32_t created;
+  uint32_t bound;
+  uint32_t last_index;
+  uint32_t max_rows;
+} list_view_test_ctx_t;
+
+static widget_t* test_create_row(void* ctx, widget_t* list_view) {
+  list_view_test_ctx_t* test = (list_view_test_ctx_t*)ctx;
+
+  if (test->max_rows > 0 && test->created >= test->max_rows) {
+    return NULL;
+  }
+  test->created++;
+
+  return label_create(list_view, 0, 0, 0, 0);
+}
+
+static ret_t test_bind_row(void* ctx, widget_t* row, uint32_t index) {
+  list_view_test_ctx_t* test = (list_view_test_ctx_t*)ctx;
+
+  test->bound++;
+  test->last_index = index;
+  row->style_type = index & 0xff;
+
+  return RET_OK;
+}
+
+static wh_t test_get_row_height(void* ctx, uint32_t index) {
+  return 20 + (index % 3) * 10;
+}
+
+static list_view_data_source_t test_data_source(list_view_test_ctx_t* test, bool_t measured) {
+  list_view_data_source_t ds;
+
+  memset(&ds, 0x00, sizeof(ds));
+  ds.create_row = test_create_row;
+  ds.bind_row = test_bind_row;
+  ds.get_row_height = measured ? test_get_row_height : NULL;
+  ds.ctx = test;
+
+  return ds;
+}
+
+TEST(ListView, fixed) {
+  list_view_test_ctx_t test;
+  list_view_data_source_t ds;
+  widget_t* w = list_view_create(NULL, 0, 0, 100, 300);
+
+  memset(&test, 0x00, sizeof(test));
+  ds = test_data_source(&test, FALSE);
+
+  ASSERT_EQ(list_view_set_row_height(w, 30), RET_OK);
+  ASSERT_EQ(list_view_set_overscan(w, 2), RET_OK);
+  ASSERT_EQ(list_view_set_data_source(w, &ds), RET_OK);
+  ASSERT_EQ(list_view_set_rows_nr(w, 1000), RET_OK);
+
+  /*10行可见，后面预留2行，再多分配3个槽位。*/
+  ASSERT_EQ(test.created, 15);
+  ASSERT_EQ(test.bound, 12);
+  ASSERT_EQ(list_view_get_row_offset(w, 10), 300);
+  ASSERT_EQ(list_view_get_row_at(w, 299), 9);
+  ASSERT_EQ(list_view_get_row_at(w, 300), 10);
+
+  /*每滚动一行只需要重新绑定一行。*/
+  test.bound = 0;
+  ASSERT_EQ(list_view_scroll_to(w, 30), RET_OK);
+  ASSERT_EQ(test.bound, 1);
+  ASSERT_EQ(test.last_index, 12);
+
+  test.bound = 0;
+  ASSERT_EQ(list_view_scroll_to(w, 90), RET_OK);
+  ASSERT_EQ(test.bound, 2);
+  ASSERT_EQ(test.last_index, 14);
+  ASSERT_EQ(test.created, 15);
+
+  ASSERT_EQ(list_view_scroll_to(w, 1000000), RET_OK);
+  ASSERT_EQ(LIST_VIEW(w)->offset, 1000 * 30 - 300);
+  ASSERT_EQ(list_view_scroll_to(w, -10), RET_OK);
+  ASSERT_EQ(LIST_VIEW(w)->offset, 0);
+
+  widget_destroy(w);
+}
+
+TEST(ListView, measured) {
+  uint32_t i = 0;
+  int32_t offset = 0;
+  list_view_test_ctx_t test;
+  list_view_data_source_t ds;
+  widget_t* w = list_view_create(NULL, 0, 0, 100, 300);
+
+  memset(&test, 0x00, sizeof(test));
+  ds = test_data_source(&test, TRUE);
+  ASSERT_EQ(list_view_set_data_source(w, &ds), RET_OK);
+  ASSERT_EQ(list_view_set_rows_nr(w, 1001), RET_OK);
+
+  for (i = 0; i <= 1001; i++) {
+    ASSERT_EQ(list_view_get_row_offset(w, i), offset);
+    if (i < 1001) {
+      ASSERT_EQ(list_view_get_row_at(w, offset), i);
+      ASSERT_EQ(list_view_get_row_at(w, offset + test_get_row_height(NULL, i) - 1), i);
+      offset += test_get_row_height(NULL, i);
+    }
+  }
+
+  ASSERT_EQ(list_view_scroll_to_row(w, 500), RET_OK);
+  ASSERT_EQ(LIST_VIEW(w)->offset, list_view_get_row_offset(w, 500));
+
+  widget_destroy(w);
+}
+
+static widget_t* test_create_table_row(void* ctx, widget_t* list_view) {
+  widget_t* row = test_create_row(ctx, list_view);
+
+  label_create(row, 0, 0, 0, 0);
+  label_create(row, 0, 0, 0, 0);
+  label_create(row, 0, 0, 0, 0);
+
+  return row;
+}
+
+TEST(ListView, columns) {
+  wh_t widths[] = {40, 30, 0};
+  list_view_test_ctx_t test;
+  list_view_data_source_t ds;
+  widget_t* w = list_view_create(NULL, 0, 0, 100, 300);
+
+  memset(&test, 0x00, sizeof(test));
+  ds = test_data_source(&test, FALSE);
+  ds.create_row = test_create_table_row;
+
+  ASSERT_EQ(list_view_set_data_source(w, &ds), RET_OK);
+  ASSERT_EQ(list_view_set_rows_nr(w, 1000), RET_OK);
+  ASSERT_EQ(list_view_set_columns(w, widths, 3), RET_OK);
+  ASSERT_EQ(LIST_VIEW(w)->cols_nr, 3);
+
+  for (uint32_t i = 0; i < 10; i++) {
+    widget_t* row = (widget_t*)(w->children->elms[i]);
+    widget_t* c0 = (widget_t*)(row->children->elms[0]);
+    widget_t* c1 = (widget_t*)(row->children->elms[1]);
+    widget_t* c2 = (widget_t*)(row->children->elms[2]);
+
+    ASSERT_EQ(c0->x, 0);
+    ASSERT_EQ(c0->w, 40);
+    ASSERT_EQ(c1->x, 40);
+    ASSERT_EQ(c1->w, 30);
+    /*最后一列占满剩余的宽度。*/
+    ASSERT_EQ(c2->x, 70);
+    ASSERT_EQ(c2->w, 30);
+    ASSERT_EQ(c2->h, row->h);
+  }
+
+  /*滚动后重新绑定的行也按列排列。*/
+  ASSERT_EQ(list_view_scroll_to(w, 3000), RET_OK);
+  for (uint32_t i = 0; i < LIST_VIEW(w)->slots_nr; i++) {
+    widget_t* row = (widget_t*)(w->children->elms[i]);
+    widget_t* c2 = (widget_t*)(row->children->elms[2]);
+    if (row->visible) {
+      ASSERT_EQ(c2->x, 70);
+      ASSERT_EQ(c2->w, 30);
+    }
+  }
+
+  ASSERT_EQ(list_view_set_columns(w, NULL, 0), RET_OK);
+  ASSERT_EQ(LIST_VIEW(w)->cols_nr, 0);
+
+  widget_destroy(w);
+}
+
+TEST(ListView, create_row_fail) {
+  list_view_test_ctx_t test;
+  list_view_data_source_t ds;
+  widget_t* w = list_view_create(NULL, 0, 0, 100, 300);
+
+  memset(&test, 0x00, sizeof(test));
+  test.max_rows = 5;
+  ds = test_data_source(&test, FALSE);
+
+  ASSERT_EQ(list_view_set_row_height(w, 30), RET_OK);
+  ASSERT_EQ(list_view_set_data_source(w, &ds), RET_OK);
+  ASSERT_NE(list_view_set_rows_nr(w, 1000), RET_OK);
+
+  /*创建到一半失败，已经创建的槽位都是空的。*/
+  ASSERT_EQ(LIST_VIEW(w)->slots_nr, 5);
+  for (uint32_t i = 0; i < LIST_VIEW(w)->slots_nr; i++) {
+    ASSERT_EQ(LIST_VIEW(w)->slots[i], -1);
+  }
+
+  /*之后可以继续创建。*/
+  test.max_rows = 0;
+  ASSERT_EQ(list_view_scroll_to(w, 300), RET_OK);
+  ASSERT_EQ(LIST_VIEW(w)->slots_nr > 10, true);
+  ASSERT_EQ(test.last_index > 10, true);
+
+  ASSERT_EQ(list_view_update_row_height(NULL, 0), RET_BAD_PARAMS);
+
+  widget_destroy(w);
+}
+
+TEST(ListView, fling_100k) {
+  uint32_t now = 0;
+  uint32_t frames = 0;
+  uint32_t start = 0;
+  uint32_t cost = 0;
+  list_view_test_ctx_t test;
+  list_view_data_source_t ds;
+  list_view_t* list_view = NULL;
+  frame_scheduler_t* old_fs = frame_scheduler();
+  frame_scheduler_t* fs = frame_scheduler_create(16);
+  widget_t* w = list_view_create(NULL, 0, 0, 320, 480);
+
+  memset(&test, 0x00, sizeof(test));
+  ds = test_data_source(&test, TRUE);
+  list_view = LIST_VIEW(w);
+  frame_scheduler_set(fs);
+  ASSERT_EQ(list_view_set_data_source(w, &ds), RET_OK);
+  ASSERT_EQ(list_view_set_rows_nr(w, 100000), RET_OK);
+
+  /*初速度足够滑过全部约3000000像素，由帧调度器按16ms的虚拟时钟驱动惯性滚动。*/
+  start = time_now_ms();
+  ASSERT_EQ(list_view_fling(w, 120.0f), RET_OK);
+  now = list_view->last_time;
+  while (list_view->timer_id != 0 && frames < 100000) {
+    now += 16;
+    frame_scheduler_run_frame(fs, now, NULL, NULL);
+    frames++;
+  }
+  cost = time_now_ms() - start;
+  log_debug("fling through 100000 rows: %u frames %u ms\n", frames, cost);
+
+  ASSERT_EQ(list_view->timer_id, 0);
+  ASSERT_EQ(list_view->offset, list_view->total_height - w->h);
+
+  /*行控件的个数只和可见的行数有关。*/
+  ASSERT_EQ(test.created, list_view->slots_nr);
+  ASSERT_EQ(w->children->size, list_view->slots_nr);
+  ASSERT_LE(list_view->slots_nr, 480 / 20 + 2 + 3 * list_view->overscan + 1);
+  ASSERT_EQ(test.last_index, 99999);
+
+  widget_destroy(w);
+  frame_scheduler_set(old_fs);
+  frame_scheduler_destroy(fs);
+}
@@ -35,6 +35,7 @@
 #include "base/font_manager.h"
 #include "base/image_manager.h"
 #include "base/window_manager.h"
+#include "base/frame_scheduler.h"
 #include "base/resource_manager.h"
 
 #ifdef WITH_STB_FONT
@@ -61,11 +62,13 @@ GTEST_API_ int main(int argc, char** argv) {
 #endif /*WITH_STB_IMAGE*/
   font_manager_set(font_manager_create());
   window_manager_set(window_manager_create());
+  frame_scheduler_set(frame_scheduler_create(16));
 
   resource_init();
   tk_init_resources();
   RUN_ALL_TESTS();
 
+  frame_scheduler_destroy(frame_scheduler());
   font_manager_destroy(font_manager());
   resource_manager_destroy(resource_manager());
 
@@ -0,0 +1,91 @@
+#include "base/idle.h"
+#include "base/time.h"
+#include "base/view.h"
+#include "base/timer.h"
+#include "base/window.h"
+#include "base/window_manager.h"
+#include "main_loop/main_loop_headless.h"
+#include "gtest/gtest.h"
+#include <vector>
+
+static ret_t test_on_frame(void* ctx, const headless_frame_t* frame) {
+  std::vector<headless_frame_t>* frames = (std::vector<headless_frame_t>*)ctx;
+
+  frames->push_back(*frame);
+
+  return RET_OK;
+}
+
+static ret_t test_on_timer(const timer_info_t* timer) {
+  *(uint32_t*)(timer->ctx) = time_now_ms();
+
+  return RET_REMOVE;
+}
+
+typedef struct _test_down_ctx_t {
+  widget_t* view;
+  uint32_t downs;
+} test_down_ctx_t;
+
+static ret_t test_on_pointer_down(void* ctx, event_t* e) {
+  test_down_ctx_t* info = (test_down_ctx_t*)ctx;
+
+  widget_invalidate(info->view, NULL);
+  info->downs++;
+
+  return RET_OK;
+}
+
+TEST(MainLoopHeadless, basic) {
+  uint32_t fired = 0;
+  test_down_ctx_t down;
+  widget_t* win = NULL;
+  widget_t* view = NULL;
+  std::vector<headless_frame_t> frames;
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  main_loop_t* l = NULL;
+
+  window_manager_set(wm);
+  l = main_loop_headless_create(200, 100);
+  ASSERT_TRUE(l != NULL);
+  ASSERT_EQ(wm->w, 200);
+  main_loop_headless_set_on_frame(l, test_on_frame, &frames);
+
+  win = window_create(wm, 0, 0, 200, 100);
+  view = view_create(win, 10, 10, 50, 50);
+  down.view = view;
+  down.downs = 0;
+  widget_on(view, EVT_POINTER_DOWN, test_on_pointer_down, &down);
+  idle_dispatch();
+
+  /*time_now_ms和定时器都由虚拟时钟驱动。*/
+  ASSERT_EQ(time_now_ms(), MAIN_LOOP_HEADLESS_START_TIME);
+  timer_add(test_on_timer, &fired, 100);
+  ASSERT_EQ(main_loop_headless_step(l, 1000), RET_OK);
+  ASSERT_EQ(main_loop_headless_now(), MAIN_LOOP_HEADLESS_START_TIME + 1000);
+  ASSERT_EQ(time_now_ms(), MAIN_LOOP_HEADLESS_START_TIME + 1000);
+  ASSERT_GE(fired, MAIN_LOOP_HEADLESS_START_TIME + 100);
+  ASSERT_LT(fired, MAIN_LOOP_HEADLESS_START_TIME + 100 + 16);
+
+  /*只有第一帧需要绘制(整个屏幕)。*/
+  ASSERT_EQ(frames.size(), 1);
+  ASSERT_EQ(frames[0].index, 0);
+  ASSERT_EQ(frames[0].time, MAIN_LOOP_HEADLESS_START_TIME);
+  ASSERT_EQ(frames[0].dirty.w, 200);
+  ASSERT_EQ(frames[0].dirty.h, 100);
+
+  ASSERT_EQ(main_loop_headless_pointer(l, EVT_POINTER_DOWN, 20, 20), RET_OK);
+  ASSERT_EQ(main_loop_headless_pointer(l, EVT_POINTER_UP, 20, 20), RET_OK);
+  ASSERT_EQ(down.downs, 1);
+  ASSERT_EQ(main_loop_headless_step(l, 0), RET_OK);
+  ASSERT_EQ(frames.size(), 2);
+  ASSERT_EQ(frames[1].index, 1);
+  ASSERT_EQ(frames[1].dirty.x, 10);
+  ASSERT_EQ(frames[1].dirty.w, 50);
+
+  widget_destroy(win);
+  main_loop_destroy(l);
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+}
@@ -0,0 +1,153 @@
+#include "base/time.h"
+#include "base/timer.h"
+#include "base/canvas.h"
+#include "base/window.h"
+#include "base/perf_stats.h"
+#include "base/window_manager.h"
+#include "lcd/lcd_mem.h"
+#include "gtest/gtest.h"
+
+static uint32_t s_now = 0;
+
+static uint32_t test_now(void) {
+  return s_now;
+}
+
+TEST(PerfStats, pixels) {
+  rect_t r;
+  canvas_t canvas;
+  perf_stats_t* s = NULL;
+  font_manager_t font_manager;
+  point_t points[] = {{0, 0}, {1, 1}, {2, 2}};
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+
+  ASSERT_EQ(perf_stats_reset(), RET_OK);
+  rect_init(r, 0, 0, 100, 100);
+  canvas_begin_frame(c, &r, LCD_DRAW_NORMAL);
+  canvas_set_fill_color(c, color_init(0xff, 0, 0, 0xff));
+  canvas_fill_rect(c, 0, 0, 10, 20);
+  canvas_set_stroke_color(c, color_init(0xff, 0, 0, 0x80));
+  canvas_draw_points(c, points, ARRAY_SIZE(points));
+  rect_init(r, 0, 0, 50, 50);
+  lcd_scroll(lcd, &r, 0, 10);
+  canvas_end_frame(c);
+  perf_stats_add(PERF_COUNTER_DIRTY_PIXELS, 100 * 100);
+
+  /*像素计数器在perf_stats_on_frame时算作这一帧的。*/
+  s = perf_stats_get();
+  ASSERT_EQ(s->pixels_filled, 0);
+
+  ASSERT_EQ(perf_stats_on_frame(0, 1500), RET_OK);
+  s = perf_stats_get();
+  ASSERT_EQ(s->frames, 1);
+  ASSERT_EQ(s->paint_time, 1500);
+  ASSERT_EQ(s->dirty_pixels, 100 * 100);
+  ASSERT_EQ(s->pixels_filled, 10 * 20);
+  ASSERT_EQ(s->pixels_blended, 3);
+  ASSERT_EQ(s->pixels_copied, 50 * 40);
+
+  ASSERT_EQ(perf_stats_on_frame(16, 500), RET_OK);
+  s = perf_stats_get();
+  ASSERT_EQ(s->frames, 2);
+  ASSERT_EQ(s->paint_time, 500);
+  ASSERT_EQ(s->max_paint_time, 1500);
+  ASSERT_EQ(s->dirty_pixels, 0);
+  ASSERT_EQ(s->pixels_filled, 0);
+
+  lcd_destroy(lcd);
+}
+
+TEST(PerfStats, fps) {
+  uint32_t i = 0;
+
+  ASSERT_EQ(perf_stats_reset(), RET_OK);
+  for (i = 0; i < 63; i++) {
+    perf_stats_on_frame(1000 + i * 16, 0);
+  }
+  ASSERT_EQ(perf_stats_get()->fps, 0);
+
+  /*63个间隔，1008毫秒。*/
+  perf_stats_on_frame(1000 + 63 * 16, 0);
+  ASSERT_EQ(perf_stats_get()->fps, 62);
+
+  /*空闲了很久之后的一帧。*/
+  perf_stats_on_frame(10000, 0);
+  ASSERT_EQ(perf_stats_get()->fps, 0);
+}
+
+TEST(PerfStats, counters) {
+  perf_stats_t* s = NULL;
+
+  ASSERT_EQ(perf_stats_reset(), RET_OK);
+  ASSERT_EQ(perf_stats_add(PERF_COUNTER_NR, 1), RET_BAD_PARAMS);
+  perf_stats_add(PERF_COUNTER_GLYPH_HITS, 3);
+  perf_stats_add(PERF_COUNTER_GLYPH_MISSES, 1);
+  perf_stats_add(PERF_COUNTER_IMAGE_MISSES, 2);
+  perf_stats_add(PERF_COUNTER_TIMERS_FIRED, 5);
+
+  s = perf_stats_get();
+  ASSERT_EQ(s->glyph_hits, 3);
+  ASSERT_EQ(s->glyph_misses, 1);
+  ASSERT_EQ(s->glyph_hit_rate, 75);
+  ASSERT_EQ(s->image_hits, 0);
+  ASSERT_EQ(s->image_hit_rate, 0);
+  ASSERT_EQ(s->timers_fired, 5);
+  ASSERT_EQ(s->timer_count, timer_count());
+  ASSERT_LE(s->mem_fragmentation, 100);
+
+  /*还没有访问过缓存。*/
+  ASSERT_EQ(perf_stats_reset(), RET_OK);
+  ASSERT_EQ(perf_stats_get()->glyph_hit_rate, 100);
+  ASSERT_EQ(perf_stats_get()->timers_fired, 0);
+}
+
+TEST(PerfStats, overlay) {
+  color_t color;
+  canvas_t canvas;
+  font_manager_t font_manager;
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  window_manager_t* w = WINDOW_MANAGER(wm);
+  widget_t* win = NULL;
+
+  s_now = 5000;
+  time_set_source(test_now);
+  window_manager_set(wm);
+  window_manager_resize(wm, 100, 100);
+  win = window_create(wm, 0, 0, 100, 100);
+  ASSERT_EQ(window_manager_paint(wm, c), RET_OK);
+  ASSERT_FALSE(window_manager_need_paint(wm));
+
+  ASSERT_EQ(window_manager_set_show_perf_stats(wm, TRUE), RET_OK);
+  ASSERT_TRUE(window_manager_need_paint(wm));
+  ASSERT_EQ(window_manager_paint(wm, c), RET_OK);
+  ASSERT_EQ(strncmp(w->perf_stats_text[0], "fps ", 4), 0);
+  color = lcd_get_point_color(lcd, 1, 1);
+  ASSERT_EQ(color.rgba.r, 0);
+  ASSERT_EQ(color.rgba.g, 0);
+  ASSERT_EQ(color.rgba.b, 0);
+
+  /*每秒更新一次。*/
+  ASSERT_FALSE(window_manager_need_paint(wm));
+  s_now += 999;
+  ASSERT_FALSE(window_manager_need_paint(wm));
+  s_now += 1;
+  ASSERT_TRUE(window_manager_need_paint(wm));
+  ASSERT_EQ(window_manager_paint(wm, c), RET_OK);
+  ASSERT_EQ(w->perf_stats_time, s_now);
+  ASSERT_FALSE(window_manager_need_paint(wm));
+
+  ASSERT_EQ(window_manager_set_show_perf_stats(wm, FALSE), RET_OK);
+  ASSERT_EQ(window_manager_paint(wm, c), RET_OK);
+  s_now += 2000;
+  ASSERT_FALSE(window_manager_need_paint(wm));
+
+  time_set_source(NULL);
+  widget_destroy(win);
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
@@ -0,0 +1,237 @@
+#include "base/fs.h"
+#include "base/mem.h"
+#include "base/platform.h"
+#include "base/button.h"
+#include "base/profiler.h"
+#include "base/window.h"
+#include "lcd/lcd_mem.h"
+#include "gtest/gtest.h"
+#include <string>
+
+static void test_busy_wait(uint32_t us) {
+  uint64_t end = get_time_us() + us;
+
+  while (get_time_us() < end) {
+  }
+}
+
+TEST(Profiler, disabled) {
+  profiler_event_t events[4];
+
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+  ASSERT_FALSE(profiler_is_enabled());
+  ASSERT_EQ(profiler_begin("a", NULL), RET_OK);
+  ASSERT_EQ(profiler_end(), RET_OK);
+  ASSERT_EQ(profiler_get_events(events, 4), 0);
+
+  /*开始记录之前进入的作用域没有入栈，多余的profiler_end被忽略。*/
+  ASSERT_EQ(profiler_start(4), RET_OK);
+  ASSERT_EQ(profiler_end(), RET_OK);
+  ASSERT_EQ(profiler_get_events(events, 4), 0);
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+}
+
+TEST(Profiler, nested) {
+  profiler_event_t events[8];
+
+  ASSERT_EQ(profiler_start(8), RET_OK);
+  ASSERT_TRUE(profiler_is_enabled());
+
+  profiler_begin("outer", "win");
+  test_busy_wait(1000);
+  profiler_begin("inner", NULL);
+  test_busy_wait(2000);
+  profiler_end();
+  profiler_end();
+
+  ASSERT_EQ(profiler_get_events(events, 8), 2);
+  ASSERT_STREQ(events[0].name, "inner");
+  ASSERT_EQ(events[0].depth, 1);
+  ASSERT_EQ(events[0].self, events[0].duration);
+  ASSERT_GE(events[0].duration, 2000);
+
+  ASSERT_STREQ(events[1].name, "outer");
+  ASSERT_STREQ(events[1].detail, "win");
+  ASSERT_EQ(events[1].depth, 0);
+  ASSERT_EQ(events[1].tid, events[0].tid);
+  ASSERT_LE(events[1].start, events[0].start);
+  ASSERT_GE(events[1].duration, 3000);
+  ASSERT_EQ(events[1].self, events[1].duration - events[0].duration);
+
+  ASSERT_EQ(profiler_stop(), RET_OK);
+  profiler_begin("ignored", NULL);
+  profiler_end();
+  ASSERT_EQ(profiler_get_events(events, 8), 2);
+
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+}
+
+TEST(Profiler, ring) {
+  uint32_t i = 0;
+  profiler_event_t events[8];
+  static const char* names[] = {"0", "1", "2", "3", "4", "5"};
+
+  ASSERT_EQ(profiler_start(4), RET_OK);
+  for (i = 0; i < 6; i++) {
+    profiler_begin(names[i], NULL);
+    profiler_end();
+  }
+
+  ASSERT_EQ(profiler_get_events(events, 8), 4);
+  for (i = 0; i < 4; i++) {
+    ASSERT_STREQ(events[i].name, names[i + 2]);
+  }
+
+  ASSERT_EQ(profiler_get_events(events, 2), 2);
+  ASSERT_STREQ(events[0].name, "2");
+
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+}
+
+TEST(Profiler, toggle) {
+  profiler_event_t events[4];
+
+  /*没有开始记录时PROFILER_BEGIN调用profiler_skip，中途开始记录，外层作用域也不会错位。*/
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+  ASSERT_EQ(profiler_skip(), RET_OK);
+  ASSERT_EQ(profiler_start(4), RET_OK);
+  profiler_begin("inner", NULL);
+  profiler_end();
+  profiler_end();
+
+  ASSERT_EQ(profiler_get_events(events, 4), 1);
+  ASSERT_STREQ(events[0].name, "inner");
+  ASSERT_EQ(events[0].depth, 1);
+
+  /*中途停止记录，离开作用域时不再记录。*/
+  profiler_begin("outer", NULL);
+  ASSERT_EQ(profiler_stop(), RET_OK);
+  profiler_end();
+  ASSERT_EQ(profiler_get_events(events, 4), 1);
+
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+}
+
+TEST(Profiler, restart) {
+  profiler_event_t events[8];
+
+  ASSERT_EQ(profiler_start(4), RET_OK);
+  profiler_begin("a", NULL);
+  profiler_end();
+  ASSERT_EQ(profiler_get_events(events, 8), 1);
+
+  /*大小不变时重用缓冲区，之前的事件被清掉。*/
+  ASSERT_EQ(profiler_start(4), RET_OK);
+  ASSERT_EQ(profiler_get_events(events, 8), 0);
+
+  /*大小改变时换新的缓冲区，旧的留到profiler_deinit释放。*/
+  profiler_begin("b", NULL);
+  ASSERT_EQ(profiler_start(8), RET_OK);
+  profiler_end();
+  profiler_begin("c", NULL);
+  profiler_end();
+  ASSERT_EQ(profiler_get_events(events, 8), 2);
+  ASSERT_STREQ(events[0].name, "b");
+  ASSERT_STREQ(events[1].name, "c");
+
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+  ASSERT_EQ(profiler_get_events(events, 8), 0);
+}
+
+TEST(Profiler, stats) {
+  uint32_t i = 0;
+  profiler_stat_t stats[4];
+
+  ASSERT_EQ(profiler_start(64), RET_OK);
+  for (i = 0; i < 3; i++) {
+    profiler_begin("widget_paint", "button");
+    test_busy_wait(100);
+    profiler_end();
+  }
+
+  profiler_begin("widget_paint", "label");
+  test_busy_wait(2000);
+  profiler_begin("lcd_fill_rect", NULL);
+  profiler_end();
+  profiler_end();
+
+  ASSERT_EQ(profiler_get_stats("widget_paint", stats, 4), 2);
+  ASSERT_STREQ(stats[0].detail, "label");
+  ASSERT_EQ(stats[0].count, 1);
+  ASSERT_STREQ(stats[1].detail, "button");
+  ASSERT_EQ(stats[1].count, 3);
+  ASSERT_GE(stats[1].total, 300);
+  ASSERT_GE(stats[1].total, stats[1].max);
+  ASSERT_EQ(stats[1].total, stats[1].self);
+
+  ASSERT_EQ(profiler_get_stats(NULL, stats, 4), 3);
+  ASSERT_EQ(profiler_get_stats(NULL, stats, 1), 1);
+  ASSERT_STREQ(stats[0].detail, "label");
+
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+}
+
+#ifdef WITH_PROFILER
+TEST(Profiler, widgetPaint) {
+  canvas_t canvas;
+  profiler_stat_t stats[8];
+  font_manager_t font_manager;
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  widget_t* win = window_create(NULL, 0, 0, 100, 100);
+  widget_t* b1 = button_create(win, 0, 0, 50, 30);
+  widget_t* b2 = button_create(win, 0, 50, 50, 30);
+  rect_t r;
+
+  rect_init(r, 0, 0, 100, 100);
+  (void)b1;
+  (void)b2;
+  ASSERT_EQ(profiler_start(256), RET_OK);
+  canvas_begin_frame(c, &r, LCD_DRAW_NORMAL);
+  widget_paint(win, c);
+  canvas_end_frame(c);
+  profiler_stop();
+
+  ASSERT_EQ(profiler_get_stats("widget_paint", stats, 8), 2);
+  for (uint32_t i = 0; i < 2; i++) {
+    if (strcmp(stats[i].detail, "button") == 0) {
+      ASSERT_EQ(stats[i].count, 2);
+    } else {
+      ASSERT_STREQ(stats[i].detail, "window");
+      ASSERT_EQ(stats[i].count, 1);
+    }
+  }
+  ASSERT_GE(profiler_get_stats("lcd_begin_frame", stats, 8), 1);
+
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+  widget_destroy(win);
+  lcd_destroy(lcd);
+}
+#endif /*WITH_PROFILER*/
+
+TEST(Profiler, chromeTrace) {
+  uint32_t size = 0;
+  char* data = NULL;
+  const char* filename = "profiler_test.json";
+
+  ASSERT_EQ(profiler_start(8), RET_OK);
+  profiler_begin("widget_paint", "\"button\"");
+  profiler_begin("lcd_draw_image", NULL);
+  profiler_end();
+  profiler_end();
+  ASSERT_EQ(profiler_export_chrome_trace(filename), RET_OK);
+
+  data = (char*)fs_read_file(filename, &size);
+  ASSERT_TRUE(data != NULL);
+  std::string str(data, size);
+  ASSERT_EQ(str.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+  ASSERT_NE(str.find("\"name\":\"lcd_draw_image\""), std::string::npos);
+  ASSERT_NE(str.find("\"name\":\"widget_paint\",\"cat\":\"awtk\",\"ph\":\"X\",\"ts\":0,"),
+            std::string::npos);
+  ASSERT_NE(str.find("\"detail\":\"button\""), std::string::npos);
+  ASSERT_EQ(str.find("]}"), size - 3);
+
+  TKMEM_FREE(data);
+  fs_unlink(filename);
+  ASSERT_EQ(profiler_deinit(), RET_OK);
+}
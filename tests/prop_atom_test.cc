@@ -0,0 +1,35 @@
+#include "base/prop_atom.h"
+#include "gtest/gtest.h"
+
+TEST(PropAtom, builtin) {
+  ASSERT_EQ(prop_atom_lookup(WIDGET_PROP_X), PROP_ATOM_X);
+  ASSERT_EQ(prop_atom_lookup(WIDGET_PROP_TEXT), PROP_ATOM_TEXT);
+  ASSERT_EQ(prop_atom_lookup(WIDGET_PROP_LAYOUT), PROP_ATOM_LAYOUT);
+  ASSERT_EQ(prop_atom_intern(WIDGET_PROP_VALUE), PROP_ATOM_VALUE);
+
+  ASSERT_EQ(strcmp(prop_atom_name(PROP_ATOM_ANIM_HINT), WIDGET_PROP_ANIM_HINT), 0);
+  ASSERT_EQ(prop_atom_name(PROP_ATOM_NONE) == NULL, true);
+
+  ASSERT_EQ(prop_atom_is_builtin(PROP_ATOM_Y), true);
+  ASSERT_EQ(prop_atom_is_builtin(PROP_ATOM_NONE), false);
+  ASSERT_EQ(prop_atom_is_builtin(PROP_ATOM_BUILTIN_NR), false);
+}
+
+TEST(PropAtom, intern) {
+  prop_atom_t a = PROP_ATOM_NONE;
+  prop_atom_t b = PROP_ATOM_NONE;
+
+  ASSERT_EQ(prop_atom_lookup("prop_atom_test_a"), PROP_ATOM_NONE);
+  a = prop_atom_intern("prop_atom_test_a");
+  ASSERT_EQ(a >= PROP_ATOM_BUILTIN_NR, true);
+  ASSERT_EQ(prop_atom_lookup("prop_atom_test_a"), a);
+  ASSERT_EQ(prop_atom_intern("prop_atom_test_a"), a);
+  ASSERT_EQ(strcmp(prop_atom_name(a), "prop_atom_test_a"), 0);
+
+  b = prop_atom_intern("prop_atom_test_b");
+  ASSERT_NE(a, b);
+  ASSERT_EQ(prop_atom_lookup("prop_atom_test_b"), b);
+
+  ASSERT_EQ(prop_atom_intern(""), PROP_ATOM_NONE);
+  ASSERT_EQ(prop_atom_name(b + 1) == NULL, true);
+}
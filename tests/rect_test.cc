@@ -22,3 +22,20 @@ TEST(Rect, contains) {
   ASSERT_EQ(rect_contains(&r, 5, 24), FALSE);
   ASSERT_EQ(rect_contains(&r, 5, 240), FALSE);
 }
+
+TEST(Rect, intersect) {
+  rect_t dr;
+  rect_t r;
+  rect_init(dr, 0, 0, 100, 100);
+  rect_init(r, 50, 60, 80, 30);
+  ASSERT_EQ(rect_intersect(&dr, &r), RET_OK);
+  ASSERT_EQ(dr.x, 50);
+  ASSERT_EQ(dr.y, 60);
+  ASSERT_EQ(dr.w, 50);
+  ASSERT_EQ(dr.h, 30);
+
+  rect_init(r, 200, 200, 10, 10);
+  ASSERT_EQ(rect_intersect(&dr, &r), RET_OK);
+  ASSERT_EQ(dr.w, 0);
+  ASSERT_EQ(dr.h, 0);
+}
@@ -0,0 +1,234 @@
+#include "base/view.h"
+#include "base/canvas.h"
+#include "base/widget_cache.h"
+#include "base/atomic.h"
+#include "base/render_thread.h"
+#include "lcd/lcd_mem.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <thread>
+
+#define LCD_W 200
+#define LCD_H 200
+
+static void test_draw_frame(canvas_t* c, uint32_t i) {
+  rect_t r;
+  point_t points[] = {{10, 10}, {20, 20}};
+
+  rect_init(r, 0, 0, LCD_W, LCD_H);
+  canvas_begin_frame(c, &r, LCD_DRAW_NORMAL);
+  canvas_set_fill_color(c, color_init(i * 10, 0, 0, 0xff));
+  canvas_fill_rect(c, 0, 0, LCD_W, LCD_H);
+  canvas_set_fill_color(c, color_init(0, i * 20, 0, 0xff));
+  canvas_fill_rect(c, i, i, 50, 50);
+  canvas_set_stroke_color(c, color_init(0, 0, i * 30, 0xff));
+  canvas_draw_hline(c, 0, 100 + i, LCD_W);
+  canvas_draw_vline(c, 100 + i, 0, LCD_H);
+  canvas_draw_points(c, points, ARRAY_SIZE(points));
+  canvas_end_frame(c);
+}
+
+static lcd_t* test_create_lcd(void) {
+  lcd_t* lcd = lcd_mem_create(LCD_W, LCD_H, TRUE);
+  memset(((lcd_mem_t*)lcd)->pixels, 0x00, LCD_W * LCD_H * 4);
+
+  return lcd;
+}
+
+static bool_t test_same_pixels(lcd_t* a, lcd_t* b) {
+  return memcmp(((lcd_mem_t*)a)->pixels, ((lcd_mem_t*)b)->pixels, LCD_W * LCD_H * 4) == 0;
+}
+
+TEST(RenderThread, basic) {
+  canvas_t c;
+  canvas_t ref_c;
+  uint32_t i = 0;
+  font_manager_t font_manager;
+  lcd_t* ref = test_create_lcd();
+  lcd_t* target = test_create_lcd();
+  render_thread_t* rt = render_thread_create(target, 1);
+
+  ASSERT_TRUE(rt != NULL);
+  font_manager_init(&font_manager);
+  canvas_init(&c, &(rt->lcd), &font_manager);
+  canvas_init(&ref_c, ref, &font_manager);
+
+  for (i = 0; i < 8; i++) {
+    test_draw_frame(&c, i);
+    test_draw_frame(&ref_c, i);
+  }
+
+  /*渲染线程显示的结果与直接绘制的相同。*/
+  ASSERT_EQ(render_thread_flush(rt), RET_OK);
+  ASSERT_EQ(rt->submitted, 8);
+  ASSERT_EQ(rt->presented, 8);
+  ASSERT_EQ(rt->syncs, 0);
+  ASSERT_EQ(test_same_pixels(target, ref), TRUE);
+
+  lcd_destroy(&(rt->lcd));
+  lcd_destroy(target);
+  lcd_destroy(ref);
+}
+
+TEST(RenderThread, sync) {
+  rect_t r;
+  canvas_t c;
+  canvas_t ref_c;
+  font_manager_t font_manager;
+  color_t red = color_init(0xff, 0, 0, 0xff);
+  lcd_t* ref = test_create_lcd();
+  lcd_t* target = test_create_lcd();
+  render_thread_t* rt = render_thread_create(target, 2);
+
+  font_manager_init(&font_manager);
+  canvas_init(&c, &(rt->lcd), &font_manager);
+  canvas_init(&ref_c, ref, &font_manager);
+  test_draw_frame(&c, 1);
+  test_draw_frame(&ref_c, 1);
+
+  /*读取像素时，本帧已经录制的命令先绘制到target上，余下的部分直接绘制。*/
+  rect_init(r, 0, 0, LCD_W, LCD_H);
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  canvas_set_fill_color(&c, red);
+  canvas_fill_rect(&c, 0, 0, 10, 10);
+  ASSERT_EQ(lcd_get_point_color(&(rt->lcd), 5, 5).color, red.color);
+  ASSERT_EQ(rt->syncs, 1);
+  canvas_fill_rect(&c, 190, 190, 10, 10);
+  canvas_end_frame(&c);
+
+  canvas_begin_frame(&ref_c, &r, LCD_DRAW_NORMAL);
+  canvas_set_fill_color(&ref_c, red);
+  canvas_fill_rect(&ref_c, 0, 0, 10, 10);
+  canvas_fill_rect(&ref_c, 190, 190, 10, 10);
+  canvas_end_frame(&ref_c);
+
+  /*之后的帧仍然交给渲染线程。*/
+  test_draw_frame(&c, 2);
+  test_draw_frame(&ref_c, 2);
+  render_thread_flush(rt);
+  ASSERT_EQ(rt->submitted, 2);
+  ASSERT_EQ(rt->syncs, 1);
+  ASSERT_EQ(test_same_pixels(target, ref), TRUE);
+
+  lcd_destroy(&(rt->lcd));
+  lcd_destroy(target);
+  lcd_destroy(ref);
+}
+
+typedef struct _slow_lcd_t {
+  lcd_t lcd;
+  uint32_t frames;
+} slow_lcd_t;
+
+static ret_t slow_lcd_begin_frame(lcd_t* lcd, rect_t* dirty_rect) {
+  lcd->dirty_rect = dirty_rect;
+
+  return RET_OK;
+}
+
+static ret_t slow_lcd_fill_rect(lcd_t* lcd, xy_t x, xy_t y, wh_t w, wh_t h) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  return RET_OK;
+}
+
+static ret_t slow_lcd_end_frame(lcd_t* lcd) {
+  ((slow_lcd_t*)lcd)->frames++;
+
+  return RET_OK;
+}
+
+/*渲染线程来不及处理时，GUI线程等待，最多有frames_nr帧没有显示。*/
+TEST(RenderThread, framesInFlight) {
+  rect_t r;
+  canvas_t c;
+  uint32_t i = 0;
+  slow_lcd_t slow;
+  font_manager_t font_manager;
+  render_thread_t* rt = NULL;
+
+  memset(&slow, 0x00, sizeof(slow));
+  slow.lcd.w = LCD_W;
+  slow.lcd.h = LCD_H;
+  slow.lcd.begin_frame = slow_lcd_begin_frame;
+  slow.lcd.fill_rect = slow_lcd_fill_rect;
+  slow.lcd.end_frame = slow_lcd_end_frame;
+
+  rt = render_thread_create(&(slow.lcd), 2);
+  ASSERT_EQ(rt->lcd.scroll == NULL, TRUE);
+  ASSERT_EQ(rt->lcd.get_point_color == NULL, TRUE);
+
+  font_manager_init(&font_manager);
+  canvas_init(&c, &(rt->lcd), &font_manager);
+  rect_init(r, 0, 0, LCD_W, LCD_H);
+  for (i = 0; i < 10; i++) {
+    canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+    ASSERT_LE(rt->submitted - tk_atomic_load(&(rt->presented)), 2);
+    canvas_fill_rect(&c, 0, 0, LCD_W, LCD_H);
+    canvas_end_frame(&c);
+  }
+
+  ASSERT_GT(rt->waits, 0);
+  render_thread_flush(rt);
+  ASSERT_EQ(slow.frames, 10);
+
+  lcd_destroy(&(rt->lcd));
+}
+
+static lcd_draw_image_t s_mem_draw_image = NULL;
+
+/*回放到图片时先等一会，让GUI线程有机会在回放之前销毁图片。*/
+static ret_t slow_mem_draw_image(lcd_t* lcd, bitmap_t* img, rect_t* src, rect_t* dst) {
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+  return s_mem_draw_image(lcd, img, src, dst);
+}
+
+static ret_t test_on_paint_red(void* ctx, event_t* e) {
+  paint_event_t* evt = (paint_event_t*)e;
+  widget_t* widget = WIDGETP(e->target);
+
+  canvas_set_fill_color(evt->c, color_init(0xff, 0, 0, 0xff));
+  canvas_fill_rect(evt->c, 0, 0, widget->w, widget->h);
+
+  return RET_OK;
+}
+
+/*缓存的位图被还没有显示的帧引用时销毁控件，要先等这一帧显示完再释放位图。*/
+TEST(RenderThread, destroyCachedWidget) {
+  rect_t r;
+  canvas_t c;
+  font_manager_t font_manager;
+  lcd_t* target = test_create_lcd();
+  render_thread_t* rt = render_thread_create(target, 2);
+  widget_t* w = view_create(NULL, 0, 0, 50, 50);
+
+  s_mem_draw_image = target->draw_image;
+  target->draw_image = slow_mem_draw_image;
+  widget_on(w, EVT_PAINT, test_on_paint_red, NULL);
+  widget_cache_enable(w, TRUE);
+
+  font_manager_init(&font_manager);
+  canvas_init(&c, &(rt->lcd), &font_manager);
+  rect_init(r, 0, 0, LCD_W, LCD_H);
+
+  /*第一帧生成缓存(需要直接访问lcd)，第二帧只是在显示列表中引用缓存的位图。*/
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  widget_paint(w, &c);
+  canvas_end_frame(&c);
+  ASSERT_EQ(rt->syncs, 1);
+
+  memset(((lcd_mem_t*)target)->pixels, 0x00, LCD_W * LCD_H * 4);
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  widget_paint(w, &c);
+  canvas_end_frame(&c);
+  ASSERT_EQ(rt->syncs, 1);
+  ASSERT_EQ(rt->submitted, 1);
+
+  widget_destroy(w);
+  ASSERT_EQ(tk_atomic_load(&(rt->presented)), rt->submitted);
+  ASSERT_EQ(lcd_get_point_color(target, 25, 25).color, color_init(0xff, 0, 0, 0xff).color);
+
+  lcd_destroy(&(rt->lcd));
+  lcd_destroy(target);
+}
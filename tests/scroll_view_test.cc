@@ -0,0 +1,138 @@
+#include "base/label.h"
+#include "base/window.h"
+#include "base/canvas.h"
+#include "base/scroll_view.h"
+#include "base/window_manager.h"
+#include "lcd/lcd_mem.h"
+#include "gtest/gtest.h"
+
+TEST(ScrollView, basic) {
+  value_t v;
+  widget_t* w = scroll_view_create(NULL, 0, 0, 100, 100);
+  widget_t* child = label_create(w, 10, 20, 50, 30);
+
+  ASSERT_EQ(scroll_view_set_virtual_wh(w, 300, 200), RET_OK);
+  ASSERT_EQ(scroll_view_scroll_to(w, 50, 40), RET_OK);
+  ASSERT_EQ(SCROLL_VIEW(w)->xoffset, 50);
+  ASSERT_EQ(SCROLL_VIEW(w)->yoffset, 40);
+  ASSERT_EQ(child->x, 10 - 50);
+  ASSERT_EQ(child->y, 20 - 40);
+
+  /*偏移量被限制在有效范围内。*/
+  ASSERT_EQ(scroll_view_scroll_to(w, 1000, -10), RET_OK);
+  ASSERT_EQ(SCROLL_VIEW(w)->xoffset, 200);
+  ASSERT_EQ(SCROLL_VIEW(w)->yoffset, 0);
+  ASSERT_EQ(child->x, 10 - 200);
+  ASSERT_EQ(child->y, 20);
+
+  value_set_int(&v, 60);
+  ASSERT_EQ(widget_set_prop(w, WIDGET_PROP_YOFFSET, &v), RET_OK);
+  ASSERT_EQ(widget_get_prop(w, WIDGET_PROP_YOFFSET, &v), RET_OK);
+  ASSERT_EQ(value_int(&v), 60);
+  ASSERT_EQ(child->y, 20 - 60);
+
+  /*虚拟区域变小时偏移量也跟着变小。*/
+  ASSERT_EQ(scroll_view_set_virtual_wh(w, 100, 100), RET_OK);
+  ASSERT_EQ(SCROLL_VIEW(w)->xoffset, 0);
+  ASSERT_EQ(SCROLL_VIEW(w)->yoffset, 0);
+  ASSERT_EQ(child->x, 10);
+  ASSERT_EQ(child->y, 20);
+
+  widget_destroy(w);
+}
+
+TEST(ScrollView, blit) {
+  canvas_t canvas;
+  font_manager_t font_manager;
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  lcd_t* lcd = lcd_mem_create(200, 200, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  window_manager_t* wmp = WINDOW_MANAGER(wm);
+  widget_t* win = NULL;
+  widget_t* w = NULL;
+
+  window_manager_set(wm);
+  window_manager_resize(wm, 200, 200);
+  win = window_create(wm, 0, 0, 200, 200);
+  w = scroll_view_create(win, 10, 20, 100, 100);
+  label_create(w, 0, 0, 100, 300);
+  scroll_view_set_virtual_wh(w, 100, 300);
+  window_manager_paint(wm, c);
+  window_manager_paint(wm, c);
+
+  /*只需要重绘新露出的部分。*/
+  ASSERT_EQ(scroll_view_scroll_to(w, 0, 10), RET_OK);
+  ASSERT_EQ(wmp->scrolls_nr, 1);
+  ASSERT_EQ(wmp->scrolls[0].dy, -10);
+  ASSERT_EQ(wmp->dirty_rect.x, 10);
+  ASSERT_EQ(wmp->dirty_rect.y, 20 + 90);
+  ASSERT_EQ(wmp->dirty_rect.w, 100);
+  ASSERT_EQ(wmp->dirty_rect.h, 10);
+
+  /*同一帧内多次滚动会合并。*/
+  ASSERT_EQ(scroll_view_scroll_to(w, 0, 15), RET_OK);
+  ASSERT_EQ(wmp->scrolls_nr, 1);
+  ASSERT_EQ(wmp->scrolls[0].dy, -15);
+  ASSERT_EQ(wmp->dirty_rect.y, 20 + 85);
+  ASSERT_EQ(wmp->dirty_rect.h, 15);
+
+  window_manager_paint(wm, c);
+  ASSERT_EQ(wmp->scrolls_nr, 0);
+
+  /*区域内有等待重绘的内容时，退化为全部重绘。*/
+  widget_invalidate(win, NULL);
+  ASSERT_EQ(scroll_view_scroll_to(w, 0, 0), RET_OK);
+  ASSERT_EQ(wmp->scrolls_nr, 0);
+  window_manager_paint(wm, c);
+
+  /*移动的距离超过视图的大小时，也全部重绘。*/
+  window_manager_paint(wm, c);
+  ASSERT_EQ(scroll_view_scroll_to(w, 0, 200), RET_OK);
+  ASSERT_EQ(wmp->scrolls_nr, 0);
+  ASSERT_EQ(wmp->dirty_rect.y, 20);
+  ASSERT_EQ(wmp->dirty_rect.h, 100);
+
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
+
+TEST(ScrollView, blit_perf_stats) {
+  canvas_t canvas;
+  font_manager_t font_manager;
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  lcd_t* lcd = lcd_mem_create(200, 200, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  window_manager_t* wmp = WINDOW_MANAGER(wm);
+  widget_t* win = NULL;
+  widget_t* top = NULL;
+  widget_t* bottom = NULL;
+
+  window_manager_set(wm);
+  window_manager_resize(wm, 200, 200);
+  win = window_create(wm, 0, 0, 200, 200);
+  top = scroll_view_create(win, 10, 20, 100, 60);
+  label_create(top, 0, 0, 100, 300);
+  scroll_view_set_virtual_wh(top, 100, 300);
+  bottom = scroll_view_create(win, 10, 120, 100, 60);
+  label_create(bottom, 0, 0, 100, 300);
+  scroll_view_set_virtual_wh(bottom, 100, 300);
+  window_manager_set_show_perf_stats(wm, TRUE);
+  window_manager_paint(wm, c);
+  window_manager_paint(wm, c);
+
+  /*和性能统计浮层重叠的区域不能移动像素，否则浮层会被拖出残影。*/
+  ASSERT_EQ(scroll_view_scroll_to(top, 0, 10), RET_OK);
+  ASSERT_EQ(wmp->scrolls_nr, 0);
+  window_manager_paint(wm, c);
+
+  ASSERT_EQ(scroll_view_scroll_to(bottom, 0, 10), RET_OK);
+  ASSERT_EQ(wmp->scrolls_nr, 1);
+  window_manager_paint(wm, c);
+
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
@@ -0,0 +1,155 @@
+#include "base/task_queue.h"
+#include "gtest/gtest.h"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+static std::string s_log;
+
+static ret_t test_log_task(void* ctx) {
+  char buff[32];
+  snprintf(buff, sizeof(buff), "%d;", (int)(intptr_t)ctx);
+  s_log += buff;
+
+  return RET_OK;
+}
+
+static ret_t test_repost_task(void* ctx) {
+  task_queue_t* q = (task_queue_t*)ctx;
+  s_log += "r;";
+
+  return task_queue_post(q, test_log_task, (void*)99);
+}
+
+static ret_t test_wakeup(void* ctx) {
+  (*(uint32_t*)ctx)++;
+
+  return RET_OK;
+}
+
+TEST(TaskQueue, basic) {
+  task_queue_t* q = task_queue_create(5);
+
+  ASSERT_EQ(q->capacity, 8);
+  ASSERT_EQ(task_queue_dispatch(q), 0);
+
+  s_log = "";
+  for (intptr_t i = 0; i < 8; i++) {
+    ASSERT_EQ(task_queue_post(q, test_log_task, (void*)i), RET_OK);
+  }
+  ASSERT_EQ(task_queue_post(q, test_log_task, (void*)8), RET_FAIL);
+
+  ASSERT_EQ(task_queue_dispatch(q), 8);
+  ASSERT_EQ(s_log, "0;1;2;3;4;5;6;7;");
+
+  /*任务中投递的任务留到下一次执行。*/
+  s_log = "";
+  ASSERT_EQ(task_queue_post(q, test_repost_task, q), RET_OK);
+  ASSERT_EQ(task_queue_dispatch(q), 1);
+  ASSERT_EQ(s_log, "r;");
+  ASSERT_EQ(task_queue_dispatch(q), 1);
+  ASSERT_EQ(s_log, "r;99;");
+
+  task_queue_destroy(q);
+}
+
+TEST(TaskQueue, wakeup) {
+  uint32_t wakeups = 0;
+  task_queue_t* q = task_queue_create(16);
+
+  /*每次执行之前最多唤醒一次。*/
+  ASSERT_EQ(task_queue_set_wakeup(q, test_wakeup, &wakeups), RET_OK);
+  ASSERT_EQ(task_queue_post(q, test_log_task, NULL), RET_OK);
+  ASSERT_EQ(task_queue_post(q, test_log_task, NULL), RET_OK);
+  ASSERT_EQ(wakeups, 1);
+
+  ASSERT_EQ(task_queue_dispatch(q), 2);
+  ASSERT_EQ(task_queue_post(q, test_log_task, NULL), RET_OK);
+  ASSERT_EQ(wakeups, 2);
+
+  task_queue_destroy(q);
+}
+
+TEST(TaskQueue, global) {
+  task_queue_t* old = task_queue();
+  task_queue_t* q = task_queue_create(16);
+
+  s_log = "";
+  task_queue_set(q);
+  ASSERT_EQ(tk_post_task(test_log_task, (void*)1), RET_OK);
+  ASSERT_EQ(task_queue_dispatch(task_queue()), 1);
+  ASSERT_EQ(s_log, "1;");
+
+  task_queue_destroy(q);
+  task_queue_set(old);
+}
+
+#define PRODUCERS_NR 8
+#define UPDATES_NR 1000000
+
+typedef struct _test_update_t {
+  uint32_t producer;
+  uint32_t seq;
+} test_update_t;
+
+static uint32_t s_last_seq[PRODUCERS_NR];
+static uint32_t s_done = 0;
+static bool_t s_in_order = TRUE;
+
+static ret_t test_update_task(void* ctx) {
+  test_update_t* update = (test_update_t*)ctx;
+
+  if (update->seq != s_last_seq[update->producer] + 1) {
+    s_in_order = FALSE;
+  }
+  s_last_seq[update->producer] = update->seq;
+  s_done++;
+
+  return RET_OK;
+}
+
+/*8个线程一共投递1M个更新，GUI线程全部按各自的顺序执行。*/
+TEST(TaskQueue, producers) {
+  task_queue_t* q = task_queue_create(1024);
+  uint32_t per_producer = UPDATES_NR / PRODUCERS_NR;
+  std::vector<test_update_t> updates(UPDATES_NR);
+  std::vector<std::thread> producers;
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  double ms = 0;
+
+  s_done = 0;
+  s_in_order = TRUE;
+  memset(s_last_seq, 0x00, sizeof(s_last_seq));
+
+  for (uint32_t p = 0; p < PRODUCERS_NR; p++) {
+    producers.push_back(std::thread([q, p, per_producer, &updates]() {
+      for (uint32_t i = 0; i < per_producer; i++) {
+        test_update_t* update = &updates[p * per_producer + i];
+
+        update->producer = p;
+        update->seq = i + 1;
+        while (task_queue_post(q, test_update_task, update) != RET_OK) {
+          std::this_thread::yield();
+        }
+      }
+    }));
+  }
+
+  while (s_done < per_producer * PRODUCERS_NR) {
+    if (task_queue_dispatch(q) == 0) {
+      std::this_thread::yield();
+    }
+  }
+
+  for (uint32_t p = 0; p < PRODUCERS_NR; p++) {
+    producers[p].join();
+    ASSERT_EQ(s_last_seq[p], per_producer);
+  }
+
+  ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+  log_debug("%d producers posted %d tasks in %.1f ms\n", PRODUCERS_NR, UPDATES_NR, ms);
+
+  ASSERT_EQ(s_in_order, TRUE);
+  ASSERT_EQ(task_queue_dispatch(q), 0);
+  task_queue_destroy(q);
+}
@@ -0,0 +1,222 @@
+#include "base/mem.h"
+#include "base/label.h"
+#include "base/canvas.h"
+#include "base/text_layout.h"
+#include "base/font_manager.h"
+#include "font_dummy.h"
+#include "lcd_log.h"
+#include "gtest/gtest.h"
+
+class TextLayoutTest : public testing::Test {
+ protected:
+  virtual void SetUp() {
+    rect_t r;
+
+    lcd = lcd_log_init(800, 600);
+    font_manager_init(&font_manager);
+    canvas_init(&c, lcd, &font_manager);
+    font_dummy_init();
+    font_manager_add(&font_manager, font_dummy_0("demo0", 10));
+    text_layout_init(&layout);
+
+    rect_init(r, 100, 100, 200, 200);
+    canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+    canvas_set_font(&c, "demo0", 10);
+  }
+
+  virtual void TearDown() {
+    canvas_end_frame(&c);
+    text_layout_deinit(&layout);
+    font_manager_deinit(&font_manager);
+    lcd_destroy(lcd);
+  }
+
+  lcd_t* lcd;
+  canvas_t c;
+  text_layout_t layout;
+  font_manager_t font_manager;
+};
+
+TEST_F(TextLayoutTest, advances) {
+  const wchar_t* str = L"ab cd";
+
+  ASSERT_EQ(text_layout_update(&layout, &c, str, 5, 0), RET_OK);
+  ASSERT_EQ(layout.lines_nr, 1);
+  ASSERT_EQ(layout.w, 13 * 4 + 4);
+  ASSERT_EQ(layout.h, 10);
+  ASSERT_EQ(text_layout_measure(&layout, 0, 2), 26);
+  ASSERT_EQ(text_layout_measure(&layout, 2, 1), 4);
+  ASSERT_EQ(layout.w, canvas_measure_text(&c, (wchar_t*)str, 5));
+
+  /*参数不变时不重新测量。*/
+  layout.advances[0] = 99;
+  ASSERT_EQ(text_layout_update(&layout, &c, str, 5, 0), RET_OK);
+  ASSERT_EQ(layout.advances[0], 99);
+
+  /*字号改变或者主动失效时重新测量。*/
+  canvas_set_font(&c, "demo0", 12);
+  ASSERT_EQ(text_layout_update(&layout, &c, str, 5, 0), RET_OK);
+  ASSERT_EQ(layout.advances[0], 13);
+  ASSERT_EQ(layout.h, 12);
+
+  layout.advances[0] = 99;
+  ASSERT_EQ(text_layout_invalidate(&layout), RET_OK);
+  ASSERT_EQ(text_layout_update(&layout, &c, str, 5, 0), RET_OK);
+  ASSERT_EQ(layout.advances[0], 13);
+}
+
+TEST_F(TextLayoutTest, font_name) {
+  const wchar_t* str = L"ab cd";
+  char* name = (char*)TKMEM_ALLOC(8);
+
+  /*字体名来自主题数据，重新加载后原来的字符串被释放，缓存不能引用它。*/
+  strcpy(name, "demo0");
+  canvas_set_font(&c, name, 10);
+  ASSERT_EQ(text_layout_update(&layout, &c, str, 5, 0), RET_OK);
+  ASSERT_NE(layout.font_name, name);
+  memset(name, 0x00, 8);
+  TKMEM_FREE(name);
+
+  canvas_set_font(&c, "demo0", 10);
+  layout.advances[0] = 99;
+  ASSERT_EQ(text_layout_update(&layout, &c, str, 5, 0), RET_OK);
+  ASSERT_EQ(layout.advances[0], 99);
+
+  canvas_set_font(&c, NULL, 10);
+  ASSERT_EQ(text_layout_update(&layout, &c, str, 5, 0), RET_OK);
+  ASSERT_EQ(layout.advances[0], 13);
+  ASSERT_TRUE(layout.font_name == NULL);
+}
+
+TEST_F(TextLayoutTest, line_break) {
+  const wchar_t* str = L"ab\ncd\r\nef";
+
+  ASSERT_EQ(text_layout_update(&layout, &c, str, wcslen(str), 0), RET_OK);
+  ASSERT_EQ(layout.lines_nr, 3);
+  ASSERT_EQ(layout.lines[0].start, 0);
+  ASSERT_EQ(layout.lines[0].nr, 2);
+  ASSERT_EQ(layout.lines[1].start, 3);
+  ASSERT_EQ(layout.lines[1].nr, 2);
+  ASSERT_EQ(layout.lines[2].start, 7);
+  ASSERT_EQ(layout.lines[2].nr, 2);
+  ASSERT_EQ(layout.h, 30);
+}
+
+TEST_F(TextLayoutTest, wrap) {
+  const wchar_t* words = L"ab cd efg";
+  const wchar_t* chars = L"abcdefg";
+
+  /*在空格处断行，行尾的空格不计入宽度。*/
+  ASSERT_EQ(text_layout_update(&layout, &c, words, wcslen(words), 45), RET_OK);
+  ASSERT_EQ(layout.lines_nr, 3);
+  ASSERT_EQ(layout.lines[0].start, 0);
+  ASSERT_EQ(layout.lines[0].nr, 2);
+  ASSERT_EQ(layout.lines[0].w, 26);
+  ASSERT_EQ(layout.lines[1].start, 3);
+  ASSERT_EQ(layout.lines[1].nr, 2);
+  ASSERT_EQ(layout.lines[2].start, 6);
+  ASSERT_EQ(layout.lines[2].nr, 3);
+  ASSERT_EQ(layout.lines[2].w, 39);
+  ASSERT_EQ(layout.w, 39);
+
+  /*没有空格时在字符间断行。*/
+  ASSERT_EQ(text_layout_update(&layout, &c, chars, wcslen(chars), 30), RET_OK);
+  ASSERT_EQ(layout.lines_nr, 4);
+  ASSERT_EQ(layout.lines[0].nr, 2);
+  ASSERT_EQ(layout.lines[3].start, 6);
+  ASSERT_EQ(layout.lines[3].nr, 1);
+
+  /*一个字符都放不下时，每行至少一个字符。*/
+  ASSERT_EQ(text_layout_update(&layout, &c, chars, wcslen(chars), 5), RET_OK);
+  ASSERT_EQ(layout.lines_nr, 7);
+}
+
+TEST_F(TextLayoutTest, align) {
+  rect_t r;
+  const wchar_t* str = L"ab\nc";
+
+  rect_init(r, 100, 100, 100, 100);
+  ASSERT_EQ(text_layout_update(&layout, &c, str, wcslen(str), 0), RET_OK);
+
+  lcd_log_reset(lcd);
+  ASSERT_EQ(text_layout_draw(&layout, &c, &r, ALIGN_H_LEFT, ALIGN_V_TOP), RET_OK);
+  ASSERT_EQ(lcd_log_get_commands(lcd),
+            "dg(0,0,12,12,100,102);dg(0,0,12,12,113,102);dg(0,0,12,12,100,112);");
+
+  lcd_log_reset(lcd);
+  ASSERT_EQ(text_layout_draw(&layout, &c, &r, ALIGN_H_RIGHT, ALIGN_V_BOTTOM), RET_OK);
+  ASSERT_EQ(lcd_log_get_commands(lcd),
+            "dg(0,0,12,12,174,182);dg(0,0,12,12,187,182);dg(0,0,12,12,187,192);");
+
+  lcd_log_reset(lcd);
+  ASSERT_EQ(text_layout_draw(&layout, &c, &r, ALIGN_H_CENTER, ALIGN_V_MIDDLE), RET_OK);
+  ASSERT_EQ(lcd_log_get_commands(lcd),
+            "dg(0,0,12,12,137,142);dg(0,0,12,12,150,142);dg(0,0,12,12,143,152);");
+}
+
+static uint32_t test_count_glyphs(lcd_t* lcd) {
+  uint32_t nr = 0;
+  std::string cmds = lcd_log_get_commands(lcd);
+  std::string::size_type pos = cmds.find("dg(");
+
+  while (pos != std::string::npos) {
+    nr++;
+    pos = cmds.find("dg(", pos + 1);
+  }
+
+  return nr;
+}
+
+TEST_F(TextLayoutTest, cull) {
+  rect_t r;
+  uint32_t i = 0;
+  wstr_t str;
+
+  /*1000行文本只有裁剪区内的几行需要绘制。*/
+  wstr_init(&str, 0);
+  for (i = 0; i < 1000; i++) {
+    wstr_push(&str, 'a');
+    wstr_push(&str, '\n');
+  }
+
+  rect_init(r, 100, -20000, 100, 10000);
+  ASSERT_EQ(text_layout_update(&layout, &c, str.str, str.size, 0), RET_OK);
+  ASSERT_EQ(layout.lines_nr, 1001);
+
+  lcd_log_reset(lcd);
+  ASSERT_EQ(text_layout_draw(&layout, &c, &r, ALIGN_H_LEFT, ALIGN_V_TOP), RET_OK);
+  ASSERT_EQ(lcd_log_get_commands(lcd), "");
+
+  rect_init(r, 100, 100 - 10 * 100, 100, 10000);
+  lcd_log_reset(lcd);
+  ASSERT_EQ(text_layout_draw(&layout, &c, &r, ALIGN_H_LEFT, ALIGN_V_TOP), RET_OK);
+  ASSERT_EQ(test_count_glyphs(lcd), 21);
+
+  /*左边看不到的字符也跳过。*/
+  wstr_set(&str, L"abcdefghij");
+  rect_init(r, 50, 100, 200, 10);
+  ASSERT_EQ(text_layout_update(&layout, &c, str.str, str.size, 0), RET_OK);
+  lcd_log_reset(lcd);
+  ASSERT_EQ(text_layout_draw(&layout, &c, &r, ALIGN_H_LEFT, ALIGN_V_TOP), RET_OK);
+  ASSERT_EQ(lcd_log_get_commands(lcd).find("dg(11,0,1,12,100,102);dg(0,0,12,12,102,102);"), 0);
+  ASSERT_EQ(test_count_glyphs(lcd), 7);
+
+  wstr_reset(&str);
+}
+
+TEST(TextLayout, label) {
+  value_t v;
+  widget_t* label = label_create(NULL, 0, 0, 40, 100);
+
+  ASSERT_EQ(label->line_wrap, FALSE);
+  value_set_bool(&v, TRUE);
+  ASSERT_EQ(widget_set_prop(label, WIDGET_PROP_LINE_WRAP, &v), RET_OK);
+  ASSERT_EQ(label->line_wrap, TRUE);
+  ASSERT_EQ(widget_get_prop(label, WIDGET_PROP_LINE_WRAP, &v), RET_OK);
+  ASSERT_EQ(value_bool(&v), TRUE);
+
+  ASSERT_EQ(widget_set_text(label, L"abc"), RET_OK);
+  ASSERT_TRUE(label->text_layout == NULL);
+
+  widget_destroy(label);
+}
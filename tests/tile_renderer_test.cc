@@ -0,0 +1,172 @@
+#include "base/canvas.h"
+#include "base/tile_renderer.h"
+#include "lcd/lcd_mem.h"
+#include "gtest/gtest.h"
+#include <chrono>
+
+#define IMG_SIZE 64
+#define GLYPH_SIZE 16
+
+static color_t s_img_data[IMG_SIZE * IMG_SIZE];
+static uint8_t s_glyph_data[GLYPH_SIZE * GLYPH_SIZE];
+
+static void test_init_data(void) {
+  uint32_t i = 0;
+
+  for (i = 0; i < IMG_SIZE * IMG_SIZE; i++) {
+    s_img_data[i] = color_init(i & 0xff, (i >> 4) & 0xff, 0x80, (i * 7) & 0xff);
+  }
+
+  for (i = 0; i < GLYPH_SIZE * GLYPH_SIZE; i++) {
+    s_glyph_data[i] = (i * 13) & 0xff;
+  }
+}
+
+/*一个复杂的全屏帧：背景、半透明图片铺满屏幕、多行文字。*/
+static void test_record(display_list_t* dl, wh_t w, wh_t h) {
+  rect_t r;
+  rect_t src;
+  rect_t dst;
+  glyph_t g;
+  xy_t x = 0;
+  xy_t y = 0;
+  canvas_t c;
+  bitmap_t img;
+  font_manager_t font_manager;
+
+  font_manager_init(&font_manager);
+  canvas_init(&c, &(dl->lcd), &font_manager);
+
+  rect_init(r, 0, 0, w, h);
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  canvas_set_fill_color(&c, color_init(0x20, 0x40, 0x60, 0xff));
+  canvas_fill_rect(&c, 0, 0, w, h);
+
+  memset(&img, 0x00, sizeof(img));
+  img.w = IMG_SIZE;
+  img.h = IMG_SIZE;
+  img.format = BITMAP_FMT_RGBA;
+  img.data = (uint8_t*)s_img_data;
+  rect_init(src, 0, 0, IMG_SIZE, IMG_SIZE);
+  for (y = 0; y < h; y += IMG_SIZE - 7) {
+    for (x = 0; x < w; x += IMG_SIZE - 7) {
+      rect_init(dst, x, y, IMG_SIZE, IMG_SIZE);
+      canvas_draw_image(&c, &img, &src, &dst);
+    }
+  }
+
+  memset(&g, 0x00, sizeof(g));
+  g.w = GLYPH_SIZE;
+  g.h = GLYPH_SIZE;
+  g.data = s_glyph_data;
+  rect_init(src, 0, 0, GLYPH_SIZE, GLYPH_SIZE);
+  lcd_set_text_color(&(dl->lcd), color_init(0xff, 0xff, 0xff, 0xff));
+  for (y = 0; y + GLYPH_SIZE <= h; y += GLYPH_SIZE + 4) {
+    for (x = 0; x + GLYPH_SIZE <= w; x += GLYPH_SIZE) {
+      lcd_draw_glyph(&(dl->lcd), &g, &src, x, y);
+    }
+  }
+
+  canvas_end_frame(&c);
+}
+
+static lcd_t* test_create_lcd(wh_t w, wh_t h) {
+  lcd_t* lcd = lcd_mem_create(w, h, TRUE);
+  memset(((lcd_mem_t*)lcd)->pixels, 0x00, w * h * 4);
+
+  return lcd;
+}
+
+static bool_t test_same_pixels(lcd_t* a, lcd_t* b) {
+  uint32_t size = a->w * a->h * 4;
+
+  return memcmp(((lcd_mem_t*)a)->pixels, ((lcd_mem_t*)b)->pixels, size) == 0;
+}
+
+TEST(TileRenderer, basic) {
+  rect_t r;
+  uint32_t n = 0;
+  lcd_t* ref = test_create_lcd(400, 300);
+  display_list_t* dl = display_list_create(400, 300);
+
+  test_init_data();
+  test_record(dl, 400, 300);
+  rect_init(r, 10, 5, 380, 290);
+  display_list_replay(dl, ref, &r);
+
+  /*不同的线程数，结果都与直接回放相同。*/
+  for (n = 1; n <= 4; n++) {
+    lcd_t* lcd = test_create_lcd(400, 300);
+    tile_renderer_t* tr = tile_renderer_create(n);
+
+    ASSERT_EQ(tile_renderer_replay(tr, dl, lcd, &r), RET_OK);
+    ASSERT_EQ(tr->tiled, n > 1 ? 1 : 0);
+    ASSERT_EQ(test_same_pixels(lcd, ref), TRUE);
+
+    tile_renderer_destroy(tr);
+    lcd_destroy(lcd);
+  }
+
+  lcd_destroy(&(dl->lcd));
+  lcd_destroy(ref);
+}
+
+TEST(TileRenderer, small) {
+  rect_t r;
+  lcd_t* ref = test_create_lcd(400, 300);
+  lcd_t* lcd = test_create_lcd(400, 300);
+  display_list_t* dl = display_list_create(400, 300);
+  tile_renderer_t* tr = tile_renderer_create(4);
+
+  /*小的区域在调用者的线程中直接回放。*/
+  test_init_data();
+  test_record(dl, 400, 300);
+  rect_init(r, 100, 100, 100, 100);
+  display_list_replay(dl, ref, &r);
+  ASSERT_EQ(tile_renderer_replay(tr, dl, lcd, &r), RET_OK);
+  ASSERT_EQ(tr->tiled, 0);
+  ASSERT_EQ(test_same_pixels(lcd, ref), TRUE);
+
+  tile_renderer_destroy(tr);
+  lcd_destroy(&(dl->lcd));
+  lcd_destroy(lcd);
+  lcd_destroy(ref);
+}
+
+/*1920x1080的全屏重绘，1-8个线程。每次运行要一秒多，缺省不运行，
+ * 用--gtest_also_run_disabled_tests --gtest_filter=TileRenderer.*运行。*/
+TEST(TileRenderer, DISABLED_benchmark) {
+  rect_t r;
+  uint32_t n = 0;
+  double ms1 = 0;
+  lcd_t* lcd = test_create_lcd(1920, 1080);
+  display_list_t* dl = display_list_create(1920, 1080);
+
+  test_init_data();
+  test_record(dl, 1920, 1080);
+  rect_init(r, 0, 0, 1920, 1080);
+
+  for (n = 1; n <= TILE_RENDERER_MAX_THREADS; n *= 2) {
+    uint32_t i = 0;
+    double ms = 0;
+    tile_renderer_t* tr = tile_renderer_create(n);
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (i = 0; i < 5; i++) {
+      tile_renderer_replay(tr, dl, lcd, &r);
+    }
+
+    ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+             .count() /
+         5;
+    if (n == 1) {
+      ms1 = ms;
+    }
+    log_debug("%u threads: %.2f ms/frame (%.2fx)\n", n, ms, ms1 / ms);
+
+    tile_renderer_destroy(tr);
+  }
+
+  lcd_destroy(&(dl->lcd));
+  lcd_destroy(lcd);
+}
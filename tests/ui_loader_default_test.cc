@@ -42,7 +42,7 @@ TEST(UILoader, basic) {
   ASSERT_EQ(ui_builder_on_widget_end(writer), RET_OK);
 
   ASSERT_EQ(ui_builder_on_widget_end(writer), RET_OK);
-  ASSERT_EQ(wbuffer.cursor, 122);
+  ASSERT_EQ(wbuffer.cursor, 110);
 
   ASSERT_EQ(ui_loader_load(loader, wbuffer.data, wbuffer.cursor, builder), RET_OK);
   ASSERT_EQ(builder->root->type == WIDGET_DIALOG, TRUE);
@@ -102,7 +102,7 @@ TEST(UILoader, ext) {
   ASSERT_EQ(ui_builder_on_widget_end(writer), RET_OK);
 
   ASSERT_EQ(ui_builder_on_widget_end(writer), RET_OK);
-  ASSERT_EQ(wbuffer.cursor, 122);
+  ASSERT_EQ(wbuffer.cursor, 110);
 
   ASSERT_EQ(ui_loader_load(loader, wbuffer.data, wbuffer.cursor, builder), RET_OK);
   ASSERT_EQ(builder->root->type == WIDGET_GROUP_BOX, TRUE);
@@ -128,3 +128,48 @@ TEST(UILoader, ext) {
 
   widget_destroy(builder->root);
 }
+
+TEST(UILoader, props) {
+  uint8_t data[1024];
+  wbuffer_t wbuffer;
+  widget_desc_t desc;
+  uint32_t i = 0;
+  uint32_t atom_offset = 0;
+  ui_loader_t* loader = default_ui_loader();
+  ui_builder_t* builder = ui_builder_default();
+  ui_builder_t* writer = ui_builder_writer(wbuffer_init(&wbuffer, data, sizeof(data)));
+
+  memset(&desc, 0x00, sizeof(desc));
+  INIT_DESC(WIDGET_GROUP_BOX, 0, 0, 100, 200);
+  ASSERT_EQ(ui_builder_on_widget_start(writer, &desc), RET_OK);
+  ASSERT_EQ(ui_builder_on_widget_prop_end(writer), RET_OK);
+
+  INIT_DESC(WIDGET_BUTTON, 0, 0, 80, 30);
+  ASSERT_EQ(ui_builder_on_widget_start(writer, &desc), RET_OK);
+  ASSERT_EQ(ui_builder_on_widget_prop(writer, "text", "ok"), RET_OK);
+  ASSERT_EQ(ui_builder_on_widget_prop(writer, "ui_loader_test_custom", "1"), RET_OK);
+  ASSERT_EQ(ui_builder_on_widget_prop_end(writer), RET_OK);
+  ASSERT_EQ(ui_builder_on_widget_end(writer), RET_OK);
+
+  ASSERT_EQ(ui_builder_on_widget_end(writer), RET_OK);
+
+  /*没有原子化的属性名(自定义控件的属性)加载时分配原子，不会被丢掉。*/
+  ASSERT_EQ(prop_atom_lookup("ui_loader_test_custom"), PROP_ATOM_NONE);
+  ASSERT_EQ(ui_loader_load(loader, wbuffer.data, wbuffer.cursor, builder), RET_OK);
+  ASSERT_NE(prop_atom_lookup("ui_loader_test_custom"), PROP_ATOM_NONE);
+  widget_destroy(builder->root);
+
+  /*文件中的原子必须是内置的。*/
+  for (i = 0; i + 1 < wbuffer.cursor; i++) {
+    if (data[i] == UI_PROP_ATOM_MARK && data[i + 1] == PROP_ATOM_TEXT) {
+      atom_offset = i + 1;
+      break;
+    }
+  }
+  ASSERT_NE(atom_offset, 0);
+
+  data[atom_offset] = PROP_ATOM_BUILTIN_NR;
+  builder = ui_builder_default();
+  ASSERT_EQ(ui_loader_load(loader, wbuffer.data, wbuffer.cursor, builder), RET_BAD_PARAMS);
+  widget_destroy(builder->root);
+}
@@ -0,0 +1,162 @@
+#include "base/view.h"
+#include "base/canvas.h"
+#include "base/widget_cache.h"
+#include "lcd/lcd_mem.h"
+#include "gtest/gtest.h"
+
+static uint32_t test_checksum(lcd_t* lcd) {
+  uint32_t i = 0;
+  uint32_t sum = 0;
+  uint32_t* p = (uint32_t*)(((lcd_mem_t*)lcd)->pixels);
+
+  for (i = 0; i < (uint32_t)(lcd->w * lcd->h); i++) {
+    sum = sum * 31 + p[i];
+  }
+
+  return sum;
+}
+
+static uint32_t test_paint(widget_t* root, lcd_t* lcd) {
+  rect_t r;
+  canvas_t c;
+
+  rect_init(r, 0, 0, lcd->w, lcd->h);
+  canvas_init(&c, lcd, font_manager());
+  canvas_begin_frame(&c, &r, LCD_DRAW_NORMAL);
+  canvas_set_fill_color(&c, color_init(0, 0, 0, 0xff));
+  canvas_fill_rect(&c, 0, 0, lcd->w, lcd->h);
+  widget_paint(root, &c);
+  canvas_end_frame(&c);
+
+  return test_checksum(lcd);
+}
+
+TEST(WidgetCache, prop) {
+  value_t v;
+  widget_t* w = view_create(NULL, 0, 0, 50, 50);
+
+  ASSERT_EQ(w->cache, FALSE);
+  value_set_bool(&v, TRUE);
+  ASSERT_EQ(widget_set_prop(w, WIDGET_PROP_CACHE, &v), RET_OK);
+  ASSERT_EQ(w->cache, TRUE);
+  ASSERT_EQ(widget_get_prop(w, WIDGET_PROP_CACHE, &v), RET_OK);
+  ASSERT_EQ(value_bool(&v), TRUE);
+
+  value_set_str(&v, "false");
+  ASSERT_EQ(widget_set_prop(w, WIDGET_PROP_CACHE, &v), RET_OK);
+  ASSERT_EQ(w->cache, FALSE);
+
+  widget_destroy(w);
+}
+
+typedef struct _test_paint_ctx_t {
+  color_t color;
+  uint32_t times;
+} test_paint_ctx_t;
+
+static ret_t test_on_paint(void* ctx, event_t* e) {
+  paint_event_t* evt = (paint_event_t*)e;
+  test_paint_ctx_t* info = (test_paint_ctx_t*)ctx;
+  widget_t* widget = WIDGETP(e->target);
+
+  info->times++;
+  canvas_set_fill_color(evt->c, info->color);
+  canvas_fill_rect(evt->c, 0, 0, widget->w, widget->h);
+
+  return RET_OK;
+}
+
+static widget_t* test_create_view(widget_t* parent, xy_t x, xy_t y, wh_t w, wh_t h,
+                                  test_paint_ctx_t* ctx) {
+  widget_t* view = view_create(parent, x, y, w, h);
+  widget_on(view, EVT_PAINT, test_on_paint, ctx);
+
+  return view;
+}
+
+TEST(WidgetCache, paint) {
+  test_paint_ctx_t gctx = {color_init(0, 0, 0xff, 0xff), 0};
+  test_paint_ctx_t cctx = {color_init(0xff, 0, 0, 0xff), 0};
+  widget_t* root = view_create(NULL, 0, 0, 100, 100);
+  widget_t* group = test_create_view(root, 10, 10, 60, 60, &gctx);
+  widget_t* child = test_create_view(group, 5, 5, 20, 20, &cctx);
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  uint32_t used = widget_cache_get_used();
+  uint32_t direct = test_paint(root, lcd);
+
+  /*缓存的结果与直接绘制的相同，之后不再绘制子控件。*/
+  ASSERT_EQ(widget_set_cache(group, TRUE), RET_OK);
+  ASSERT_EQ(test_paint(root, lcd), direct);
+  ASSERT_EQ(widget_cache_get_used(), used + 60 * 60 * sizeof(uint32_t));
+  cctx.times = 0;
+  ASSERT_EQ(test_paint(root, lcd), direct);
+  ASSERT_EQ(test_paint(root, lcd), direct);
+  ASSERT_EQ(cctx.times, 0);
+
+  /*子控件刷新后重新生成缓存。*/
+  cctx.color = color_init(0, 0xff, 0, 0xff);
+  widget_invalidate(child, NULL);
+  ASSERT_NE(test_paint(root, lcd), direct);
+  ASSERT_EQ(cctx.times, 1);
+  ASSERT_EQ(widget_set_cache(group, FALSE), RET_OK);
+  ASSERT_EQ(widget_cache_get_used(), used);
+  direct = test_paint(root, lcd);
+  ASSERT_EQ(cctx.times, 2);
+
+  ASSERT_EQ(widget_set_cache(group, TRUE), RET_OK);
+  ASSERT_EQ(test_paint(root, lcd), direct);
+  ASSERT_EQ(test_paint(root, lcd), direct);
+  ASSERT_EQ(cctx.times, 3);
+
+  /*大小改变时重新生成缓存。*/
+  widget_resize(group, 40, 40);
+  test_paint(root, lcd);
+  ASSERT_EQ(cctx.times, 4);
+  ASSERT_EQ(widget_cache_get_used(), used + 40 * 40 * sizeof(uint32_t));
+
+  widget_destroy(root);
+  ASSERT_EQ(widget_cache_get_used(), used);
+  lcd_destroy(lcd);
+}
+
+TEST(WidgetCache, budget) {
+  test_paint_ctx_t ctx = {color_init(0xff, 0xff, 0, 0xff), 0};
+  widget_t* root = view_create(NULL, 0, 0, 100, 100);
+  widget_t* a = test_create_view(root, 0, 0, 50, 50, &ctx);
+  widget_t* b = test_create_view(root, 50, 0, 50, 50, &ctx);
+  widget_t* big = test_create_view(root, 0, 50, 100, 50, &ctx);
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  uint32_t size = 50 * 50 * sizeof(uint32_t);
+  uint32_t direct = test_paint(root, lcd);
+
+  ASSERT_EQ(widget_cache_clear(), RET_OK);
+  ASSERT_EQ(widget_cache_set_budget(size), RET_OK);
+  widget_set_cache(a, TRUE);
+  widget_set_cache(b, TRUE);
+  widget_set_cache(big, TRUE);
+
+  /*超出预算时释放最久没有用到的缓存，放不下的控件正常绘制。*/
+  ctx.times = 0;
+  ASSERT_EQ(test_paint(root, lcd), direct);
+  ASSERT_EQ(widget_cache_get_used(), size);
+  ASSERT_EQ(ctx.times, 3);
+
+  /*a和b轮流被淘汰。*/
+  ASSERT_EQ(test_paint(root, lcd), direct);
+  ASSERT_EQ(ctx.times, 6);
+
+  /*b不可见后，a的缓存一直有效。*/
+  widget_set_visible(b, FALSE, FALSE);
+  test_paint(root, lcd);
+  ctx.times = 0;
+  test_paint(root, lcd);
+  ASSERT_EQ(ctx.times, 1);
+  ASSERT_EQ(widget_cache_get_used(), size);
+
+  ASSERT_EQ(widget_cache_set_budget(0), RET_OK);
+  ASSERT_EQ(widget_cache_get_used(), 0);
+  ASSERT_EQ(widget_cache_set_budget(512 * 1024), RET_OK);
+
+  widget_destroy(root);
+  lcd_destroy(lcd);
+}
@@ -1,5 +1,7 @@
 
 #include "base/canvas.h"
+#include "base/font_manager.h"
+#include "base/time.h"
 #include "base/widget.h"
 #include "base/button.h"
 #include "base/group_box.h"
@@ -83,6 +85,29 @@ TEST(Widget, props) {
   widget_destroy(w);
 }
 
+TEST(Widget, props_atom) {
+  value_t v1;
+  value_t v2;
+  widget_t* w = window_create(NULL, 0, 0, 400, 300);
+
+  value_set_int(&v1, 5);
+  ASSERT_EQ(widget_set_prop_atom(w, PROP_ATOM_X, &v1), RET_OK);
+  ASSERT_EQ(w->x, 5);
+  ASSERT_EQ(widget_get_prop(w, WIDGET_PROP_X, &v2), RET_OK);
+  ASSERT_EQ(value_int(&v2), 5);
+
+  value_set_str(&v1, "fade");
+  ASSERT_EQ(widget_set_prop_atom(w, PROP_ATOM_ANIM_HINT, &v1), RET_OK);
+  ASSERT_EQ(widget_get_prop_atom(w, PROP_ATOM_ANIM_HINT, &v2), RET_OK);
+  ASSERT_EQ(strcmp(value_str(&v2), "fade"), 0);
+
+  ASSERT_EQ(widget_set_prop_atom(w, PROP_ATOM_VERTICAL, &v1), RET_NOT_FOUND);
+  ASSERT_EQ(widget_get_prop_atom(w, PROP_ATOM_VERTICAL, &v2), RET_NOT_FOUND);
+  ASSERT_EQ(widget_set_prop_atom(w, PROP_ATOM_NONE, &v1), RET_BAD_PARAMS);
+
+  widget_destroy(w);
+}
+
 TEST(Widget, children) {
   widget_t* w = window_create(NULL, 0, 0, 400, 300);
   widget_t* c1 = button_create(w, 0, 0, 10, 10);
@@ -124,3 +149,73 @@ TEST(Widget, children) {
 
   widget_destroy(w);
 }
+
+TEST(Widget, dirty) {
+  canvas_t c;
+  font_manager_t font_manager;
+  lcd_t* lcd = lcd_log_init(400, 300);
+  widget_t* w = window_create(NULL, 0, 0, 400, 300);
+  widget_t* group = group_box_create(w, 0, 0, 100, 100);
+  widget_t* b1 = button_create(group, 0, 0, 10, 10);
+  widget_t* b2 = button_create(w, 200, 0, 10, 10);
+
+  font_manager_init(&font_manager);
+  canvas_init(&c, lcd, &font_manager);
+  ASSERT_EQ(w->subtree_dirty, TRUE);
+  ASSERT_EQ(widget_paint(w, &c), RET_OK);
+  ASSERT_EQ(w->dirty, FALSE);
+  ASSERT_EQ(w->subtree_dirty, FALSE);
+  ASSERT_EQ(b1->dirty, FALSE);
+
+  ASSERT_EQ(widget_invalidate(b1, NULL), RET_OK);
+  ASSERT_EQ(b1->dirty, TRUE);
+  ASSERT_EQ(group->dirty, FALSE);
+  ASSERT_EQ(group->subtree_dirty, TRUE);
+  ASSERT_EQ(w->subtree_dirty, TRUE);
+  ASSERT_EQ(b2->dirty, FALSE);
+  ASSERT_EQ(widget_paint(w, &c), RET_OK);
+  ASSERT_EQ(group->subtree_dirty, FALSE);
+  ASSERT_EQ(w->subtree_dirty, FALSE);
+
+  /*不可见的子控件没有绘制，祖先保留标志。*/
+  widget_set_visible(b2, FALSE, FALSE);
+  ASSERT_EQ(widget_invalidate(b2, NULL), RET_OK);
+  ASSERT_EQ(widget_paint(w, &c), RET_OK);
+  ASSERT_EQ(b2->dirty, TRUE);
+  ASSERT_EQ(w->subtree_dirty, TRUE);
+
+  widget_destroy(w);
+  font_manager_deinit(&font_manager);
+  lcd_destroy(lcd);
+}
+
+TEST(Widget, invalidate_deep_tree) {
+  uint32_t i = 0;
+  uint32_t start = 0;
+  uint32_t cost = 0;
+  widget_t* leaf = NULL;
+  widget_t* w = window_create(NULL, 0, 0, 400, 300);
+
+  /*64层，每层再挂8个兄弟节点。*/
+  leaf = w;
+  for (i = 0; i < 64; i++) {
+    uint32_t k = 0;
+    for (k = 0; k < 8; k++) {
+      button_create(leaf, 0, 0, 4, 4);
+    }
+    leaf = group_box_create(leaf, 0, 0, 300, 200);
+  }
+
+  start = time_now_ms();
+  for (i = 0; i < 10000; i++) {
+    widget_invalidate(leaf, NULL);
+  }
+  cost = time_now_ms() - start;
+  log_debug("invalidate leaf of deep tree 10000 times: %u ms\n", cost);
+
+  ASSERT_EQ(leaf->dirty, TRUE);
+  ASSERT_EQ(leaf->parent->subtree_dirty, TRUE);
+  ASSERT_EQ(w->subtree_dirty, TRUE);
+
+  widget_destroy(w);
+}
@@ -0,0 +1,105 @@
+#include "base/mem.h"
+#include "base/view.h"
+#include "base/canvas.h"
+#include "base/window_animator.h"
+#include "lcd/lcd_mem.h"
+#include "gtest/gtest.h"
+
+static ret_t test_get_dirty_rect(window_animator_t* wa, rect_t* r) {
+  int32_t h = 50 * wa->percent;
+
+  rectp_init(r, 0, 100 - h, 100, h);
+
+  return RET_OK;
+}
+
+static ret_t test_destroy(window_animator_t* wa) {
+  TKMEM_FREE(wa);
+
+  return RET_OK;
+}
+
+static window_animator_t* test_create(canvas_t* c, widget_t* win) {
+  window_animator_t* wa = TKMEM_ZALLOC(window_animator_t);
+
+  wa->canvas = c;
+  wa->curr_win = win;
+  wa->duration = 160;
+  wa->destroy = test_destroy;
+  wa->get_dirty_rect = test_get_dirty_rect;
+
+  return wa;
+}
+
+static void test_assert_rect(rect_t* r, xy_t x, xy_t y, wh_t w, wh_t h) {
+  ASSERT_EQ(r->x, x);
+  ASSERT_EQ(r->y, y);
+  ASSERT_EQ(r->w, w);
+  ASSERT_EQ(r->h, h);
+}
+
+TEST(WindowAnimator, dirty_rect) {
+  canvas_t canvas;
+  font_manager_t font_manager;
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  widget_t* wm = view_create(NULL, 0, 0, 100, 100);
+  widget_t* win = view_create(wm, 0, 50, 100, 50);
+  window_animator_t* wa = test_create(c, win);
+
+  /*第一帧更新整个屏幕，之后只更新窗口上一帧和这一帧覆盖的区域。*/
+  ASSERT_EQ(window_animator_update(wa, 1000), RET_OK);
+  test_assert_rect(&(wa->dirty_rect), 0, 0, 100, 100);
+
+  ASSERT_EQ(window_animator_update(wa, 1016), RET_OK);
+  test_assert_rect(&(wa->dirty_rect), 0, 95, 100, 5);
+
+  ASSERT_EQ(window_animator_update(wa, 1064), RET_OK);
+  test_assert_rect(&(wa->dirty_rect), 0, 80, 100, 20);
+
+  ASSERT_EQ(window_animator_update(wa, 1160), RET_DONE);
+  test_assert_rect(&(wa->dirty_rect), 0, 50, 100, 50);
+
+  /*没有提供get_dirty_rect的动画(平移)每帧更新整个屏幕。*/
+  window_animator_destroy(wa);
+  wa = test_create(c, win);
+  wa->get_dirty_rect = NULL;
+  ASSERT_EQ(window_animator_update(wa, 1000), RET_OK);
+  ASSERT_EQ(window_animator_update(wa, 1016), RET_OK);
+  test_assert_rect(&(wa->dirty_rect), 0, 0, 100, 100);
+
+  window_animator_destroy(wa);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
+
+TEST(WindowAnimator, stat) {
+  canvas_t canvas;
+  window_animator_stat_t stat;
+  font_manager_t font_manager;
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  widget_t* wm = view_create(NULL, 0, 0, 100, 100);
+  widget_t* win = view_create(wm, 0, 50, 100, 50);
+  window_animator_t* wa = test_create(c, win);
+
+  ASSERT_EQ(window_animator_update(wa, 1000), RET_OK);
+  ASSERT_EQ(window_animator_update(wa, 1016), RET_OK);
+  ASSERT_EQ(window_animator_get_stat(wa, &stat), RET_OK);
+  ASSERT_EQ(stat.frames, 2);
+  ASSERT_EQ(stat.dropped_frames, 0);
+  ASSERT_EQ(stat.fps, 62);
+
+  /*间隔48ms，丢掉两帧。*/
+  ASSERT_EQ(window_animator_update(wa, 1064), RET_OK);
+  ASSERT_EQ(window_animator_update(wa, 1160), RET_DONE);
+  ASSERT_EQ(window_animator_get_stat(wa, &stat), RET_OK);
+  ASSERT_EQ(stat.frames, 4);
+  ASSERT_EQ(stat.cost, 160);
+  ASSERT_EQ(stat.fps, 18);
+  ASSERT_EQ(stat.dropped_frames, 7);
+
+  window_animator_destroy(wa);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
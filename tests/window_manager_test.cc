@@ -0,0 +1,276 @@
+#include "base/idle.h"
+#include "base/view.h"
+#include "base/window.h"
+#include "base/dialog.h"
+#include "base/canvas.h"
+#include "base/window_manager.h"
+#include "lcd/lcd_mem.h"
+#include "tools/theme_gen/xml_theme_gen.h"
+#include "gtest/gtest.h"
+
+typedef struct _test_paint_ctx_t {
+  color_t color;
+  uint32_t times;
+} test_paint_ctx_t;
+
+static ret_t test_on_paint(void* ctx, event_t* e) {
+  paint_event_t* evt = (paint_event_t*)e;
+  test_paint_ctx_t* info = (test_paint_ctx_t*)ctx;
+  widget_t* widget = WIDGETP(e->target);
+
+  info->times++;
+  canvas_set_fill_color(evt->c, info->color);
+  canvas_fill_rect(evt->c, 0, 0, widget->w, widget->h);
+
+  return RET_OK;
+}
+
+static color_t test_get_color(lcd_t* lcd, xy_t x, xy_t y) {
+  return lcd->get_point_color(lcd, x, y);
+}
+
+/*背景色不透明的窗口才使用合成模式的缓冲区。*/
+static const uint8_t* test_opaque_style(uint16_t type) {
+  static uint8_t buff[1024];
+  static theme_t theme = {NULL};
+  const char* str =
+      "<window><style><normal bg_color=\"black\" /></style></window>"
+      "<dialog><style><normal bg_color=\"black\" /></style></dialog>";
+
+  if (theme.data == NULL) {
+    xml_gen_buff(str, buff, sizeof(buff));
+    theme.data = buff;
+  }
+
+  return theme_find_style(&theme, type, 0, WIDGET_STATE_NORMAL);
+}
+
+static widget_t* test_add_client(widget_t* win, test_paint_ctx_t* ctx) {
+  widget_t* client = view_create(win, 0, 0, win->w, win->h);
+
+  win->style.data = test_opaque_style(win->type);
+
+  widget_on(client, EVT_PAINT, test_on_paint, ctx);
+  idle_dispatch();
+
+  return win;
+}
+
+static widget_t* test_create_window(widget_t* wm, test_paint_ctx_t* ctx) {
+  return test_add_client(window_create(wm, 0, 0, wm->w, wm->h), ctx);
+}
+
+static widget_t* test_create_dialog(widget_t* wm, wh_t w, wh_t h, test_paint_ctx_t* ctx) {
+  return test_add_client(dialog_create(wm, 0, 0, w, h), ctx);
+}
+
+TEST(WindowManager, compositor) {
+  canvas_t canvas;
+  font_manager_t font_manager;
+  test_paint_ctx_t wctx = {color_init(0, 0, 0xff, 0xff), 0};
+  test_paint_ctx_t dctx = {color_init(0xff, 0, 0, 0xff), 0};
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  window_manager_t* wmp = WINDOW_MANAGER(wm);
+  window_surface_t* s = NULL;
+  widget_t* win = NULL;
+  widget_t* dlg = NULL;
+  rect_t r;
+
+  window_manager_set(wm);
+  window_manager_resize(wm, 100, 100);
+  win = test_create_window(wm, &wctx);
+
+  ASSERT_EQ(window_manager_set_compositor(wm, TRUE), RET_OK);
+  window_manager_paint(wm, c);
+  window_manager_paint(wm, c);
+  ASSERT_EQ(wmp->surfaces.size, 1);
+  ASSERT_EQ(wctx.times, 1);
+  ASSERT_EQ(test_get_color(lcd, 50, 50).color, wctx.color.color);
+
+  /*打开和关闭对话框时，下面的窗口只需要重新合成。*/
+  dlg = test_create_dialog(wm, 40, 40, &dctx);
+  window_manager_paint(wm, c);
+  ASSERT_EQ(wmp->surfaces.size, 2);
+  ASSERT_EQ(wctx.times, 1);
+  ASSERT_EQ(dctx.times, 1);
+  ASSERT_EQ(test_get_color(lcd, 50, 50).color, dctx.color.color);
+  ASSERT_EQ(test_get_color(lcd, 10, 10).color, wctx.color.color);
+
+  window_manager_remove_child(wm, dlg);
+  idle_dispatch();
+  window_manager_paint(wm, c);
+  window_manager_paint(wm, c);
+  ASSERT_EQ(wmp->surfaces.size, 1);
+  ASSERT_EQ(wctx.times, 1);
+  ASSERT_EQ(test_get_color(lcd, 50, 50).color, wctx.color.color);
+
+  /*窗口内的刷新只重绘缓冲区中脏的部分。*/
+  rect_init(r, 5, 6, 7, 8);
+  widget_invalidate(win, &r);
+  s = (window_surface_t*)(wmp->surfaces.elms[0]);
+  ASSERT_EQ(s->dirty.x, 5);
+  ASSERT_EQ(s->dirty.y, 6);
+  ASSERT_EQ(s->dirty.w, 7);
+  ASSERT_EQ(s->dirty.h, 8);
+  window_manager_paint(wm, c);
+  ASSERT_EQ(wctx.times, 2);
+  ASSERT_EQ(s->dirty.w, 0);
+
+  /*按不透明度合成。*/
+  dlg = test_create_dialog(wm, 40, 40, &dctx);
+  widget_set_opacity(dlg, 0x80);
+  window_manager_paint(wm, c);
+  ASSERT_EQ(test_get_color(lcd, 50, 50).rgba.r, 0x80);
+  ASSERT_EQ(test_get_color(lcd, 50, 50).rgba.b, 0x7f);
+  ASSERT_EQ(test_get_color(lcd, 10, 10).color, wctx.color.color);
+
+  /*动画直接使用缓冲区。*/
+  ASSERT_TRUE(window_manager_get_surface(wm, win) != NULL);
+  ASSERT_TRUE(window_manager_get_surface(wm, win)->flags & BITMAP_FLAG_LCD_NATIVE);
+
+  ASSERT_EQ(window_manager_set_compositor(wm, FALSE), RET_OK);
+  ASSERT_EQ(wmp->surfaces.size, 0);
+  ASSERT_TRUE(window_manager_get_surface(wm, win) == NULL);
+  window_manager_paint(wm, c);
+  ASSERT_EQ(wctx.times, 3);
+
+  widget_destroy(dlg);
+  widget_destroy(win);
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
+
+TEST(WindowManager, compositor_transparent) {
+  canvas_t canvas;
+  font_manager_t font_manager;
+  test_paint_ctx_t wctx = {color_init(0, 0, 0xff, 0xff), 0};
+  test_paint_ctx_t dctx = {color_init(0xff, 0, 0, 0xff), 0};
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  window_manager_t* wmp = WINDOW_MANAGER(wm);
+  widget_t* win = NULL;
+  widget_t* dlg = NULL;
+  widget_t* box = NULL;
+
+  window_manager_set(wm);
+  window_manager_resize(wm, 100, 100);
+  win = test_create_window(wm, &wctx);
+  ASSERT_EQ(window_manager_set_compositor(wm, TRUE), RET_OK);
+  window_manager_paint(wm, c);
+  window_manager_paint(wm, c);
+
+  /*没有背景色的对话框只画了左上角，其它部分要露出下面的窗口，不能使用没有清除的缓冲区。*/
+  dlg = dialog_create(wm, 0, 0, 40, 40);
+  widget_set_visible(DIALOG(dlg)->title, FALSE, FALSE);
+  widget_set_visible(DIALOG(dlg)->client, FALSE, FALSE);
+  box = view_create(dlg, 0, 0, 10, 10);
+  widget_on(box, EVT_PAINT, test_on_paint, &dctx);
+  idle_dispatch();
+  window_manager_paint(wm, c);
+  ASSERT_EQ(wmp->surfaces.size, 1);
+  ASSERT_TRUE(window_manager_get_surface(wm, dlg) == NULL);
+  ASSERT_EQ(dctx.times, 1);
+  ASSERT_EQ(wctx.times, 1);
+  ASSERT_EQ(test_get_color(lcd, dlg->x + 5, dlg->y + 5).color, dctx.color.color);
+  ASSERT_EQ(test_get_color(lcd, dlg->x + 20, dlg->y + 20).color, wctx.color.color);
+
+  /*对话框内的刷新重新合成下面的窗口，再直接绘制对话框。*/
+  widget_invalidate(box, NULL);
+  window_manager_paint(wm, c);
+  ASSERT_EQ(dctx.times, 2);
+  ASSERT_EQ(wctx.times, 1);
+  ASSERT_EQ(test_get_color(lcd, dlg->x + 5, dlg->y + 5).color, dctx.color.color);
+
+  widget_destroy(dlg);
+  widget_destroy(win);
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
+
+TEST(WindowManager, compositor_same_as_normal) {
+  uint32_t i = 0;
+  canvas_t canvas;
+  font_manager_t font_manager;
+  test_paint_ctx_t wctx = {color_init(0, 0xff, 0, 0xff), 0};
+  test_paint_ctx_t dctx = {color_init(0xff, 0, 0xff, 0xff), 0};
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  lcd_t* lcd = lcd_mem_create(100, 100, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  uint32_t* pixels = (uint32_t*)(((lcd_mem_t*)lcd)->pixels);
+  uint32_t* normal = (uint32_t*)malloc(100 * 100 * sizeof(uint32_t));
+  widget_t* win = NULL;
+  widget_t* dlg = NULL;
+
+  window_manager_set(wm);
+  window_manager_resize(wm, 100, 100);
+  win = test_create_window(wm, &wctx);
+  dlg = test_create_dialog(wm, 60, 30, &dctx);
+
+  window_manager_paint(wm, c);
+  memcpy(normal, pixels, 100 * 100 * sizeof(uint32_t));
+
+  memset(pixels, 0x00, 100 * 100 * sizeof(uint32_t));
+  window_manager_set_compositor(wm, TRUE);
+  window_manager_paint(wm, c);
+  for (i = 0; i < 100 * 100; i++) {
+    ASSERT_EQ(pixels[i], normal[i]);
+  }
+
+  free(normal);
+  widget_destroy(dlg);
+  widget_destroy(win);
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
+
+TEST(WindowManager, tiled_same_as_normal) {
+  uint32_t i = 0;
+  canvas_t canvas;
+  font_manager_t font_manager;
+  test_paint_ctx_t wctx = {color_init(0, 0xff, 0, 0xff), 0};
+  test_paint_ctx_t dctx = {color_init(0xff, 0, 0xff, 0xff), 0};
+  widget_t* old_wm = window_manager();
+  widget_t* wm = window_manager_create();
+  lcd_t* lcd = lcd_mem_create(400, 400, TRUE);
+  canvas_t* c = canvas_init(&canvas, lcd, font_manager_init(&font_manager));
+  uint32_t* pixels = (uint32_t*)(((lcd_mem_t*)lcd)->pixels);
+  uint32_t* normal = (uint32_t*)malloc(400 * 400 * sizeof(uint32_t));
+  tile_renderer_t* tr = tile_renderer_create(4);
+  widget_t* win = NULL;
+  widget_t* dlg = NULL;
+
+  window_manager_set(wm);
+  window_manager_resize(wm, 400, 400);
+  win = test_create_window(wm, &wctx);
+  dlg = test_create_dialog(wm, 200, 100, &dctx);
+
+  window_manager_paint(wm, c);
+  memcpy(normal, pixels, 400 * 400 * sizeof(uint32_t));
+
+  memset(pixels, 0x00, 400 * 400 * sizeof(uint32_t));
+  window_manager_set_tile_renderer(wm, tr);
+  widget_invalidate(wm, NULL);
+  window_manager_paint(wm, c);
+  ASSERT_EQ(tr->tiled, 1);
+  for (i = 0; i < 400 * 400; i++) {
+    ASSERT_EQ(pixels[i], normal[i]);
+  }
+
+  window_manager_set_tile_renderer(wm, NULL);
+  tile_renderer_destroy(tr);
+  free(normal);
+  widget_destroy(dlg);
+  widget_destroy(win);
+  window_manager_set(old_wm);
+  widget_destroy(wm);
+  lcd_destroy(lcd);
+}
@@ -0,0 +1,331 @@
+/**
+ * File:   main.c
+ * Author: Li XianJing <xianjimli@hotmail.com>
+ * Brief:  headless benchmark runner
+ *
+ * Copyright (c) 2018 - 2018  Li XianJing <xianjimli@hotmail.com>
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * License file for more details.
+ *
+ */
+
+/**
+ * History:
+ * ================================================================
+ * 2018-05-21 Li XianJing <xianjimli@hotmail.com> created
+ *
+ */
+
+#include "tk.h"
+#include "base/mem.h"
+#include "base/locale.h"
+#include "base/platform.h"
+#include "base/profiler.h"
+#include "common/utils.h"
+#include "lcd/lcd_mem.h"
+#include "demos/resource.h"
+#include "base/font_manager.h"
+#include "base/image_manager.h"
+#include "base/window_manager.h"
+#include "base/frame_scheduler.h"
+#include "base/resource_manager.h"
+#include "ui_loader/ui_builder_default.h"
+#include "main_loop/main_loop_headless.h"
+
+#ifdef WITH_STB_IMAGE
+#include "image_loader/image_loader_stb.h"
+#endif /*WITH_STB_IMAGE*/
+
+#define BENCH_PROFILER_EVENTS 4096
+
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb/stb_image_write.h"
+
+typedef struct _bench_t {
+  FILE* fp;
+  lcd_t* lcd;
+  uint32_t frames;
+  uint32_t total_cost;
+  uint32_t max_cost;
+  uint32_t total_cpu_time;
+  uint32_t max_cpu_time;
+  uint32_t total_dirty_area;
+  uint32_t alloc_times;
+  uint32_t free_times;
+  uint32_t mismatches;
+  uint32_t overdraw_frames;
+  uint32_t total_overdraw;
+  uint32_t max_overdraw;
+  uint64_t profile_off_us;
+  uint64_t profile_on_us;
+} bench_t;
+
+static ret_t bench_on_frame(void* ctx, const headless_frame_t* frame) {
+  bench_t* bench = (bench_t*)ctx;
+  const rect_t* r = &(frame->dirty);
+  uint32_t area = (r->w > 0 && r->h > 0) ? r->w * r->h : 0;
+  uint32_t overdraw = lcd_mem_get_overdraw_ratio(bench->lcd);
+
+  fprintf(bench->fp,
+          "%s\n    {\"index\":%u, \"time\":%u, \"dirty\":[%d, %d, %d, %d], \"dirty_area\":%u, "
+          "\"cost_ms\":%u, \"cpu_us\":%u, \"allocs\":%u, \"frees\":%u, "
+          "\"checksum\":\"%08x\", \"overdraw\":%u}",
+          frame->index > 0 ? "," : "", frame->index, frame->time, r->x, r->y, r->w, r->h, area,
+          frame->cost, frame->cpu_time, frame->alloc_times, frame->free_times, frame->checksum,
+          overdraw);
+
+  if (overdraw > 0) {
+    bench->overdraw_frames++;
+    bench->total_overdraw += overdraw;
+    bench->max_overdraw = ftk_max(bench->max_overdraw, overdraw);
+  }
+
+  bench->frames++;
+  bench->total_cost += frame->cost;
+  bench->max_cost = ftk_max(bench->max_cost, frame->cost);
+  bench->total_cpu_time += frame->cpu_time;
+  bench->max_cpu_time = ftk_max(bench->max_cpu_time, frame->cpu_time);
+  bench->total_dirty_area += area;
+  bench->alloc_times += frame->alloc_times;
+  bench->free_times += frame->free_times;
+
+  return RET_OK;
+}
+
+/*拖动：按下、在ms毫秒内每帧移动一次、抬起。*/
+static ret_t bench_drag(main_loop_t* l, int x1, int y1, int x2, int y2, uint32_t ms) {
+  uint32_t i = 0;
+  uint32_t interval = frame_scheduler()->interval;
+  uint32_t steps = ftk_max(ms / interval, 1);
+
+  main_loop_headless_pointer(l, EVT_POINTER_DOWN, x1, y1);
+  for (i = 1; i <= steps; i++) {
+    main_loop_headless_step(l, interval);
+    main_loop_headless_pointer(l, EVT_POINTER_MOVE, x1 + (x2 - x1) * (int)i / (int)steps,
+                               y1 + (y2 - y1) * (int)i / (int)steps);
+  }
+  main_loop_headless_pointer(l, EVT_POINTER_UP, x2, y2);
+
+  return RET_OK;
+}
+
+/*回放输入轨迹，update为TRUE时把回放得到的校验和写回轨迹文件。*/
+static ret_t bench_replay(bench_t* bench, main_loop_t* l, const char* filename, bool_t update) {
+  ret_t ret = RET_OK;
+  input_trace_t* trace = input_trace_load(filename);
+  return_value_if_fail(trace != NULL, RET_FAIL);
+
+  ret = main_loop_headless_replay(l, trace, update);
+  bench->mismatches += ((main_loop_headless_t*)l)->mismatches;
+  if (update) {
+    ret = input_trace_save(trace, filename);
+  } else if (ret == RET_FAIL) {
+    /*不一致的帧记在summary中，继续运行后面的命令。*/
+    ret = RET_OK;
+  }
+  input_trace_destroy(trace);
+
+  return ret;
+}
+
+/*把最近一帧的过度绘制热图保存为PNG文件。*/
+static ret_t bench_save_heatmap(bench_t* bench, const char* filename) {
+  bitmap_t img;
+  int ok = 0;
+
+  return_value_if_fail(lcd_mem_get_overdraw_heatmap(bench->lcd, &img) == RET_OK, RET_FAIL);
+  ok = stbi_write_png(filename, img.w, img.h, 4, img.data, img.w * 4);
+  bitmap_destroy(&img);
+
+  return ok ? RET_OK : RET_FAIL;
+}
+
+/*把全部窗口重绘n次，关闭和开启profiler的记录交替进行，减少CPU频率变化等因素对比较的影响。*/
+static ret_t bench_profile(bench_t* bench, main_loop_t* l, uint32_t n) {
+  uint32_t i = 0;
+  uint32_t j = 0;
+  uint64_t start = 0;
+  main_loop_headless_t* loop = (main_loop_headless_t*)l;
+  widget_t* wm = loop->wm;
+  return_value_if_fail(n > 0 && wm->children != NULL, RET_BAD_PARAMS);
+
+  for (i = 0; i < 2 * n; i++) {
+    bool_t on = (i & 1) != 0;
+
+    if (on) {
+      return_value_if_fail(profiler_start(BENCH_PROFILER_EVENTS) == RET_OK, RET_OOM);
+    }
+
+    for (j = 0; j < wm->children->size; j++) {
+      widget_invalidate((widget_t*)(wm->children->elms[j]), NULL);
+    }
+
+    start = get_time_us();
+    window_manager_paint(wm, &(loop->canvas));
+    if (on) {
+      bench->profile_on_us += get_time_us() - start;
+      profiler_stop();
+    } else {
+      bench->profile_off_us += get_time_us() - start;
+    }
+  }
+  profiler_deinit();
+
+  return RET_OK;
+}
+
+static ret_t bench_run_line(bench_t* bench, main_loop_t* l, const char* line) {
+  int x = 0;
+  int y = 0;
+  int x2 = 0;
+  int y2 = 0;
+  uint32_t n = 0;
+  char name[MAX_PATH + 1];
+  char mode[16];
+
+  memset(name, 0x00, sizeof(name));
+  memset(mode, 0x00, sizeof(mode));
+  if (sscanf(line, "open %63s", name) == 1) {
+    return window_open(name) != NULL ? RET_OK : RET_NOT_FOUND;
+  } else if (sscanf(line, "down %d %d", &x, &y) == 2) {
+    return main_loop_headless_pointer(l, EVT_POINTER_DOWN, x, y);
+  } else if (sscanf(line, "move %d %d", &x, &y) == 2) {
+    return main_loop_headless_pointer(l, EVT_POINTER_MOVE, x, y);
+  } else if (sscanf(line, "up %d %d", &x, &y) == 2) {
+    return main_loop_headless_pointer(l, EVT_POINTER_UP, x, y);
+  } else if (sscanf(line, "click %d %d", &x, &y) == 2) {
+    main_loop_headless_pointer(l, EVT_POINTER_DOWN, x, y);
+    return main_loop_headless_pointer(l, EVT_POINTER_UP, x, y);
+  } else if (sscanf(line, "drag %d %d %d %d %u", &x, &y, &x2, &y2, &n) == 5) {
+    return bench_drag(l, x, y, x2, y2, n);
+  } else if (sscanf(line, "key %u", &n) == 1) {
+    main_loop_headless_key(l, EVT_KEY_DOWN, n);
+    return main_loop_headless_key(l, EVT_KEY_UP, n);
+  } else if (sscanf(line, "wait %u", &n) == 1) {
+    return main_loop_headless_step(l, n);
+  } else if (sscanf(line, "replay %255s %15s", name, mode) >= 1) {
+    return bench_replay(bench, l, name, strcmp(mode, "update") == 0);
+  } else if (sscanf(line, "overdraw %15s", mode) == 1) {
+    return lcd_mem_set_overdraw(bench->lcd, strcmp(mode, "off") != 0, strcmp(mode, "show") == 0);
+  } else if (sscanf(line, "heatmap %255s", name) == 1) {
+    return bench_save_heatmap(bench, name);
+  } else if (sscanf(line, "profile %u", &n) == 1) {
+    return bench_profile(bench, l, n);
+  } else if (line[0] == '#' || line[0] == '\0') {
+    return RET_OK;
+  }
+
+  return RET_BAD_PARAMS;
+}
+
+static ret_t bench_run_script(bench_t* bench, main_loop_t* l, char* script) {
+  uint32_t lineno = 1;
+  char* line = script;
+
+  while (line != NULL && *line) {
+    char* end = strchr(line, '\n');
+    if (end != NULL) {
+      *end = '\0';
+      if (end > line && end[-1] == '\r') {
+        end[-1] = '\0';
+      }
+    }
+
+    if (bench_run_line(bench, l, line) != RET_OK) {
+      fprintf(stderr, "line %u: invalid command: %s\n", lineno, line);
+      return RET_FAIL;
+    }
+
+    line = end != NULL ? end + 1 : NULL;
+    lineno++;
+  }
+
+  /*最后一个输入之后的帧。*/
+  return main_loop_headless_step(l, 0);
+}
+
+static ret_t bench_init(void) {
+  image_loader_t* loader = NULL;
+#ifdef WITH_STB_IMAGE
+  loader = image_loader_stb();
+#endif /*WITH_STB_IMAGE*/
+
+  platform_prepare();
+  resource_manager_set(resource_manager_create(30));
+  locale_set(locale_create(NULL, NULL));
+  font_manager_set(font_manager_create());
+  image_manager_set(image_manager_create(loader));
+  window_manager_set(window_manager_create());
+  frame_scheduler_set(frame_scheduler_create(TK_FRAME_INTERVAL));
+
+  resource_init();
+
+  return tk_init_resources();
+}
+
+int main(int argc, char** argv) {
+  bench_t bench;
+  ret_t ret = RET_OK;
+  uint32_t size = 0;
+  char* script = NULL;
+  main_loop_t* l = NULL;
+  wh_t w = 320;
+  wh_t h = 480;
+
+  TKMEM_INIT(4 * 1024 * 1024);
+
+  if (argc < 3) {
+    printf("Usage: %s script_filename output_filename [width] [height]\n", argv[0]);
+    return 0;
+  }
+
+  if (argc > 4) {
+    w = atoi(argv[3]);
+    h = atoi(argv[4]);
+  }
+
+  script = read_file(argv[1], &size);
+  return_value_if_fail(script != NULL, 1);
+
+  memset(&bench, 0x00, sizeof(bench));
+  bench.fp = fopen(argv[2], "w");
+  return_value_if_fail(bench.fp != NULL, 1);
+
+  bench_init();
+  l = main_loop_headless_create(w, h);
+  return_value_if_fail(l != NULL, 1);
+  bench.lcd = ((main_loop_headless_t*)l)->lcd;
+  main_loop_headless_set_on_frame(l, bench_on_frame, &bench);
+
+  fprintf(bench.fp, "{\n  \"script\":\"%s\", \"width\":%d, \"height\":%d, \"interval\":%u,\n",
+          argv[1], w, h, frame_scheduler()->interval);
+  fprintf(bench.fp, "  \"frames\":[");
+  ret = bench_run_script(&bench, l, script);
+  fprintf(bench.fp, "\n  ],\n");
+
+  fprintf(bench.fp,
+          "  \"summary\":{\"ok\":%s, \"frames\":%u, \"missed\":%u, \"total_cost_ms\":%u, "
+          "\"max_cost_ms\":%u, \"total_cpu_us\":%u, \"max_cpu_us\":%u, \"total_dirty_area\":%u, "
+          "\"allocs\":%u, \"frees\":%u, \"mismatches\":%u, \"avg_overdraw\":%u, "
+          "\"max_overdraw\":%u, \"profile_off_us\":%u, \"profile_on_us\":%u, "
+          "\"profile_overhead\":%.1f}\n}\n",
+          ret == RET_OK && bench.mismatches == 0 ? "true" : "false", bench.frames,
+          frame_scheduler()->stat.missed, bench.total_cost, bench.max_cost, bench.total_cpu_time,
+          bench.max_cpu_time, bench.total_dirty_area, bench.alloc_times, bench.free_times,
+          bench.mismatches,
+          bench.overdraw_frames > 0 ? bench.total_overdraw / bench.overdraw_frames : 0,
+          bench.max_overdraw, (uint32_t)bench.profile_off_us, (uint32_t)bench.profile_on_us,
+          bench.profile_off_us > 0
+              ? ((double)bench.profile_on_us - bench.profile_off_us) * 100 / bench.profile_off_us
+              : 0.0);
+
+  fclose(bench.fp);
+
+  main_loop_destroy(l);
+  TKMEM_FREE(script);
+
+  return ret == RET_OK && bench.mismatches == 0 ? 0 : 1;
+}
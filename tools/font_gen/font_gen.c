@@ -29,7 +29,7 @@
 #include "base/resource_manager.h"
 
 #define MAX_CHARS 100 * 1024
-#define MAX_BUFF_SIZE 1 * 1024 * 1024
+#define MAX_BUFF_SIZE 16 * 1024 * 1024
 
 static int char_cmp(const void* a, const void* b) {
   wchar_t c1 = *(wchar_t*)a;
@@ -44,20 +44,184 @@ ret_t font_gen(font_t* font, uint16_t font_size, const char* str, const char* ou
   uint32_t size = font_gen_buff(font, font_size, str, buff, MAX_BUFF_SIZE);
 
   filename_to_name(output_filename, name, sizeof(name));
-  output_res_c_source(output_filename, RESOURCE_TYPE_FONT, RESOURCE_TYPE_FONT_BMP, buff, size);
+  if (size > 0) {
+    output_res_c_source(output_filename, RESOURCE_TYPE_FONT, RESOURCE_TYPE_FONT_BMP, buff, size);
+  }
 
   TKMEM_FREE(buff);
 
-  return RET_OK;
+  return size > 0 ? RET_OK : RET_FAIL;
+}
+
+ret_t font_gen_sizes(font_t* font, const uint16_t* sizes, uint32_t nr, uint8_t format,
+                     const char* str, const char* output_filename) {
+  uint32_t size = 0;
+  uint8_t* buff = NULL;
+  return_value_if_fail(sizes != NULL && nr > 0, RET_BAD_PARAMS);
+
+  buff = (uint8_t*)TKMEM_ALLOC(MAX_BUFF_SIZE * nr);
+  return_value_if_fail(buff != NULL, RET_OOM);
+
+  /*总是放到容器中，容器中的字体使用32位的字模偏移，大字库也不会溢出。*/
+  size = font_gen_buff_sizes(font, sizes, nr, format, str, buff, MAX_BUFF_SIZE * nr);
+
+  if (size > 0) {
+    output_res_c_source(output_filename, RESOURCE_TYPE_FONT, RESOURCE_TYPE_FONT_BMP, buff, size);
+  }
+
+  TKMEM_FREE(buff);
+
+  return size > 0 ? RET_OK : RET_FAIL;
+}
+
+uint32_t font_gen_buff_sizes(font_t* font, const uint16_t* sizes, uint32_t nr, uint8_t format,
+                             const char* str, uint8_t* output_buff, uint32_t buff_size) {
+  uint32_t i = 0;
+  uint8_t* p = output_buff;
+  uint8_t* table = NULL;
+  return_value_if_fail(sizes != NULL && nr > 0 && buff_size > 8 + nr * 8, 0);
+
+  save_uint32(p, FONT_BITMAP_CONTAINER_MAGIC);
+  save_uint32(p, nr);
+  table = p;
+  p += nr * 8;
+
+  for (i = 0; i < nr; i++) {
+    uint32_t size = 0;
+    uint32_t offset = ((p - output_buff) + 3) & ~3;
+
+    return_value_if_fail(offset < buff_size, 0);
+    p = output_buff + offset;
+    size = font_gen_buff_face(font, sizes[i], format, str, p, buff_size - offset, TRUE);
+    return_value_if_fail(size > 0, 0);
+
+    save_uint32(table, offset);
+    save_uint32(table, size);
+    p += size;
+  }
+
+  return p - output_buff;
+}
+
+/*8位覆盖率量化成bpp位，四舍五入。*/
+static uint8_t font_gen_quantize(uint8_t alpha, uint32_t bpp) {
+  uint32_t max = (1 << bpp) - 1;
+
+  return (alpha * max + 0x7f) / 0xff;
+}
+
+static uint32_t font_gen_encode_rle(glyph_t* g, uint32_t bpp, uint8_t* output_buff,
+                                    uint32_t buff_size) {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint8_t* p = output_buff;
+  uint32_t max_run = 0xff >> bpp;
+
+  for (y = 0; y < g->h; y++) {
+    const uint8_t* row = g->data + y * g->w;
+
+    for (x = 0; x < g->w;) {
+      uint32_t n = 1;
+      uint8_t v = font_gen_quantize(row[x], bpp);
+
+      while (x + n < g->w && n <= max_run && font_gen_quantize(row[x + n], bpp) == v) {
+        n++;
+      }
+
+      return_value_if_fail((uint32_t)(p - output_buff) < buff_size, 0);
+      *p++ = (v << (8 - bpp)) | (n - 1);
+      x += n;
+    }
+  }
+
+  return p - output_buff;
+}
+
+uint32_t font_gen_encode_glyph(glyph_t* g, uint8_t format, uint8_t* output_buff,
+                               uint32_t buff_size) {
+  uint32_t x = 0;
+  uint32_t y = 0;
+  uint32_t size = 0;
+  uint32_t stride = 0;
+  uint32_t bpp = GLYPH_FMT_BPP(format);
+  return_value_if_fail(g != NULL && output_buff != NULL, 0);
+
+  if (bpp == 8) {
+    size = g->w * g->h;
+    return_value_if_fail(size <= buff_size, 0);
+    memcpy(output_buff, g->data, size);
+
+    return size;
+  }
+
+  if (format & GLYPH_FMT_RLE) {
+    return font_gen_encode_rle(g, bpp, output_buff, buff_size);
+  }
+
+  stride = (g->w * bpp + 7) >> 3;
+  size = stride * g->h;
+  return_value_if_fail(size <= buff_size, 0);
+  memset(output_buff, 0x00, size);
+
+  for (y = 0; y < g->h; y++) {
+    uint8_t* row = output_buff + y * stride;
+    for (x = 0; x < g->w; x++) {
+      uint32_t bits = x * bpp;
+      uint8_t v = font_gen_quantize(g->data[y * g->w + x], bpp);
+
+      row[bits >> 3] |= v << (8 - bpp - (bits & 0x07));
+    }
+  }
+
+  return size;
 }
 
 uint32_t font_gen_buff(font_t* font, uint16_t font_size, const char* str, uint8_t* output_buff,
                        uint32_t buff_size) {
+  return font_gen_buff_ex(font, font_size, GLYPH_FMT_A8, str, output_buff, buff_size);
+}
+
+uint32_t font_gen_buff_ex(font_t* font, uint16_t font_size, uint8_t format, const char* str,
+                          uint8_t* output_buff, uint32_t buff_size) {
+  return font_gen_buff_face(font, font_size, format, str, output_buff, buff_size, FALSE);
+}
+
+/*
+ * 写入一个字符的索引。旧格式的字模偏移只有16位，超过时报错，不生成错误的字体。
+ */
+static ret_t font_gen_save_index(uint8_t* output_buff, uint32_t i, uint32_t c, uint32_t offset,
+                                 bool_t wide) {
+  font_bitmap_header_t* header = (font_bitmap_header_t*)output_buff;
+
+  if (wide) {
+    font_bitmap_index32_t* iter = ((font_bitmap_index32_t*)(header->index)) + i;
+    iter->c = c;
+    iter->offset = offset;
+  } else {
+    font_bitmap_index_t* iter = header->index + i;
+    if (offset > 0xffff) {
+      printf("font is too large(glyph offset %u > 0xffff), use the multi-size container.\n",
+             offset);
+      return RET_FAIL;
+    }
+    iter->c = c;
+    iter->offset = offset;
+  }
+
+  return RET_OK;
+}
+
+uint32_t font_gen_buff_face(font_t* font, uint16_t font_size, uint8_t format, const char* str,
+                            uint8_t* output_buff, uint32_t buff_size, bool_t wide) {
   int i = 0;
   glyph_t g;
   int size = 0;
   uint8_t* p = NULL;
+  uint32_t offset = 0;
+  uint8_t* advances = NULL;
   wchar_t wstr[MAX_CHARS];
+  glyph_metrics_t m;
+  uint32_t index_size = wide ? sizeof(font_bitmap_index32_t) : sizeof(font_bitmap_index_t);
 
   font_bitmap_header_t* header = (font_bitmap_header_t*)output_buff;
 
@@ -66,41 +230,71 @@ uint32_t font_gen_buff(font_t* font, uint16_t font_size, const char* str, uint8_
 
   qsort(wstr, size, sizeof(wchar_t), char_cmp);
   size = unique(wstr, size);
+  return_value_if_fail(size <= 0xffff, 0);
+  return_value_if_fail(buff_size > 512 && buff_size > 4 + size * index_size, 0);
 
   header->char_nr = size;
   header->font_size = font_size;
 
-  p = (uint8_t*)(header->index + size);
-  return_value_if_fail(buff_size > 512, 0);
+  p = output_buff + 4 + size * index_size;
 
   for (i = 0; i < size; i++) {
     wchar_t c = wstr[i];
-    font_bitmap_index_t* iter = header->index + i;
 
-    iter->c = c;
-    iter->offset = p - output_buff;
+    offset = p - output_buff;
+    return_value_if_fail(font_gen_save_index(output_buff, i, c, offset, wide) == RET_OK, 0);
 
+    /*空白字符只保存宽度。*/
     if (iswspace(c)) {
+      return_value_if_fail(buff_size > (offset + 4), 0);
+      save_uint8(p, 0);
+      save_uint8(p, 0);
+      save_uint8(p, 0);
+      save_uint8(p, 0);
       continue;
     }
     printf("%d/%d: 0x%04x\n", i, size, c);
     if (font_find_glyph(font, c, &g, font_size) == RET_OK) {
-      uint32_t data_size = g.w * g.h;
-      return_value_if_fail(buff_size > (iter->offset + data_size + 4), 0);
+      uint32_t data_size = 0;
+      return_value_if_fail(buff_size > (offset + 4), 0);
 
       save_uint8(p, g.x);
       save_uint8(p, g.y);
       save_uint8(p, g.w);
       save_uint8(p, g.h);
-      memcpy(p, g.data, data_size);
+      if (g.w > 0 && g.h > 0) {
+        data_size = font_gen_encode_glyph(&g, format, p, buff_size - (offset + 4));
+        return_value_if_fail(data_size > 0, 0);
+      }
       p += data_size;
     } else if (c > 32) {
       printf("not found %d\n", c);
       exit(0);
     } else {
-      iter->offset = 0;
+      font_gen_save_index(output_buff, i, c, 0, wide);
     }
   }
 
+  /*每个字符的宽度放在最后，测量文本时不需要访问字模。*/
+  return_value_if_fail(buff_size > (p - output_buff) + size + FONT_BITMAP_FORMAT_FOOTER_SIZE, 0);
+
+  advances = p;
+  for (i = 0; i < size; i++) {
+    if (font_get_metrics(font, wstr[i], &m, font_size) == RET_OK) {
+      save_uint8(p, m.advance);
+    } else {
+      save_uint8(p, FONT_DEFAULT_ADVANCE);
+    }
+  }
+
+  if (format == GLYPH_FMT_A8) {
+    save_uint32(p, (uint32_t)(advances - output_buff));
+    save_uint32(p, FONT_BITMAP_METRICS_MAGIC);
+  } else {
+    save_uint32(p, format);
+    save_uint32(p, (uint32_t)(advances - output_buff));
+    save_uint32(p, FONT_BITMAP_FORMAT_MAGIC);
+  }
+
   return p - output_buff;
 }
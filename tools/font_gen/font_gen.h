@@ -29,6 +29,18 @@ BEGIN_C_DECLS
 ret_t font_gen(font_t* font, uint16_t font_size, const char* str, const char* output_filename);
 uint32_t font_gen_buff(font_t* font, uint16_t font_size, const char* str, uint8_t* output_buff,
                        uint32_t buff_size);
+uint32_t font_gen_buff_ex(font_t* font, uint16_t font_size, uint8_t format, const char* str,
+                          uint8_t* output_buff, uint32_t buff_size);
+uint32_t font_gen_buff_face(font_t* font, uint16_t font_size, uint8_t format, const char* str,
+                            uint8_t* output_buff, uint32_t buff_size, bool_t wide);
+
+ret_t font_gen_sizes(font_t* font, const uint16_t* sizes, uint32_t nr, uint8_t format,
+                     const char* str, const char* output_filename);
+uint32_t font_gen_buff_sizes(font_t* font, const uint16_t* sizes, uint32_t nr, uint8_t format,
+                             const char* str, uint8_t* output_buff, uint32_t buff_size);
+
+uint32_t font_gen_encode_glyph(glyph_t* g, uint8_t format, uint8_t* output_buff,
+                               uint32_t buff_size);
 
 END_C_DECLS
 
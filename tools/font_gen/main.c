@@ -25,20 +25,55 @@
 #include "font/font_stb.h"
 #include "font_gen.h"
 
+#define MAX_SIZES 8
+
+/*a8/a4/a2/a1，低位深的格式后面可以加_rle(如a2_rle)。*/
+static uint8_t parse_format(const char* str) {
+  uint8_t format = GLYPH_FMT_A8;
+
+  if (str[0] == 'a' || str[0] == 'A') {
+    switch (atoi(str + 1)) {
+      case 1:
+        format = GLYPH_FMT_A1;
+        break;
+      case 2:
+        format = GLYPH_FMT_A2;
+        break;
+      case 4:
+        format = GLYPH_FMT_A4;
+        break;
+      default:
+        break;
+    }
+  }
+
+  if (format != GLYPH_FMT_A8 && strstr(str, "_rle") != NULL) {
+    format |= GLYPH_FMT_RLE;
+  }
+
+  return format;
+}
+
 int main(int argc, char** argv) {
   uint32_t size = 0;
   font_t* font = NULL;
   char* str_buff = NULL;
   uint8_t* ttf_buff = NULL;
-  uint32_t font_size = 20;
+  uint32_t sizes_nr = 0;
+  uint16_t sizes[MAX_SIZES];
+  uint8_t format = GLYPH_FMT_A8;
+  const char* p = NULL;
   const char* ttf_filename = NULL;
   const char* str_filename = NULL;
   const char* output_filename = NULL;
 
   TKMEM_INIT(4 * 1024 * 1024);
 
-  if (argc != 5) {
-    printf("Usage: %s ttf_filename str_filename output_filename font_size\n", argv[0]);
+  if (argc != 5 && argc != 6) {
+    printf(
+        "Usage: %s ttf_filename str_filename output_filename font_size[,font_size...] "
+        "[a8|a4|a2|a1|a4_rle|a2_rle|a1_rle]\n",
+        argv[0]);
 
     return 0;
   }
@@ -46,7 +81,21 @@ int main(int argc, char** argv) {
   ttf_filename = argv[1];
   str_filename = argv[2];
   output_filename = argv[3];
-  font_size = atoi(argv[4]);
+
+  /*多个字号用逗号分开，生成多字号的位图字体。*/
+  p = argv[4];
+  while (p != NULL && *p && sizes_nr < MAX_SIZES) {
+    sizes[sizes_nr++] = (uint16_t)atoi(p);
+    p = strchr(p, ',');
+    if (p != NULL) {
+      p++;
+    }
+  }
+  return_value_if_fail(sizes_nr > 0, 0);
+
+  if (argc == 6) {
+    format = parse_format(argv[5]);
+  }
 
   ttf_buff = (uint8_t*)read_file(ttf_filename, &size);
   return_value_if_fail(ttf_buff != NULL, 0);
@@ -57,7 +106,7 @@ int main(int argc, char** argv) {
   return_value_if_fail(str_buff != NULL, 0);
 
   if (font != NULL) {
-    font_gen(font, (uint16_t)font_size, str_buff, output_filename);
+    font_gen_sizes(font, sizes, sizes_nr, format, str_buff, output_filename);
   }
 
   TKMEM_FREE(ttf_buff);